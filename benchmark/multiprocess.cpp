@@ -0,0 +1,291 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include "multithread.hpp"
+
+#include <umf/ipc.h>
+#include <umf/ipc_channel.h>
+#include <umf/memory_pool.h>
+#include <umf/pools/pool_shared.h>
+#include <umf/providers/provider_os_memory.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#define SHM_NAME "umf_bench_shared_pool"
+
+struct bench_params {
+    size_t n_repeats = 5;
+    size_t n_iterations = 100000;
+    size_t alloc_size = 64;
+};
+
+static umf_memory_pool_handle_t createSharedPool(char *shm_name,
+                                                 umf_ipc_handle_t heapHandle) {
+    auto osParams = umfOsMemoryProviderParamsDefault();
+    osParams.visibility = UMF_MEM_MAP_SHARED;
+    osParams.shm_name = shm_name;
+
+    umf_memory_provider_handle_t provider = nullptr;
+    auto ret =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &osParams, &provider);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "provider create failed" << std::endl;
+        abort();
+    }
+
+    auto poolParams = umfSharedPoolParamsDefault();
+    poolParams.heap_ipc_handle = heapHandle;
+
+    umf_memory_pool_handle_t hPool = nullptr;
+    ret = umfPoolCreate(umfSharedPoolOps(), provider, &poolParams,
+                        UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hPool);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "pool create failed" << std::endl;
+        abort();
+    }
+
+    return hPool;
+}
+
+// Run in a child process: open the heap and allocate and free
+// n_iterations objects. Returns the time of the workload in [ms].
+static double mp_worker(umf_ipc_handle_t heapHandle,
+                        const bench_params &bench) {
+    umf_memory_pool_handle_t pool = createSharedPool(nullptr, heapHandle);
+
+    std::vector<void *> allocs;
+    allocs.reserve(bench.n_iterations);
+    size_t numFailures = 0;
+
+    auto time = umf_bench::measure<std::chrono::microseconds>([&]() {
+        for (size_t i = 0; i < bench.n_iterations; i++) {
+            allocs.push_back(umfPoolMalloc(pool, bench.alloc_size));
+            if (!allocs.back()) {
+                numFailures++;
+            }
+        }
+
+        for (size_t i = 0; i < bench.n_iterations; i++) {
+            umfPoolFree(pool, allocs[i]);
+        }
+    });
+
+    umfPoolDestroy(pool);
+
+    return numFailures ? -1.0 : time / 1000.0;
+}
+
+static void mp_alloc_free(size_t n_procs,
+                          const bench_params &bench = bench_params()) {
+    char shm_name[] = SHM_NAME;
+    umf_memory_pool_handle_t pool = createSharedPool(shm_name, nullptr);
+
+    umf_ipc_handle_t heapHandle = nullptr;
+    size_t handleSize = 0;
+    auto ret = umfSharedPoolGetIPCHandle(pool, &heapHandle, &handleSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "getting IPC handle of the heap failed" << std::endl;
+        abort();
+    }
+
+    std::vector<double> values;
+    size_t numFailures = 0;
+
+    for (size_t r = 0; r < bench.n_repeats; r++) {
+        int fds[2];
+        if (pipe(fds)) {
+            std::cerr << "pipe failed" << std::endl;
+            abort();
+        }
+
+        // do not duplicate the buffered output in the child processes
+        std::cout.flush();
+
+        // the IPC handle is inherited by the child processes
+        for (size_t p = 0; p < n_procs; p++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(fds[0]);
+                double time = mp_worker(heapHandle, bench);
+                ssize_t len = write(fds[1], &time, sizeof(time));
+                _exit(len == sizeof(time) ? 0 : 1);
+            }
+        }
+
+        close(fds[1]);
+        for (size_t p = 0; p < n_procs; p++) {
+            double time;
+            if (read(fds[0], &time, sizeof(time)) != sizeof(time) || time < 0) {
+                numFailures++;
+                continue;
+            }
+
+            // skip the first 'warmup' iteration
+            if (r != 0) {
+                values.push_back(time);
+            }
+        }
+        close(fds[0]);
+
+        while (wait(nullptr) > 0) {
+        }
+    }
+
+    umfPutIPCHandle(heapHandle);
+    umfPoolDestroy(pool);
+
+    std::cout << "mean: " << umf_bench::mean(values)
+              << " [ms] std_dev: " << umf_bench::std_dev(values) << " [ms]"
+              << " (failed processes: " << numFailures << " out of "
+              << n_procs * bench.n_repeats << ")" << std::endl;
+}
+
+static void check_channel(umf_result_t ret, const char *what) {
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << what << " failed" << std::endl;
+        abort();
+    }
+}
+
+// Run in the child process: receive the messages from the 'request' channel
+// and send them back through the 'response' channel (pingpong = true)
+// or free them (pingpong = false).
+static void channel_worker(umf_ipc_handle_t heapHandle, uint64_t requestId,
+                           uint64_t responseId, size_t n_messages,
+                           bool pingpong) {
+    umf_memory_pool_handle_t pool = createSharedPool(nullptr, heapHandle);
+
+    umf_ipc_channel_handle_t request = nullptr;
+    umf_ipc_channel_handle_t response = nullptr;
+    check_channel(umfIPCChannelOpen(pool, requestId, &request),
+                  "opening the request channel");
+    check_channel(umfIPCChannelOpen(pool, responseId, &response),
+                  "opening the response channel");
+
+    for (size_t i = 0; i < n_messages; i++) {
+        void *ptr = nullptr;
+        size_t size = 0;
+        check_channel(umfIPCChannelReceive(request, &ptr, &size, -1),
+                      "receiving a message");
+        if (pingpong) {
+            check_channel(umfIPCChannelSend(response, ptr, size, -1),
+                          "sending a message");
+        } else {
+            umfPoolFree(pool, ptr);
+        }
+    }
+
+    umfIPCChannelClose(response);
+    umfIPCChannelClose(request);
+    umfPoolDestroy(pool);
+}
+
+// Measure the round-trip latency (pingpong = true) or the throughput
+// (pingpong = false) of the IPC channel between two processes.
+static void mp_channel(bool pingpong,
+                       const bench_params &bench = bench_params()) {
+    char shm_name[] = SHM_NAME;
+    umf_memory_pool_handle_t pool = createSharedPool(shm_name, nullptr);
+
+    umf_ipc_handle_t heapHandle = nullptr;
+    size_t handleSize = 0;
+    check_channel(umfSharedPoolGetIPCHandle(pool, &heapHandle, &handleSize),
+                  "getting IPC handle of the heap");
+
+    umf_ipc_channel_handle_t request = nullptr;
+    umf_ipc_channel_handle_t response = nullptr;
+    check_channel(
+        umfIPCChannelCreate(pool, UMF_IPC_CHANNEL_SPSC, 1024, &request),
+        "creating the request channel");
+    check_channel(
+        umfIPCChannelCreate(pool, UMF_IPC_CHANNEL_SPSC, 1024, &response),
+        "creating the response channel");
+
+    uint64_t requestId = 0, responseId = 0;
+    umfIPCChannelGetId(request, &requestId);
+    umfIPCChannelGetId(response, &responseId);
+
+    std::vector<double> values;
+    for (size_t r = 0; r < bench.n_repeats; r++) {
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            channel_worker(heapHandle, requestId, responseId,
+                           bench.n_iterations, pingpong);
+            _exit(0);
+        }
+
+        auto time = umf_bench::measure<std::chrono::microseconds>([&]() {
+            for (size_t i = 0; i < bench.n_iterations; i++) {
+                void *ptr = umfPoolMalloc(pool, bench.alloc_size);
+                check_channel(
+                    umfIPCChannelSend(request, ptr, bench.alloc_size, -1),
+                    "sending a message");
+                if (!pingpong) {
+                    continue;
+                }
+
+                size_t size = 0;
+                check_channel(umfIPCChannelReceive(response, &ptr, &size, -1),
+                              "receiving a message");
+                umfPoolFree(pool, ptr);
+            }
+        });
+
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0) {
+            std::cerr << "the consumer process failed" << std::endl;
+            abort();
+        }
+
+        // skip the first 'warmup' iteration
+        if (r != 0) {
+            values.push_back(time);
+        }
+    }
+
+    umfIPCChannelClose(response);
+    umfIPCChannelClose(request);
+    umfPutIPCHandle(heapHandle);
+    umfPoolDestroy(pool);
+
+    // time of a single round trip or a single message [us]
+    for (auto &v : values) {
+        v /= bench.n_iterations;
+    }
+
+    std::cout << "mean: " << umf_bench::mean(values)
+              << " [us] std_dev: " << umf_bench::std_dev(values) << " [us]"
+              << std::endl;
+}
+
+int main() {
+    for (size_t n_procs : {1, 2, 4, 8}) {
+        std::cout << "shared_pool mp_alloc_free (" << n_procs
+                  << " processes): ";
+        mp_alloc_free(n_procs);
+    }
+
+    std::cout << "ipc_channel round-trip latency: ";
+    mp_channel(true);
+
+    std::cout << "ipc_channel time per message (streaming): ";
+    mp_channel(false);
+
+    // ctest looks for "PASSED" in the output
+    std::cout << "PASSED" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+// This benchmark shows how the RSS of the process changes over time
+// after a burst of allocations from the jemalloc pool is freed,
+// depending on the decay settings of the pool.
+
+#include <umf/memory_pool.h>
+#include <umf/pools/pool_jemalloc.h>
+#include <umf/providers/provider_os_memory.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+struct bench_params {
+    size_t n_allocs = 4096;
+    size_t alloc_size = 16 * 1024; // 64 MB in total
+    size_t n_samples = 15;
+    size_t sample_interval_ms = 100;
+};
+
+static size_t rss_mb() {
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) {
+        return 0;
+    }
+
+    unsigned long size = 0, resident = 0;
+    if (fscanf(f, "%lu %lu", &size, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(f);
+
+    return resident * (size_t)sysconf(_SC_PAGE_SIZE) / (1024 * 1024);
+}
+
+static void rss_over_time(const char *name, int64_t dirty_decay_ms,
+                          int64_t muzzy_decay_ms, bool purge,
+                          const bench_params &bench = bench_params()) {
+    auto osParams = umfOsMemoryProviderParamsDefault();
+    umf_memory_provider_handle_t provider = nullptr;
+    auto ret =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &osParams, &provider);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "provider create failed" << std::endl;
+        abort();
+    }
+
+    auto poolParams = umfJemallocPoolParamsDefault();
+    poolParams.dirty_decay_ms = dirty_decay_ms;
+    poolParams.muzzy_decay_ms = muzzy_decay_ms;
+
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(umfJemallocPoolOps(), provider, &poolParams,
+                        UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+    if (ret != UMF_RESULT_SUCCESS) {
+        std::cerr << "pool create failed" << std::endl;
+        abort();
+    }
+
+    size_t base = rss_mb();
+
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < bench.n_allocs; i++) {
+        void *ptr = umfPoolMalloc(pool, bench.alloc_size);
+        if (!ptr) {
+            std::cerr << "allocation failed" << std::endl;
+            abort();
+        }
+        memset(ptr, 0xAB, bench.alloc_size);
+        allocs.push_back(ptr);
+    }
+
+    size_t peak = rss_mb();
+
+    for (auto ptr : allocs) {
+        umfPoolFree(pool, ptr);
+    }
+
+    if (purge) {
+        umfJemallocPoolPurge(pool);
+    }
+
+    std::cout << name << " (peak: " << peak - base << " MB) [MB]:";
+    for (size_t s = 0; s < bench.n_samples; s++) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(bench.sample_interval_ms));
+
+        // jemalloc purges on allocation activity (background threads are
+        // disabled by default), so keep the pool slightly busy
+        umfPoolFree(pool, umfPoolMalloc(pool, 64));
+
+        size_t rss = rss_mb();
+        std::cout << " " << (rss > base ? rss - base : 0);
+    }
+    std::cout << std::endl;
+
+    umfPoolDestroy(pool);
+}
+
+int main() {
+    std::cout << "RSS of the jemalloc pool after freeing all allocations, "
+                 "sampled every "
+              << bench_params().sample_interval_ms << " ms" << std::endl;
+
+    rss_over_time("default decay", UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT,
+                  UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT, false);
+    rss_over_time("dirty_decay_ms=500", 500, 0, false);
+    rss_over_time("dirty_decay_ms=0", 0, 0, false);
+    rss_over_time("no decay", -1, -1, false);
+    rss_over_time("no decay + umfJemallocPoolPurge()", -1, -1, true);
+
+    // ctest looks for "PASSED" in the output
+    std::cout << "PASSED" << std::endl;
+
+    return 0;
+}
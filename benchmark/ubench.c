@@ -15,8 +15,12 @@
 
 #include <umf/ipc.h>
 #include <umf/memory_pool.h>
+#include <umf/pools/pool_object.h>
 #include <umf/pools/pool_proxy.h>
 #include <umf/pools/pool_scalable.h>
+#include <umf/providers/provider_coarse.h>
+#include <umf/providers/provider_devdax_memory.h>
+#include <umf/providers/provider_file_memory.h>
 #include <umf/providers/provider_level_zero.h>
 #include <umf/providers/provider_os_memory.h>
 
@@ -191,6 +195,136 @@ UBENCH_EX(simple, os_memory_provider) {
     free(array);
 }
 
+#ifndef _WIN32
+////////////////// DEVDAX MEMORY PROVIDER (EMULATED WITH A MEMFD)
+
+UBENCH_EX(simple, devdax_memory_provider_emulation) {
+    if (umfDevDaxMemoryProviderOps() == NULL) {
+        fprintf(stderr, "devdax memory provider is not supported\n");
+        return;
+    }
+
+    alloc_t *array = alloc_array(N_ITERATIONS);
+
+    // every allocation takes at least one 2 MB page of the device DAX
+    umf_devdax_memory_provider_params_t devdax_params =
+        umfDevDaxMemoryProviderParamsDefault(
+            NULL, (N_ITERATIONS + 1) * 2 * 1024 * 1024);
+    devdax_params.emulation = true;
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t devdax_memory_provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfDevDaxMemoryProviderOps(),
+                                         &devdax_params,
+                                         &devdax_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    do_benchmark(array, N_ITERATIONS, w_umfMemoryProviderAlloc,
+                 w_umfMemoryProviderFree, devdax_memory_provider); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_benchmark(array, N_ITERATIONS, w_umfMemoryProviderAlloc,
+                     w_umfMemoryProviderFree, devdax_memory_provider);
+    }
+
+    umfMemoryProviderDestroy(devdax_memory_provider);
+    free(array);
+}
+
+////////////////// PERSIST (MSYNC VS CPU CACHE FLUSH)
+
+#define PERSIST_FILE_PATH "ubench_persist_file"
+#define PERSIST_N_PAGES 64
+
+typedef void (*persist_t)(void *provider, void *ptr, size_t size);
+
+// dirty one cache line of every page and persist the pages one by one
+static void do_persist_benchmark(char *base, size_t n_pages,
+                                 persist_t persist_f, void *provider) {
+    size_t page_size = ALLOC_SIZE;
+    for (size_t i = 0; i < n_pages; i++) {
+        char *page = base + i * page_size;
+        page[0]++;
+        persist_f(provider, page, 64);
+    }
+}
+
+static void w_umfMemoryProviderPersist(void *provider, void *ptr,
+                                       size_t size) {
+    umf_result_t umf_result = umfMemoryProviderPersist(provider, ptr, size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderPersist() failed\n");
+        exit(-1);
+    }
+}
+
+static void w_utils_flush_cache(void *provider, void *ptr, size_t size) {
+    (void)provider; // unused
+    utils_flush_cache(ptr, size);
+}
+
+static umf_memory_provider_handle_t create_persist_file_provider(void) {
+    umf_file_memory_provider_params_t file_params =
+        umfFileMemoryProviderParamsDefault(PERSIST_FILE_PATH);
+    file_params.visibility = UMF_MEM_MAP_SHARED;
+
+    umf_memory_provider_handle_t file_memory_provider = NULL;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &file_params, &file_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    return file_memory_provider;
+}
+
+static void run_persist_benchmark(struct ubench_run_state_s *ubench_run_state,
+                                  persist_t persist_f) {
+    umf_memory_provider_handle_t file_memory_provider =
+        create_persist_file_provider();
+
+    size_t size = PERSIST_N_PAGES * ALLOC_SIZE;
+    void *ptr = NULL;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(file_memory_provider, size, 0, &ptr);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderAlloc() failed\n");
+        exit(-1);
+    }
+
+    do_persist_benchmark(ptr, PERSIST_N_PAGES, persist_f,
+                         file_memory_provider); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_persist_benchmark(ptr, PERSIST_N_PAGES, persist_f,
+                             file_memory_provider);
+    }
+
+    umfMemoryProviderFree(file_memory_provider, ptr, size);
+    umfMemoryProviderDestroy(file_memory_provider);
+    unlink(PERSIST_FILE_PATH);
+}
+
+// msync is the fallback path of a regular (not MAP_SYNC) file mapping
+UBENCH_EX(persist, file_memory_provider_msync) {
+    run_persist_benchmark(ubench_run_state, w_umfMemoryProviderPersist);
+}
+
+// the path of MAP_SYNC and devdax mappings measured on the same memory
+UBENCH_EX(persist, cpu_cache_flush) {
+    if (utils_flush_cache_instruction() == NULL) {
+        fprintf(stderr, "CPU cache flush is not supported\n");
+        return;
+    }
+
+    run_persist_benchmark(ubench_run_state, w_utils_flush_cache);
+}
+#endif /* _WIN32 */
+
 static void *w_umfPoolMalloc(void *provider, size_t size, size_t alignment) {
     (void)alignment; // unused
     umf_memory_pool_handle_t hPool = (umf_memory_pool_handle_t)provider;
@@ -244,6 +378,45 @@ UBENCH_EX(simple, proxy_pool_with_os_memory_provider) {
     free(array);
 }
 
+////////////////// OBJECT POOL WITH OS MEMORY PROVIDER
+
+UBENCH_EX(simple, object_pool_with_os_memory_provider) {
+    alloc_t *array = alloc_array(N_ITERATIONS);
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t os_memory_provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                         &UMF_OS_MEMORY_PROVIDER_PARAMS,
+                                         &os_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    umf_object_pool_params_t object_pool_params =
+        umfObjectPoolParamsDefault(ALLOC_SIZE);
+
+    umf_memory_pool_handle_t object_pool;
+    umf_result = umfPoolCreate(umfObjectPoolOps(), os_memory_provider,
+                               &object_pool_params, 0, &object_pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        exit(-1);
+    }
+
+    do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, w_umfPoolFree,
+                 object_pool); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, w_umfPoolFree,
+                     object_pool);
+    }
+
+    umfPoolDestroy(object_pool);
+    umfMemoryProviderDestroy(os_memory_provider);
+    free(array);
+}
+
 #if (defined UMF_BUILD_LIBUMF_POOL_DISJOINT)
 ////////////////// DISJOINT POOL WITH OS MEMORY PROVIDER
 
@@ -325,6 +498,55 @@ UBENCH_EX(simple, jemalloc_pool_with_os_memory_provider) {
     umfMemoryProviderDestroy(os_memory_provider);
     free(array);
 }
+
+////////////////// JEMALLOC POOL CREATE/DESTROY
+
+#define N_POOLS 100
+
+// creates and destroys a pool with a single allocation,
+// as in the pattern of one pool per request
+static void do_jemalloc_pool_create_destroy(void *provider) {
+    umf_memory_pool_handle_t jemalloc_pool;
+    for (int i = 0; i < N_POOLS; i++) {
+        umf_result_t umf_result = umfPoolCreate(
+            umfJemallocPoolOps(), provider, NULL, 0, &jemalloc_pool);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            fprintf(stderr, "error: umfPoolCreate() failed\n");
+            exit(-1);
+        }
+
+        void *ptr = umfPoolMalloc(jemalloc_pool, Alloc_size);
+        if (ptr == NULL) {
+            fprintf(stderr, "error: umfPoolMalloc() failed\n");
+            exit(-1);
+        }
+        umfPoolFree(jemalloc_pool, ptr);
+
+        umfPoolDestroy(jemalloc_pool);
+    }
+}
+
+UBENCH_EX(simple, jemalloc_pool_create_destroy) {
+    Alloc_size = (int)ALLOC_SIZE;
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t os_memory_provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                         &UMF_OS_MEMORY_PROVIDER_PARAMS,
+                                         &os_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    do_jemalloc_pool_create_destroy(os_memory_provider); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_jemalloc_pool_create_destroy(os_memory_provider);
+    }
+
+    umfMemoryProviderDestroy(os_memory_provider);
+}
 #endif /* (defined UMF_BUILD_LIBUMF_POOL_JEMALLOC) */
 
 #if (defined UMF_POOL_SCALABLE_ENABLED)
@@ -363,9 +585,113 @@ UBENCH_EX(simple, scalable_pool_with_os_memory_provider) {
     umfMemoryProviderDestroy(os_memory_provider);
     free(array);
 }
+
+////////////////// SCALABLE (TBB) POOL SETTINGS
+
+// runs the benchmark of the scalable pool with the given params over the OS
+// memory provider or over the coarse provider on top of the OS one
+static void
+do_scalable_pool_params_benchmark(struct ubench_run_state_s *ubench_run_state,
+                                  umf_scalable_pool_params_t *params,
+                                  bool coarse) {
+    alloc_t *array = alloc_array(N_ITERATIONS);
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                         &UMF_OS_MEMORY_PROVIDER_PARAMS,
+                                         &provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        exit(-1);
+    }
+
+    if (coarse) {
+        coarse_memory_provider_params_t coarse_params =
+            umfCoarseMemoryProviderParamsDefault();
+        coarse_params.upstream_memory_provider = provider;
+        coarse_params.destroy_upstream_memory_provider = true;
+
+        umf_result = umfMemoryProviderCreate(umfCoarseMemoryProviderOps(),
+                                             &coarse_params, &provider);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+            exit(-1);
+        }
+    }
+
+    umf_memory_pool_handle_t scalable_pool;
+    umf_result = umfPoolCreate(umfScalablePoolOps(), provider, params,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER,
+                               &scalable_pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        exit(-1);
+    }
+
+    do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, w_umfPoolFree,
+                 scalable_pool); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_benchmark(array, N_ITERATIONS, w_umfPoolMalloc, w_umfPoolFree,
+                     scalable_pool);
+    }
+
+    umfPoolDestroy(scalable_pool);
+    free(array);
+}
+
+static umf_scalable_pool_params_t scalable_params_granularity_64k(void) {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.granularity = 64 * 1024;
+    return params;
+}
+
+static umf_scalable_pool_params_t scalable_params_keep_all_memory(void) {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.keep_all_memory = true;
+    return params;
+}
+
+static umf_scalable_pool_params_t scalable_params_fixed_pool(void) {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.fixed_pool_size = 2 * N_ITERATIONS * ALLOC_SIZE;
+    return params;
+}
+
+UBENCH_EX(simple, scalable_pool_granularity_64k_with_os_memory_provider) {
+    umf_scalable_pool_params_t params = scalable_params_granularity_64k();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, false);
+}
+
+UBENCH_EX(simple, scalable_pool_keep_all_memory_with_os_memory_provider) {
+    umf_scalable_pool_params_t params = scalable_params_keep_all_memory();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, false);
+}
+
+UBENCH_EX(simple, scalable_pool_fixed_with_os_memory_provider) {
+    umf_scalable_pool_params_t params = scalable_params_fixed_pool();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, false);
+}
+
+UBENCH_EX(simple, scalable_pool_granularity_64k_with_coarse_provider) {
+    umf_scalable_pool_params_t params = scalable_params_granularity_64k();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, true);
+}
+
+UBENCH_EX(simple, scalable_pool_keep_all_memory_with_coarse_provider) {
+    umf_scalable_pool_params_t params = scalable_params_keep_all_memory();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, true);
+}
+
+UBENCH_EX(simple, scalable_pool_fixed_with_coarse_provider) {
+    umf_scalable_pool_params_t params = scalable_params_fixed_pool();
+    do_scalable_pool_params_benchmark(ubench_run_state, &params, true);
+}
 #endif /* (defined UMF_POOL_SCALABLE_ENABLED) */
 
-#if (defined UMF_BUILD_LIBUMF_POOL_DISJOINT &&                                 \
+#if !defined(_WIN32) ||                                                        \
+    (defined UMF_BUILD_LIBUMF_POOL_DISJOINT &&                                 \
      defined UMF_BUILD_LEVEL_ZERO_PROVIDER && defined UMF_BUILD_GPU_TESTS)
 static void do_ipc_get_put_benchmark(alloc_t *allocs, size_t num_allocs,
                                      size_t repeats,
@@ -388,6 +714,259 @@ static void do_ipc_get_put_benchmark(alloc_t *allocs, size_t num_allocs,
         }
     }
 }
+#endif
+
+#ifndef _WIN32
+////////////////// IPC GET/PUT WITH OS MEMORY PROVIDER
+
+static void do_ipc_get_to_buffer_benchmark(alloc_t *allocs, size_t num_allocs,
+                                           size_t repeats, void *buffer,
+                                           size_t buffer_size) {
+    for (size_t r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < num_allocs; ++i) {
+            size_t handle_size = 0;
+            umf_result_t res = umfGetIPCHandleToBuffer(
+                allocs[i].ptr, buffer, buffer_size, &handle_size);
+            if (res != UMF_RESULT_SUCCESS) {
+                fprintf(stderr, "umfGetIPCHandleToBuffer() failed\n");
+            }
+        }
+    }
+}
+
+static umf_memory_pool_handle_t create_ipc_proxy_pool(void) {
+    umf_os_memory_provider_params_t os_params = UMF_OS_MEMORY_PROVIDER_PARAMS;
+    os_params.visibility = UMF_MEM_MAP_SHARED;
+
+    umf_memory_provider_handle_t os_memory_provider = NULL;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &os_params, &os_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        return NULL;
+    }
+
+    umf_memory_pool_handle_t pool = NULL;
+    umf_result = umfPoolCreate(umfProxyPoolOps(), os_memory_provider, NULL,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        umfMemoryProviderDestroy(os_memory_provider);
+        return NULL;
+    }
+
+    return pool;
+}
+
+UBENCH_EX(ipc, get_put_proxy_pool_with_os_memory_provider) {
+    const size_t N_BUFFERS = 1000;
+
+    alloc_t *allocs = alloc_array(N_BUFFERS);
+
+    umf_ipc_handle_t *ipc_handles = calloc(N_BUFFERS, sizeof(umf_ipc_handle_t));
+    if (ipc_handles == NULL) {
+        fprintf(stderr, "error: calloc() failed\n");
+        goto err_free_allocs;
+    }
+
+    umf_memory_pool_handle_t pool = create_ipc_proxy_pool();
+    if (pool == NULL) {
+        goto err_free_ipc_handles;
+    }
+
+    size_t n_allocs = 0;
+    for (; n_allocs < N_BUFFERS; ++n_allocs) {
+        allocs[n_allocs].ptr = umfPoolMalloc(pool, ALLOC_SIZE);
+        if (allocs[n_allocs].ptr == NULL) {
+            goto err_free_buffers;
+        }
+        allocs[n_allocs].size = ALLOC_SIZE;
+    }
+
+    do_ipc_get_put_benchmark(allocs, N_BUFFERS, N_ITERATIONS / 100,
+                             ipc_handles); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_ipc_get_put_benchmark(allocs, N_BUFFERS, N_ITERATIONS / 100,
+                                 ipc_handles);
+    }
+
+err_free_buffers:
+    for (size_t i = 0; i < n_allocs; ++i) {
+        umfPoolFree(pool, allocs[i].ptr);
+    }
+
+    umfPoolDestroy(pool);
+
+err_free_ipc_handles:
+    free(ipc_handles);
+
+err_free_allocs:
+    free(allocs);
+}
+
+UBENCH_EX(ipc, get_to_buffer_proxy_pool_with_os_memory_provider) {
+    const size_t N_BUFFERS = 1000;
+
+    alloc_t *allocs = alloc_array(N_BUFFERS);
+
+    umf_memory_pool_handle_t pool = create_ipc_proxy_pool();
+    if (pool == NULL) {
+        goto err_free_allocs;
+    }
+
+    size_t buffer_size = 0;
+    if (umfPoolGetIPCHandleSize(pool, &buffer_size) != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolGetIPCHandleSize() failed\n");
+        goto err_destroy_pool;
+    }
+
+    // the IPC handle has to be aligned to 8 bytes
+    uint64_t *buffer = calloc(1, buffer_size + sizeof(uint64_t));
+    if (buffer == NULL) {
+        fprintf(stderr, "error: calloc() failed\n");
+        goto err_destroy_pool;
+    }
+
+    size_t n_allocs = 0;
+    for (; n_allocs < N_BUFFERS; ++n_allocs) {
+        allocs[n_allocs].ptr = umfPoolMalloc(pool, ALLOC_SIZE);
+        if (allocs[n_allocs].ptr == NULL) {
+            goto err_free_buffers;
+        }
+        allocs[n_allocs].size = ALLOC_SIZE;
+    }
+
+    do_ipc_get_to_buffer_benchmark(allocs, N_BUFFERS, N_ITERATIONS / 100,
+                                   buffer, buffer_size); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_ipc_get_to_buffer_benchmark(allocs, N_BUFFERS, N_ITERATIONS / 100,
+                                       buffer, buffer_size);
+    }
+
+err_free_buffers:
+    for (size_t i = 0; i < n_allocs; ++i) {
+        umfPoolFree(pool, allocs[i].ptr);
+    }
+
+    free(buffer);
+
+err_destroy_pool:
+    umfPoolDestroy(pool);
+
+err_free_allocs:
+    free(allocs);
+}
+
+////////////////// IPC OPEN/CLOSE WITH OS MEMORY PROVIDER
+
+static void do_ipc_open_close_benchmark(umf_memory_pool_handle_t pool,
+                                        umf_ipc_handle_t *ipc_handles,
+                                        size_t num_handles, size_t repeats) {
+    for (size_t r = 0; r < repeats; ++r) {
+        for (size_t i = 0; i < num_handles; ++i) {
+            void *ptr = NULL;
+            umf_result_t res = umfOpenIPCHandle(pool, ipc_handles[i], &ptr);
+            if (res != UMF_RESULT_SUCCESS) {
+                fprintf(stderr, "umfOpenIPCHandle() failed\n");
+                continue;
+            }
+
+            res = umfCloseIPCHandle(ptr);
+            if (res != UMF_RESULT_SUCCESS) {
+                fprintf(stderr, "umfCloseIPCHandle() failed\n");
+            }
+        }
+    }
+}
+
+UBENCH_EX(ipc, open_close_proxy_pool_with_os_memory_provider) {
+    const size_t N_BUFFERS = 32;
+    umf_os_memory_provider_params_t os_params = UMF_OS_MEMORY_PROVIDER_PARAMS;
+    os_params.visibility = UMF_MEM_MAP_SHARED;
+
+    alloc_t *allocs = alloc_array(N_BUFFERS);
+
+    umf_ipc_handle_t *ipc_handles = calloc(N_BUFFERS, sizeof(umf_ipc_handle_t));
+    if (ipc_handles == NULL) {
+        fprintf(stderr, "error: calloc() failed\n");
+        goto err_free_allocs;
+    }
+
+    umf_result_t umf_result;
+    umf_memory_provider_handle_t os_memory_provider = NULL;
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(), &os_params,
+                                         &os_memory_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfMemoryProviderCreate() failed\n");
+        goto err_free_ipc_handles;
+    }
+
+    // the producer's pool
+    umf_memory_pool_handle_t pool;
+    umf_result = umfPoolCreate(umfProxyPoolOps(), os_memory_provider, NULL, 0,
+                               &pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        goto err_destroy_provider;
+    }
+
+    // the consumer's pool
+    umf_memory_pool_handle_t consumer_pool;
+    umf_result = umfPoolCreate(umfProxyPoolOps(), os_memory_provider, NULL, 0,
+                               &consumer_pool);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        fprintf(stderr, "error: umfPoolCreate() failed\n");
+        goto err_destroy_pool;
+    }
+
+    size_t n_handles = 0;
+    for (; n_handles < N_BUFFERS; ++n_handles) {
+        size_t handle_size = 0;
+        allocs[n_handles].ptr = umfPoolMalloc(pool, ALLOC_SIZE);
+        if (allocs[n_handles].ptr == NULL) {
+            goto err_put_handles;
+        }
+        if (umfGetIPCHandle(allocs[n_handles].ptr, &ipc_handles[n_handles],
+                            &handle_size) != UMF_RESULT_SUCCESS) {
+            umfPoolFree(pool, allocs[n_handles].ptr);
+            goto err_put_handles;
+        }
+    }
+
+    do_ipc_open_close_benchmark(consumer_pool, ipc_handles, n_handles,
+                                N_ITERATIONS / 10); // WARMUP
+
+    UBENCH_DO_BENCHMARK() {
+        do_ipc_open_close_benchmark(consumer_pool, ipc_handles, n_handles,
+                                    N_ITERATIONS / 10);
+    }
+
+err_put_handles:
+    for (size_t i = 0; i < n_handles; ++i) {
+        umfPutIPCHandle(ipc_handles[i]);
+        umfPoolFree(pool, allocs[i].ptr);
+    }
+
+    umfPoolDestroy(consumer_pool);
+
+err_destroy_pool:
+    umfPoolDestroy(pool);
+
+err_destroy_provider:
+    umfMemoryProviderDestroy(os_memory_provider);
+
+err_free_ipc_handles:
+    free(ipc_handles);
+
+err_free_allocs:
+    free(allocs);
+}
+#endif /* _WIN32 */
+
+#if (defined UMF_BUILD_LIBUMF_POOL_DISJOINT &&                                 \
+     defined UMF_BUILD_LEVEL_ZERO_PROVIDER && defined UMF_BUILD_GPU_TESTS)
 
 int create_level_zero_params(level_zero_memory_provider_params_t *params) {
     uint32_t driver_idx = 0;
@@ -67,7 +67,7 @@ static umf_memory_pool_handle_t create_fsdax_pool(const char *path) {
     // so it should be used with a pool manager that will take over
     // the managing of the provided memory - for example the jemalloc pool
     // with the `disable_provider_free` parameter set to true.
-    umf_jemalloc_pool_params_t pool_params;
+    umf_jemalloc_pool_params_t pool_params = umfJemallocPoolParamsDefault();
     pool_params.disable_provider_free = true;
 
     // Create an FSDAX memory pool
@@ -19,6 +19,30 @@ extern "C" {
 
 typedef struct umf_ipc_data_t *umf_ipc_handle_t;
 
+typedef struct umf_ipc_region_t *umf_ipc_region_handle_t;
+
+/// @brief Reference to an object in a base allocation (region) of a pool
+///        exported once with umfGetIPCHandle(). It is a small,
+///        self-contained value that can be sent instead of a full IPC handle.
+typedef struct umf_ipc_region_ref_t {
+    uint64_t region_id; ///< ID of the region in the producer process
+    uint64_t offset;    ///< offset of the object in the region
+    uint64_t size;      ///< size of the object
+} umf_ipc_region_ref_t;
+
+/// @brief Statistics of the caches of IPC handles of a pool
+typedef struct umf_ipc_cache_stats_t {
+    /// number of IPC handles created from the cached IPC handles
+    /// of the base allocations
+    uint64_t get_hits;
+    /// number of IPC handles got from the memory provider
+    uint64_t get_misses;
+    /// number of IPC handles opened using the cached mappings
+    uint64_t open_hits;
+    /// number of IPC handles opened (mapped) by the memory provider
+    uint64_t open_misses;
+} umf_ipc_cache_stats_t;
+
 ///
 /// @brief Returns the size of IPC handles for the specified pool.
 /// @param hPool [in] Pool handle
@@ -36,6 +60,23 @@ umf_result_t umfPoolGetIPCHandleSize(umf_memory_pool_handle_t hPool,
 umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *ipcHandle,
                              size_t *size);
 
+///
+/// @brief Creates an IPC handle for the specified UMF allocation in the
+///        buffer provided by the caller. No memory is allocated if the
+///        IPC handle of the base allocation is already cached in the pool.
+///        The handle must not be released with umfPutIPCHandle().
+/// @param ptr [in] pointer to the allocated memory.
+/// @param buffer [out] buffer for the IPC handle (aligned to 8 bytes),
+///        it can be passed to umfOpenIPCHandle() as umf_ipc_handle_t.
+/// @param bufferSize [in] size of the buffer in bytes.
+/// @param size [out] size of IPC handle in bytes (the required size
+///        of the buffer if the buffer is too small).
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the buffer is too small
+///         or appropriate error code on failure.
+umf_result_t umfGetIPCHandleToBuffer(const void *ptr, void *buffer,
+                                     size_t bufferSize, size_t *size);
+
 ///
 /// @brief Release IPC handle retrieved by umfGetIPCHandle.
 /// @param ipcHandle IPC handle.
@@ -57,6 +98,119 @@ umf_result_t umfOpenIPCHandle(umf_memory_pool_handle_t hPool,
 /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
 umf_result_t umfCloseIPCHandle(void *ptr);
 
+///
+/// @brief Creates a single batch of IPC handles for an array of UMF
+///        allocations. Pointers sharing a base allocation share a single
+///        IPC handle in the batch. The batch is a contiguous buffer which
+///        can be sent to another process as is.
+/// @param ptrs [in] array of pointers to the allocated memory.
+/// @param count [in] number of pointers.
+/// @param ipcHandles [out] returned batch of IPC handles.
+/// @param size [out] size of the batch in bytes.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfGetIPCHandles(const void *const *ptrs, size_t count,
+                              void **ipcHandles, size_t *size);
+
+///
+/// @brief Release the batch of IPC handles retrieved by umfGetIPCHandles.
+/// @param ipcHandles batch of IPC handles.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfPutIPCHandles(void *ipcHandles);
+
+///
+/// @brief Open the batch of IPC handles retrieved by umfGetIPCHandles.
+///        Every opened pointer has to be closed with umfCloseIPCHandle()
+///        or umfCloseIPCHandles().
+/// @param hPool [in] Pool handle where to open the IPC handles.
+/// @param ipcHandles [in] batch of IPC handles (aligned to 8 bytes).
+/// @param size [in] size of the batch in bytes.
+/// @param ptrs [out] array of 'count' pointers to the memory in the current
+///        process (in the order of umfGetIPCHandles()).
+/// @param count [in] number of pointers in the batch.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfOpenIPCHandles(umf_memory_pool_handle_t hPool,
+                               void *ipcHandles, size_t size, void **ptrs,
+                               size_t count);
+
+///
+/// @brief Close the array of pointers opened by umfOpenIPCHandles.
+/// @param ptrs [in] array of pointers to the memory.
+/// @param count [in] number of pointers.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfCloseIPCHandles(void **ptrs, size_t count);
+
+///
+/// @brief Creates a reference to an object in the base allocation (region)
+///        of a pool. The region has to be exported to the consumer once
+///        with umfGetIPCHandle() called for any pointer of the region.
+/// @param ptr [in] pointer to the object.
+/// @param size [in] size of the object.
+/// @param ref [out] returned reference to the object.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfGetIPCRegionRef(const void *ptr, size_t size,
+                                umf_ipc_region_ref_t *ref);
+
+///
+/// @brief Open the region exported with umfGetIPCHandle(). The objects
+///        of the region are resolved with umfIPCRegionGetPtr() without
+///        mapping the region again.
+/// @param hPool [in] Pool handle where to open the region.
+/// @param ipcHandle [in] IPC handle of any pointer of the region.
+/// @param region [out] handle of the opened region.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfOpenIPCRegion(umf_memory_pool_handle_t hPool,
+                              umf_ipc_handle_t ipcHandle,
+                              umf_ipc_region_handle_t *region);
+
+///
+/// @brief Get the region ID of the opened region (to match it
+///        with the 'region_id' of the references to its objects).
+/// @param region [in] handle of the opened region.
+/// @param regionId [out] ID of the region in the producer process.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCRegionGetId(umf_ipc_region_handle_t region,
+                               uint64_t *regionId);
+
+///
+/// @brief Resolve the reference to an object in the opened region.
+///        The returned pointer is valid until the region is closed.
+/// @param region [in] handle of the opened region.
+/// @param ref [in] reference created by umfGetIPCRegionRef().
+/// @param ptr [out] pointer to the object in the current process.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCRegionGetPtr(umf_ipc_region_handle_t region,
+                                const umf_ipc_region_ref_t *ref, void **ptr);
+
+///
+/// @brief Close the region opened by umfOpenIPCRegion().
+/// @param region [in] handle of the opened region.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfCloseIPCRegion(umf_ipc_region_handle_t region);
+
+///
+/// @brief Set the size of the cache of IPC handles opened in the pool.
+///        Opening an IPC handle that is already opened in the pool
+///        reuses the existing mapping and the mapping is kept open after
+///        its last umfCloseIPCHandle(). At most 'size' of such unused
+///        mappings are kept in the pool, the least recently used ones
+///        above this limit are closed. IPC handles opened in the pool
+///        that are not closed when the pool is destroyed are closed
+///        (unmapped) then, so their pointers must not be used anymore.
+/// @param hPool [in] Pool handle
+/// @param size [in] maximum number of unused opened IPC handles kept in
+///        the pool (0 means the mappings are closed on the last close)
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfPoolSetOpenedIPCCacheSize(umf_memory_pool_handle_t hPool,
+                                          size_t size);
+
+///
+/// @brief Get the statistics of the caches of IPC handles of the pool.
+/// @param hPool [in] Pool handle
+/// @param stats [out] statistics of the caches
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfPoolGetIPCCacheStats(umf_memory_pool_handle_t hPool,
+                                     umf_ipc_cache_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
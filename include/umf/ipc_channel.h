@@ -0,0 +1,107 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_IPC_CHANNEL_H
+#define UMF_IPC_CHANNEL_H 1
+
+#include <umf/base.h>
+#include <umf/memory_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Mode of the IPC channel
+typedef enum umf_ipc_channel_mode_t {
+    UMF_IPC_CHANNEL_SPSC, ///< single producer, single consumer
+    UMF_IPC_CHANNEL_MPSC, ///< multiple producers, single consumer
+} umf_ipc_channel_mode_t;
+
+/// @brief The IPC channel passes messages (pointers to the memory
+///        allocated from a shared memory pool) between processes without
+///        copying them. The channel is a ring of (offset, size) descriptors
+///        placed in the heap of the shared memory pool.
+typedef struct umf_ipc_channel_t *umf_ipc_channel_handle_t;
+
+///
+/// @brief Create a new IPC channel in the heap of the shared memory pool.
+/// @param hPool [in] handle of the shared memory pool.
+/// @param mode [in] mode of the channel.
+/// @param capacity [in] maximum number of messages in the channel
+///        (rounded up to a power of 2).
+/// @param channel [out] handle of the new channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelCreate(umf_memory_pool_handle_t hPool,
+                                 umf_ipc_channel_mode_t mode, size_t capacity,
+                                 umf_ipc_channel_handle_t *channel);
+
+///
+/// @brief Get the ID of the channel, which is used to open the channel
+///        in another process.
+/// @param channel [in] handle of the channel.
+/// @param channelId [out] ID of the channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelGetId(umf_ipc_channel_handle_t channel,
+                                uint64_t *channelId);
+
+///
+/// @brief Open the channel created in the same heap of the shared memory pool
+///        (possibly by another process).
+/// @param hPool [in] handle of the shared memory pool that opened the heap.
+/// @param channelId [in] ID of the channel returned by umfIPCChannelGetId().
+/// @param channel [out] handle of the opened channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelOpen(umf_memory_pool_handle_t hPool,
+                               uint64_t channelId,
+                               umf_ipc_channel_handle_t *channel);
+
+///
+/// @brief Send the message to the channel. The ownership of the memory
+///        of the message is passed to the receiver.
+/// @param channel [in] handle of the channel.
+/// @param ptr [in] pointer to the memory of the heap of the pool.
+/// @param size [in] size of the message.
+/// @param timeout_ms [in] how long to wait if the channel is full
+///        (0 - do not wait, a negative value - wait forever).
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_TIMEOUT if the channel is still full,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if waiting is not supported
+///         on this platform (only Linux is supported now)
+///         or appropriate error code on failure.
+umf_result_t umfIPCChannelSend(umf_ipc_channel_handle_t channel, void *ptr,
+                               size_t size, int timeout_ms);
+
+///
+/// @brief Receive a message from the channel.
+///        Only one process (thread) can receive messages from the channel.
+/// @param channel [in] handle of the channel.
+/// @param ptr [out] pointer to the memory of the message.
+/// @param size [out] size of the message.
+/// @param timeout_ms [in] how long to wait if the channel is empty
+///        (0 - do not wait, a negative value - wait forever).
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_TIMEOUT if the channel is still empty,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if waiting is not supported
+///         on this platform (only Linux is supported now)
+///         or appropriate error code on failure.
+umf_result_t umfIPCChannelReceive(umf_ipc_channel_handle_t channel, void **ptr,
+                                  size_t *size, int timeout_ms);
+
+///
+/// @brief Close the channel handle. The ring of the channel is freed
+///        when the handle returned by umfIPCChannelCreate() is closed.
+/// @param channel [in] handle of the channel.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfIPCChannelClose(umf_ipc_channel_handle_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_IPC_CHANNEL_H */
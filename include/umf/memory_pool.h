@@ -132,6 +132,17 @@ umf_result_t umfPoolFree(umf_memory_pool_handle_t hPool, void *ptr);
 ///
 umf_result_t umfFree(void *ptr);
 
+///
+/// @brief Makes stores to the given range of a UMF allocation durable
+///        (see umfMemoryProviderPersist()).
+/// @param ptr pointer to memory allocated from a UMF pool
+/// @param size size of the range to persist
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if ptr does not belong to a UMF pool.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the memory of the pool is not persistent.
+///
+umf_result_t umfPersist(const void *ptr, size_t size);
+
 ///
 /// @brief Retrieve \p umf_result_t representing the error of the last failed allocation
 ///        operation in this thread (malloc, calloc, realloc, aligned_malloc).
@@ -152,6 +163,18 @@ umf_result_t umfFree(void *ptr);
 ///
 umf_result_t umfPoolGetLastAllocationError(umf_memory_pool_handle_t hPool);
 
+///
+/// @brief Frees all memory allocated from the specified \p hPool at once.
+///        All pointers previously returned by \p hPool become invalid.
+///        The caller must make sure that no other thread uses \p hPool
+///        during the reset.
+/// @param hPool specified memory pool handle
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the pool does not support reset
+///         or other appropriate error code on failure.
+///
+umf_result_t umfPoolReset(umf_memory_pool_handle_t hPool);
+
 ///
 /// @brief Retrieve memory pool associated with a given ptr. Only memory allocated
 ///        with the usage of a memory provider is being tracked.
@@ -170,6 +193,23 @@ umf_memory_pool_handle_t umfPoolByPtr(const void *ptr);
 umf_result_t umfPoolGetMemoryProvider(umf_memory_pool_handle_t hPool,
                                       umf_memory_provider_handle_t *hProvider);
 
+///
+/// @brief Migrate physical pages backing a live allocation of the given pool
+///        to the memory target \p target. The virtual address range stays valid
+///        and its content is preserved. The range is extended to whole pages
+///        of the underlying memory provider, so other allocations sharing
+///        these pages are migrated too.
+/// @param hPool specified memory pool
+/// @param ptr pointer to memory allocated from \p hPool
+/// @param size size of the range to migrate
+/// @param target memory target the pages should be moved to
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if ptr does not belong to \p hPool.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the memory provider does not support migration.
+///
+umf_result_t umfPoolMigrate(umf_memory_pool_handle_t hPool, void *ptr,
+                            size_t size, umf_const_memtarget_handle_t target);
+
 #ifdef __cplusplus
 }
 #endif
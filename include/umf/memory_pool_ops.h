@@ -25,6 +25,7 @@ extern "C" {
 typedef struct umf_memory_pool_ops_t {
     /// Version of the ops structure.
     /// Should be initialized using UMF_VERSION_CURRENT.
+    /// umfPoolCreate() rejects ops of any other version.
     uint32_t version;
 
     ///
@@ -120,6 +121,16 @@ typedef struct umf_memory_pool_ops_t {
     ///         The value is undefined if the previous allocation was successful.
     ///
     umf_result_t (*get_last_allocation_error)(void *pool);
+
+    ///
+    /// @brief Frees all memory allocated from the \p pool at once, returning
+    ///        the pool to the state it had right after initialization.
+    ///        This operation is optional and can be set to NULL
+    ///        if the pool does not support it.
+    /// @param pool pointer to the memory pool
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///
+    umf_result_t (*reset)(void *pool);
 } umf_memory_pool_ops_t;
 
 #ifdef __cplusplus
@@ -12,6 +12,7 @@
 
 #include <umf/base.h>
 #include <umf/memory_provider_ops.h>
+#include <umf/memtarget.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,6 +68,24 @@ void umfMemoryProviderDestroy(umf_memory_provider_handle_t hProvider);
 umf_result_t umfMemoryProviderAlloc(umf_memory_provider_handle_t hProvider,
                                     size_t size, size_t alignment, void **ptr);
 
+///
+/// @brief Allocates \p size bytes from memory \p hProvider like
+///        umfMemoryProviderAlloc() and reports whether the allocated memory
+///        is known to be zeroed (e.g. it comes straight from a fresh anonymous
+///        mapping), so that callers can skip zeroing it. Providers that do
+///        not implement this operation always report false.
+/// @param hProvider handle to the memory provider
+/// @param size number of bytes to allocate
+/// @param alignment alignment of the allocation in bytes, it has to be a multiple or a divider of the minimum page size
+/// @param ptr [out] pointer to the allocated memory
+/// @param zeroed [out] true if the allocated memory is zeroed
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+///
+umf_result_t
+umfMemoryProviderAllocZeroInfo(umf_memory_provider_handle_t hProvider,
+                               size_t size, size_t alignment, void **ptr,
+                               bool *zeroed);
+
 ///
 /// @brief Frees the memory space pointed by \p ptr from the memory \p hProvider
 /// @param hProvider handle to the memory provider
@@ -154,6 +173,56 @@ umf_result_t umfMemoryProviderPurgeLazy(umf_memory_provider_handle_t hProvider,
 umf_result_t umfMemoryProviderPurgeForce(umf_memory_provider_handle_t hProvider,
                                          void *ptr, size_t size);
 
+///
+/// @brief Migrates physical pages backing the given virtual memory range to the memory target
+///        \p target without changing the virtual address of the range.
+/// @param hProvider handle to the memory provider
+/// @param ptr beginning of the virtual memory range
+/// @param size size of the virtual memory range
+/// @param target memory target the pages should be moved to
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr is not page-aligned.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider
+///         or by the type of the \p target.
+///
+umf_result_t umfMemoryProviderMigrate(umf_memory_provider_handle_t hProvider,
+                                      void *ptr, size_t size,
+                                      umf_const_memtarget_handle_t target);
+
+///
+/// @brief Changes the size of an allocation without copying its content.
+///        The allocation may be moved to a different virtual address.
+///        The content is preserved up to the lesser of the old and the new size.
+/// @param hProvider handle to the memory provider
+/// @param ptr pointer to the beginning of the allocation
+/// @param oldSize current size of the allocation
+/// @param newSize requested size of the allocation
+/// @param newPtr [out] pointer to the resized allocation
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the allocation cannot be resized
+///         this way by the provider; the original allocation is left untouched.
+///
+umf_result_t umfMemoryProviderResize(umf_memory_provider_handle_t hProvider,
+                                     void *ptr, size_t oldSize, size_t newSize,
+                                     void **newPtr);
+
+///
+/// @brief Makes stores to the given virtual memory range durable. The provider
+///        picks the fastest correct primitive for the range: CPU cache flushes
+///        (CLWB, CLFLUSHOPT or CLFLUSH followed by SFENCE) for devdax and
+///        MAP_SYNC file mappings, msync for other file mappings.
+/// @param hProvider handle to the memory provider
+/// @param ptr beginning of the virtual memory range
+/// @param size size of the virtual memory range
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+///         UMF_RESULT_ERROR_INVALID_ARGUMENT if the range is not allocated
+///         from \p hProvider.
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if the memory of this provider
+///         is not persistent.
+///
+umf_result_t umfMemoryProviderPersist(umf_memory_provider_handle_t hProvider,
+                                      const void *ptr, size_t size);
+
 ///
 /// @brief Retrieve the size of opaque data structure required to store IPC data.
 /// \param hProvider [in] handle to the memory provider.
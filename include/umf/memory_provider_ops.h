@@ -10,7 +10,10 @@
 #ifndef UMF_MEMORY_PROVIDER_OPS_H
 #define UMF_MEMORY_PROVIDER_OPS_H 1
 
+#include <stdbool.h>
+
 #include <umf/base.h>
+#include <umf/memtarget.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -87,6 +90,70 @@ typedef struct umf_memory_provider_ext_ops_t {
     umf_result_t (*allocation_split)(void *hProvider, void *ptr,
                                      size_t totalSize, size_t firstSize);
 
+    ///
+    /// @brief Migrates physical pages backing the given virtual memory range
+    ///        to the memory target \p target. The virtual address of the range
+    ///        does not change and the content of the memory is preserved.
+    ///        Later allocations of the provider are not affected.
+    /// @param provider pointer to the memory provider
+    /// @param ptr beginning of the virtual memory range
+    /// @param size size of the virtual memory range
+    /// @param target memory target the pages should be moved to
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_INVALID_ALIGNMENT if ptr is not page-aligned.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if operation is not supported by this provider.
+    ///
+    umf_result_t (*migrate)(void *provider, void *ptr, size_t size,
+                            umf_const_memtarget_handle_t target);
+
+    ///
+    /// @brief Changes the size of an allocation without copying its content
+    ///        (e.g. by remapping its pages). The allocation may be moved
+    ///        to a different virtual address. The content is preserved up to
+    ///        the lesser of the old and the new size. On failure the original
+    ///        allocation is left untouched.
+    /// @param provider pointer to the memory provider
+    /// @param ptr pointer to the beginning of the allocation
+    /// @param oldSize current size of the allocation
+    /// @param newSize requested size of the allocation
+    /// @param newPtr [out] pointer to the resized allocation
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if this allocation cannot be resized
+    ///         without copying its content by this provider.
+    ///
+    umf_result_t (*resize)(void *provider, void *ptr, size_t oldSize,
+                           size_t newSize, void **newPtr);
+
+    ///
+    /// @brief Makes stores to the given virtual memory range durable
+    ///        using the fastest primitive correct for the backing memory:
+    ///        CPU cache flushes for synchronous DAX mappings or msync
+    ///        for regular file mappings.
+    /// @param provider pointer to the memory provider
+    /// @param ptr beginning of the virtual memory range
+    /// @param size size of the virtual memory range
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///         UMF_RESULT_ERROR_NOT_SUPPORTED if the memory of this provider
+    ///         is not persistent.
+    ///
+    umf_result_t (*persist)(void *provider, const void *ptr, size_t size);
+
+    ///
+    /// @brief Allocates memory like alloc() and reports whether the allocated
+    ///        memory is known to contain only zeros (e.g. fresh anonymous
+    ///        pages), so that it does not have to be zeroed by the caller.
+    /// @param provider pointer to the memory provider
+    /// @param size number of bytes to allocate
+    /// @param alignment alignment of the allocation in bytes
+    /// @param ptr [out] pointer to the allocated memory
+    /// @param zeroed [out] true if the allocated memory is zeroed,
+    ///        false if its content is unknown
+    /// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+    ///
+    umf_result_t (*alloc_zero_info)(void *provider, size_t size,
+                                    size_t alignment, void **ptr,
+                                    bool *zeroed);
+
 } umf_memory_provider_ext_ops_t;
 
 ///
@@ -153,6 +220,7 @@ typedef struct umf_memory_provider_ipc_ops_t {
 typedef struct umf_memory_provider_ops_t {
     /// Version of the ops structure.
     /// Should be initialized using UMF_VERSION_CURRENT.
+    /// umfMemoryProviderCreate() rejects ops of any other version.
     uint32_t version;
 
     ///
@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_ARENA_MEMORY_POOL_H
+#define UMF_ARENA_MEMORY_POOL_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <umf/base.h>
+#include <umf/memory_pool.h>
+#include <umf/memory_provider.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Default size of the chunks the arena pool allocates
+///        from the memory provider (1 MB).
+#define UMF_ARENA_POOL_CHUNK_SIZE_DEFAULT (1024 * 1024)
+
+/// @brief Configuration of the arena pool.
+/// The arena pool bump-allocates memory from chunks of the memory provider.
+/// Every thread allocates from its own chunk, umfPoolFree() does nothing
+/// and all allocations are freed at once by umfPoolReset(),
+/// which rewinds all chunks, so they are reused by the next allocations.
+typedef struct umf_arena_pool_params_t {
+    /// Size of the chunks allocated from the memory provider. It is rounded
+    /// up to a multiple of the page size recommended by the memory provider.
+    /// Allocations larger than a chunk get a chunk of their own,
+    /// which is returned to the memory provider by umfPoolReset().
+    /// 0 means UMF_ARENA_POOL_CHUNK_SIZE_DEFAULT.
+    size_t chunk_size;
+    /// Set to true to purge (umfMemoryProviderPurgeLazy()) the physical
+    /// pages of all chunks on umfPoolReset().
+    bool purge_on_reset;
+} umf_arena_pool_params_t;
+
+/// @brief Create default params for the arena pool
+static inline umf_arena_pool_params_t umfArenaPoolParamsDefault(void) {
+    umf_arena_pool_params_t params = {
+        UMF_ARENA_POOL_CHUNK_SIZE_DEFAULT, /* chunk_size */
+        false,                             /* purge_on_reset */
+    };
+
+    return params;
+}
+
+umf_memory_pool_ops_t *umfArenaPoolOps(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_ARENA_MEMORY_POOL_H */
@@ -21,6 +21,7 @@ using namespace std;
 #include <limits.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <umf/memory_pool.h>
 #include <umf/memory_pool_ops.h>
 #include <jemalloc/jemalloc.h>
@@ -33,8 +34,6 @@ using namespace std;
 
 #include <stdbool.h>
 
-#include <pthread.h>
-
 typedef struct umf_memory_pool_t {
     void *pool_priv;
     umf_memory_pool_ops_t ops;
@@ -45,129 +44,196 @@ typedef struct umf_memory_pool_t {
 } umf_memory_pool_t;
 
 
-#define MAX_JEMALLOC_THREADS 200
 #define je_mallctl mallctl
 
+/// @brief Arena selection modes of Jemalloc Pool
+typedef enum umf_jemalloc_pool_arena_mode_t {
+    /// Each thread sticks to one arena of the pool (default).
+    UMF_JEMALLOC_POOL_ARENA_MODE_THREAD = 0,
+    /// Threads use the arena of the CPU they are currently running on.
+    UMF_JEMALLOC_POOL_ARENA_MODE_CPU,
+    /// Arenas are split into groups, one per NUMA node, and threads use
+    /// the arena of their CPU within the group of their NUMA node.
+    UMF_JEMALLOC_POOL_ARENA_MODE_NUMA,
+} umf_jemalloc_pool_arena_mode_t;
+
+/// @brief Keep the jemalloc default decay time
+/// (see opt.dirty_decay_ms and opt.muzzy_decay_ms in jemalloc docs).
+#define UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT (-2)
+
 /// @brief Configuration of Jemalloc Pool
 typedef struct umf_jemalloc_pool_params_t {
     /// Set to true if umfMemoryProviderFree() should never be called.
     bool disable_provider_free;
+    /// Number of jemalloc arenas of the pool, 0 means the number of CPUs.
+    unsigned num_arenas;
+    /// Arena selection mode.
+    umf_jemalloc_pool_arena_mode_t arena_mode;
+    /// Time (in ms) after which unused dirty pages are purged
+    /// with umfMemoryProviderPurgeLazy() (or umfMemoryProviderPurgeForce()
+    /// if muzzy_decay_ms is 0). 0 purges them immediately, -1 disables
+    /// purging, UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT keeps the jemalloc default.
+    int64_t dirty_decay_ms;
+    /// Time (in ms) after which lazily purged (muzzy) pages are purged
+    /// with umfMemoryProviderPurgeForce(). The values are as above.
+    int64_t muzzy_decay_ms;
 } umf_jemalloc_pool_params_t;
 
+/// @brief Create default params for Jemalloc Pool
+static inline umf_jemalloc_pool_params_t umfJemallocPoolParamsDefault(void) {
+    umf_jemalloc_pool_params_t params = {
+        false,                               /* disable_provider_free */
+        0,                                   /* num_arenas */
+        UMF_JEMALLOC_POOL_ARENA_MODE_THREAD, /* arena_mode */
+        UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT,  /* dirty_decay_ms */
+        UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT,  /* muzzy_decay_ms */
+    };
+
+    return params;
+}
+
 umf_memory_pool_ops_t *umfJemallocPoolOps(void);
 
+/// @brief Purge all unused pages of the pool back to its memory provider,
+///        regardless of the decay settings. Objects cached by the calling
+///        thread are flushed first; caches of other threads are not touched.
+/// @param hPool handle to the jemalloc pool
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfJemallocPoolPurge(umf_memory_pool_handle_t hPool);
+
+/// @brief Statistics of Jemalloc Pool, aggregated over all arenas of the pool.
+///        Objects cached in the tcaches of threads are counted as allocated.
+typedef struct umf_jemalloc_pool_stats_t {
+    /// Number of arenas of the pool used so far
+    /// (arenas are created on their first use).
+    unsigned num_arenas;
+    /// Number of bytes allocated by the application.
+    size_t allocated;
+    /// Number of bytes in active pages (pages with allocated objects).
+    size_t active;
+    /// Number of bytes in pages obtained from the memory provider
+    /// that are backed by physical memory.
+    size_t resident;
+    /// Number of bytes obtained from the memory provider.
+    size_t mapped;
+    /// Number of bytes in dirty pages (unused, not purged yet).
+    size_t dirty;
+    /// Number of bytes in muzzy pages (unused, purged lazily).
+    size_t muzzy;
+    /// Total number of allocations.
+    uint64_t nmalloc;
+    /// Total number of deallocations.
+    uint64_t ndalloc;
+} umf_jemalloc_pool_stats_t;
+
+/// @brief Statistics of a single size class of Jemalloc Pool.
+typedef struct umf_jemalloc_pool_size_class_stats_t {
+    /// Size of the objects of the class in bytes.
+    size_t size;
+    /// Total number of allocations.
+    uint64_t nmalloc;
+    /// Total number of deallocations.
+    uint64_t ndalloc;
+    /// Current number of allocated objects.
+    size_t curobjs;
+} umf_jemalloc_pool_size_class_stats_t;
+
+/// @brief Get the statistics of the pool. The statistics of all jemalloc
+///        arenas are refreshed on each call, so it should not be called
+///        more often than every few milliseconds.
+/// @param hPool handle to the jemalloc pool
+/// @param stats [out] statistics of the pool
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if jemalloc was built without
+///         statistics or appropriate error code on failure.
+umf_result_t umfJemallocPoolGetStats(umf_memory_pool_handle_t hPool,
+                                     umf_jemalloc_pool_stats_t *stats);
+
+/// @brief Get the per-size-class statistics of the pool, ordered by size.
+///        The statistics are refreshed as in umfJemallocPoolGetStats().
+/// @param hPool handle to the jemalloc pool
+/// @param stats [out] array of statistics, or NULL to query the number
+///        of size classes
+/// @param count [in,out] capacity of the stats array on input, number of
+///        size classes (stored in the array) on output
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if jemalloc was built without
+///         statistics or appropriate error code on failure.
+umf_result_t
+umfJemallocPoolGetSizeClassStats(umf_memory_pool_handle_t hPool,
+                                 umf_jemalloc_pool_size_class_stats_t *stats,
+                                 size_t *count);
+
+/// @brief Dump the statistics of the pool in the JSON format. Only the size
+///        classes that were ever allocated from are included.
+/// @param hPool handle to the jemalloc pool
+/// @param write_cb callback called with consecutive parts of the output
+/// @param arg argument passed to write_cb
+/// @return UMF_RESULT_SUCCESS on success,
+///         UMF_RESULT_ERROR_NOT_SUPPORTED if jemalloc was built without
+///         statistics or appropriate error code on failure.
+umf_result_t umfJemallocPoolDumpStats(umf_memory_pool_handle_t hPool,
+                                      void (*write_cb)(void *arg,
+                                                       const char *str),
+                                      void *arg);
+
 
-extern __thread unsigned arena_spin;
 extern __thread unsigned thread_id;
 extern atomic_int thread_count;
 inline unsigned __attribute__((always_inline)) tid(){
 	if(thread_id==UINT_MAX){
 		thread_id = atomic_fetch_add_explicit(&thread_count, 1, memory_order_relaxed);
-		arena_spin = thread_id;
 	}
 	return thread_id;
 }
 
-// typedef struct jemalloc_memory_pool_t {
-//     umf_memory_provider_handle_t provider;
-//     unsigned arena_index; // base index of jemalloc arena
-// 	unsigned num_arenas; // range of associated indices
-// 	unsigned tcaches[MAX_JEMALLOC_THREADS];
-//     // set to true if umfMemoryProviderFree() should never be called
-//     bool disable_provider_free;
-// } jemalloc_memory_pool_t;
+// marks an arena of a pool that has not been created yet
+#define JEMALLOC_ARENA_NONE UINT_MAX
+
+// per-thread tcache of a pool (defined in pool_jemalloc.c)
+struct jemalloc_tcache_slot_t;
 
 typedef struct jemalloc_memory_pool_t {
     umf_memory_provider_handle_t provider;
-    unsigned arena_index; // base index of jemalloc arena
-	unsigned num_arenas; // range of associated indices
-	unsigned *tcaches;
-    // unsigned tcaches[MAX_JEMALLOC_THREADS];
-    size_t tcaches_size;
-    pthread_rwlock_t tcaches_resize_lk;
+    unsigned num_arenas;
+    // jemalloc indices of the arenas of the pool,
+    // JEMALLOC_ARENA_NONE until an arena is used for the first time
+    unsigned *arenas;
+    umf_jemalloc_pool_arena_mode_t arena_mode;
+    // one group of arenas per NUMA node (UMF_JEMALLOC_POOL_ARENA_MODE_NUMA)
+    unsigned num_arena_groups;
+    unsigned arenas_per_group;
+    unsigned pool_id; // index of the pool's tcache in per-thread tables
+    // list of tcaches created for this pool
+    struct jemalloc_tcache_slot_t *tcaches;
     // set to true if umfMemoryProviderFree() should never be called
     bool disable_provider_free;
+    // decay times of the arenas (see umf_jemalloc_pool_params_t)
+    int64_t dirty_decay_ms;
+    int64_t muzzy_decay_ms;
+    // set to 1 once the provider returned UMF_RESULT_ERROR_NOT_SUPPORTED
+    // from umfMemoryProviderAllocationSplit()/Merge(), so the extent hooks
+    // do not have to call the provider again
+    uint32_t split_not_supported;
+    uint32_t merge_not_supported;
 } jemalloc_memory_pool_t;
 
-
-inline  __attribute__((always_inline))
-unsigned set_tcache(jemalloc_memory_pool_t* je_pool, unsigned tid, unsigned tcache){
-    assert(je_pool);
-    access_tcaches:
-    pthread_rwlock_rdlock(&je_pool->tcaches_resize_lk);
-    if(tid < je_pool->tcaches_size){
-        // int size = je_pool->tcaches_size;
-        je_pool->tcaches[tid] = tcache;
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-    } else {
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-        pthread_rwlock_wrlock(&je_pool->tcaches_resize_lk);
-        if (tid>= je_pool->tcaches_size){
-            //resizing tcaches
-            unsigned *temp_tcaches = (unsigned *)realloc(je_pool->tcaches, (tid+1) * sizeof(unsigned));
-            if (!temp_tcaches) {
-                pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-                exit(EXIT_FAILURE);
-            }
-            je_pool->tcaches = temp_tcaches;
-            je_pool->tcaches_size = tid+1;
-        }
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-        goto access_tcaches;
-    }
-}
-
-inline  __attribute__((always_inline))
-unsigned get_tcache(jemalloc_memory_pool_t* je_pool, unsigned tid ){
-    assert(je_pool);
-    access_tcaches:
-    pthread_rwlock_rdlock(&je_pool->tcaches_resize_lk);
-    if(tid < je_pool->tcaches_size){
-        unsigned tcache_tid = je_pool->tcaches[tid];
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-        return tcache_tid;
-    } else {
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-        pthread_rwlock_wrlock(&je_pool->tcaches_resize_lk);
-        if (tid>= je_pool->tcaches_size){
-            //resising tcaches
-            unsigned *temp_tcaches = (unsigned *)realloc(je_pool->tcaches, (tid+1) * sizeof(unsigned));
-            if (!temp_tcaches) {
-                pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-                exit(EXIT_FAILURE);
-            }
-            
-            je_pool->tcaches = temp_tcaches;
-            je_pool->tcaches_size = tid+1;
-            pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-            unsigned tcache;
-            size_t sz = sizeof(unsigned);
-            je_mallctl("tcache.create",&tcache,&sz,NULL,0);
-            // pool->tcaches[i] = tcache;
-            set_tcache(je_pool,tid,tcache);
-        }
-        else{
-        pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-        }
-        goto access_tcaches;
-    }
-}
-
+// tcache and arena of the pool used by the current thread
+// (created on the first use)
+unsigned jemalloc_pool_get_tcache(jemalloc_memory_pool_t *je_pool);
+unsigned jemalloc_pool_get_arena(jemalloc_memory_pool_t *je_pool);
 
 inline void* __attribute__((always_inline))
 umfFastJemallocMalloc(umf_memory_pool_handle_t hPool, size_t size){
 	assert(hPool!=NULL);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)((void*)hPool->pool_priv);
 	assert(je_pool);
-	/*
-	cycle through arenas associated with our pool
-	use tcache associated with this ppol
-	*/
-	arena_spin++;
-	if(arena_spin>=je_pool->num_arenas){arena_spin=0;}
-	int arena = je_pool->arena_index + arena_spin;
-    // uint64_t flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(je_pool->tcaches[tid()]);
-    uint64_t flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool,tid()));
+	// use the arena and the tcache of this thread associated with our pool
+	unsigned arena = jemalloc_pool_get_arena(je_pool);
+    if (arena == JEMALLOC_ARENA_NONE) {
+        return NULL;
+    }
+    uint64_t flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(jemalloc_pool_get_tcache(je_pool));
     void *ptr = mallocx(size, flags);
     if (ptr == NULL) {
         //TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -185,10 +251,8 @@ umf_result_t umfFastJemallocFree(umf_memory_pool_handle_t hPool, void* ptr){
 
     if (ptr != NULL) {
         //VALGRIND_DO_MEMPOOL_FREE(hPool, ptr);
-        // dallocx(ptr, MALLOCX_TCACHE(je_pool->tcaches[tid()]));
         
-        dallocx(ptr, MALLOCX_TCACHE(get_tcache(je_pool,tid())));
-    //    free(je_pool->tcaches); 
+        dallocx(ptr, MALLOCX_TCACHE(jemalloc_pool_get_tcache(je_pool)));
     }
 
     return UMF_RESULT_SUCCESS;
@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_OBJECT_MEMORY_POOL_H
+#define UMF_OBJECT_MEMORY_POOL_H 1
+
+#include <stddef.h>
+
+#include <umf/base.h>
+#include <umf/memory_pool.h>
+#include <umf/memory_provider.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Default (and minimum) alignment of the objects
+///        of the object pool (16 bytes).
+#define UMF_OBJECT_POOL_ALIGNMENT_DEFAULT 16
+
+/// @brief Configuration of the object pool.
+/// The object pool allocates objects of a single size. The objects are
+/// carved out of slabs allocated from the memory provider, which have to
+/// be accessible from the host, because the free lists of the pool
+/// are kept in the free objects. Free objects are kept in lock-free lists
+/// (one per CPU), so allocating and freeing an object takes O(1) time
+/// and the pool does not look up the memory tracker on free.
+typedef struct umf_object_pool_params_t {
+    /// Size of the objects. Allocations larger than the object size fail.
+    size_t object_size;
+    /// Alignment of the objects. It has to be a power of 2.
+    /// It is raised to UMF_OBJECT_POOL_ALIGNMENT_DEFAULT if it is smaller.
+    size_t alignment;
+    /// Size of the slabs allocated from the memory provider. It has to be
+    /// a power of 2 and it is raised to the page size recommended by
+    /// the memory provider if it is smaller. 0 means the smallest size
+    /// (at least 64 KB) that holds at least 16 objects.
+    size_t slab_size;
+} umf_object_pool_params_t;
+
+/// @brief Create default params for the object pool
+/// @param object_size size of the objects
+static inline umf_object_pool_params_t
+umfObjectPoolParamsDefault(size_t object_size) {
+    umf_object_pool_params_t params = {
+        object_size,                       /* object_size */
+        UMF_OBJECT_POOL_ALIGNMENT_DEFAULT, /* alignment */
+        0,                                 /* slab_size */
+    };
+
+    return params;
+}
+
+umf_memory_pool_ops_t *umfObjectPoolOps(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_OBJECT_MEMORY_POOL_H */
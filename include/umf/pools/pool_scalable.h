@@ -14,9 +14,43 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
 
+/// @brief Default granularity of the allocations of Scalable Pool
+///        from the memory provider (2 MB).
+#define UMF_SCALABLE_POOL_GRANULARITY_DEFAULT (2 * 1024 * 1024)
+
+/// @brief Configuration of Scalable Pool
+typedef struct umf_scalable_pool_params_t {
+    /// Minimum size (and the multiple of the sizes) of the allocations
+    /// from the memory provider. It has to be a power of 2, e.g. the size
+    /// of a huge page. 0 means UMF_SCALABLE_POOL_GRANULARITY_DEFAULT.
+    size_t granularity;
+    /// Set to true to keep all memory obtained from the memory provider
+    /// until the pool is destroyed, instead of returning it on the fly.
+    bool keep_all_memory;
+    /// Size of the fixed pool. If it is greater than 0, the whole memory
+    /// of the pool (at least this size) is allocated from the memory provider
+    /// once, when the pool is created, and the pool never grows.
+    /// 0 means the pool is not fixed.
+    size_t fixed_pool_size;
+} umf_scalable_pool_params_t;
+
+/// @brief Create default params for Scalable Pool
+static inline umf_scalable_pool_params_t umfScalablePoolParamsDefault(void) {
+    umf_scalable_pool_params_t params = {
+        UMF_SCALABLE_POOL_GRANULARITY_DEFAULT, /* granularity */
+        false,                                 /* keep_all_memory */
+        0,                                     /* fixed_pool_size */
+    };
+
+    return params;
+}
+
 umf_memory_pool_ops_t *umfScalablePoolOps(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#ifndef UMF_SHARED_MEMORY_POOL_H
+#define UMF_SHARED_MEMORY_POOL_H 1
+
+#include <umf/base.h>
+#include <umf/ipc.h>
+#include <umf/memory_pool.h>
+#include <umf/memory_provider.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Configuration of the shared memory pool.
+/// The heap of the pool (together with all its metadata) is a single
+/// allocation of the memory provider, so several processes can allocate
+/// and free memory of the same heap concurrently. The memory provider
+/// has to support IPC, e.g. the OS memory provider with
+/// the UMF_MEM_MAP_SHARED visibility or the file memory provider.
+/// If a process using the heap dies, the other processes can keep using
+/// the heap, but the memory allocated by the dead process is never returned
+/// to the heap (and on Linux, if the process died in the middle
+/// of an allocation or a free, up to a few slabs of the heap are leaked too).
+/// On Windows and macOS, the death of a process in the middle of
+/// an allocation or a free can block the other processes.
+typedef struct umf_shared_pool_params_t {
+    /// size of the heap allocated from the memory provider
+    /// (used only when a new heap is created)
+    size_t heap_size;
+    /// (optional) IPC handle of the heap created by another pool
+    /// (returned by umfSharedPoolGetIPCHandle()), NULL means that
+    /// a new heap is created
+    umf_ipc_handle_t heap_ipc_handle;
+} umf_shared_pool_params_t;
+
+umf_memory_pool_ops_t *umfSharedPoolOps(void);
+
+/// @brief Create default params for the shared memory pool
+static inline umf_shared_pool_params_t umfSharedPoolParamsDefault(void) {
+    umf_shared_pool_params_t params = {
+        (size_t)1 << 30, /* heap_size */
+        NULL             /* heap_ipc_handle */
+    };
+
+    return params;
+}
+
+///
+/// @brief Get the IPC handle of the heap of the shared memory pool,
+///        which can be used to open the same heap in another process
+///        (see umf_shared_pool_params_t::heap_ipc_handle).
+///        The handle has to be released with umfPutIPCHandle().
+/// @param hPool [in] handle of the shared memory pool.
+/// @param ipcHandle [out] returned IPC handle of the heap.
+/// @param size [out] size of IPC handle in bytes.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedPoolGetIPCHandle(umf_memory_pool_handle_t hPool,
+                                       umf_ipc_handle_t *ipcHandle,
+                                       size_t *size);
+
+///
+/// @brief Get the offset of the pointer in the heap of the shared memory
+///        pool. The offset is the same in all processes that opened the heap.
+/// @param hPool [in] handle of the shared memory pool.
+/// @param ptr [in] pointer to the memory of the heap.
+/// @param offset [out] offset of the pointer in the heap.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedPoolGetOffset(umf_memory_pool_handle_t hPool,
+                                    const void *ptr, uint64_t *offset);
+
+///
+/// @brief Get the pointer to the memory at the offset in the heap
+///        of the shared memory pool (in the current process).
+/// @param hPool [in] handle of the shared memory pool.
+/// @param offset [in] offset in the heap.
+/// @param ptr [out] pointer to the memory of the heap.
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure.
+umf_result_t umfSharedPoolGetPtr(umf_memory_pool_handle_t hPool,
+                                 uint64_t offset, void **ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UMF_SHARED_MEMORY_POOL_H */
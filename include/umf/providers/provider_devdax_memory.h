@@ -8,6 +8,8 @@
 #ifndef UMF_DEVDAX_MEMORY_PROVIDER_H
 #define UMF_DEVDAX_MEMORY_PROVIDER_H
 
+#include <stdbool.h>
+
 #include <umf/providers/provider_os_memory.h>
 
 #ifdef __cplusplus
@@ -26,6 +28,10 @@ typedef struct umf_devdax_memory_provider_params_t {
     size_t size;
     /// combination of 'umf_mem_protection_flags_t' flags
     unsigned protection;
+    /// emulate the device DAX with a regular file created (or resized)
+    /// at the given path or with an anonymous memfd if the path is NULL,
+    /// so that the provider can be tested without a device DAX
+    bool emulation;
 } umf_devdax_memory_provider_params_t;
 
 /// @brief Devdax Memory Provider operation results
@@ -35,6 +41,7 @@ typedef enum umf_devdax_memory_provider_native_error {
     UMF_DEVDAX_RESULT_ERROR_ADDRESS_NOT_ALIGNED, ///< Allocated address is not aligned
     UMF_DEVDAX_RESULT_ERROR_FREE_FAILED,         ///< Memory deallocation failed
     UMF_DEVDAX_RESULT_ERROR_PURGE_FORCE_FAILED, ///< Force purging failed
+    UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED,     ///< Persisting memory failed
 } umf_devdax_memory_provider_native_error_t;
 
 umf_memory_provider_ops_t *umfDevDaxMemoryProviderOps(void);
@@ -46,6 +53,7 @@ umfDevDaxMemoryProviderParamsDefault(char *path, size_t size) {
         path, /* path of the device DAX */
         size, /* size of the device DAX in bytes */
         UMF_PROTECTION_READ | UMF_PROTECTION_WRITE, /* protection */
+        false, /* emulation */
     };
 
     return params;
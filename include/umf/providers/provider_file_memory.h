@@ -8,6 +8,8 @@
 #ifndef UMF_FILE_MEMORY_PROVIDER_H
 #define UMF_FILE_MEMORY_PROVIDER_H
 
+#include <stdbool.h>
+
 #include <umf/providers/provider_os_memory.h>
 
 #ifdef __cplusplus
@@ -18,6 +20,20 @@ extern "C" {
 #define UMF_FILE_RESULTS_START_FROM 3000
 /// @endcond
 
+/// @brief Default maximum number of live allocations
+///        of a persistent heap (see 'persistent_max_allocs')
+#define UMF_FILE_PERSISTENT_MAX_ALLOCS_DEFAULT (16 * 1024)
+
+/// @brief Prefetching of memory allocated by the file memory provider
+typedef enum umf_file_prefetch_flags_t {
+    UMF_FILE_PREFETCH_NONE = 0, ///< no prefetching
+    /// read ahead the allocated part of the file (MADV_WILLNEED)
+    UMF_FILE_PREFETCH_WILLNEED = (1 << 0),
+    /// prefault page tables of the allocated memory for reading,
+    /// it requires the UMF_PROTECTION_READ protection
+    UMF_FILE_PREFETCH_POPULATE = (1 << 1),
+} umf_file_prefetch_flags_t;
+
 /// @brief Memory provider settings struct
 typedef struct umf_file_memory_provider_params_t {
     /// a path to the file (of maximum length PATH_MAX characters)
@@ -26,6 +42,30 @@ typedef struct umf_file_memory_provider_params_t {
     unsigned protection;
     /// memory visibility mode
     umf_memory_visibility_t visibility;
+    /// minimum size of a single memory mapping of the file - a multiple
+    /// of the page size (0 means the page size). Bigger mappings reduce
+    /// the number of mappings (VMAs) created for many medium allocations.
+    size_t mmap_granularity;
+    /// number of bytes the file is extended by (with fallocate())
+    /// ahead of demand every time it has to grow (0 means the file grows
+    /// only on demand)
+    size_t fallocate_ahead;
+    /// combination of 'umf_file_prefetch_flags_t' flags applied to every
+    /// allocation (useful for read-mostly data)
+    unsigned prefetch;
+    /// keep a persistent heap in the file: the allocations and the root
+    /// object survive destroying the provider and are recovered when
+    /// the provider is created again with the same file. It requires
+    /// the UMF_MEM_MAP_SHARED or UMF_MEM_MAP_SYNC visibility mode.
+    /// The heap can be opened by one provider at a time (the file is locked
+    /// with flock(); creating the second provider fails).
+    bool persistent;
+    /// maximum number of live allocations of a new persistent heap
+    /// (0 means UMF_FILE_PERSISTENT_MAX_ALLOCS_DEFAULT). The log of
+    /// the allocations is kept in the header of the file, which takes
+    /// 64 bytes per allocation. When the limit is reached, allocations fail.
+    /// An existing heap keeps the limit it was created with.
+    size_t persistent_max_allocs;
 } umf_file_memory_provider_params_t;
 
 /// @brief File Memory Provider operation results
@@ -34,10 +74,32 @@ typedef enum umf_file_memory_provider_native_error {
     UMF_FILE_RESULT_ERROR_ALLOC_FAILED,       ///< Memory allocation failed
     UMF_FILE_RESULT_ERROR_FREE_FAILED,        ///< Memory deallocation failed
     UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED, ///< Force purging failed
+    UMF_FILE_RESULT_ERROR_PERSIST_FAILED,     ///< Persisting memory failed
 } umf_file_memory_provider_native_error_t;
 
 umf_memory_provider_ops_t *umfFileMemoryProviderOps(void);
 
+/// @brief Set the root object of the persistent heap of the file memory
+///        provider. The root object is the entry point to the data stored
+///        in the persistent heap after the provider is created again.
+/// @param hProvider handle to the file memory provider
+///        created with the 'persistent' parameter set
+/// @param ptr pointer to the beginning of an allocation of the provider
+///        or NULL to clear the root object
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+umf_result_t
+umfFileMemoryProviderSetRoot(umf_memory_provider_handle_t hProvider, void *ptr);
+
+/// @brief Get the root object of the persistent heap of the file memory
+///        provider.
+/// @param hProvider handle to the file memory provider
+///        created with the 'persistent' parameter set
+/// @param ptr [out] pointer to the root object (NULL if it is not set)
+/// @return UMF_RESULT_SUCCESS on success or appropriate error code on failure
+umf_result_t
+umfFileMemoryProviderGetRoot(umf_memory_provider_handle_t hProvider,
+                             void **ptr);
+
 /// @brief Create default params for the file memory provider
 static inline umf_file_memory_provider_params_t
 umfFileMemoryProviderParamsDefault(const char *path) {
@@ -45,6 +107,11 @@ umfFileMemoryProviderParamsDefault(const char *path) {
         path,                                       /* a path to the file */
         UMF_PROTECTION_READ | UMF_PROTECTION_WRITE, /* protection */
         UMF_MEM_MAP_PRIVATE,                        /* visibility mode */
+        0,                                          /* mmap_granularity */
+        0,                                          /* fallocate_ahead */
+        UMF_FILE_PREFETCH_NONE,                     /* prefetch */
+        false,                                      /* persistent */
+        0,                                          /* persistent_max_allocs */
     };
 
     return params;
@@ -97,6 +97,8 @@ typedef enum umf_os_memory_provider_native_error {
     UMF_OS_RESULT_ERROR_PURGE_LAZY_FAILED,     ///< Lazy purging failed
     UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED,    ///< Force purging failed
     UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED, ///< HWLOC topology discovery failed
+    UMF_OS_RESULT_ERROR_MIGRATE_FAILED, ///< Migrating memory to NUMA node failed
+    UMF_OS_RESULT_ERROR_RESIZE_FAILED,  ///< Resizing memory mapping failed
 } umf_os_memory_provider_native_error_t;
 
 umf_memory_provider_ops_t *umfOsMemoryProviderOps(void);
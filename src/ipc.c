@@ -9,12 +9,15 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <umf/ipc.h>
 
 #include "base_alloc_global.h"
+#include "critnib.h"
 #include "ipc_internal.h"
 #include "memory_pool_internal.h"
+#include "memory_provider_internal.h"
 #include "provider/provider_tracking.h"
 #include "utils_common.h"
 #include "utils_log.h"
@@ -49,6 +52,27 @@ umf_result_t umfPoolGetIPCHandleSize(umf_memory_pool_handle_t hPool,
     return ret;
 }
 
+// ipc_get_cached_handle - get the IPC handle of the base allocation
+// cached in the tracking provider of the pool
+static umf_result_t ipc_get_cached_handle(const umf_alloc_info_t *allocInfo,
+                                          const umf_ipc_data_t **ipcData,
+                                          size_t *size) {
+    // We cannot use umfPoolGetMemoryProvider function because it returns
+    // upstream provider but we need tracking one
+    umf_memory_provider_handle_t provider = allocInfo->pool->provider;
+    assert(provider);
+
+    umf_result_t ret = umfTrackingMemoryProviderGetIPCHandle(
+        umfMemoryProviderGetPriv(provider), allocInfo->base,
+        allocInfo->baseSize, ipcData, size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to get IPC handle.");
+        return ret;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
                              size_t *size) {
     if (ptr == NULL || umfIPCHandle == NULL || size == NULL) {
@@ -56,7 +80,6 @@ umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    size_t ipcHandleSize = 0;
     umf_alloc_info_t allocInfo;
     umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
     if (ret != UMF_RESULT_SUCCESS) {
@@ -64,9 +87,10 @@ umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
         return ret;
     }
 
-    ret = umfPoolGetIPCHandleSize(allocInfo.pool, &ipcHandleSize);
+    const umf_ipc_data_t *cachedIpcData = NULL;
+    size_t ipcHandleSize = 0;
+    ret = ipc_get_cached_handle(&allocInfo, &cachedIpcData, &ipcHandleSize);
     if (ret != UMF_RESULT_SUCCESS) {
-        LOG_ERR("cannot get IPC handle size.");
         return ret;
     }
 
@@ -76,28 +100,48 @@ umf_result_t umfGetIPCHandle(const void *ptr, umf_ipc_handle_t *umfIPCHandle,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    // We cannot use umfPoolGetMemoryProvider function because it returns
-    // upstream provider but we need tracking one
-    umf_memory_provider_handle_t provider = allocInfo.pool->provider;
-    assert(provider);
+    memcpy(ipcData, cachedIpcData, ipcHandleSize);
+    ipcData->offset = (uintptr_t)ptr - (uintptr_t)allocInfo.base;
 
-    ret = umfMemoryProviderGetIPCHandle(provider, allocInfo.base,
-                                        allocInfo.baseSize,
-                                        (void *)ipcData->providerIpcData);
+    *umfIPCHandle = ipcData;
+    *size = ipcHandleSize;
+
+    return ret;
+}
+
+umf_result_t umfGetIPCHandleToBuffer(const void *ptr, void *buffer,
+                                     size_t bufferSize, size_t *size) {
+    if (ptr == NULL || buffer == NULL || size == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_alloc_info_t allocInfo;
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
     if (ret != UMF_RESULT_SUCCESS) {
-        LOG_ERR("failed to get IPC handle.");
-        umf_ba_global_free(ipcData);
+        LOG_ERR("cannot get alloc info for ptr = %p.", ptr);
         return ret;
     }
 
-    ipcData->pid = utils_getpid();
-    ipcData->baseSize = allocInfo.baseSize;
-    ipcData->offset = (uintptr_t)ptr - (uintptr_t)allocInfo.base;
+    const umf_ipc_data_t *cachedIpcData = NULL;
+    size_t ipcHandleSize = 0;
+    ret = ipc_get_cached_handle(&allocInfo, &cachedIpcData, &ipcHandleSize);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
 
-    *umfIPCHandle = ipcData;
     *size = ipcHandleSize;
+    if (bufferSize < ipcHandleSize) {
+        LOG_ERR("the buffer is too small for the IPC handle (%zu < %zu).",
+                bufferSize, ipcHandleSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
-    return ret;
+    umf_ipc_data_t *ipcData = buffer;
+    memcpy(ipcData, cachedIpcData, ipcHandleSize);
+    ipcData->offset = (uintptr_t)ptr - (uintptr_t)allocInfo.base;
+
+    return UMF_RESULT_SUCCESS;
 }
 
 umf_result_t umfPutIPCHandle(umf_ipc_handle_t umfIPCHandle) {
@@ -151,3 +195,421 @@ umf_result_t umfCloseIPCHandle(void *ptr) {
     return umfMemoryProviderCloseIPCHandle(hProvider, allocInfo.base,
                                            allocInfo.baseSize);
 }
+
+umf_result_t umfPoolSetOpenedIPCCacheSize(umf_memory_pool_handle_t hPool,
+                                          size_t size) {
+    if (hPool == NULL) {
+        LOG_ERR("pool handle is NULL.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the cache of opened IPC handles is kept by the tracking provider
+    if (hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING) {
+        LOG_ERR("tracking of the pool is disabled.");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    return umfTrackingMemoryProviderSetOpenedIPCCacheSize(
+        umfMemoryProviderGetPriv(hPool->provider), size);
+}
+
+umf_result_t umfPoolGetIPCCacheStats(umf_memory_pool_handle_t hPool,
+                                     umf_ipc_cache_stats_t *stats) {
+    if (hPool == NULL || stats == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the caches of IPC handles are kept by the tracking provider
+    if (hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING) {
+        LOG_ERR("tracking of the pool is disabled.");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    umfTrackingMemoryProviderGetIPCCacheStats(
+        umfMemoryProviderGetPriv(hPool->provider), stats);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfGetIPCHandles(const void *const *ptrs, size_t count,
+                              void **ipcHandles, size_t *size) {
+    if (ptrs == NULL || count == 0 || ipcHandles == NULL || size == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (count > SIZE_MAX / sizeof(umf_alloc_info_t)) {
+        LOG_ERR("too many pointers: %zu.", count);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    size_t n_regions = 0;
+    size_t region_size = 0;
+
+    // base allocations of the pointers
+    umf_alloc_info_t *regions =
+        umf_ba_global_alloc(count * sizeof(umf_alloc_info_t));
+    umf_ipc_handles_ptr_t *entries =
+        umf_ba_global_alloc(count * sizeof(umf_ipc_handles_ptr_t));
+    // base address -> (index of the region + 1)
+    critnib *region_index = critnib_new();
+    if (!regions || !entries || !region_index) {
+        LOG_ERR("failed to allocate memory for the batch of IPC handles.");
+        goto err_free;
+    }
+
+    // coalesce the pointers sharing a base allocation
+    for (size_t i = 0; i < count; i++) {
+        if (ptrs[i] == NULL) {
+            LOG_ERR("pointer %zu is NULL.", i);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_free;
+        }
+
+        umf_alloc_info_t allocInfo;
+        ret = umfMemoryTrackerGetAllocInfo(ptrs[i], &allocInfo);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("cannot get alloc info for ptr = %p.", ptrs[i]);
+            goto err_free;
+        }
+
+        uintptr_t index = (uintptr_t)critnib_get(region_index,
+                                                 (uintptr_t)allocInfo.base);
+        if (index == 0) {
+            const umf_ipc_data_t *cachedIpcData;
+            size_t handle_size;
+            ret = ipc_get_cached_handle(&allocInfo, &cachedIpcData,
+                                        &handle_size);
+            if (ret != UMF_RESULT_SUCCESS) {
+                goto err_free;
+            }
+
+            // keep the IPC handles aligned in the batch
+            handle_size = ALIGN_UP(handle_size, sizeof(uint64_t));
+            if (handle_size > region_size) {
+                region_size = handle_size;
+            }
+
+            regions[n_regions] = allocInfo;
+            index = ++n_regions;
+            if (critnib_insert(region_index, (uintptr_t)allocInfo.base,
+                               (void *)index, 0 /* update */)) {
+                LOG_ERR("failed to insert the base allocation to the index.");
+                ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+                goto err_free;
+            }
+        }
+
+        entries[i].region = index - 1;
+        entries[i].offset = (uintptr_t)ptrs[i] - (uintptr_t)allocInfo.base;
+    }
+
+    size_t batch_size = sizeof(umf_ipc_handles_header_t) +
+                        n_regions * region_size +
+                        count * sizeof(umf_ipc_handles_ptr_t);
+
+    uint8_t *batch = umf_ba_global_alloc(batch_size);
+    if (!batch) {
+        LOG_ERR("failed to allocate the batch of IPC handles.");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_free;
+    }
+
+    // the padding bytes are sent as well
+    memset(batch, 0, batch_size);
+
+    umf_ipc_handles_header_t *header = (umf_ipc_handles_header_t *)batch;
+    header->signature = UMF_IPC_HANDLES_SIGNATURE;
+    header->size = batch_size;
+    header->n_regions = n_regions;
+    header->region_size = region_size;
+    header->n_ptrs = count;
+
+    uint8_t *region_handles = batch + sizeof(umf_ipc_handles_header_t);
+    for (size_t r = 0; r < n_regions; r++) {
+        const umf_ipc_data_t *cachedIpcData;
+        size_t handle_size;
+        ret = ipc_get_cached_handle(&regions[r], &cachedIpcData, &handle_size);
+        if (ret != UMF_RESULT_SUCCESS) {
+            umf_ba_global_free(batch);
+            goto err_free;
+        }
+
+        assert(handle_size <= region_size);
+        memcpy(region_handles + r * region_size, cachedIpcData, handle_size);
+    }
+
+    memcpy(region_handles + n_regions * region_size, entries,
+           count * sizeof(umf_ipc_handles_ptr_t));
+
+    LOG_DEBUG("created a batch of IPC handles of %zu pointers in %zu base "
+              "allocations (size=%zu).",
+              count, n_regions, batch_size);
+
+    *ipcHandles = batch;
+    *size = batch_size;
+    ret = UMF_RESULT_SUCCESS;
+
+err_free:
+    if (region_index) {
+        critnib_delete(region_index);
+    }
+    umf_ba_global_free(entries);
+    umf_ba_global_free(regions);
+    return ret;
+}
+
+umf_result_t umfPutIPCHandles(void *ipcHandles) {
+    // the same as umfPutIPCHandle() - the IPC handles of the base
+    // allocations are put back to the provider when they are freed
+    umf_ba_global_free(ipcHandles);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfOpenIPCHandles(umf_memory_pool_handle_t hPool,
+                               void *ipcHandles, size_t size, void **ptrs,
+                               size_t count) {
+    if (hPool == NULL || ipcHandles == NULL || ptrs == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    const umf_ipc_handles_header_t *header = ipcHandles;
+    if (size < sizeof(*header) ||
+        header->signature != UMF_IPC_HANDLES_SIGNATURE ||
+        header->size != size || header->n_ptrs != count ||
+        header->region_size < sizeof(umf_ipc_data_t) ||
+        header->region_size % sizeof(uint64_t) ||
+        header->n_regions > count ||
+        count > (size - sizeof(*header)) / sizeof(umf_ipc_handles_ptr_t)) {
+        LOG_ERR("invalid batch of IPC handles (size=%zu, count=%zu).", size,
+                count);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the regions have to fill the rest of the batch exactly;
+    // divide first, so a forged region_size cannot wrap the product
+    size_t regions_size =
+        size - sizeof(*header) - count * sizeof(umf_ipc_handles_ptr_t);
+    if ((header->n_regions == 0 && regions_size != 0) ||
+        (header->n_regions != 0 &&
+         (header->region_size > regions_size / header->n_regions ||
+          header->n_regions * header->region_size != regions_size))) {
+        LOG_ERR("invalid batch of IPC handles (size=%zu, count=%zu, "
+                "n_regions=%zu, region_size=%zu).",
+                size, count, (size_t)header->n_regions,
+                (size_t)header->region_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t handle_size;
+    umf_result_t ret = umfPoolGetIPCHandleSize(hPool, &handle_size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get IPC handle size.");
+        return ret;
+    }
+
+    if (handle_size > header->region_size) {
+        LOG_ERR("IPC handles do not match the memory provider of the pool.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint8_t *region_handles = (uint8_t *)ipcHandles + sizeof(*header);
+    const umf_ipc_handles_ptr_t *entries =
+        (const umf_ipc_handles_ptr_t *)(region_handles +
+                                        header->n_regions *
+                                            header->region_size);
+
+    size_t i;
+    for (i = 0; i < count; i++) {
+        if (entries[i].region >= header->n_regions) {
+            LOG_ERR("invalid entry %zu of the batch of IPC handles.", i);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_close;
+        }
+
+        umf_ipc_data_t *ipcData =
+            (umf_ipc_data_t *)(region_handles +
+                               entries[i].region * header->region_size);
+        if (entries[i].offset >= ipcData->baseSize) {
+            LOG_ERR("invalid entry %zu of the batch of IPC handles.", i);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_close;
+        }
+
+        // every pointer holds its own reference to the opened base
+        // allocation, the cache of opened IPC handles of the pool
+        // makes opening the same base allocation again cheap
+        void *base = NULL;
+        ret = umfOpenIPCHandle(hPool, ipcData, &base);
+        if (ret != UMF_RESULT_SUCCESS) {
+            goto err_close;
+        }
+
+        ptrs[i] = (void *)((uintptr_t)base + entries[i].offset);
+    }
+
+    return UMF_RESULT_SUCCESS;
+
+err_close:
+    while (i-- > 0) {
+        (void)umfCloseIPCHandle(ptrs[i]);
+        ptrs[i] = NULL;
+    }
+    return ret;
+}
+
+umf_result_t umfCloseIPCHandles(void **ptrs, size_t count) {
+    if (ptrs == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        umf_result_t ret_close = umfCloseIPCHandle(ptrs[i]);
+        if (ret_close != UMF_RESULT_SUCCESS && ret == UMF_RESULT_SUCCESS) {
+            ret = ret_close;
+        }
+    }
+
+    return ret;
+}
+
+// region opened by umfOpenIPCRegion()
+typedef struct umf_ipc_region_t {
+    uint64_t region_id;
+    void *base;
+    size_t size;
+} umf_ipc_region_t;
+
+umf_result_t umfGetIPCRegionRef(const void *ptr, size_t size,
+                                umf_ipc_region_ref_t *ref) {
+    if (ptr == NULL || ref == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_alloc_info_t allocInfo;
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get alloc info for ptr = %p.", ptr);
+        return ret;
+    }
+
+    size_t offset = (uintptr_t)ptr - (uintptr_t)allocInfo.base;
+    if (size > allocInfo.baseSize - offset) {
+        LOG_ERR("the object exceeds its region (ptr = %p, size = %zu).", ptr,
+                size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the ID of the IPC handle of the region identifies the region,
+    // the IPC handle is kept in the tracking provider until the region
+    // is freed, so the ID is the same for all objects of the region
+    uint64_t region_id;
+    ret = umfTrackingMemoryProviderGetIPCHandleId(
+        umfMemoryProviderGetPriv(allocInfo.pool->provider), allocInfo.base,
+        allocInfo.baseSize, &region_id);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to get IPC handle of the region.");
+        return ret;
+    }
+
+    ref->region_id = region_id;
+    ref->offset = offset;
+    ref->size = size;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfOpenIPCRegion(umf_memory_pool_handle_t hPool,
+                              umf_ipc_handle_t ipcHandle,
+                              umf_ipc_region_handle_t *region) {
+    if (hPool == NULL || ipcHandle == NULL || region == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ipcHandle->handle_id == 0) {
+        LOG_ERR("the IPC handle does not identify a region.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_ipc_region_t *ipc_region =
+        umf_ba_global_alloc(sizeof(umf_ipc_region_t));
+    if (!ipc_region) {
+        LOG_ERR("failed to allocate the IPC region.");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    void *ptr = NULL;
+    umf_result_t ret = umfOpenIPCHandle(hPool, ipcHandle, &ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        umf_ba_global_free(ipc_region);
+        return ret;
+    }
+
+    ipc_region->region_id = ipcHandle->handle_id;
+    ipc_region->base = (void *)((uintptr_t)ptr - ipcHandle->offset);
+    ipc_region->size = ipcHandle->baseSize;
+
+    *region = ipc_region;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCRegionGetId(umf_ipc_region_handle_t region,
+                               uint64_t *regionId) {
+    if (region == NULL || regionId == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *regionId = region->region_id;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCRegionGetPtr(umf_ipc_region_handle_t region,
+                                const umf_ipc_region_ref_t *ref, void **ptr) {
+    if (region == NULL || ref == NULL || ptr == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ref->region_id != region->region_id) {
+        LOG_ERR("the reference does not belong to the region (region_id = "
+                "%llu, expected %llu).",
+                (unsigned long long)ref->region_id,
+                (unsigned long long)region->region_id);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ref->offset > region->size || ref->size > region->size - ref->offset) {
+        LOG_ERR("the reference exceeds the region (offset = %llu, size = "
+                "%llu).",
+                (unsigned long long)ref->offset,
+                (unsigned long long)ref->size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *ptr = (void *)((uintptr_t)region->base + ref->offset);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfCloseIPCRegion(umf_ipc_region_handle_t region) {
+    if (region == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = umfCloseIPCHandle(region->base);
+    umf_ba_global_free(region);
+
+    return ret;
+}
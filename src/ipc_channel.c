@@ -0,0 +1,411 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/ipc_channel.h>
+#include <umf/pools/pool_shared.h>
+
+#include "base_alloc_global.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+// The ring of the channel is a bounded queue of (offset, size) descriptors
+// with a sequence number in every slot (a slot can be written when its
+// sequence number equals the position of the producer and read when it
+// equals the position of the consumer + 1). Producers of an MPSC channel
+// reserve slots with the compare-exchange of the head, the only producer
+// of an SPSC channel just stores it. The futex words are changed (and
+// the waiters woken up) only when the other side has announced waiting.
+
+#define IPC_CHANNEL_SIGNATURE 0x554D464348414E4CULL // "UMFCHANL"
+#define IPC_CHANNEL_CACHE_LINE 64
+
+// number of retries before the thread goes to sleep on the futex
+#define IPC_CHANNEL_SPIN_COUNT 1024
+
+typedef struct ipc_channel_slot_t {
+    uint64_t seq;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t reserved;
+} ipc_channel_slot_t;
+
+typedef struct ipc_channel_ring_t {
+    uint64_t signature;
+    uint64_t mode;
+    uint64_t capacity;
+    uint8_t pad0[IPC_CHANNEL_CACHE_LINE - 3 * sizeof(uint64_t)];
+
+    // written by producers
+    uint64_t head;
+    uint32_t not_empty; // futex: changed when a message is sent
+    uint32_t producers_waiting;
+    uint8_t pad1[IPC_CHANNEL_CACHE_LINE - 2 * sizeof(uint64_t)];
+
+    // written by the consumer
+    uint64_t tail;
+    uint32_t not_full; // futex: changed when a message is received
+    uint32_t consumer_waiting;
+    uint8_t pad2[IPC_CHANNEL_CACHE_LINE - 2 * sizeof(uint64_t)];
+
+    ipc_channel_slot_t slots[];
+} ipc_channel_ring_t;
+
+typedef struct umf_ipc_channel_t {
+    umf_memory_pool_handle_t pool;
+    ipc_channel_ring_t *ring;
+    uint64_t id;
+    // true if the ring was created (not opened) by this handle
+    bool owner;
+} umf_ipc_channel_t;
+
+static bool ring_try_push(ipc_channel_ring_t *ring, uint64_t offset,
+                          uint64_t size) {
+    uint64_t mask = ring->capacity - 1;
+    ipc_channel_slot_t *slot;
+    uint64_t pos;
+
+    utils_atomic_load_acquire(&ring->head, &pos);
+    for (;;) {
+        slot = &ring->slots[pos & mask];
+
+        uint64_t seq;
+        utils_atomic_load_acquire(&slot->seq, &seq);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff < 0) {
+            // the slot has not been read yet - the ring is full
+            return false;
+        }
+
+        if (diff > 0) {
+            // the slot has been taken by another producer
+            utils_atomic_load_acquire(&ring->head, &pos);
+            continue;
+        }
+
+        if (ring->mode == UMF_IPC_CHANNEL_SPSC) {
+            utils_atomic_store_release(&ring->head, pos + 1);
+            break;
+        }
+
+        // 'pos' is updated if the exchange fails
+        if (utils_compare_exchange(&ring->head, &pos, pos + 1)) {
+            break;
+        }
+    }
+
+    slot->offset = offset;
+    slot->size = size;
+    utils_atomic_store_release(&slot->seq, pos + 1);
+
+    return true;
+}
+
+static bool ring_try_pop(ipc_channel_ring_t *ring, uint64_t *offset,
+                         uint64_t *size) {
+    // there is only one consumer, so no one else writes the tail
+    uint64_t pos = ring->tail;
+    ipc_channel_slot_t *slot = &ring->slots[pos & (ring->capacity - 1)];
+
+    uint64_t seq;
+    utils_atomic_load_acquire(&slot->seq, &seq);
+    if (seq != pos + 1) {
+        // the ring is empty
+        return false;
+    }
+
+    *offset = slot->offset;
+    *size = slot->size;
+    utils_atomic_store_release(&slot->seq, pos + ring->capacity);
+    utils_atomic_store_release(&ring->tail, pos + 1);
+
+    return true;
+}
+
+// wake up the other side if it has announced waiting
+static void channel_notify(uint32_t *futex, uint32_t *waiting) {
+    utils_atomic_fence();
+
+    uint32_t is_waiting;
+    utils_atomic_load_acquire_u32(waiting, &is_waiting);
+    if (is_waiting) {
+        utils_atomic_store_release_u32(waiting, 0);
+        utils_atomic_increment_u32(futex);
+        utils_futex_wake(futex, INT_MAX);
+    }
+}
+
+// wait on the futex until the deadline (forever if timeout_ms < 0),
+// the caller retries its operation after every wake-up
+static umf_result_t channel_wait(uint32_t *futex, uint32_t expected,
+                                 int timeout_ms, uint64_t deadline) {
+    int remaining_ms = -1;
+    if (timeout_ms >= 0) {
+        uint64_t now = utils_get_time_ms();
+        if (now >= deadline) {
+            return UMF_RESULT_ERROR_TIMEOUT;
+        }
+        remaining_ms = (int)(deadline - now);
+    }
+
+    if (utils_futex_wait(futex, expected, remaining_ms)) {
+        if (errno == ETIMEDOUT) {
+            return UMF_RESULT_ERROR_TIMEOUT;
+        }
+        if (errno == ENOSYS) {
+            LOG_ERR("waiting on the IPC channel is not supported.");
+            return UMF_RESULT_ERROR_NOT_SUPPORTED;
+        }
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelCreate(umf_memory_pool_handle_t hPool,
+                                 umf_ipc_channel_mode_t mode, size_t capacity,
+                                 umf_ipc_channel_handle_t *channel) {
+    if (hPool == NULL || channel == NULL || capacity == 0 ||
+        capacity > UINT32_MAX ||
+        (mode != UMF_IPC_CHANNEL_SPSC && mode != UMF_IPC_CHANNEL_MPSC)) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the ring has to be placed in the heap of the shared memory pool
+    void *heap = NULL;
+    umf_result_t ret = umfSharedPoolGetPtr(hPool, 0, &heap);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    size_t ring_capacity = 1;
+    while (ring_capacity < capacity) {
+        ring_capacity <<= 1;
+    }
+
+    umf_ipc_channel_t *ipc_channel =
+        umf_ba_global_alloc(sizeof(umf_ipc_channel_t));
+    if (!ipc_channel) {
+        LOG_ERR("failed to allocate the IPC channel.");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    size_t ring_size =
+        sizeof(ipc_channel_ring_t) + ring_capacity * sizeof(ipc_channel_slot_t);
+    ipc_channel_ring_t *ring = (ipc_channel_ring_t *)umfPoolAlignedMalloc(
+        hPool, ring_size, IPC_CHANNEL_CACHE_LINE);
+    if (!ring) {
+        LOG_ERR("failed to allocate the ring of the IPC channel.");
+        ret = umfPoolGetLastAllocationError(hPool);
+        goto err_free_channel;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->mode = mode;
+    ring->capacity = ring_capacity;
+    for (size_t i = 0; i < ring_capacity; i++) {
+        ring->slots[i].seq = i;
+    }
+
+    // the signature is set as the last one - the ring is ready to be opened
+    utils_atomic_store_release(&ring->signature, IPC_CHANNEL_SIGNATURE);
+
+    ret = umfSharedPoolGetOffset(hPool, ring, &ipc_channel->id);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto err_free_ring;
+    }
+
+    ipc_channel->pool = hPool;
+    ipc_channel->ring = ring;
+    ipc_channel->owner = true;
+
+    *channel = ipc_channel;
+
+    return UMF_RESULT_SUCCESS;
+
+err_free_ring:
+    umfPoolFree(hPool, ring);
+err_free_channel:
+    umf_ba_global_free(ipc_channel);
+    return ret;
+}
+
+umf_result_t umfIPCChannelGetId(umf_ipc_channel_handle_t channel,
+                                uint64_t *channelId) {
+    if (channel == NULL || channelId == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *channelId = channel->id;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelOpen(umf_memory_pool_handle_t hPool,
+                               uint64_t channelId,
+                               umf_ipc_channel_handle_t *channel) {
+    if (hPool == NULL || channel == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    ipc_channel_ring_t *ring = NULL;
+    umf_result_t ret = umfSharedPoolGetPtr(hPool, channelId, (void **)&ring);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    uint64_t signature;
+    utils_atomic_load_acquire(&ring->signature, &signature);
+    if (signature != IPC_CHANNEL_SIGNATURE) {
+        LOG_ERR("there is no IPC channel with ID %llu",
+                (unsigned long long)channelId);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_ipc_channel_t *ipc_channel =
+        umf_ba_global_alloc(sizeof(umf_ipc_channel_t));
+    if (!ipc_channel) {
+        LOG_ERR("failed to allocate the IPC channel.");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    ipc_channel->pool = hPool;
+    ipc_channel->ring = ring;
+    ipc_channel->id = channelId;
+    ipc_channel->owner = false;
+
+    *channel = ipc_channel;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelSend(umf_ipc_channel_handle_t channel, void *ptr,
+                               size_t size, int timeout_ms) {
+    if (channel == NULL || ptr == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint64_t offset;
+    umf_result_t ret = umfSharedPoolGetOffset(channel->pool, ptr, &offset);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    // the timeout covers all the retries, not each wait separately
+    uint64_t deadline = timeout_ms > 0 ? utils_get_time_ms() + timeout_ms : 0;
+    ipc_channel_ring_t *ring = channel->ring;
+    for (unsigned spin = 0;;) {
+        if (ring_try_push(ring, offset, size)) {
+            break;
+        }
+
+        if (timeout_ms == 0) {
+            return UMF_RESULT_ERROR_TIMEOUT;
+        }
+
+        if (spin < IPC_CHANNEL_SPIN_COUNT) {
+            spin++;
+            continue;
+        }
+
+        uint32_t not_full;
+        utils_atomic_load_acquire_u32(&ring->not_full, &not_full);
+        utils_atomic_store_release_u32(&ring->producers_waiting, 1);
+        utils_atomic_fence();
+
+        // the consumer could have received a message in the meantime
+        if (ring_try_push(ring, offset, size)) {
+            break;
+        }
+
+        ret = channel_wait(&ring->not_full, not_full, timeout_ms, deadline);
+        if (ret != UMF_RESULT_SUCCESS) {
+            return ret;
+        }
+    }
+
+    channel_notify(&ring->not_empty, &ring->consumer_waiting);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfIPCChannelReceive(umf_ipc_channel_handle_t channel, void **ptr,
+                                  size_t *size, int timeout_ms) {
+    if (channel == NULL || ptr == NULL || size == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the timeout covers all the retries, not each wait separately
+    uint64_t deadline = timeout_ms > 0 ? utils_get_time_ms() + timeout_ms : 0;
+    ipc_channel_ring_t *ring = channel->ring;
+    uint64_t offset = 0;
+    uint64_t msg_size = 0;
+    umf_result_t ret;
+    for (unsigned spin = 0;;) {
+        if (ring_try_pop(ring, &offset, &msg_size)) {
+            break;
+        }
+
+        if (timeout_ms == 0) {
+            return UMF_RESULT_ERROR_TIMEOUT;
+        }
+
+        if (spin < IPC_CHANNEL_SPIN_COUNT) {
+            spin++;
+            continue;
+        }
+
+        uint32_t not_empty;
+        utils_atomic_load_acquire_u32(&ring->not_empty, &not_empty);
+        utils_atomic_store_release_u32(&ring->consumer_waiting, 1);
+        utils_atomic_fence();
+
+        // a producer could have sent a message in the meantime
+        if (ring_try_pop(ring, &offset, &msg_size)) {
+            break;
+        }
+
+        ret = channel_wait(&ring->not_empty, not_empty, timeout_ms, deadline);
+        if (ret != UMF_RESULT_SUCCESS) {
+            return ret;
+        }
+    }
+
+    channel_notify(&ring->not_full, &ring->producers_waiting);
+
+    *size = msg_size;
+    return umfSharedPoolGetPtr(channel->pool, offset, ptr);
+}
+
+umf_result_t umfIPCChannelClose(umf_ipc_channel_handle_t channel) {
+    if (channel == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+    if (channel->owner) {
+        utils_atomic_store_release(&channel->ring->signature, 0);
+        ret = umfPoolFree(channel->pool, channel->ring);
+    }
+
+    umf_ba_global_free(channel);
+
+    return ret;
+}
@@ -24,9 +24,31 @@ typedef struct umf_ipc_data_t {
     int pid;         // process ID of the process that allocated the memory
     size_t baseSize; // size of base (coarse-grain) allocation
     uint64_t offset;
+    uint64_t handle_id;     // unique ID of the handle in the producer process
+    uint64_t process_nonce; // random ID of the producer (pids are reused)
+    uint64_t base;          // address of the base allocation in the producer
     char providerIpcData[];
 } umf_ipc_data_t;
 
+// Serialized batch of IPC handles created by umfGetIPCHandles().
+// The header is followed by 'n_regions' IPC handles (umf_ipc_data_t) of the
+// base allocations, each of 'region_size' bytes, and by 'n_ptrs' entries
+// (umf_ipc_handles_ptr_t) locating the pointers in these base allocations.
+#define UMF_IPC_HANDLES_SIGNATURE 0x53454C444E4148ULL // "HANDLES"
+
+typedef struct umf_ipc_handles_header_t {
+    uint64_t signature;
+    uint64_t size; // size of the whole batch in bytes
+    uint64_t n_regions;
+    uint64_t region_size;
+    uint64_t n_ptrs;
+} umf_ipc_handles_header_t;
+
+typedef struct umf_ipc_handles_ptr_t {
+    uint64_t region; // index of the IPC handle of the base allocation
+    uint64_t offset; // offset of the pointer in the base allocation
+} umf_ipc_handles_ptr_t;
+
 #ifdef __cplusplus
 }
 #endif
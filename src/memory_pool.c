@@ -21,6 +21,7 @@
 #include "memory_pool_internal.h"
 #include "memory_provider_internal.h"
 #include "provider_tracking.h"
+#include "utils_common.h"
 
 static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
                                           umf_memory_provider_handle_t provider,
@@ -31,6 +32,17 @@ static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    // the layout of the ops depends on the version,
+    // so ops of another version cannot be copied
+    if (ops->version != UMF_VERSION_CURRENT) {
+        LOG_ERR("unsupported version of the pool ops: %d.%d (expected: %d.%d)",
+                UMF_MAJOR_VERSION(ops->version),
+                UMF_MINOR_VERSION(ops->version),
+                UMF_MAJOR_VERSION(UMF_VERSION_CURRENT),
+                UMF_MINOR_VERSION(UMF_VERSION_CURRENT));
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
     umf_result_t ret = UMF_RESULT_SUCCESS;
     umf_memory_pool_handle_t pool =
         umf_ba_global_alloc(sizeof(umf_memory_pool_t));
@@ -38,8 +50,6 @@ static umf_result_t umfPoolCreateInternal(const umf_memory_pool_ops_t *ops,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    assert(ops->version == UMF_VERSION_CURRENT);
-
     if (!(flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING)) {
         // Wrap provider with memory tracking provider.
         // Check if the provider supports the free() operation.
@@ -104,6 +114,20 @@ umf_result_t umfFree(void *ptr) {
     return UMF_RESULT_SUCCESS;
 }
 
+umf_result_t umfPersist(const void *ptr, size_t size) {
+    if (!ptr) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_memory_pool_handle_t hPool = umfPoolByPtr(ptr);
+    if (!hPool) {
+        LOG_ERR("pointer %p does not belong to any UMF pool", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfMemoryProviderPersist(hPool->provider, ptr, size);
+}
+
 umf_memory_pool_handle_t umfPoolByPtr(const void *ptr) {
     return umfMemoryTrackerGetPool(ptr);
 }
@@ -124,6 +148,64 @@ umf_result_t umfPoolGetMemoryProvider(umf_memory_pool_handle_t hPool,
     return UMF_RESULT_SUCCESS;
 }
 
+umf_result_t umfPoolMigrate(umf_memory_pool_handle_t hPool, void *ptr,
+                            size_t size, umf_const_memtarget_handle_t target) {
+    UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!ptr || !target) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (size == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (!(hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING) &&
+        umfPoolByPtr(ptr) != hPool) {
+        LOG_ERR("pointer %p does not belong to the pool %p", ptr,
+                (void *)hPool);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t page_size = 0;
+    umf_result_t ret =
+        umfMemoryProviderGetMinPageSize(hPool->provider, ptr, &page_size);
+    if (ret != UMF_RESULT_SUCCESS || page_size == 0) {
+        return ret != UMF_RESULT_SUCCESS ? ret : UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    uintptr_t begin = ALIGN_DOWN((uintptr_t)ptr, page_size);
+    uintptr_t end = ALIGN_UP((uintptr_t)ptr + size, page_size);
+
+    // the memory tracker accepts only ranges of a single allocation,
+    // so the page bounds are clamped to the tracked allocation
+    // (the provider rounds the size up to the page size by itself)
+    if (!(hPool->flags & UMF_POOL_CREATE_FLAG_DISABLE_TRACKING)) {
+        umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+        ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+        if (ret != UMF_RESULT_SUCCESS) {
+            return ret;
+        }
+
+        uintptr_t alloc_begin = (uintptr_t)allocInfo.base;
+        uintptr_t alloc_end = alloc_begin + allocInfo.baseSize;
+        if ((uintptr_t)ptr + size > alloc_end) {
+            LOG_ERR("range (ptr=%p, size=%zu) exceeds the allocation", ptr,
+                    size);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (begin < alloc_begin) {
+            begin = alloc_begin;
+        }
+        if (end > alloc_end) {
+            end = alloc_end;
+        }
+    }
+
+    return umfMemoryProviderMigrate(hPool->provider, (void *)begin,
+                                    end - begin, target);
+}
+
 umf_result_t umfPoolCreate(const umf_memory_pool_ops_t *ops,
                            umf_memory_provider_handle_t provider, void *params,
                            umf_pool_create_flags_t flags,
@@ -175,3 +257,11 @@ umf_result_t umfPoolGetLastAllocationError(umf_memory_pool_handle_t hPool) {
     UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
     return hPool->ops.get_last_allocation_error(hPool->pool_priv);
 }
+
+umf_result_t umfPoolReset(umf_memory_pool_handle_t hPool) {
+    UMF_CHECK((hPool != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!hPool->ops.reset) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+    return hPool->ops.reset(hPool->pool_priv);
+}
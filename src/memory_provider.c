@@ -19,6 +19,7 @@
 #include "libumf.h"
 #include "memory_provider_internal.h"
 #include "utils_assert.h"
+#include "utils_log.h"
 
 typedef struct umf_memory_provider_t {
     umf_memory_provider_ops_t ops;
@@ -67,6 +68,45 @@ static umf_result_t umfDefaultAllocationMerge(void *provider, void *lowPtr,
     return UMF_RESULT_ERROR_NOT_SUPPORTED;
 }
 
+static umf_result_t umfDefaultMigrate(void *provider, void *ptr, size_t size,
+                                       umf_const_memtarget_handle_t target) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    (void)target;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+static umf_result_t umfDefaultPersist(void *provider, const void *ptr,
+                                      size_t size) {
+    (void)provider;
+    (void)ptr;
+    (void)size;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+static umf_result_t umfDefaultAllocZeroInfo(void *provider, size_t size,
+                                            size_t alignment, void **ptr,
+                                            bool *zeroed) {
+    (void)provider;
+    (void)size;
+    (void)alignment;
+    (void)ptr;
+    (void)zeroed;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+static umf_result_t umfDefaultResize(void *provider, void *ptr,
+                                     size_t oldSize, size_t newSize,
+                                     void **newPtr) {
+    (void)provider;
+    (void)ptr;
+    (void)oldSize;
+    (void)newSize;
+    (void)newPtr;
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 static umf_result_t umfDefaultGetIPCHandleSize(void *provider, size_t *size) {
     (void)provider;
     (void)size;
@@ -121,6 +161,18 @@ void assignOpsExtDefaults(umf_memory_provider_ops_t *ops) {
     if (!ops->ext.allocation_merge) {
         ops->ext.allocation_merge = umfDefaultAllocationMerge;
     }
+    if (!ops->ext.migrate) {
+        ops->ext.migrate = umfDefaultMigrate;
+    }
+    if (!ops->ext.resize) {
+        ops->ext.resize = umfDefaultResize;
+    }
+    if (!ops->ext.persist) {
+        ops->ext.persist = umfDefaultPersist;
+    }
+    if (!ops->ext.alloc_zero_info) {
+        ops->ext.alloc_zero_info = umfDefaultAllocZeroInfo;
+    }
 }
 
 void assignOpsIpcDefaults(umf_memory_provider_ops_t *ops) {
@@ -177,7 +229,23 @@ umf_result_t umfMemoryProviderCreate(const umf_memory_provider_ops_t *ops,
                                      void *params,
                                      umf_memory_provider_handle_t *hProvider) {
     libumfInit();
-    if (!ops || !hProvider || !validateOps(ops)) {
+    if (!ops || !hProvider) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // the layout of the ops depends on the version,
+    // so ops of another version cannot be validated nor copied
+    if (ops->version != UMF_VERSION_CURRENT) {
+        LOG_ERR("unsupported version of the provider ops: %d.%d "
+                "(expected: %d.%d)",
+                UMF_MAJOR_VERSION(ops->version),
+                UMF_MINOR_VERSION(ops->version),
+                UMF_MAJOR_VERSION(UMF_VERSION_CURRENT),
+                UMF_MINOR_VERSION(UMF_VERSION_CURRENT));
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!validateOps(ops)) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
@@ -187,8 +255,6 @@ umf_result_t umfMemoryProviderCreate(const umf_memory_provider_ops_t *ops,
         return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    assert(ops->version == UMF_VERSION_CURRENT);
-
     provider->ops = *ops;
 
     assignOpsExtDefaults(&(provider->ops));
@@ -232,6 +298,27 @@ umf_result_t umfMemoryProviderAlloc(umf_memory_provider_handle_t hProvider,
     return res;
 }
 
+umf_result_t
+umfMemoryProviderAllocZeroInfo(umf_memory_provider_handle_t hProvider,
+                               size_t size, size_t alignment, void **ptr,
+                               bool *zeroed) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((zeroed != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result_t res;
+    if (hProvider->ops.ext.alloc_zero_info == umfDefaultAllocZeroInfo) {
+        // the content of the memory is unknown
+        *zeroed = false;
+        res = hProvider->ops.alloc(hProvider->provider_priv, size, alignment,
+                                   ptr);
+    } else {
+        res = hProvider->ops.ext.alloc_zero_info(hProvider->provider_priv, size,
+                                                 alignment, ptr, zeroed);
+    }
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
 umf_result_t umfMemoryProviderFree(umf_memory_provider_handle_t hProvider,
                                    void *ptr, size_t size) {
     UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
@@ -297,6 +384,54 @@ umf_result_t umfMemoryProviderPurgeForce(umf_memory_provider_handle_t hProvider,
     return res;
 }
 
+umf_result_t umfMemoryProviderMigrate(umf_memory_provider_handle_t hProvider,
+                                      void *ptr, size_t size,
+                                      umf_const_memtarget_handle_t target) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!ptr || !target) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (size == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    umf_result_t res =
+        hProvider->ops.ext.migrate(hProvider->provider_priv, ptr, size, target);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
+umf_result_t umfMemoryProviderResize(umf_memory_provider_handle_t hProvider,
+                                     void *ptr, size_t oldSize, size_t newSize,
+                                     void **newPtr) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    UMF_CHECK((newPtr != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!ptr || !oldSize || !newSize) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t res = hProvider->ops.ext.resize(hProvider->provider_priv, ptr,
+                                                 oldSize, newSize, newPtr);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
+umf_result_t umfMemoryProviderPersist(umf_memory_provider_handle_t hProvider,
+                                      const void *ptr, size_t size) {
+    UMF_CHECK((hProvider != NULL), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    if (!ptr) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (size == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    umf_result_t res =
+        hProvider->ops.ext.persist(hProvider->provider_priv, ptr, size);
+    checkErrorAndSetLastProvider(res, hProvider);
+    return res;
+}
+
 umf_memory_provider_handle_t umfGetLastFailedMemoryProvider(void) {
     return *umfGetLastFailedMemoryProviderPtr();
 }
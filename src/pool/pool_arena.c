@@ -0,0 +1,539 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/memory_pool_ops.h>
+#include <umf/pools/pool_arena.h>
+
+#include "base_alloc_global.h"
+#include "provider/provider_tracking.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+// The arena pool bump-allocates memory from chunks of the memory provider.
+// Every thread allocates from its own chunk (kept in a TLS slot), so the fast
+// path takes no locks. Chunks are never returned to the memory provider
+// before the pool is destroyed: umfPoolReset() rewinds all of them and puts
+// them on the list of free chunks, from which the threads take new chunks.
+// Only the chunks of allocations larger than the chunk size (or with
+// an alignment larger than the page size) are freed by the reset.
+//
+// A TLS slot is valid only if its epoch is equal to the current epoch
+// of the pool. Epochs are unique among all pools and every reset gives
+// the pool a new one, so a reset invalidates the slots of all threads
+// at once and a slot can never match a destroyed pool.
+//
+// The TLS slots are grouped in sets of ARENA_TLS_WAYS slots and a pool can
+// use any slot of the set selected by its id, so up to ARENA_TLS_WAYS pools
+// with the same set index do not evict each other. When a set is full,
+// the slot with the oldest epoch is evicted (it is the most likely to belong
+// to a reset or destroyed pool). Every chunk given to a thread remembers
+// the thread, so the thread takes its chunk back after an eviction instead
+// of leaving the rest of the chunk unused until the next reset.
+
+#define ARENA_TLS_SLOTS 64
+#define ARENA_TLS_WAYS 4
+#define ARENA_MIN_ALIGNMENT 16
+
+typedef struct arena_chunk_t {
+    struct arena_chunk_t *next;
+    void *base;
+    size_t size;
+    size_t used; // changed only by the thread that owns the chunk
+    // the thread that allocates from the chunk (see thread_token()),
+    // NULL if the chunk is full or rewound, protected by the pool lock
+    void *owner;
+} arena_chunk_t;
+
+typedef struct arena_memory_pool_t {
+    umf_memory_provider_handle_t provider;
+    size_t page_size;
+    size_t chunk_size;
+    bool purge_on_reset;
+    uint64_t id;    // selects the set of TLS slots of the pool
+    uint64_t epoch; // changed by every reset
+
+    // protects the lists of chunks
+    utils_mutex_t lock;
+    arena_chunk_t *chunks;       // chunks given to threads
+    arena_chunk_t *free_chunks;  // rewound chunks
+    arena_chunk_t *large_chunks; // chunks of single large allocations
+} arena_memory_pool_t;
+
+typedef struct arena_tls_slot_t {
+    uint64_t epoch;
+    arena_chunk_t *chunk;
+    void *last; // the last allocation from the chunk
+} arena_tls_slot_t;
+
+static __TLS arena_tls_slot_t TLS_slots[ARENA_TLS_SLOTS];
+static __TLS umf_result_t TLS_last_allocation_error;
+
+static uint64_t arena_pool_count;
+static uint64_t arena_epoch_count;
+
+static inline arena_tls_slot_t *slot_set(arena_memory_pool_t *pool) {
+    return &TLS_slots[(pool->id % (ARENA_TLS_SLOTS / ARENA_TLS_WAYS)) *
+                      ARENA_TLS_WAYS];
+}
+
+static inline arena_tls_slot_t *slot_get(arena_memory_pool_t *pool) {
+    arena_tls_slot_t *set = slot_set(pool);
+    for (int i = 0; i < ARENA_TLS_WAYS; i++) {
+        if (set[i].epoch == pool->epoch) {
+            return &set[i];
+        }
+    }
+
+    return NULL;
+}
+
+// the slot with the oldest epoch (an unused slot has epoch 0)
+static arena_tls_slot_t *slot_evict(arena_memory_pool_t *pool) {
+    arena_tls_slot_t *set = slot_set(pool);
+    arena_tls_slot_t *victim = &set[0];
+    for (int i = 1; i < ARENA_TLS_WAYS; i++) {
+        if (set[i].epoch < victim->epoch) {
+            victim = &set[i];
+        }
+    }
+
+    return victim;
+}
+
+// identifies the calling thread as long as it lives
+static inline void *thread_token(void) { return (void *)TLS_slots; }
+
+static arena_chunk_t *chunk_create(arena_memory_pool_t *pool, size_t size,
+                                   size_t alignment) {
+    arena_chunk_t *chunk = umf_ba_global_alloc(sizeof(*chunk));
+    if (!chunk) {
+        LOG_ERR("cannot allocate memory for metadata");
+        return NULL;
+    }
+
+    umf_result_t ret =
+        umfMemoryProviderAlloc(pool->provider, size, alignment, &chunk->base);
+    if (ret != UMF_RESULT_SUCCESS || !chunk->base) {
+        umf_ba_global_free(chunk);
+        return NULL;
+    }
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->owner = NULL;
+
+    return chunk;
+}
+
+static void chunk_destroy(arena_memory_pool_t *pool, arena_chunk_t *chunk) {
+    umf_result_t ret =
+        umfMemoryProviderFree(pool->provider, chunk->base, chunk->size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("memory provider failed to free a chunk, addr = %p, "
+                "size = %zu",
+                chunk->base, chunk->size);
+    }
+    umf_ba_global_free(chunk);
+}
+
+static void *chunk_bump(arena_chunk_t *chunk, size_t size, size_t alignment) {
+    uintptr_t base = (uintptr_t)chunk->base;
+    uintptr_t ptr = ALIGN_UP(base + chunk->used, alignment);
+    if (ptr + size > base + chunk->size) {
+        return NULL;
+    }
+
+    chunk->used = ptr + size - base;
+    return (void *)ptr;
+}
+
+static bool chunk_fits(arena_chunk_t *chunk, size_t size, size_t alignment) {
+    uintptr_t base = (uintptr_t)chunk->base;
+    uintptr_t ptr = ALIGN_UP(base + chunk->used, alignment);
+    return ptr + size <= base + chunk->size;
+}
+
+// Gives the TLS slot of the pool a chunk that fits the allocation:
+// the chunk of this thread, if the slot was evicted by another pool,
+// a rewound chunk or a new one. 'full' is the chunk the slot has
+// run out of (NULL if the slot was not valid).
+static umf_result_t slot_refill(arena_memory_pool_t *pool,
+                                arena_tls_slot_t *slot, arena_chunk_t *full,
+                                size_t size, size_t alignment) {
+    void *owner = thread_token();
+    arena_chunk_t *chunk = NULL;
+
+    utils_mutex_lock(&pool->lock);
+    if (full) {
+        full->owner = NULL;
+    } else {
+        for (arena_chunk_t *c = pool->chunks; c; c = c->next) {
+            if (c->owner == owner) {
+                if (chunk_fits(c, size, alignment)) {
+                    chunk = c;
+                } else {
+                    c->owner = NULL;
+                }
+                break;
+            }
+        }
+    }
+
+    if (!chunk && pool->free_chunks) {
+        chunk = pool->free_chunks;
+        pool->free_chunks = chunk->next;
+        chunk->owner = owner;
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+    }
+    utils_mutex_unlock(&pool->lock);
+
+    if (!chunk) {
+        chunk = chunk_create(pool, pool->chunk_size, pool->page_size);
+        if (!chunk) {
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        utils_mutex_lock(&pool->lock);
+        chunk->owner = owner;
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        utils_mutex_unlock(&pool->lock);
+    }
+
+    slot->epoch = pool->epoch;
+    slot->chunk = chunk;
+    slot->last = NULL;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void *arena_alloc_large(arena_memory_pool_t *pool, size_t size,
+                               size_t alignment) {
+    size_t chunk_size = ALIGN_UP(size, pool->page_size);
+    if (chunk_size < size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    arena_chunk_t *chunk = chunk_create(
+        pool, chunk_size,
+        alignment > pool->page_size ? alignment : pool->page_size);
+    if (!chunk) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    utils_mutex_lock(&pool->lock);
+    chunk->next = pool->large_chunks;
+    pool->large_chunks = chunk;
+    utils_mutex_unlock(&pool->lock);
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return chunk->base;
+}
+
+static void *arena_alloc(arena_memory_pool_t *pool, size_t size,
+                         size_t alignment) {
+    if (alignment < ARENA_MIN_ALIGNMENT) {
+        alignment = ARENA_MIN_ALIGNMENT;
+    }
+
+    if (alignment & (alignment - 1)) {
+        LOG_ERR("alignment (%zu) has to be a power of 2", alignment);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+        return NULL;
+    }
+
+    // every allocation gets a unique address
+    if (size == 0) {
+        size = 1;
+    }
+
+    if (size > pool->chunk_size || alignment > pool->page_size) {
+        return arena_alloc_large(pool, size, alignment);
+    }
+
+    arena_tls_slot_t *slot = slot_get(pool);
+    arena_chunk_t *full = NULL;
+    void *ptr = NULL;
+    if (slot) {
+        ptr = chunk_bump(slot->chunk, size, alignment);
+        full = slot->chunk;
+    } else {
+        slot = slot_evict(pool);
+    }
+
+    if (!ptr) {
+        umf_result_t ret = slot_refill(pool, slot, full, size, alignment);
+        if (ret != UMF_RESULT_SUCCESS) {
+            TLS_last_allocation_error = ret;
+            return NULL;
+        }
+
+        // slot_refill() gives a chunk that fits the allocation
+        ptr = chunk_bump(slot->chunk, size, alignment);
+        assert(ptr);
+    }
+
+    slot->last = ptr;
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
+}
+
+static umf_result_t arena_initialize(umf_memory_provider_handle_t provider,
+                                     void *params, void **pool) {
+    umf_arena_pool_params_t default_params = umfArenaPoolParamsDefault();
+    umf_arena_pool_params_t *arena_params = (umf_arena_pool_params_t *)params;
+    if (!arena_params) {
+        arena_params = &default_params;
+    }
+
+    size_t chunk_size = arena_params->chunk_size;
+    if (chunk_size == 0) {
+        chunk_size = UMF_ARENA_POOL_CHUNK_SIZE_DEFAULT;
+    }
+
+    size_t page_size = 0;
+    umf_result_t ret = umfMemoryProviderGetRecommendedPageSize(
+        provider, chunk_size, &page_size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get the recommended page size of the memory provider");
+        return ret;
+    }
+
+    if (page_size == 0 || (page_size & (page_size - 1))) {
+        LOG_ERR("wrong page size of the memory provider: %zu", page_size);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (ALIGN_UP(chunk_size, page_size) < chunk_size) {
+        LOG_ERR("chunk size is too big: %zu", chunk_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    arena_memory_pool_t *arena_pool =
+        umf_ba_global_alloc(sizeof(arena_memory_pool_t));
+    if (!arena_pool) {
+        LOG_ERR("cannot allocate memory for metadata");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (!utils_mutex_init(&arena_pool->lock)) {
+        LOG_ERR("cannot initialize the lock of the arena pool");
+        umf_ba_global_free(arena_pool);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    arena_pool->provider = provider;
+    arena_pool->page_size = page_size;
+    arena_pool->chunk_size = ALIGN_UP(chunk_size, page_size);
+    arena_pool->purge_on_reset = arena_params->purge_on_reset;
+    arena_pool->id = utils_atomic_increment(&arena_pool_count);
+    arena_pool->epoch = utils_atomic_increment(&arena_epoch_count);
+    arena_pool->chunks = NULL;
+    arena_pool->free_chunks = NULL;
+    arena_pool->large_chunks = NULL;
+
+    *pool = (void *)arena_pool;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void arena_finalize(void *pool) {
+    arena_memory_pool_t *arena_pool = (arena_memory_pool_t *)pool;
+    arena_chunk_t *lists[] = {arena_pool->chunks, arena_pool->free_chunks,
+                              arena_pool->large_chunks};
+
+    for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        while (lists[i]) {
+            arena_chunk_t *chunk = lists[i];
+            lists[i] = chunk->next;
+            chunk_destroy(arena_pool, chunk);
+        }
+    }
+
+    utils_mutex_destroy_not_free(&arena_pool->lock);
+    umf_ba_global_free(arena_pool);
+}
+
+static void *arena_malloc(void *pool, size_t size) {
+    return arena_alloc((arena_memory_pool_t *)pool, size, 0);
+}
+
+static void *arena_calloc(void *pool, size_t num, size_t size) {
+    if (size && num > SIZE_MAX / size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    size_t csize = num * size;
+    void *ptr = arena_malloc(pool, csize);
+    if (ptr == NULL) {
+        // TLS_last_allocation_error is set by arena_malloc()
+        return NULL;
+    }
+
+    // rewound chunks are not zeroed
+    memset(ptr, 0, csize);
+    return ptr;
+}
+
+static void *arena_aligned_malloc(void *pool, size_t size, size_t alignment) {
+    return arena_alloc((arena_memory_pool_t *)pool, size, alignment);
+}
+
+static umf_result_t arena_free(void *pool, void *ptr) {
+    arena_memory_pool_t *arena_pool = (arena_memory_pool_t *)pool;
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    // the memory is freed by umfPoolReset(), only the last allocation
+    // of this thread can be given back right away
+    arena_tls_slot_t *slot = slot_get(arena_pool);
+    if (slot && slot->last == ptr) {
+        slot->chunk->used = (uintptr_t)ptr - (uintptr_t)slot->chunk->base;
+        slot->last = NULL;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void *arena_realloc(void *pool, void *ptr, size_t size) {
+    arena_memory_pool_t *arena_pool = (arena_memory_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return arena_malloc(pool, size);
+    }
+
+    if (size == 0) {
+        TLS_last_allocation_error = arena_free(pool, ptr);
+        return NULL;
+    }
+
+    // the last allocation of this thread can be resized in place
+    arena_tls_slot_t *slot = slot_get(arena_pool);
+    if (slot && slot->last == ptr) {
+        arena_chunk_t *chunk = slot->chunk;
+        uintptr_t offset = (uintptr_t)ptr - (uintptr_t)chunk->base;
+        if (size <= chunk->size - offset) {
+            chunk->used = offset + size;
+            TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+            return ptr;
+        }
+    }
+
+    // The size of the old allocation is not known, so as much memory
+    // as the chunk of the old allocation holds after it is copied.
+    // That requires the memory tracker to find the chunk.
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
+        return NULL;
+    }
+
+    size_t available =
+        (uintptr_t)allocInfo.base + allocInfo.baseSize - (uintptr_t)ptr;
+
+    void *new_ptr = arena_malloc(pool, size);
+    if (new_ptr == NULL) {
+        // TLS_last_allocation_error is set by arena_malloc()
+        return NULL;
+    }
+
+    // the copied ranges can overlap, if both are in the same chunk
+    size_t copy_size = size < available ? size : available;
+    if ((uintptr_t)new_ptr + copy_size <= (uintptr_t)ptr ||
+        (uintptr_t)ptr + copy_size <= (uintptr_t)new_ptr) {
+        utils_memcpy_nt(new_ptr, ptr, copy_size);
+    } else {
+        memmove(new_ptr, ptr, copy_size);
+    }
+
+    return new_ptr;
+}
+
+static size_t arena_malloc_usable_size(void *pool, void *ptr) {
+    (void)pool; // not used
+    (void)ptr;  // not used
+
+    // sizes of allocations are not stored
+    TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
+    return 0;
+}
+
+static umf_result_t arena_get_last_allocation_error(void *pool) {
+    (void)pool; // not used
+    return TLS_last_allocation_error;
+}
+
+static umf_result_t arena_reset(void *pool) {
+    arena_memory_pool_t *arena_pool = (arena_memory_pool_t *)pool;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+
+    utils_mutex_lock(&arena_pool->lock);
+
+    while (arena_pool->chunks) {
+        arena_chunk_t *chunk = arena_pool->chunks;
+        arena_pool->chunks = chunk->next;
+
+        if (arena_pool->purge_on_reset) {
+            umf_result_t purge_ret = umfMemoryProviderPurgeLazy(
+                arena_pool->provider, chunk->base, chunk->size);
+            if (purge_ret != UMF_RESULT_SUCCESS &&
+                purge_ret != UMF_RESULT_ERROR_NOT_SUPPORTED) {
+                LOG_ERR("purging a chunk failed, addr = %p, size = %zu",
+                        chunk->base, chunk->size);
+                ret = purge_ret;
+            }
+        }
+
+        chunk->used = 0;
+        chunk->owner = NULL;
+        chunk->next = arena_pool->free_chunks;
+        arena_pool->free_chunks = chunk;
+    }
+
+    while (arena_pool->large_chunks) {
+        arena_chunk_t *chunk = arena_pool->large_chunks;
+        arena_pool->large_chunks = chunk->next;
+        chunk_destroy(arena_pool, chunk);
+    }
+
+    // invalidates the TLS slots of all threads
+    arena_pool->epoch = utils_atomic_increment(&arena_epoch_count);
+
+    utils_mutex_unlock(&arena_pool->lock);
+
+    return ret;
+}
+
+static umf_memory_pool_ops_t UMF_ARENA_POOL_OPS = {
+    .version = UMF_VERSION_CURRENT,
+    .initialize = arena_initialize,
+    .finalize = arena_finalize,
+    .malloc = arena_malloc,
+    .calloc = arena_calloc,
+    .realloc = arena_realloc,
+    .aligned_malloc = arena_aligned_malloc,
+    .malloc_usable_size = arena_malloc_usable_size,
+    .free = arena_free,
+    .get_last_allocation_error = arena_get_last_allocation_error,
+    .reset = arena_reset};
+
+umf_memory_pool_ops_t *umfArenaPoolOps(void) { return &UMF_ARENA_POOL_OPS; }
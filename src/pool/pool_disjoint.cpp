@@ -384,6 +384,7 @@ class DisjointPool::AllocImpl {
     void *allocate(size_t Size, size_t Alignment, bool &FromPool);
     void *allocate(size_t Size, bool &FromPool);
     void deallocate(void *Ptr, bool &ToPool);
+    void *reallocate(void *Ptr, size_t Size);
 
     umf_memory_provider_handle_t getMemHandle() { return MemHandle; }
 
@@ -1000,6 +1001,43 @@ void DisjointPool::AllocImpl::deallocate(void *Ptr, bool &ToPool) {
     memoryProviderFree(getMemHandle(), Ptr);
 }
 
+void *DisjointPool::AllocImpl::reallocate(void *Ptr, size_t Size) {
+    auto *SlabPtr = AlignPtrDown(Ptr, SlabMinSize());
+
+    // Lock the map on read
+    std::shared_lock<std::shared_timed_mutex> Lk(getKnownSlabsMapLock());
+
+    auto Slabs = getKnownSlabs().equal_range(SlabPtr);
+    for (auto It = Slabs.first; It != Slabs.second; ++It) {
+        auto &Slab = It->second;
+        if (Ptr >= Slab.getPtr() && Ptr < Slab.getEnd()) {
+            // Chunks and slabs cannot be resized and currently we cannot copy
+            // the data in a way that would work for memory that is
+            // inaccessible on the host.
+            throw MemoryProviderError{UMF_RESULT_ERROR_NOT_SUPPORTED};
+        }
+    }
+
+    Lk.unlock();
+
+    // The allocation was served directly by the memory provider,
+    // so the provider can try to resize it without copying the data.
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    auto ret = umfMemoryTrackerGetAllocInfo(Ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS || allocInfo.base != Ptr) {
+        throw MemoryProviderError{UMF_RESULT_ERROR_INVALID_ARGUMENT};
+    }
+
+    void *NewPtr = nullptr;
+    ret = umfMemoryProviderResize(getMemHandle(), Ptr, allocInfo.baseSize, Size,
+                                  &NewPtr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        throw MemoryProviderError{ret};
+    }
+
+    return NewPtr;
+}
+
 void DisjointPool::AllocImpl::printStats(bool &TitlePrinted,
                                          size_t &HighBucketSize,
                                          size_t &HighPeakSlabsInUse,
@@ -1051,10 +1089,28 @@ void *DisjointPool::calloc(size_t, size_t) {
     return NULL;
 }
 
-void *DisjointPool::realloc(void *, size_t) {
-    // Not supported
-    umf::getPoolLastStatusRef<DisjointPool>() = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
+void *DisjointPool::realloc(void *ptr, size_t size) try {
+    if (ptr == nullptr) {
+        return malloc(size);
+    }
+
+    if (size == 0) {
+        umf::getPoolLastStatusRef<DisjointPool>() = free(ptr);
+        return nullptr;
+    }
+
+    auto NewPtr = impl->reallocate(ptr, size);
+
+    if (impl->getParams().PoolTrace > 2) {
+        auto MT = impl->getParams().Name;
+        std::cout << "Reallocated " << MT << " " << ptr << " to "
+                  << std::setw(8) << size << " bytes ->" << NewPtr
+                  << std::endl;
+    }
+    return NewPtr;
+} catch (MemoryProviderError &e) {
+    umf::getPoolLastStatusRef<DisjointPool>() = e.code;
+    return nullptr;
 }
 
 void *DisjointPool::aligned_malloc(size_t size, size_t alignment) {
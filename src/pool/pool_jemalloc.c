@@ -6,6 +6,7 @@
 */
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,6 +23,7 @@
 
 #include <jemalloc/jemalloc.h>
 
+#include <pthread.h>
 #include <threads.h>
 #include <stdatomic.h>
 
@@ -33,81 +35,264 @@
 #define je_dallocx dallocx
 #define je_rallocx rallocx
 // #define je_mallctl mallctl
+#define je_mallctlnametomib mallctlnametomib
+#define je_mallctlbymib mallctlbymib
 #define je_malloc_usable_size malloc_usable_size
 #endif
 
 __thread unsigned thread_id=UINT_MAX;
-__thread unsigned arena_spin=0;
 atomic_int thread_count=0;
 
 #define MALLOCX_ARENA_MAX (MALLCTL_ARENAS_ALL - 1)
 
-// unsigned set_tcache(jemalloc_memory_pool_t* je_pool, unsigned tid, unsigned tcache){
-//     assert(je_pool);
-//     // assert(je_pool->tcaches_resize_lk);
-//     access_tcaches:
-//     pthread_rwlock_rdlock(&je_pool->tcaches_resize_lk);
-//     if(tid < je_pool->tcaches_size){
-//         int size = je_pool->tcaches_size;
-//         je_pool->tcaches[tid] = tcache;
-//         pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//     } else {
-//         pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//         pthread_rwlock_wrlock(&je_pool->tcaches_resize_lk);
-//         if (tid>= je_pool->tcaches_size){
-//             //resizing tcaches
-//             unsigned *temp_tcaches = (unsigned *)realloc(je_pool->tcaches, (tid+1) * sizeof(unsigned));
-//             if (!temp_tcaches) {
-//                 // printf("temp_tcaches realloc failed");
-//                 pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//                 exit(EXIT_FAILURE);
-//             }
-//             je_pool->tcaches = temp_tcaches;
-//             je_pool->tcaches_size = tid+1;
-//         }
-//         pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//         goto access_tcaches;
-//     }
-// }
-
-// unsigned get_tcache(jemalloc_memory_pool_t* je_pool, unsigned tid ){
-//     assert(je_pool);
-//     // assert(je_pool->tcaches_resize_lk);
-//     access_tcaches:
-//     pthread_rwlock_rdlock(&je_pool->tcaches_resize_lk);
-//     if(tid < je_pool->tcaches_size){
-//         unsigned tcache_tid = je_pool->tcaches[tid];
-//         // pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//         return tcache_tid;
-//     } else {
-//         pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//         pthread_rwlock_wrlock(&je_pool->tcaches_resize_lk);
-//         if (tid>= je_pool->tcaches_size){
-//             //resising tcaches
-//             unsigned *temp_tcaches = (unsigned *)realloc(je_pool->tcaches, (tid+1) * sizeof(unsigned));
-//             if (!temp_tcaches) {
-//                 // printf("temp_tcaches realloc failed");
-//                 pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//                 exit(EXIT_FAILURE);
-//             }
-//             je_pool->tcaches = temp_tcaches;
-//             je_pool->tcaches_size = tid+1;
-//         }
-//         pthread_rwlock_unlock(&je_pool->tcaches_resize_lk);
-//         goto access_tcaches;
-//     }
-// }
+// tcache of a pool used by the current thread
+typedef struct jemalloc_tcache_slot_t {
+    struct jemalloc_memory_pool_t *pool; // NULL if the slot is not used
+    unsigned tcache;
+    unsigned arena; // used in UMF_JEMALLOC_POOL_ARENA_MODE_THREAD
+    // all tcaches of a pool are linked together,
+    // so they can be destroyed when the pool is destroyed
+    struct jemalloc_tcache_slot_t *prev;
+    struct jemalloc_tcache_slot_t *next;
+} jemalloc_tcache_slot_t;
+
+// per-thread tcaches indexed by jemalloc_memory_pool_t.pool_id,
+// so the fast path does not take any lock; the table grows when the thread
+// uses a pool with a higher id and the slots are allocated one by one,
+// because they are linked into the lists of tcaches of their pools
+static __thread jemalloc_tcache_slot_t **tcache_slots;
+static __thread unsigned tcache_slots_size;
+
+// protects pool_by_id and the lists of tcaches of all pools;
+// it is taken only when a pool or a tcache is created or destroyed
+static utils_mutex_t tcaches_lock;
+static pthread_key_t tcaches_key;
+// ids of destroyed pools are reused, so the tables of tcache_slots
+// do not grow beyond the number of pools existing at the same time
+static jemalloc_memory_pool_t **pool_by_id;
+static unsigned pool_by_id_size;
+static unsigned num_pools;
+
+// serializes the lazy creation of arenas, see arena_get_or_create()
+static utils_mutex_t arenas_lock;
+
+static UTIL_ONCE_FLAG globals_init_flag = UTIL_ONCE_FLAG_INIT;
+
+static unsigned arena_get_or_create(jemalloc_memory_pool_t *je_pool,
+                                    unsigned idx);
+
+// must be called with tcaches_lock held
+static void tcache_destroy(jemalloc_tcache_slot_t *slot) {
+    jemalloc_memory_pool_t *je_pool = slot->pool;
+    assert(je_pool);
+
+    // tcache.destroy flushes the cached objects back to the arenas
+    je_mallctl("tcache.destroy", NULL, NULL, (void *)&slot->tcache,
+               sizeof(unsigned));
+
+    if (slot->prev) {
+        slot->prev->next = slot->next;
+    } else {
+        je_pool->tcaches = slot->next;
+    }
+    if (slot->next) {
+        slot->next->prev = slot->prev;
+    }
 
+    slot->pool = NULL;
+    slot->prev = NULL;
+    slot->next = NULL;
+}
 
+// destroys the tcaches of an exiting thread, so they do not leak
+// when worker threads come and go
+static void tcaches_thread_exit(void *arg) {
+    (void)arg; // the same as tcache_slots
 
+    utils_mutex_lock(&tcaches_lock);
+    for (unsigned i = 0; i < tcache_slots_size; i++) {
+        if (tcache_slots[i] && tcache_slots[i]->pool) {
+            tcache_destroy(tcache_slots[i]);
+        }
+    }
+    utils_mutex_unlock(&tcaches_lock);
 
+    for (unsigned i = 0; i < tcache_slots_size; i++) {
+        umf_ba_global_free(tcache_slots[i]);
+    }
+    umf_ba_global_free(tcache_slots);
+    tcache_slots = NULL;
+    tcache_slots_size = 0;
+}
 
+static void globals_init(void) {
+    if (!utils_mutex_init(&tcaches_lock)) {
+        LOG_FATAL("Could not initialize the tcaches lock.");
+        return;
+    }
 
+    if (!utils_mutex_init(&arenas_lock)) {
+        LOG_FATAL("Could not initialize the arenas lock.");
+        return;
+    }
 
+    if (pthread_key_create(&tcaches_key, tcaches_thread_exit)) {
+        LOG_FATAL("Could not create the tcaches key.");
+    }
+}
 
+// returns the tcache slot of the pool used by the current thread
+// or NULL if the thread has not used the pool yet
+static inline jemalloc_tcache_slot_t *
+get_tcache_slot(jemalloc_memory_pool_t *je_pool) {
+    unsigned pool_id = je_pool->pool_id;
+    if (pool_id < tcache_slots_size && tcache_slots[pool_id] &&
+        tcache_slots[pool_id]->pool == je_pool) {
+        return tcache_slots[pool_id];
+    }
 
+    return NULL;
+}
 
+// slow path of get_arena() - picks an arena of the pool according to its mode
+// and creates it if it is used for the first time (JEMALLOC_ARENA_NONE if
+// the arena could not be created)
+static unsigned pick_arena(jemalloc_memory_pool_t *je_pool) {
+    assert(je_pool);
+    unsigned cpu, node;
+
+    switch (je_pool->arena_mode) {
+    case UMF_JEMALLOC_POOL_ARENA_MODE_CPU:
+        if (utils_getcpu(&cpu, &node) == 0) {
+            return arena_get_or_create(je_pool, cpu % je_pool->num_arenas);
+        }
+        break;
+    case UMF_JEMALLOC_POOL_ARENA_MODE_NUMA:
+        if (utils_getcpu(&cpu, &node) == 0) {
+            unsigned group = node % je_pool->num_arena_groups;
+            return arena_get_or_create(
+                je_pool, group * je_pool->arenas_per_group +
+                             cpu % je_pool->arenas_per_group);
+        }
+        break;
+    default:
+        break;
+    }
+
+    // UMF_JEMALLOC_POOL_ARENA_MODE_THREAD or getcpu() is not supported
+    return arena_get_or_create(je_pool, tid() % je_pool->num_arenas);
+}
+
+// returns the (possibly new) unused tcache slot of the pool
+// for the current thread or NULL if it could not be allocated
+static jemalloc_tcache_slot_t *alloc_tcache_slot(unsigned pool_id) {
+    if (pool_id >= tcache_slots_size) {
+        unsigned new_size = tcache_slots_size ? 2 * tcache_slots_size : 8;
+        while (new_size <= pool_id) {
+            new_size *= 2;
+        }
 
+        jemalloc_tcache_slot_t **new_slots =
+            umf_ba_global_alloc(new_size * sizeof(*new_slots));
+        if (!new_slots) {
+            return NULL;
+        }
+
+        memset(new_slots, 0, new_size * sizeof(*new_slots));
+        if (tcache_slots) {
+            memcpy(new_slots, tcache_slots,
+                   tcache_slots_size * sizeof(*new_slots));
+            umf_ba_global_free(tcache_slots);
+        }
+        tcache_slots = new_slots;
+        tcache_slots_size = new_size;
+    }
+
+    if (!tcache_slots[pool_id]) {
+        jemalloc_tcache_slot_t *slot =
+            umf_ba_global_alloc(sizeof(jemalloc_tcache_slot_t));
+        if (!slot) {
+            return NULL;
+        }
+
+        memset(slot, 0, sizeof(*slot));
+        tcache_slots[pool_id] = slot;
+    }
+
+    return tcache_slots[pool_id];
+}
+
+// slow path of get_tcache() - creates a tcache of the pool for this thread
+static unsigned create_tcache(jemalloc_memory_pool_t *je_pool) {
+    assert(je_pool);
+    jemalloc_tcache_slot_t *slot = alloc_tcache_slot(je_pool->pool_id);
+    if (!slot) {
+        LOG_ERR("Could not allocate a tcache slot.");
+        // MALLOCX_TCACHE(UINT_MAX) == MALLOCX_TCACHE_NONE
+        return UINT_MAX;
+    }
+    assert(slot->pool == NULL);
+
+    unsigned tcache;
+    size_t sz = sizeof(unsigned);
+    if (je_mallctl("tcache.create", (void *)&tcache, &sz, NULL, 0)) {
+        LOG_ERR("Could not create tcache.");
+        // MALLOCX_TCACHE(UINT_MAX) == MALLOCX_TCACHE_NONE
+        return UINT_MAX;
+    }
+
+    // JEMALLOC_ARENA_NONE if the arena could not be created,
+    // get_arena() tries again then
+    unsigned arena =
+        arena_get_or_create(je_pool, tid() % je_pool->num_arenas);
+
+    utils_mutex_lock(&tcaches_lock);
+    slot->tcache = tcache;
+    slot->arena = arena;
+    slot->prev = NULL;
+    slot->next = je_pool->tcaches;
+    if (slot->next) {
+        slot->next->prev = slot;
+    }
+    je_pool->tcaches = slot;
+    slot->pool = je_pool;
+    utils_mutex_unlock(&tcaches_lock);
+
+    // the value only has to be non-NULL for tcaches_thread_exit() to be called
+    pthread_setspecific(tcaches_key, tcache_slots);
+
+    return tcache;
+}
+
+static inline unsigned get_tcache(jemalloc_memory_pool_t *je_pool) {
+    assert(je_pool);
+    jemalloc_tcache_slot_t *slot = get_tcache_slot(je_pool);
+    if (slot) {
+        return slot->tcache;
+    }
+
+    return create_tcache(je_pool);
+}
+
+static inline unsigned get_arena(jemalloc_memory_pool_t *je_pool) {
+    assert(je_pool);
+    if (je_pool->arena_mode == UMF_JEMALLOC_POOL_ARENA_MODE_THREAD) {
+        jemalloc_tcache_slot_t *slot = get_tcache_slot(je_pool);
+        if (slot && slot->arena != JEMALLOC_ARENA_NONE) {
+            return slot->arena;
+        }
+    }
+
+    return pick_arena(je_pool);
+}
+
+unsigned jemalloc_pool_get_tcache(jemalloc_memory_pool_t *je_pool) {
+    return get_tcache(je_pool);
+}
+
+unsigned jemalloc_pool_get_arena(jemalloc_memory_pool_t *je_pool) {
+    return get_arena(je_pool);
+}
 
 static __TLS umf_result_t TLS_last_allocation_error;
 
@@ -143,7 +328,9 @@ static void *arena_extent_alloc(extent_hooks_t *extent_hooks, void *new_addr,
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
 
     void *ptr = new_addr;
-    ret = umfMemoryProviderAlloc(pool->provider, size, alignment, &ptr);
+    bool zeroed = false;
+    ret = umfMemoryProviderAllocZeroInfo(pool->provider, size, alignment, &ptr,
+                                         &zeroed);
     if (ret != UMF_RESULT_SUCCESS) {
         return NULL;
     }
@@ -161,11 +348,20 @@ static void *arena_extent_alloc(extent_hooks_t *extent_hooks, void *new_addr,
     utils_annotate_memory_inaccessible(ptr, size);
 #endif
 
-    if (*zero) {
+    if (*zero || zeroed) {
         utils_annotate_memory_defined(ptr, size);
-        memset(ptr, 0, size); // TODO: device memory is not accessible by host
     }
 
+    // memory that is already zeroed (e.g. fresh anonymous pages)
+    // is not touched, so its pages are not faulted in here
+    if (*zero && !zeroed) {
+        // TODO: device memory is not accessible by host
+        utils_memzero_nt(ptr, size);
+    }
+
+    // let jemalloc know the extent is zeroed, so it does not zero it again
+    *zero = *zero || zeroed;
+
     *commit = true;
 
     return ptr;
@@ -262,6 +458,10 @@ static bool arena_extent_decommit(extent_hooks_t *extent_hooks, void *addr,
     (void)length;       // unused
     (void)arena_ind;    // unused
 
+    // A forced purge cannot stand in for decommit: jemalloc treats
+    // recommitted pages as zeroed, but the purge does not zero shared,
+    // file or devdax mappings. The memory is still released to the provider
+    // by the purge hooks below.
     // TODO: add this function to the provider API to support Windows and USM
     return true; // true means failure (unsupported)
 }
@@ -299,10 +499,16 @@ static bool arena_extent_purge_forced(extent_hooks_t *extent_hooks, void *addr,
 
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
 
-    umf_result_t ret = umfMemoryProviderPurgeForce(
-        pool->provider, (char *)addr + offset, length);
+    // The pages are released to the provider, but a failure is always
+    // reported: jemalloc treats force-purged extents (e.g. the retained ones
+    // of disable_provider_free pools) as zeroed and skips zeroing them
+    // in calloc, while the forced purge of the provider (MADV_DONTNEED)
+    // does not zero shared, file or devdax mappings. After the failure
+    // jemalloc only tries a lazy purge and keeps the extent as not zeroed.
+    (void)umfMemoryProviderPurgeForce(pool->provider, (char *)addr + offset,
+                                      length);
 
-    return (ret != UMF_RESULT_SUCCESS); // false means success
+    return true; // true means failure
 }
 
 // arena_extent_split - an extent split function conforms to the extent_split_t type and optionally
@@ -322,8 +528,20 @@ static bool arena_extent_split(extent_hooks_t *extent_hooks, void *addr,
 
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
     assert(pool);
-    return umfMemoryProviderAllocationSplit(pool->provider, addr, size,
-                                            size_a) != UMF_RESULT_SUCCESS;
+
+    uint32_t not_supported;
+    utils_atomic_load_acquire_u32(&pool->split_not_supported, &not_supported);
+    if (not_supported) {
+        return true; // the extent remains unsplit
+    }
+
+    umf_result_t ret =
+        umfMemoryProviderAllocationSplit(pool->provider, addr, size, size_a);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        utils_atomic_store_release_u32(&pool->split_not_supported, 1);
+    }
+
+    return ret != UMF_RESULT_SUCCESS;
 }
 
 // arena_extent_merge - an extent merge function conforms to the extent_merge_t type and optionally
@@ -340,9 +558,20 @@ static bool arena_extent_merge(extent_hooks_t *extent_hooks, void *addr_a,
 
     jemalloc_memory_pool_t *pool = get_pool_by_arena_index(arena_ind);
     assert(pool);
-    return umfMemoryProviderAllocationMerge(pool->provider, addr_a, addr_b,
-                                            size_a + size_b) !=
-           UMF_RESULT_SUCCESS;
+
+    uint32_t not_supported;
+    utils_atomic_load_acquire_u32(&pool->merge_not_supported, &not_supported);
+    if (not_supported) {
+        return true; // the extents remain distinct
+    }
+
+    umf_result_t ret = umfMemoryProviderAllocationMerge(
+        pool->provider, addr_a, addr_b, size_a + size_b);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        utils_atomic_store_release_u32(&pool->merge_not_supported, 1);
+    }
+
+    return ret != UMF_RESULT_SUCCESS;
 }
 
 // The extent_hooks_t structure comprises function pointers which are described individually below.
@@ -368,21 +597,20 @@ static extent_hooks_t arena_extent_hooks = {
     .merge = arena_extent_merge,
 };
 
-static void *op_malloc(void *pool, size_t size) {
+// extra_flags are passed to je_mallocx() along with the arena and the tcache
+static void *op_malloc_flags(void *pool, size_t size, int extra_flags) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
     // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
     // the tcache, so we wouldn't be able to guarantee isolation of different providers.
-	
-	/*
-	cycle through arenas associated with our pool
-	use tcache associated with this ppol
-	*/
-	arena_spin++;
-	if(arena_spin>=je_pool->num_arenas){arena_spin=0;}
-	int arena = je_pool->arena_index + arena_spin;
-    // int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(je_pool->tcaches[tid()]);
-    int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool,tid()));
+	// use the arena and the tcache of this thread associated with our pool
+	unsigned arena = get_arena(je_pool);
+    if (arena == JEMALLOC_ARENA_NONE) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+    int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool));
+    flags |= extra_flags;
     void *ptr = je_mallocx(size, flags);
     if (ptr == NULL) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -394,6 +622,10 @@ static void *op_malloc(void *pool, size_t size) {
     return ptr;
 }
 
+static void *op_malloc(void *pool, size_t size) {
+    return op_malloc_flags(pool, size, 0);
+}
+
 static umf_result_t op_free(void *pool, void *ptr) {
     (void)pool; // unused
     assert(pool);
@@ -402,8 +634,7 @@ static umf_result_t op_free(void *pool, void *ptr) {
 
     if (ptr != NULL) {
         VALGRIND_DO_MEMPOOL_FREE(pool, ptr);
-        // je_dallocx(ptr, MALLOCX_TCACHE(je_pool->tcaches[tid()]));
-        je_dallocx(ptr, MALLOCX_TCACHE(get_tcache(je_pool,tid())));
+        je_dallocx(ptr, MALLOCX_TCACHE(get_tcache(je_pool)));
         
     }
 
@@ -413,15 +644,20 @@ static umf_result_t op_free(void *pool, void *ptr) {
 static void *op_calloc(void *pool, size_t num, size_t size) {
     assert(pool);
     size_t csize = num * size;
-    void *ptr = op_malloc(pool, csize);
+
+    // jemalloc zeroes only the memory that is not known to be zeroed,
+    // so large allocations backed by fresh extents (see arena_extent_alloc())
+    // are not touched at all, while reused (also force-purged) extents
+    // are always zeroed (see arena_extent_purge_forced())
+    // TODO: device memory is not accessible by host
+    void *ptr = op_malloc_flags(pool, csize, MALLOCX_ZERO);
     if (ptr == NULL) {
-        // TLS_last_allocation_error is set by op_malloc()
+        // TLS_last_allocation_error is set by op_malloc_flags()
         return NULL;
     }
 
     utils_annotate_memory_defined(ptr, num * size);
 
-    memset(ptr, 0, csize); // TODO: device memory is not accessible by host
     return ptr;
 }
 
@@ -430,8 +666,7 @@ static void *op_realloc(void *pool, void *ptr, size_t size) {
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
 
     if (size == 0 && ptr != NULL) {
-        // je_dallocx(ptr, MALLOCX_TCACHE(je_pool->tcaches[tid()]));
-        je_dallocx(ptr, MALLOCX_TCACHE(get_tcache(je_pool,tid())));
+        je_dallocx(ptr, MALLOCX_TCACHE(get_tcache(je_pool)));
         TLS_last_allocation_error = UMF_RESULT_SUCCESS;
         VALGRIND_DO_MEMPOOL_FREE(pool, ptr);
         return NULL;
@@ -440,11 +675,12 @@ static void *op_realloc(void *pool, void *ptr, size_t size) {
     }
     // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
     // the tcache, so we wouldn't be able to guarantee isolation of different providers.
-	arena_spin++;
-	if(arena_spin>=je_pool->num_arenas){arena_spin=0;}
-	int arena = je_pool->arena_index + arena_spin;
-    // int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(je_pool->tcaches[tid()]);
-    int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool,tid()));
+	unsigned arena = get_arena(je_pool);
+    if (arena == JEMALLOC_ARENA_NONE) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+    int flags = MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool));
     void *new_ptr = je_rallocx(ptr, size, flags);
     if (new_ptr == NULL) {
         TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -465,11 +701,12 @@ static void *op_realloc(void *pool, void *ptr, size_t size) {
 static void *op_aligned_alloc(void *pool, size_t size, size_t alignment) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-	arena_spin++;
-	if(arena_spin>=je_pool->num_arenas){arena_spin=0;}
-	int arena = je_pool->arena_index + arena_spin;
-    // int flags = MALLOCX_ALIGN(alignment) | MALLOCX_ARENA(arena) | MALLOCX_TCACHE(je_pool->tcaches[tid()]);
-    int flags = MALLOCX_ALIGN(alignment) | MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool,tid()));
+	unsigned arena = get_arena(je_pool);
+    if (arena == JEMALLOC_ARENA_NONE) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+    int flags = MALLOCX_ALIGN(alignment) | MALLOCX_ARENA(arena) | MALLOCX_TCACHE(get_tcache(je_pool));
     // MALLOCX_TCACHE_NONE is set, because jemalloc can mix objects from different arenas inside
     // the tcache, so we wouldn't be able to guarantee isolation of different providers.
     void *ptr = je_mallocx(size, flags);
@@ -483,6 +720,102 @@ static void *op_aligned_alloc(void *pool, size_t size, size_t alignment) {
     return ptr;
 }
 
+static bool decay_ms_is_valid(int64_t decay_ms) {
+    return decay_ms >= -1 || decay_ms == UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT;
+}
+
+// name is "dirty_decay_ms" or "muzzy_decay_ms"
+static int arena_set_decay_ms(unsigned arena_ind, const char *name,
+                              int64_t decay_ms) {
+    if (decay_ms == UMF_JEMALLOC_POOL_DECAY_MS_DEFAULT) {
+        return 0;
+    }
+
+    char cmd[64];
+    ssize_t value = (ssize_t)decay_ms;
+    snprintf(cmd, sizeof(cmd), "arena.%u.%s", arena_ind, name);
+    int err = je_mallctl(cmd, NULL, NULL, (void *)&value, sizeof(value));
+    if (err) {
+        LOG_ERR("Could not set %s of arena %u.", name, arena_ind);
+    }
+
+    return err;
+}
+
+static void arena_destroy(unsigned arena_ind) {
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "arena.%u.destroy", arena_ind);
+    je_mallctl(cmd, NULL, 0, NULL, 0);
+    pool_by_arena_index[arena_ind] = NULL;
+}
+
+// must be called with arenas_lock held
+static unsigned arena_create(jemalloc_memory_pool_t *je_pool) {
+    extent_hooks_t *pHooks = &arena_extent_hooks;
+    size_t unsigned_size = sizeof(unsigned);
+    unsigned arena_ind;
+
+    // the arena is created with the default hooks, so its metadata
+    // is not allocated from the memory provider
+    if (je_mallctl("arenas.create", (void *)&arena_ind, &unsigned_size, NULL,
+                   0)) {
+        LOG_ERR("Could not create arena.");
+        return JEMALLOC_ARENA_NONE;
+    }
+
+    // the hooks look up the pool by the arena index
+    pool_by_arena_index[arena_ind] = je_pool;
+
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "arena.%u.extent_hooks", arena_ind);
+    if (je_mallctl(cmd, NULL, NULL, (void *)&pHooks, sizeof(void *))) {
+        LOG_ERR("Could not setup extent_hooks for newly created arena.");
+        arena_destroy(arena_ind);
+        return JEMALLOC_ARENA_NONE;
+    }
+
+    if (arena_set_decay_ms(arena_ind, "dirty_decay_ms",
+                           je_pool->dirty_decay_ms) ||
+        arena_set_decay_ms(arena_ind, "muzzy_decay_ms",
+                           je_pool->muzzy_decay_ms)) {
+        arena_destroy(arena_ind);
+        return JEMALLOC_ARENA_NONE;
+    }
+
+    return arena_ind;
+}
+
+// returns the index of the idx-th jemalloc arena of the pool,
+// creating the arena on its first use (JEMALLOC_ARENA_NONE on failure)
+static unsigned arena_get_or_create(jemalloc_memory_pool_t *je_pool,
+                                    unsigned idx) {
+    assert(idx < je_pool->num_arenas);
+
+    unsigned arena_ind;
+    utils_atomic_load_acquire_u32(&je_pool->arenas[idx], &arena_ind);
+    if (arena_ind != JEMALLOC_ARENA_NONE) {
+        return arena_ind;
+    }
+
+    utils_mutex_lock(&arenas_lock);
+    arena_ind = je_pool->arenas[idx];
+    if (arena_ind == JEMALLOC_ARENA_NONE) {
+        arena_ind = arena_create(je_pool);
+        utils_atomic_store_release_u32(&je_pool->arenas[idx], arena_ind);
+    }
+    utils_mutex_unlock(&arenas_lock);
+
+    return arena_ind;
+}
+
+// returns the index of the idx-th jemalloc arena of the pool
+// or JEMALLOC_ARENA_NONE if it was not used yet
+static unsigned arena_at(jemalloc_memory_pool_t *je_pool, unsigned idx) {
+    unsigned arena_ind;
+    utils_atomic_load_acquire_u32(&je_pool->arenas[idx], &arena_ind);
+    return arena_ind;
+}
+
 static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
                                   void *params, void **out_pool) {
     assert(provider);
@@ -491,9 +824,29 @@ static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
     umf_jemalloc_pool_params_t *je_params =
         (umf_jemalloc_pool_params_t *)params;
 
-    extent_hooks_t *pHooks = &arena_extent_hooks;
-    size_t unsigned_size = sizeof(unsigned);
-    int err;
+    umf_jemalloc_pool_params_t default_params = umfJemallocPoolParamsDefault();
+    if (!je_params) {
+        je_params = &default_params;
+    }
+
+    if (je_params->arena_mode > UMF_JEMALLOC_POOL_ARENA_MODE_NUMA) {
+        LOG_ERR("Invalid arena mode: %d.", (int)je_params->arena_mode);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!decay_ms_is_valid(je_params->dirty_decay_ms) ||
+        !decay_ms_is_valid(je_params->muzzy_decay_ms)) {
+        LOG_ERR("Invalid decay time: dirty %lld ms, muzzy %lld ms.",
+                (long long)je_params->dirty_decay_ms,
+                (long long)je_params->muzzy_decay_ms);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (je_params->num_arenas >= MALLOCX_ARENA_MAX) {
+        LOG_ERR("Too many arenas: %u (max: %u).", je_params->num_arenas,
+                (unsigned)MALLOCX_ARENA_MAX - 1);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
     jemalloc_memory_pool_t *pool =
         umf_ba_global_alloc(sizeof(jemalloc_memory_pool_t));
@@ -502,89 +855,108 @@ static umf_result_t op_initialize(umf_memory_provider_handle_t provider,
     }
 
     pool->provider = provider;
-	pool->num_arenas = 160;
-    pool->tcaches_size = 1;
-    printf("Tcaches_size is %zu\n",pool->tcaches_size);
-    pool->tcaches = malloc(pool->tcaches_size * sizeof(unsigned));
-    int lk_init_fail = pthread_rwlock_init(&pool->tcaches_resize_lk, NULL);
-    assert(lk_init_fail==0);
-    if (je_params) {
-        pool->disable_provider_free = je_params->disable_provider_free;
-    } else {
-        pool->disable_provider_free = false;
-    }
-
-	unsigned new_arena_index;
-	for(unsigned i = 0; i<pool->num_arenas; i++){
-		err = je_mallctl("arenas.create", (void *)&new_arena_index, &unsigned_size,
-						 NULL, 0);
-		if (err) {
-			LOG_ERR("Could not create arena.");
-			goto err_free_pool;
-		}
-
-		// setup extent_hooks for newly created arena
-		char cmd[64];
-		snprintf(cmd, sizeof(cmd), "arena.%u.extent_hooks", new_arena_index);
-		err = je_mallctl(cmd, NULL, NULL, (void *)&pHooks, sizeof(void *));
-		if (err) {
-			snprintf(cmd, sizeof(cmd), "arena.%u.destroy", new_arena_index);
-			je_mallctl(cmd, NULL, 0, NULL, 0);
-			LOG_ERR("Could not setup extent_hooks for newly created arena.");
-			goto err_free_pool;
-		}
-
-		if(i == 0){
-			pool->arena_index = new_arena_index; // set the base index
-		}
-		pool_by_arena_index[new_arena_index] = pool;
-
-		*out_pool = (umf_memory_pool_handle_t)pool;
-
-		VALGRIND_DO_CREATE_MEMPOOL(pool, 0, 0);
-	}
-	
-	// assert(MAX_JEMALLOC_THREADS<250);
-    assert(pool);
-    printf("Initial size:: %zu\n",pool->tcaches_size);
-    // changed i < MAX_JEMALLOC_THREADS to i < tcaches_size
-    for(unsigned i = 0; i<pool->tcaches_size;i++){
-	// for(unsigned i = 0; i<MAX_JEMALLOC_THREADS;i++){
-		unsigned tcache;
-		size_t sz = sizeof(unsigned);
-		je_mallctl("tcache.create",&tcache,&sz,NULL,0);
-		// pool->tcaches[i] = tcache;
-        set_tcache(pool,i,tcache);
-		// printf("Creating tcache: %d\n",tcache);
-	}
-	
-    return UMF_RESULT_SUCCESS;
+    pool->disable_provider_free = je_params->disable_provider_free;
+    pool->split_not_supported = 0;
+    pool->merge_not_supported = 0;
+    pool->dirty_decay_ms = je_params->dirty_decay_ms;
+    pool->muzzy_decay_ms = je_params->muzzy_decay_ms;
+    pool->arena_mode = je_params->arena_mode;
+    pool->num_arenas = je_params->num_arenas;
+    if (pool->num_arenas == 0) {
+        pool->num_arenas = utils_get_num_cpus();
+    }
+
+    // arenas are created lazily, on the first use by a thread,
+    // so creating a pool is cheap
+    pool->arenas = umf_ba_global_alloc(pool->num_arenas * sizeof(unsigned));
+    if (!pool->arenas) {
+        umf_ba_global_free(pool);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    for (unsigned i = 0; i < pool->num_arenas; i++) {
+        pool->arenas[i] = JEMALLOC_ARENA_NONE;
+    }
 
-err_free_pool:
-	assert(false && "Failed to create a pool, error checking not implemented");
-	exit(-1);
-    umf_ba_global_free(pool);
-    return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    // each NUMA node gets its own group of arenas, as long as there are enough
+    // arenas - the ones that do not fill up a whole group are not used
+    pool->num_arena_groups = 1;
+    if (pool->arena_mode == UMF_JEMALLOC_POOL_ARENA_MODE_NUMA) {
+        pool->num_arena_groups = utils_get_num_numa_nodes();
+        if (pool->num_arena_groups > pool->num_arenas) {
+            pool->num_arena_groups = pool->num_arenas;
+        }
+    }
+    pool->arenas_per_group = pool->num_arenas / pool->num_arena_groups;
+    pool->tcaches = NULL;
+
+    utils_init_once(&globals_init_flag, globals_init);
+
+    // tcaches are created lazily, on the first allocation of each thread
+    utils_mutex_lock(&tcaches_lock);
+    unsigned pool_id = 0;
+    while (pool_id < pool_by_id_size && pool_by_id[pool_id]) {
+        pool_id++;
+    }
+    if (pool_id == pool_by_id_size) {
+        unsigned new_size = pool_by_id_size ? 2 * pool_by_id_size : 8;
+        jemalloc_memory_pool_t **new_pool_by_id =
+            umf_ba_global_alloc(new_size * sizeof(*new_pool_by_id));
+        if (!new_pool_by_id) {
+            utils_mutex_unlock(&tcaches_lock);
+            LOG_ERR("Could not allocate the table of jemalloc pools.");
+            umf_ba_global_free(pool->arenas);
+            umf_ba_global_free(pool);
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        memset(new_pool_by_id, 0, new_size * sizeof(*new_pool_by_id));
+        if (pool_by_id) {
+            memcpy(new_pool_by_id, pool_by_id,
+                   pool_by_id_size * sizeof(*new_pool_by_id));
+            umf_ba_global_free(pool_by_id);
+        }
+        pool_by_id = new_pool_by_id;
+        pool_by_id_size = new_size;
+    }
+    pool_by_id[pool_id] = pool;
+    num_pools++;
+    utils_mutex_unlock(&tcaches_lock);
+
+    pool->pool_id = pool_id;
+
+    VALGRIND_DO_CREATE_MEMPOOL(pool, 0, 0);
+
+    *out_pool = (umf_memory_pool_handle_t)pool;
+
+    return UMF_RESULT_SUCCESS;
 }
 
 static void op_finalize(void *pool) {
     assert(pool);
     jemalloc_memory_pool_t *je_pool = (jemalloc_memory_pool_t *)pool;
-    char cmd[64];
-	for(unsigned i = 0; i<je_pool->num_arenas; i++){
-		snprintf(cmd, sizeof(cmd), "arena.%u.destroy", je_pool->arena_index);
-		je_mallctl(cmd, NULL, 0, NULL, 0);
-		pool_by_arena_index[je_pool->arena_index] = NULL;		
-	}
-    // replace MAX_JEMALLOC_THREADS with pool->tcaches_size
-	// for(unsigned i = 0; i< MAX_JEMALLOC_THREADS;i++){
-    for(unsigned i = 0; i< je_pool->tcaches_size;i++){
-		// unsigned tcache = je_pool->tcaches[i];
-        unsigned tcache = get_tcache(je_pool,i);
-		size_t sz = sizeof(unsigned);
-		je_mallctl("tcache.destroy",NULL,0,&tcache,sz);
-	}
-	free(je_pool->tcaches); 
+
+    // destroy the tcaches of all threads first,
+    // so no cached objects are left behind in the destroyed arenas
+    utils_mutex_lock(&tcaches_lock);
+    while (je_pool->tcaches) {
+        tcache_destroy(je_pool->tcaches);
+    }
+    pool_by_id[je_pool->pool_id] = NULL;
+    if (--num_pools == 0) {
+        umf_ba_global_free(pool_by_id);
+        pool_by_id = NULL;
+        pool_by_id_size = 0;
+    }
+    utils_mutex_unlock(&tcaches_lock);
+
+    // destroy all arenas the pool has created
+    for (unsigned i = 0; i < je_pool->num_arenas; i++) {
+        if (je_pool->arenas[i] != JEMALLOC_ARENA_NONE) {
+            arena_destroy(je_pool->arenas[i]);
+        }
+    }
+
+    umf_ba_global_free(je_pool->arenas);
     umf_ba_global_free(je_pool);
 
     VALGRIND_DO_DESTROY_MEMPOOL(pool);
@@ -616,3 +988,382 @@ static umf_memory_pool_ops_t UMF_JEMALLOC_POOL_OPS = {
 umf_memory_pool_ops_t *umfJemallocPoolOps(void) {
     return &UMF_JEMALLOC_POOL_OPS;
 }
+
+umf_result_t umfJemallocPoolPurge(umf_memory_pool_handle_t hPool) {
+    if (!hPool || hPool->ops.initialize != op_initialize) {
+        LOG_ERR("Not a jemalloc pool.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    jemalloc_memory_pool_t *je_pool =
+        (jemalloc_memory_pool_t *)hPool->pool_priv;
+    assert(je_pool);
+
+    // objects cached in the tcache are still in use for the arena
+    jemalloc_tcache_slot_t *slot = get_tcache_slot(je_pool);
+    if (slot) {
+        je_mallctl("tcache.flush", NULL, NULL, (void *)&slot->tcache,
+                   sizeof(unsigned));
+    }
+
+    char cmd[64];
+    for (unsigned i = 0; i < je_pool->num_arenas; i++) {
+        unsigned arena_ind = arena_at(je_pool, i);
+        if (arena_ind == JEMALLOC_ARENA_NONE) {
+            continue;
+        }
+
+        snprintf(cmd, sizeof(cmd), "arena.%u.purge", arena_ind);
+        if (je_mallctl(cmd, NULL, NULL, NULL, 0)) {
+            LOG_ERR("Could not purge arena %u.", arena_ind);
+            return UMF_RESULT_ERROR_UNKNOWN;
+        }
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// statistics read with je_mallctlbymib(), see stats_mibs_init()
+enum {
+    STATS_PACTIVE,
+    STATS_PDIRTY,
+    STATS_PMUZZY,
+    STATS_MAPPED,
+    STATS_RESIDENT,
+    STATS_SMALL_ALLOCATED,
+    STATS_SMALL_NMALLOC,
+    STATS_SMALL_NDALLOC,
+    STATS_LARGE_ALLOCATED,
+    STATS_LARGE_NMALLOC,
+    STATS_LARGE_NDALLOC,
+    STATS_BIN_NMALLOC,
+    STATS_BIN_NDALLOC,
+    STATS_BIN_CURREGS,
+    STATS_LEXTENT_NMALLOC,
+    STATS_LEXTENT_NDALLOC,
+    STATS_LEXTENT_CURLEXTENTS,
+    STATS_BIN_SIZE,
+    STATS_LEXTENT_SIZE,
+    STATS_MAX
+};
+
+#define STATS_MIB_MAX_LEN 6
+
+typedef struct stats_mib_t {
+    const char *name;
+    // positions of the arena and size class indices in the MIB (0 if none)
+    size_t arena_pos;
+    size_t class_pos;
+    size_t size; // size of the value: sizeof(size_t) or sizeof(uint64_t)
+    size_t mib[STATS_MIB_MAX_LEN];
+    size_t miblen;
+} stats_mib_t;
+
+#define STATS_MIB(name_, arena_pos_, class_pos_, type_)                        \
+    {                                                                          \
+        .name = (name_), .arena_pos = (arena_pos_), .class_pos = (class_pos_), \
+        .size = sizeof(type_)                                                  \
+    }
+
+// translating the names once and filling in only the indices afterwards
+// is much cheaper than parsing the names in je_mallctl() on every read
+static stats_mib_t stats_mibs[STATS_MAX] = {
+    STATS_MIB("stats.arenas.0.pactive", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.pdirty", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.pmuzzy", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.mapped", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.resident", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.small.allocated", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.small.nmalloc", 2, 0, uint64_t),
+    STATS_MIB("stats.arenas.0.small.ndalloc", 2, 0, uint64_t),
+    STATS_MIB("stats.arenas.0.large.allocated", 2, 0, size_t),
+    STATS_MIB("stats.arenas.0.large.nmalloc", 2, 0, uint64_t),
+    STATS_MIB("stats.arenas.0.large.ndalloc", 2, 0, uint64_t),
+    STATS_MIB("stats.arenas.0.bins.0.nmalloc", 2, 4, uint64_t),
+    STATS_MIB("stats.arenas.0.bins.0.ndalloc", 2, 4, uint64_t),
+    STATS_MIB("stats.arenas.0.bins.0.curregs", 2, 4, size_t),
+    STATS_MIB("stats.arenas.0.lextents.0.nmalloc", 2, 4, uint64_t),
+    STATS_MIB("stats.arenas.0.lextents.0.ndalloc", 2, 4, uint64_t),
+    STATS_MIB("stats.arenas.0.lextents.0.curlextents", 2, 4, size_t),
+    STATS_MIB("arenas.bin.0.size", 0, 2, size_t),
+    STATS_MIB("arenas.lextent.0.size", 0, 2, size_t),
+};
+
+static UTIL_ONCE_FLAG stats_init_flag = UTIL_ONCE_FLAG_INIT;
+static bool stats_supported;
+static size_t stats_page_size;
+static unsigned stats_nbins;
+static unsigned stats_nlextents;
+
+static void stats_mibs_init(void) {
+    bool config_stats = false;
+    size_t len = sizeof(config_stats);
+    if (je_mallctl("config.stats", &config_stats, &len, NULL, 0) ||
+        !config_stats) {
+        LOG_ERR("jemalloc was built without statistics.");
+        return;
+    }
+
+    len = sizeof(stats_page_size);
+    if (je_mallctl("arenas.page", &stats_page_size, &len, NULL, 0)) {
+        LOG_ERR("Could not read arenas.page.");
+        return;
+    }
+
+    len = sizeof(stats_nbins);
+    if (je_mallctl("arenas.nbins", &stats_nbins, &len, NULL, 0)) {
+        LOG_ERR("Could not read arenas.nbins.");
+        return;
+    }
+
+    len = sizeof(stats_nlextents);
+    if (je_mallctl("arenas.nlextents", &stats_nlextents, &len, NULL, 0)) {
+        LOG_ERR("Could not read arenas.nlextents.");
+        return;
+    }
+
+    for (int i = 0; i < STATS_MAX; i++) {
+        stats_mibs[i].miblen = STATS_MIB_MAX_LEN;
+        if (je_mallctlnametomib(stats_mibs[i].name, stats_mibs[i].mib,
+                                &stats_mibs[i].miblen)) {
+            LOG_ERR("Could not translate %s.", stats_mibs[i].name);
+            return;
+        }
+    }
+
+    stats_supported = true;
+}
+
+static int stats_read(int stat, unsigned arena_ind, unsigned class_ind,
+                      void *val) {
+    stats_mib_t *stats_mib = &stats_mibs[stat];
+    size_t mib[STATS_MIB_MAX_LEN];
+    size_t size = stats_mib->size;
+
+    memcpy(mib, stats_mib->mib, sizeof(mib));
+    if (stats_mib->arena_pos) {
+        mib[stats_mib->arena_pos] = arena_ind;
+    }
+    if (stats_mib->class_pos) {
+        mib[stats_mib->class_pos] = class_ind;
+    }
+
+    return je_mallctlbymib(mib, stats_mib->miblen, val, &size, NULL, 0);
+}
+
+// sums up a statistic over all arenas of the pool
+static void stats_sum(jemalloc_memory_pool_t *je_pool, int stat,
+                      unsigned class_ind, uint64_t *sum) {
+    *sum = 0;
+    for (unsigned i = 0; i < je_pool->num_arenas; i++) {
+        unsigned arena_ind = arena_at(je_pool, i);
+        if (arena_ind == JEMALLOC_ARENA_NONE) {
+            continue;
+        }
+
+        union {
+            size_t size;
+            uint64_t u64;
+        } val;
+
+        // reading fails only if the arena was created
+        // after the statistics were refreshed - it has nothing to add then
+        if (stats_read(stat, arena_ind, class_ind, &val)) {
+            continue;
+        }
+
+        *sum += (stats_mibs[stat].size == sizeof(uint64_t)) ? val.u64
+                                                            : val.size;
+    }
+}
+
+static umf_result_t stats_refresh(umf_memory_pool_handle_t hPool,
+                                  jemalloc_memory_pool_t **je_pool) {
+    if (!hPool || hPool->ops.initialize != op_initialize) {
+        LOG_ERR("Not a jemalloc pool.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    utils_init_once(&stats_init_flag, stats_mibs_init);
+    if (!stats_supported) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    // the statistics are a snapshot taken when the epoch is advanced
+    uint64_t epoch = 1;
+    size_t len = sizeof(epoch);
+    if (je_mallctl("epoch", &epoch, &len, &epoch, len)) {
+        LOG_ERR("Could not refresh the statistics.");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    *je_pool = (jemalloc_memory_pool_t *)hPool->pool_priv;
+    assert(*je_pool);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void stats_get(jemalloc_memory_pool_t *je_pool,
+                      umf_jemalloc_pool_stats_t *stats) {
+    uint64_t sums[STATS_LARGE_NDALLOC + 1];
+
+    for (int stat = 0; stat <= STATS_LARGE_NDALLOC; stat++) {
+        stats_sum(je_pool, stat, 0, &sums[stat]);
+    }
+
+    stats->num_arenas = 0;
+    for (unsigned i = 0; i < je_pool->num_arenas; i++) {
+        if (arena_at(je_pool, i) != JEMALLOC_ARENA_NONE) {
+            stats->num_arenas++;
+        }
+    }
+    stats->allocated =
+        (size_t)(sums[STATS_SMALL_ALLOCATED] + sums[STATS_LARGE_ALLOCATED]);
+    stats->active = (size_t)sums[STATS_PACTIVE] * stats_page_size;
+    stats->resident = (size_t)sums[STATS_RESIDENT];
+    stats->mapped = (size_t)sums[STATS_MAPPED];
+    stats->dirty = (size_t)sums[STATS_PDIRTY] * stats_page_size;
+    stats->muzzy = (size_t)sums[STATS_PMUZZY] * stats_page_size;
+    stats->nmalloc = sums[STATS_SMALL_NMALLOC] + sums[STATS_LARGE_NMALLOC];
+    stats->ndalloc = sums[STATS_SMALL_NDALLOC] + sums[STATS_LARGE_NDALLOC];
+}
+
+// fills min(*count, number of size classes) entries of stats
+static umf_result_t
+stats_get_size_classes(jemalloc_memory_pool_t *je_pool,
+                       umf_jemalloc_pool_size_class_stats_t *stats,
+                       size_t *count) {
+    size_t num_classes = (size_t)stats_nbins + stats_nlextents;
+    if (*count > num_classes) {
+        *count = num_classes;
+    }
+
+    for (size_t c = 0; c < *count; c++) {
+        // small size classes (bins) go first, then the large ones
+        bool small = c < stats_nbins;
+        unsigned ind = small ? (unsigned)c : (unsigned)(c - stats_nbins);
+        int first_stat = small ? STATS_BIN_NMALLOC : STATS_LEXTENT_NMALLOC;
+        uint64_t sums[3];
+
+        if (stats_read(small ? STATS_BIN_SIZE : STATS_LEXTENT_SIZE, 0, ind,
+                       &stats[c].size)) {
+            LOG_ERR("Could not read the size of size class %zu.", c);
+            return UMF_RESULT_ERROR_UNKNOWN;
+        }
+
+        // nmalloc, ndalloc and the current number of objects
+        for (int i = 0; i < 3; i++) {
+            stats_sum(je_pool, first_stat + i, ind, &sums[i]);
+        }
+
+        stats[c].nmalloc = sums[0];
+        stats[c].ndalloc = sums[1];
+        stats[c].curobjs = (size_t)sums[2];
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfJemallocPoolGetStats(umf_memory_pool_handle_t hPool,
+                                     umf_jemalloc_pool_stats_t *stats) {
+    if (!stats) {
+        LOG_ERR("stats is NULL.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    jemalloc_memory_pool_t *je_pool = NULL;
+    umf_result_t ret = stats_refresh(hPool, &je_pool);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    stats_get(je_pool, stats);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfJemallocPoolGetSizeClassStats(umf_memory_pool_handle_t hPool,
+                                 umf_jemalloc_pool_size_class_stats_t *stats,
+                                 size_t *count) {
+    if (!count) {
+        LOG_ERR("count is NULL.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    jemalloc_memory_pool_t *je_pool = NULL;
+    umf_result_t ret = stats_refresh(hPool, &je_pool);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    if (!stats) {
+        *count = (size_t)stats_nbins + stats_nlextents;
+        return UMF_RESULT_SUCCESS;
+    }
+
+    return stats_get_size_classes(je_pool, stats, count);
+}
+
+umf_result_t umfJemallocPoolDumpStats(umf_memory_pool_handle_t hPool,
+                                      void (*write_cb)(void *arg,
+                                                       const char *str),
+                                      void *arg) {
+    if (!write_cb) {
+        LOG_ERR("write_cb is NULL.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    jemalloc_memory_pool_t *je_pool = NULL;
+    umf_result_t ret = stats_refresh(hPool, &je_pool);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    umf_jemalloc_pool_stats_t stats;
+    stats_get(je_pool, &stats);
+
+    size_t count = (size_t)stats_nbins + stats_nlextents;
+    umf_jemalloc_pool_size_class_stats_t *class_stats =
+        umf_ba_global_alloc(count * sizeof(*class_stats));
+    if (!class_stats) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    ret = stats_get_size_classes(je_pool, class_stats, &count);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto err_free_class_stats;
+    }
+
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"num_arenas\":%u,\"allocated\":%zu,\"active\":%zu,"
+             "\"resident\":%zu,\"mapped\":%zu,\"dirty\":%zu,"
+             "\"muzzy\":%zu,\"nmalloc\":%" PRIu64 ",\"ndalloc\":%" PRIu64
+             ",\"size_classes\":[",
+             stats.num_arenas, stats.allocated, stats.active, stats.resident,
+             stats.mapped, stats.dirty, stats.muzzy, stats.nmalloc,
+             stats.ndalloc);
+    write_cb(arg, buf);
+
+    const char *sep = "";
+    for (size_t c = 0; c < count; c++) {
+        if (class_stats[c].nmalloc == 0) {
+            continue;
+        }
+
+        snprintf(buf, sizeof(buf),
+                 "%s{\"size\":%zu,\"nmalloc\":%" PRIu64
+                 ",\"ndalloc\":%" PRIu64 ",\"curobjs\":%zu}",
+                 sep, class_stats[c].size, class_stats[c].nmalloc,
+                 class_stats[c].ndalloc, class_stats[c].curobjs);
+        write_cb(arg, buf);
+        sep = ",";
+    }
+
+    write_cb(arg, "]}");
+
+err_free_class_stats:
+    umf_ba_global_free(class_stats);
+    return ret;
+}
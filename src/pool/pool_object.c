@@ -0,0 +1,519 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/memory_pool_ops.h>
+#include <umf/pools/pool_object.h>
+
+#include "base_alloc_global.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+// The object pool allocates objects of a single size from slabs
+// of the memory provider. Slabs are aligned to their size, so the header
+// of the slab of an object is found by aligning the address of the object
+// down - free() needs neither a size class lookup nor the memory tracker.
+//
+// Layout of a slab:
+// | header | (padding) | object 0 | object 1 | ... | object n-1 | (unused) |
+//
+// Free objects are kept in intrusive lists, one per CPU (the address of
+// the next free object is stored in the first 8 bytes of the free object):
+// - the local list is a lock-free stack with an ABA tag; objects are popped
+//   from the list of the current CPU and pushed back to it when they are
+//   freed on the CPU their slab belongs to (the home CPU of the slab),
+// - the remote list collects objects freed on other CPUs; it is taken over
+//   as a whole (that is immune to ABA) when the local list is empty,
+//   so objects passed between threads return to the CPU they came from.
+// When both lists are empty, free objects are taken from the local
+// and remote lists of other CPUs and only then a new slab is allocated. Slabs are returned
+// to the memory provider when the pool is destroyed.
+//
+// If the UMF_OBJECT_POOL_LISTS environment variable contains "per_thread"
+// when the pool is created, the pool has OBJECT_MAX_LISTS lists and they
+// are given to threads (round-robin, in the order in which the threads
+// first use an object pool) instead of CPUs. It lets the handoff of objects
+// between lists be tested on a machine with a single CPU.
+
+#define OBJECT_LIST_SHIFT 4 // objects are aligned to at least 16 bytes
+#define OBJECT_LIST_PTR_BITS 44
+#define OBJECT_LIST_PTR_MASK (((uint64_t)1 << OBJECT_LIST_PTR_BITS) - 1)
+#define OBJECT_LIST_PTR_LIMIT                                                  \
+    ((uint64_t)1 << (OBJECT_LIST_PTR_BITS + OBJECT_LIST_SHIFT))
+
+#define OBJECT_SLAB_SIZE_MIN ((size_t)64 * 1024)
+#define OBJECT_SLAB_MIN_OBJECTS 16
+#define OBJECT_MAX_LISTS 64
+#define OBJECT_CACHE_LINE_SIZE 64
+
+typedef struct object_list_t {
+    uint64_t local;  // (ABA tag << 44) | (address of the first object >> 4)
+    uint64_t remote; // address of the first object freed on another CPU
+    char padding[OBJECT_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+} object_list_t;
+
+typedef struct object_memory_pool_t object_memory_pool_t;
+
+typedef struct object_slab_t {
+    object_memory_pool_t *pool;
+    struct object_slab_t *next; // next slab of the pool
+    unsigned home;              // index of the list of the home CPU
+} object_slab_t;
+
+struct object_memory_pool_t {
+    umf_memory_provider_handle_t provider;
+    size_t object_size;
+    size_t alignment;
+    size_t stride; // object size aligned up to the alignment
+    size_t slab_size;
+    size_t first_offset; // offset of the first object in a slab
+    size_t n_objects;    // number of objects in a slab
+    unsigned n_lists;
+    object_list_t *lists;
+    bool lists_per_thread; // see UMF_OBJECT_POOL_LISTS above
+
+    // protects the list of slabs
+    utils_mutex_t lock;
+    object_slab_t *slabs;
+};
+
+static __TLS umf_result_t TLS_last_allocation_error;
+
+// sequence number of the thread used with UMF_OBJECT_POOL_LISTS=per_thread
+static __TLS uint32_t TLS_thread_seq;
+static uint32_t thread_seq_last;
+
+static inline uint64_t list_head(uint64_t head, uint64_t addr) {
+    uint64_t tag = (head >> OBJECT_LIST_PTR_BITS) + 1;
+    return (tag << OBJECT_LIST_PTR_BITS) | (addr >> OBJECT_LIST_SHIFT);
+}
+
+static inline uint64_t list_addr(uint64_t head) {
+    return (head & OBJECT_LIST_PTR_MASK) << OBJECT_LIST_SHIFT;
+}
+
+// push the objects linked from 'first' to 'last' to the local list
+static void local_push(object_list_t *list, uint64_t first, uint64_t last) {
+    volatile uint64_t *last_next = (uint64_t *)last;
+    uint64_t head;
+    utils_atomic_load_acquire(&list->local, &head);
+    do {
+        *last_next = list_addr(head);
+    } while (!utils_compare_exchange(&list->local, &head,
+                                     list_head(head, first)));
+}
+
+static uint64_t local_pop(object_list_t *list) {
+    uint64_t head;
+    utils_atomic_load_acquire(&list->local, &head);
+    do {
+        uint64_t addr = list_addr(head);
+        if (addr == 0) {
+            return 0;
+        }
+
+        // the object can be popped and reused concurrently, so its 'next'
+        // can be a garbage, but then the tag of the head has changed
+        // and the exchange fails
+        volatile uint64_t *next = (uint64_t *)addr;
+        uint64_t new_head = list_head(head, *next);
+        if (utils_compare_exchange(&list->local, &head, new_head)) {
+            return addr;
+        }
+    } while (1);
+}
+
+static void remote_push(object_list_t *list, uint64_t addr) {
+    volatile uint64_t *next = (uint64_t *)addr;
+    uint64_t head;
+    utils_atomic_load_acquire(&list->remote, &head);
+    do {
+        *next = head;
+    } while (!utils_compare_exchange(&list->remote, &head, addr));
+}
+
+// take over all objects of the remote list
+static uint64_t remote_take(object_list_t *list) {
+    uint64_t head;
+    utils_atomic_load_acquire(&list->remote, &head);
+    do {
+        if (head == 0) {
+            return 0;
+        }
+    } while (!utils_compare_exchange(&list->remote, &head, 0));
+
+    return head;
+}
+
+// take over the remote list: the first object is returned,
+// the rest is added to the local list of the same CPU
+static uint64_t remote_drain(object_list_t *list) {
+    uint64_t addr = remote_take(list);
+    if (addr) {
+        uint64_t first = *(uint64_t *)(uintptr_t)addr;
+        if (first) {
+            uint64_t last = first;
+            while (*(uint64_t *)(uintptr_t)last) {
+                last = *(uint64_t *)(uintptr_t)last;
+            }
+            local_push(list, first, last);
+        }
+    }
+
+    return addr;
+}
+
+static inline unsigned list_index(object_memory_pool_t *pool) {
+    if (pool->lists_per_thread) {
+        if (TLS_thread_seq == 0) {
+            TLS_thread_seq = utils_atomic_increment_u32(&thread_seq_last);
+        }
+        return TLS_thread_seq % pool->n_lists;
+    }
+
+    unsigned cpu, node;
+    if (utils_getcpu(&cpu, &node) == 0) {
+        return cpu % pool->n_lists;
+    }
+
+    return (unsigned)utils_gettid() % pool->n_lists;
+}
+
+static void *slab_create(object_memory_pool_t *pool, unsigned home) {
+    void *base = NULL;
+    umf_result_t ret = umfMemoryProviderAlloc(pool->provider, pool->slab_size,
+                                              pool->slab_size, &base);
+    if (ret != UMF_RESULT_SUCCESS || !base) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    ASSERT_IS_ALIGNED((uintptr_t)base, pool->slab_size);
+
+    if ((uint64_t)(uintptr_t)base + pool->slab_size > OBJECT_LIST_PTR_LIMIT) {
+        LOG_ERR("address of the slab (%p) is too high for the free lists",
+                base);
+        umfMemoryProviderFree(pool->provider, base, pool->slab_size);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_UNKNOWN;
+        return NULL;
+    }
+
+    object_slab_t *slab = (object_slab_t *)base;
+    slab->pool = pool;
+    slab->home = home;
+
+    utils_mutex_lock(&pool->lock);
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    utils_mutex_unlock(&pool->lock);
+
+    uint64_t first = (uintptr_t)base + pool->first_offset;
+    size_t stride = pool->stride;
+    size_t n_objects = pool->n_objects;
+
+    // the first object is returned, the rest is linked and added to the list
+    if (n_objects > 1) {
+        for (size_t i = 1; i < n_objects - 1; i++) {
+            *(uint64_t *)(uintptr_t)(first + i * stride) =
+                first + (i + 1) * stride;
+        }
+
+        local_push(&pool->lists[home], first + stride,
+                   first + (n_objects - 1) * stride);
+    }
+
+    return (void *)(uintptr_t)first;
+}
+
+static void *object_alloc(object_memory_pool_t *pool) {
+    unsigned idx = list_index(pool);
+    object_list_t *list = &pool->lists[idx];
+
+    uint64_t addr = local_pop(list);
+    if (addr) {
+        return (void *)(uintptr_t)addr;
+    }
+
+    // take back the objects freed on other CPUs
+    addr = remote_drain(list);
+    if (addr) {
+        return (void *)(uintptr_t)addr;
+    }
+
+    // use the free objects of other CPUs before the pool grows,
+    // including the ones waiting on their remote lists
+    for (unsigned i = 1; i < pool->n_lists; i++) {
+        object_list_t *other = &pool->lists[(idx + i) % pool->n_lists];
+        addr = local_pop(other);
+        if (!addr) {
+            addr = remote_drain(other);
+        }
+        if (addr) {
+            return (void *)(uintptr_t)addr;
+        }
+    }
+
+    return slab_create(pool, idx);
+}
+
+static umf_result_t object_initialize(umf_memory_provider_handle_t provider,
+                                      void *params, void **pool) {
+    umf_object_pool_params_t *object_params =
+        (umf_object_pool_params_t *)params;
+    if (!object_params) {
+        LOG_ERR("params of the object pool are missing (no object size)");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (object_params->object_size == 0) {
+        LOG_ERR("object size has to be greater than 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t alignment = object_params->alignment;
+    if (alignment < UMF_OBJECT_POOL_ALIGNMENT_DEFAULT) {
+        alignment = UMF_OBJECT_POOL_ALIGNMENT_DEFAULT;
+    }
+    if (alignment & (alignment - 1)) {
+        LOG_ERR("alignment (%zu) has to be a power of 2", alignment);
+        return UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+    }
+
+    size_t first_offset = ALIGN_UP(sizeof(object_slab_t), alignment);
+    size_t stride = ALIGN_UP(object_params->object_size, alignment);
+    if (stride < object_params->object_size ||
+        stride > (SIZE_MAX / 2 - first_offset) / OBJECT_SLAB_MIN_OBJECTS) {
+        LOG_ERR("object size is too big: %zu", object_params->object_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t slab_size = object_params->slab_size;
+    if (slab_size & (slab_size - 1)) {
+        LOG_ERR("slab size (%zu) has to be a power of 2", slab_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (slab_size == 0) {
+        slab_size = OBJECT_SLAB_SIZE_MIN;
+        while (slab_size < first_offset + OBJECT_SLAB_MIN_OBJECTS * stride) {
+            slab_size <<= 1;
+        }
+    }
+
+    size_t page_size = 0;
+    umf_result_t ret = umfMemoryProviderGetRecommendedPageSize(
+        provider, slab_size, &page_size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("cannot get the recommended page size of the memory provider");
+        return ret;
+    }
+
+    if (page_size & (page_size - 1)) {
+        LOG_ERR("wrong page size of the memory provider: %zu", page_size);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (slab_size < page_size) {
+        slab_size = page_size;
+    }
+
+    if (slab_size < first_offset + stride) {
+        LOG_ERR("slab size (%zu) is too small for objects of size %zu",
+                slab_size, object_params->object_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    object_memory_pool_t *object_pool =
+        umf_ba_global_alloc(sizeof(object_memory_pool_t));
+    if (!object_pool) {
+        LOG_ERR("cannot allocate memory for metadata");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    bool lists_per_thread =
+        utils_env_var_has_str("UMF_OBJECT_POOL_LISTS", "per_thread");
+    unsigned n_lists =
+        lists_per_thread ? OBJECT_MAX_LISTS : utils_get_num_cpus();
+    if (n_lists == 0) {
+        n_lists = 1;
+    }
+    if (n_lists > OBJECT_MAX_LISTS) {
+        n_lists = OBJECT_MAX_LISTS;
+    }
+
+    object_pool->lists = umf_ba_global_alloc(n_lists * sizeof(object_list_t));
+    if (!object_pool->lists) {
+        LOG_ERR("cannot allocate memory for metadata");
+        umf_ba_global_free(object_pool);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    memset(object_pool->lists, 0, n_lists * sizeof(object_list_t));
+
+    if (!utils_mutex_init(&object_pool->lock)) {
+        LOG_ERR("cannot initialize the lock of the object pool");
+        umf_ba_global_free(object_pool->lists);
+        umf_ba_global_free(object_pool);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    object_pool->provider = provider;
+    object_pool->object_size = object_params->object_size;
+    object_pool->alignment = alignment;
+    object_pool->stride = stride;
+    object_pool->slab_size = slab_size;
+    object_pool->first_offset = first_offset;
+    object_pool->n_objects = (slab_size - first_offset) / stride;
+    object_pool->n_lists = n_lists;
+    object_pool->lists_per_thread = lists_per_thread;
+    object_pool->slabs = NULL;
+
+    *pool = (void *)object_pool;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void object_finalize(void *pool) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+
+    while (object_pool->slabs) {
+        object_slab_t *slab = object_pool->slabs;
+        object_pool->slabs = slab->next;
+
+        umf_result_t ret = umfMemoryProviderFree(object_pool->provider, slab,
+                                                 object_pool->slab_size);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("memory provider failed to free a slab, addr = %p",
+                    (void *)slab);
+        }
+    }
+
+    utils_mutex_destroy_not_free(&object_pool->lock);
+    umf_ba_global_free(object_pool->lists);
+    umf_ba_global_free(object_pool);
+}
+
+static void *object_malloc(void *pool, size_t size) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+    if (size > object_pool->object_size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    void *ptr = object_alloc(object_pool);
+    if (ptr == NULL) {
+        // TLS_last_allocation_error is set by slab_create()
+        return NULL;
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
+}
+
+static void *object_calloc(void *pool, size_t num, size_t size) {
+    if (size && num > SIZE_MAX / size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    size_t csize = num * size;
+    void *ptr = object_malloc(pool, csize);
+    if (ptr == NULL) {
+        // TLS_last_allocation_error is set by object_malloc()
+        return NULL;
+    }
+
+    memset(ptr, 0, csize);
+    return ptr;
+}
+
+static void *object_aligned_malloc(void *pool, size_t size, size_t alignment) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+
+    // all objects are aligned to the alignment of the pool
+    if (alignment & (alignment - 1) || alignment > object_pool->alignment) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+        return NULL;
+    }
+
+    return object_malloc(pool, size);
+}
+
+static umf_result_t object_free(void *pool, void *ptr) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    object_slab_t *slab = (object_slab_t *)ALIGN_DOWN((uintptr_t)ptr,
+                                                      object_pool->slab_size);
+    assert(slab->pool == object_pool);
+    assert(((uintptr_t)ptr - (uintptr_t)slab - object_pool->first_offset) %
+               object_pool->stride ==
+           0);
+
+    object_list_t *home = &object_pool->lists[slab->home];
+    if (slab->home == list_index(object_pool)) {
+        local_push(home, (uintptr_t)ptr, (uintptr_t)ptr);
+    } else {
+        remote_push(home, (uintptr_t)ptr);
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void *object_realloc(void *pool, void *ptr, size_t size) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return object_malloc(pool, size);
+    }
+
+    if (size == 0) {
+        TLS_last_allocation_error = object_free(pool, ptr);
+        return NULL;
+    }
+
+    // all objects have the same size
+    if (size > object_pool->object_size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
+}
+
+static size_t object_malloc_usable_size(void *pool, void *ptr) {
+    object_memory_pool_t *object_pool = (object_memory_pool_t *)pool;
+    return ptr ? object_pool->stride : 0;
+}
+
+static umf_result_t object_get_last_allocation_error(void *pool) {
+    (void)pool; // not used
+    return TLS_last_allocation_error;
+}
+
+static umf_memory_pool_ops_t UMF_OBJECT_POOL_OPS = {
+    .version = UMF_VERSION_CURRENT,
+    .initialize = object_initialize,
+    .finalize = object_finalize,
+    .malloc = object_malloc,
+    .calloc = object_calloc,
+    .realloc = object_realloc,
+    .aligned_malloc = object_aligned_malloc,
+    .malloc_usable_size = object_malloc_usable_size,
+    .free = object_free,
+    .get_last_allocation_error = object_get_last_allocation_error};
+
+umf_memory_pool_ops_t *umfObjectPoolOps(void) { return &UMF_OBJECT_POOL_OPS; }
@@ -11,6 +11,8 @@
 #include <umf/pools/pool_proxy.h>
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include "base_alloc_global.h"
 #include "provider/provider_tracking.h"
@@ -67,27 +69,34 @@ static void *proxy_malloc(void *pool, size_t size) {
 static void *proxy_calloc(void *pool, size_t num, size_t size) {
     assert(pool);
 
-    (void)pool;
-    (void)num;
-    (void)size;
+    struct proxy_memory_pool *hPool = (struct proxy_memory_pool *)pool;
 
-    // Currently we cannot implement calloc in a way that would
-    // work for memory that is inaccessible on the host
-    TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
-}
+    if (size && num > SIZE_MAX / size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
 
-static void *proxy_realloc(void *pool, void *ptr, size_t size) {
-    assert(pool);
+    size_t csize = num * size;
+    void *ptr = NULL;
+    bool zeroed = false;
+    umf_result_t ret = umfMemoryProviderAllocZeroInfo(hPool->hProvider, csize,
+                                                      0, &ptr, &zeroed);
+    if (ret != UMF_RESULT_SUCCESS) {
+        TLS_last_allocation_error = ret;
+        return NULL;
+    }
 
-    (void)pool;
-    (void)ptr;
-    (void)size;
+    if (!zeroed) {
+        // Currently we cannot zero memory in a way that would
+        // work for memory that is inaccessible on the host,
+        // so calloc is supported only if the provider returned zeroed memory
+        umfMemoryProviderFree(hPool->hProvider, ptr, csize);
+        TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
+        return NULL;
+    }
 
-    // Currently we cannot implement realloc in a way that would
-    // work for memory that is inaccessible on the host
-    TLS_last_allocation_error = UMF_RESULT_ERROR_NOT_SUPPORTED;
-    return NULL;
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
 }
 
 static umf_result_t proxy_free(void *pool, void *ptr) {
@@ -107,6 +116,42 @@ static umf_result_t proxy_free(void *pool, void *ptr) {
     return umfMemoryProviderFree(hPool->hProvider, ptr, size);
 }
 
+static void *proxy_realloc(void *pool, void *ptr, size_t size) {
+    assert(pool);
+
+    struct proxy_memory_pool *hPool = (struct proxy_memory_pool *)pool;
+
+    if (ptr == NULL) {
+        return proxy_malloc(pool, size);
+    }
+
+    if (size == 0) {
+        TLS_last_allocation_error = proxy_free(pool, ptr);
+        return NULL;
+    }
+
+    umf_alloc_info_t allocInfo = {NULL, 0, NULL};
+    umf_result_t ret = umfMemoryTrackerGetAllocInfo(ptr, &allocInfo);
+    if (ret != UMF_RESULT_SUCCESS || allocInfo.base != ptr) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    // Currently we cannot copy the data in a way that would work for memory
+    // that is inaccessible on the host, so realloc is supported only
+    // if the memory provider can resize the allocation by itself.
+    void *new_ptr = NULL;
+    ret = umfMemoryProviderResize(hPool->hProvider, ptr, allocInfo.baseSize,
+                                  size, &new_ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        TLS_last_allocation_error = ret;
+        return NULL;
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return new_ptr;
+}
+
 static size_t proxy_malloc_usable_size(void *pool, void *ptr) {
     assert(pool);
 
@@ -47,6 +47,7 @@ typedef struct tbb_callbacks_t {
     int (*pool_create_v1)(intptr_t, const struct tbb_mem_pool_policy_t *,
                           void **);
     bool (*pool_destroy)(void *);
+    bool (*pool_reset)(void *);
     void *(*pool_identify)(void *object);
     size_t (*pool_msize)(void *, void *);
 #ifdef _WIN32
@@ -58,6 +59,7 @@ typedef struct tbb_callbacks_t {
 
 typedef struct tbb_memory_pool_t {
     umf_memory_provider_handle_t mem_provider;
+    size_t fixed_pool_size; // 0 if the pool is not fixed
     void *tbb_pool;
     tbb_callbacks_t tbb_callbacks;
 } tbb_memory_pool_t;
@@ -70,6 +72,7 @@ typedef enum tbb_enums_t {
     TBB_POOL_FREE,
     TBB_POOL_CREATE_V1,
     TBB_POOL_DESTROY,
+    TBB_POOL_RESET,
     TBB_POOL_IDENTIFY,
     TBB_POOL_MSIZE,
     TBB_POOL_SYMBOLS_MAX // it has to be the last one
@@ -86,6 +89,7 @@ static const char *tbb_symbol[TBB_POOL_SYMBOLS_MAX] = {
     ("?pool_create_v1@rml@@YA?AW4MemPoolError@1@_JPEBUMemPoolPolicy@1@"
      "PEAPEAVMemoryPool@1@@Z"),
     "?pool_destroy@rml@@YA_NPEAVMemoryPool@1@@Z",
+    "?pool_reset@rml@@YA_NPEAVMemoryPool@1@@Z",
     "?pool_identify@rml@@YAPEAVMemoryPool@1@PEAX@Z",
     "?pool_msize@rml@@YA_KPEAVMemoryPool@1@PEAX@Z"
 #else
@@ -97,6 +101,7 @@ static const char *tbb_symbol[TBB_POOL_SYMBOLS_MAX] = {
     "_ZN3rml9pool_freeEPNS_10MemoryPoolEPv",
     "_ZN3rml14pool_create_v1ElPKNS_13MemPoolPolicyEPPNS_10MemoryPoolE",
     "_ZN3rml12pool_destroyEPNS_10MemoryPoolE",
+    "_ZN3rml10pool_resetEPNS_10MemoryPoolE",
     "_ZN3rml13pool_identifyEPv",
     "_ZN3rml10pool_msizeEPNS_10MemoryPoolEPv"
 #endif
@@ -127,6 +132,8 @@ static int init_tbb_callbacks(tbb_callbacks_t *tbb_callbacks) {
         tbb_callbacks->lib_handle, tbb_symbol[TBB_POOL_CREATE_V1], lib_name);
     *(void **)&tbb_callbacks->pool_destroy = utils_get_symbol_addr(
         tbb_callbacks->lib_handle, tbb_symbol[TBB_POOL_DESTROY], lib_name);
+    *(void **)&tbb_callbacks->pool_reset = utils_get_symbol_addr(
+        tbb_callbacks->lib_handle, tbb_symbol[TBB_POOL_RESET], lib_name);
     *(void **)&tbb_callbacks->pool_identify = utils_get_symbol_addr(
         tbb_callbacks->lib_handle, tbb_symbol[TBB_POOL_IDENTIFY], lib_name);
     *(void **)&tbb_callbacks->pool_msize = utils_get_symbol_addr(
@@ -135,7 +142,7 @@ static int init_tbb_callbacks(tbb_callbacks_t *tbb_callbacks) {
     if (!tbb_callbacks->pool_malloc || !tbb_callbacks->pool_realloc ||
         !tbb_callbacks->pool_aligned_malloc || !tbb_callbacks->pool_free ||
         !tbb_callbacks->pool_create_v1 || !tbb_callbacks->pool_destroy ||
-        !tbb_callbacks->pool_identify) {
+        !tbb_callbacks->pool_reset || !tbb_callbacks->pool_identify) {
         LOG_ERR("Could not find symbols in %s", lib_name);
         utils_close_library(tbb_callbacks->lib_handle);
         return -1;
@@ -147,6 +154,13 @@ static int init_tbb_callbacks(tbb_callbacks_t *tbb_callbacks) {
 static void *tbb_raw_alloc_wrapper(intptr_t pool_id, size_t *raw_bytes) {
     void *resPtr;
     tbb_memory_pool_t *pool = (tbb_memory_pool_t *)pool_id;
+
+    // TBB asks a fixed pool for memory only once
+    // and uses as much of it as it gets
+    if (pool->fixed_pool_size > *raw_bytes) {
+        *raw_bytes = pool->fixed_pool_size;
+    }
+
     umf_result_t ret =
         umfMemoryProviderAlloc(pool->mem_provider, *raw_bytes, 0, &resPtr);
     if (ret != UMF_RESULT_SUCCESS) {
@@ -169,16 +183,30 @@ static void tbb_raw_free_wrapper(intptr_t pool_id, void *ptr, size_t bytes) {
 
 static umf_result_t tbb_pool_initialize(umf_memory_provider_handle_t provider,
                                         void *params, void **pool) {
-    (void)params; // unused
+    umf_scalable_pool_params_t default_params = umfScalablePoolParamsDefault();
+    umf_scalable_pool_params_t *scalable_params =
+        (umf_scalable_pool_params_t *)params;
+    if (!scalable_params) {
+        scalable_params = &default_params;
+    }
 
-    const size_t GRANULARITY = 2 * 1024 * 1024;
-    tbb_mem_pool_policy_t policy = {.pAlloc = tbb_raw_alloc_wrapper,
-                                    .pFree = tbb_raw_free_wrapper,
-                                    .granularity = GRANULARITY,
-                                    .version = 1,
-                                    .fixed_pool = false,
-                                    .keep_all_memory = false,
-                                    .reserved = 0};
+    size_t granularity = scalable_params->granularity;
+    if (granularity == 0) {
+        granularity = UMF_SCALABLE_POOL_GRANULARITY_DEFAULT;
+    }
+    if (granularity & (granularity - 1)) {
+        LOG_ERR("granularity (%zu) has to be a power of 2", granularity);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    tbb_mem_pool_policy_t policy = {
+        .pAlloc = tbb_raw_alloc_wrapper,
+        .pFree = tbb_raw_free_wrapper,
+        .granularity = granularity,
+        .version = 1,
+        .fixed_pool = scalable_params->fixed_pool_size > 0,
+        .keep_all_memory = scalable_params->keep_all_memory,
+        .reserved = 0};
 
     tbb_memory_pool_t *pool_data =
         umf_ba_global_alloc(sizeof(tbb_memory_pool_t));
@@ -190,13 +218,17 @@ static umf_result_t tbb_pool_initialize(umf_memory_provider_handle_t provider,
     int ret = init_tbb_callbacks(&pool_data->tbb_callbacks);
     if (ret != 0) {
         LOG_ERR("loading TBB symbols failed");
+        umf_ba_global_free(pool_data);
         return UMF_RESULT_ERROR_UNKNOWN;
     }
 
     pool_data->mem_provider = provider;
+    pool_data->fixed_pool_size = scalable_params->fixed_pool_size;
     ret = pool_data->tbb_callbacks.pool_create_v1((intptr_t)pool_data, &policy,
                                                   &(pool_data->tbb_pool));
     if (ret != 0 /* TBBMALLOC_OK */) {
+        utils_close_library(pool_data->tbb_callbacks.lib_handle);
+        umf_ba_global_free(pool_data);
         return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
     }
 
@@ -235,7 +267,7 @@ static void *tbb_calloc(void *pool, size_t num, size_t size) {
         return NULL;
     }
 
-    memset(ptr, 0, csize);
+    utils_memzero_nt(ptr, csize);
     return ptr;
 }
 
@@ -299,6 +331,23 @@ static size_t tbb_malloc_usable_size(void *pool, void *ptr) {
     return pool_data->tbb_callbacks.pool_msize(pool_data->tbb_pool, ptr);
 }
 
+static umf_result_t tbb_reset(void *pool) {
+    tbb_memory_pool_t *pool_data = (tbb_memory_pool_t *)pool;
+
+    // all objects are released at once, so (like in tbb_free())
+    // make their previous writes happen-before any reuse of the memory
+    utils_annotate_release(pool);
+
+    // TBB keeps the memory obtained from the provider
+    // and marks all of it as free
+    if (!pool_data->tbb_callbacks.pool_reset(pool_data->tbb_pool)) {
+        LOG_ERR("resetting the TBB pool failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static umf_result_t tbb_get_last_allocation_error(void *pool) {
     (void)pool; // not used
     return TLS_last_allocation_error;
@@ -314,7 +363,8 @@ static umf_memory_pool_ops_t UMF_SCALABLE_POOL_OPS = {
     .aligned_malloc = tbb_aligned_malloc,
     .malloc_usable_size = tbb_malloc_usable_size,
     .free = tbb_free,
-    .get_last_allocation_error = tbb_get_last_allocation_error};
+    .get_last_allocation_error = tbb_get_last_allocation_error,
+    .reset = tbb_reset};
 
 umf_memory_pool_ops_t *umfScalablePoolOps(void) {
     return &UMF_SCALABLE_POOL_OPS;
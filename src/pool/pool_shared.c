@@ -0,0 +1,711 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ *
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umf/memory_pool_ops.h>
+#include <umf/pools/pool_shared.h>
+
+#include "base_alloc_global.h"
+#include "ipc_internal.h"
+#include "memory_pool_internal.h"
+#include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
+
+// The whole heap of the shared memory pool, including all its metadata,
+// is a single allocation of the memory provider, that can be mapped
+// by many processes at different addresses. That is why the metadata
+// contain only offsets (relative to the beginning of the heap) and all
+// of them are updated with atomic operations that work also between
+// processes.
+//
+// Layout of the heap:
+// | header | slab descriptors | slab bitmap | (padding) | slabs ... |
+//
+// The heap is divided into slabs of SHARED_SLAB_SIZE bytes. A slab is either
+// divided into blocks of a single size class or it is a part of a large
+// allocation (a run of slabs). Free blocks of each size class are kept
+// in a lock-free list (a stack with an ABA tag) with the offset of the next
+// free block stored in the first 8 bytes of the free block. Slabs given
+// to size classes are never returned to the slab bitmap. The slab bitmap
+// (a set bit means a used slab) is protected by a process-shared mutex
+// kept in the header.
+//
+// If a process dies while using the heap, the heap stays usable for
+// the other processes: on Linux the mutex is robust, so it is taken over
+// by the next process that locks it. Memory allocated by the dead process
+// and not freed yet, blocks it was just taking from or giving back to
+// a free list and slabs it was just reserving or releasing under the mutex
+// are leaked until the heap is destroyed. On Windows and macOS the mutex is
+// not robust and the death of a process holding it blocks all other
+// processes reserving and releasing slabs.
+
+#define SHARED_HEAP_SIGNATURE 0x554D465348524832ULL // "UMFSHRH2"
+#define SHARED_SLAB_SIZE ((size_t)64 * 1024)
+
+#define SHARED_MIN_CLASS_SHIFT 4 // 16 bytes
+#define SHARED_MAX_CLASS_SHIFT 15 // 32 KiB
+#define SHARED_N_CLASSES (SHARED_MAX_CLASS_SHIFT - SHARED_MIN_CLASS_SHIFT + 1)
+#define SHARED_MAX_SMALL_SIZE ((size_t)1 << SHARED_MAX_CLASS_SHIFT)
+
+// head of a free list: (ABA tag << 44) | (offset of the first block >> 4)
+#define SHARED_LIST_OFFSET_BITS 44
+#define SHARED_LIST_OFFSET_MASK (((uint64_t)1 << SHARED_LIST_OFFSET_BITS) - 1)
+
+// values of shared_slab_t::kind, size classes are kept as (class + 1)
+#define SHARED_SLAB_FREE 0
+#define SHARED_SLAB_LARGE UINT32_MAX
+
+typedef struct shared_slab_t {
+    uint32_t kind;    // SHARED_SLAB_FREE, (size class + 1) or SHARED_SLAB_LARGE
+    uint32_t first;   // index of the first slab of the large allocation
+    uint32_t n_slabs; // number of slabs of the large allocation (first only)
+    uint32_t reserved;
+} shared_slab_t;
+
+typedef struct shared_heap_header_t {
+    uint64_t signature;
+    uint64_t size;
+    uint64_t n_slabs;
+    uint64_t slabs_offset;  // offset of the slab descriptors
+    uint64_t bitmap_offset; // offset of the slab bitmap
+    uint64_t data_offset;   // offset of the first slab
+    uint64_t free_lists[SHARED_N_CLASSES];
+    utils_shared_mutex_t lock; // lock of the slab bitmap
+} shared_heap_header_t;
+
+typedef struct shared_memory_pool_t {
+    umf_memory_provider_handle_t provider;
+    shared_heap_header_t *heap;
+    size_t heap_size;
+    // true if the heap was created (not opened) by this pool
+    bool owner;
+} shared_memory_pool_t;
+
+static __TLS umf_result_t TLS_last_allocation_error;
+
+static inline uintptr_t heap_base(shared_memory_pool_t *pool) {
+    return (uintptr_t)pool->heap;
+}
+
+static inline shared_slab_t *heap_slabs(shared_memory_pool_t *pool) {
+    return (shared_slab_t *)(heap_base(pool) + pool->heap->slabs_offset);
+}
+
+static inline uint64_t *heap_bitmap(shared_memory_pool_t *pool) {
+    return (uint64_t *)(heap_base(pool) + pool->heap->bitmap_offset);
+}
+
+static inline uintptr_t slab_addr(shared_memory_pool_t *pool, size_t idx) {
+    return heap_base(pool) + pool->heap->data_offset + idx * SHARED_SLAB_SIZE;
+}
+
+static size_t heap_metadata_size(size_t n_slabs) {
+    size_t bitmap_size = ALIGN_UP(n_slabs, 64) / 8;
+    size_t size = sizeof(shared_heap_header_t) +
+                  n_slabs * sizeof(shared_slab_t) + bitmap_size;
+    return ALIGN_UP(size, SHARED_SLAB_SIZE);
+}
+
+static umf_result_t heap_format(shared_heap_header_t *heap, size_t size) {
+    size_t n_slabs = size / SHARED_SLAB_SIZE;
+    while (n_slabs &&
+           heap_metadata_size(n_slabs) + n_slabs * SHARED_SLAB_SIZE > size) {
+        n_slabs--;
+    }
+
+    if (n_slabs == 0) {
+        LOG_ERR("heap size (%zu) is too small", size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t metadata_size = heap_metadata_size(n_slabs);
+    memset(heap, 0, metadata_size);
+
+    heap->size = size;
+    heap->n_slabs = n_slabs;
+    heap->slabs_offset = sizeof(shared_heap_header_t);
+    heap->bitmap_offset =
+        heap->slabs_offset + n_slabs * sizeof(shared_slab_t);
+    heap->data_offset = metadata_size;
+
+    int ret = utils_shared_mutex_init(&heap->lock);
+    if (ret) {
+        LOG_ERR("initializing the lock of the heap failed (%i)", ret);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    // the signature is set as the last one - the heap is ready to be opened
+    utils_atomic_store_release(&heap->signature, SHARED_HEAP_SIGNATURE);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static bool heap_lock(shared_heap_header_t *heap) {
+    int ret = utils_shared_mutex_lock(&heap->lock);
+    if (ret == EOWNERDEAD) {
+        LOG_WARN("a process died holding the lock of the heap, slabs it was "
+                 "reserving or releasing may be leaked");
+        return true;
+    }
+
+    if (ret) {
+        LOG_ERR("locking the heap failed (%i)", ret);
+        return false;
+    }
+
+    return true;
+}
+
+static void heap_unlock(shared_heap_header_t *heap) {
+    utils_shared_mutex_unlock(&heap->lock);
+}
+
+static inline bool bitmap_get(uint64_t *bitmap, size_t idx) {
+    return (bitmap[idx / 64] >> (idx % 64)) & 1;
+}
+
+static void bitmap_set_range(uint64_t *bitmap, size_t idx, size_t n,
+                             bool value) {
+    for (size_t i = idx; i < idx + n; i++) {
+        if (value) {
+            bitmap[i / 64] |= (1ULL << (i % 64));
+        } else {
+            bitmap[i / 64] &= ~(1ULL << (i % 64));
+        }
+    }
+}
+
+// Find (first fit) and reserve a run of slabs that can hold 'size' bytes
+// starting at an address aligned to 'alignment' (in this process).
+// Returns the aligned address or 0 if there is no such run in the heap.
+static uintptr_t slabs_reserve(shared_memory_pool_t *pool, size_t size,
+                               size_t alignment, uint32_t kind) {
+    shared_heap_header_t *heap = pool->heap;
+    uint64_t *bitmap = heap_bitmap(pool);
+    shared_slab_t *slabs = heap_slabs(pool);
+    size_t n_slabs = heap->n_slabs;
+    uintptr_t ret = 0;
+
+    if (!heap_lock(heap)) {
+        return 0;
+    }
+
+    size_t i = 0;
+    while (i < n_slabs) {
+        // skip fully used words of the bitmap
+        if ((i % 64) == 0 && bitmap[i / 64] == UINT64_MAX) {
+            i += 64;
+            continue;
+        }
+
+        if (bitmap_get(bitmap, i)) {
+            i++;
+            continue;
+        }
+
+        uintptr_t addr = slab_addr(pool, i);
+        uintptr_t aligned = ALIGN_UP(addr, alignment);
+        size_t n = (aligned - addr + size + SHARED_SLAB_SIZE - 1) /
+                   SHARED_SLAB_SIZE;
+        if (i + n > n_slabs) {
+            i++;
+            continue;
+        }
+
+        size_t j = i + 1;
+        while (j < i + n && !bitmap_get(bitmap, j)) {
+            j++;
+        }
+
+        if (j < i + n) {
+            // slab 'j' is used
+            i = j + 1;
+            continue;
+        }
+
+        bitmap_set_range(bitmap, i, n, true);
+        for (size_t k = i; k < i + n; k++) {
+            slabs[k].kind = kind;
+            slabs[k].first = (uint32_t)i;
+        }
+        slabs[i].n_slabs = (uint32_t)n;
+
+        ret = aligned;
+        break;
+    }
+
+    heap_unlock(heap);
+
+    return ret;
+}
+
+static void slabs_release(shared_memory_pool_t *pool, size_t first) {
+    shared_slab_t *slabs = heap_slabs(pool);
+
+    if (!heap_lock(pool->heap)) {
+        // the slabs are leaked
+        return;
+    }
+
+    size_t n = slabs[first].n_slabs;
+    for (size_t k = first; k < first + n; k++) {
+        slabs[k].kind = SHARED_SLAB_FREE;
+    }
+    bitmap_set_range(heap_bitmap(pool), first, n, false);
+
+    heap_unlock(pool->heap);
+}
+
+static inline uint64_t list_head(uint64_t head, uint64_t offset) {
+    uint64_t tag = (head >> SHARED_LIST_OFFSET_BITS) + 1;
+    return (tag << SHARED_LIST_OFFSET_BITS) |
+           (offset >> SHARED_MIN_CLASS_SHIFT);
+}
+
+static inline uint64_t list_offset(uint64_t head) {
+    return (head & SHARED_LIST_OFFSET_MASK) << SHARED_MIN_CLASS_SHIFT;
+}
+
+// push the list of blocks linked from 'first' to 'last' to the free list
+static void list_push(shared_memory_pool_t *pool, uint64_t *list,
+                      uint64_t first, uint64_t last) {
+    volatile uint64_t *last_next = (uint64_t *)(heap_base(pool) + last);
+    uint64_t head;
+    utils_atomic_load_acquire(list, &head);
+    do {
+        *last_next = list_offset(head);
+    } while (!utils_compare_exchange(list, &head, list_head(head, first)));
+}
+
+static uint64_t list_pop(shared_memory_pool_t *pool, uint64_t *list) {
+    uint64_t head;
+    utils_atomic_load_acquire(list, &head);
+    do {
+        uint64_t offset = list_offset(head);
+        if (offset == 0) {
+            return 0;
+        }
+
+        // the block can be popped and reused concurrently, so its 'next'
+        // can be a garbage, but then the tag of the head has changed
+        // and the exchange fails
+        volatile uint64_t *next = (uint64_t *)(heap_base(pool) + offset);
+        uint64_t new_head = list_head(head, *next);
+        if (utils_compare_exchange(list, &head, new_head)) {
+            return offset;
+        }
+    } while (1);
+}
+
+static void *shared_alloc_small(shared_memory_pool_t *pool, size_t cls) {
+    uint64_t *list = &pool->heap->free_lists[cls];
+
+    uint64_t offset = list_pop(pool, list);
+    if (offset) {
+        return (void *)(heap_base(pool) + offset);
+    }
+
+    // the free list is empty - divide a new slab into blocks
+    uintptr_t slab =
+        slabs_reserve(pool, SHARED_SLAB_SIZE, 1, (uint32_t)cls + 1);
+    if (!slab) {
+        return NULL;
+    }
+
+    size_t block_size = (size_t)1 << (cls + SHARED_MIN_CLASS_SHIFT);
+    size_t n_blocks = SHARED_SLAB_SIZE / block_size;
+    uint64_t first = slab - heap_base(pool);
+
+    // the first block is returned, the rest is linked and added to the list
+    if (n_blocks > 1) {
+        for (size_t i = 1; i < n_blocks - 1; i++) {
+            *(uint64_t *)(slab + i * block_size) = first + (i + 1) * block_size;
+        }
+
+        list_push(pool, list, first + block_size,
+                  first + (n_blocks - 1) * block_size);
+    }
+
+    return (void *)slab;
+}
+
+static void *shared_aligned_malloc(void *pool, size_t size, size_t alignment) {
+    assert(pool);
+    shared_memory_pool_t *shared_pool = (shared_memory_pool_t *)pool;
+
+    if (alignment && (alignment & (alignment - 1))) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+        return NULL;
+    }
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    if (size > shared_pool->heap->size) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    void *ptr = NULL;
+    if (size <= SHARED_MAX_SMALL_SIZE && alignment <= utils_get_page_size()) {
+        // blocks of a size class are aligned to their size (up to the size
+        // of a page, since the heap can be mapped at any page boundary)
+        size_t cls = 0;
+        size_t block_size = size > alignment ? size : alignment;
+        while (((size_t)1 << (cls + SHARED_MIN_CLASS_SHIFT)) < block_size) {
+            cls++;
+        }
+
+        ptr = shared_alloc_small(shared_pool, cls);
+    } else {
+        if (alignment < utils_get_page_size()) {
+            alignment = utils_get_page_size();
+        }
+
+        ptr = (void *)slabs_reserve(shared_pool, size, alignment,
+                                    SHARED_SLAB_LARGE);
+    }
+
+    if (ptr == NULL) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        return NULL;
+    }
+
+    TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+    return ptr;
+}
+
+static void *shared_malloc(void *pool, size_t size) {
+    return shared_aligned_malloc(pool, size, 0);
+}
+
+static void *shared_calloc(void *pool, size_t num, size_t size) {
+    size_t total = num * size;
+    if (size && total / size != num) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    void *ptr = shared_malloc(pool, total);
+    if (ptr) {
+        utils_memzero_nt(ptr, total);
+    }
+
+    return ptr;
+}
+
+// returns the index of the slab of 'ptr' or SIZE_MAX if 'ptr' is not
+// a pointer to the data of the heap
+static size_t shared_slab_index(shared_memory_pool_t *pool, void *ptr) {
+    uintptr_t data = heap_base(pool) + pool->heap->data_offset;
+    if ((uintptr_t)ptr < data) {
+        return SIZE_MAX;
+    }
+
+    size_t idx = ((uintptr_t)ptr - data) / SHARED_SLAB_SIZE;
+    if (idx >= pool->heap->n_slabs) {
+        return SIZE_MAX;
+    }
+
+    return idx;
+}
+
+static size_t shared_malloc_usable_size(void *pool, void *ptr) {
+    assert(pool);
+    shared_memory_pool_t *shared_pool = (shared_memory_pool_t *)pool;
+
+    size_t idx = shared_slab_index(shared_pool, ptr);
+    if (idx == SIZE_MAX) {
+        return 0;
+    }
+
+    shared_slab_t *slab = &heap_slabs(shared_pool)[idx];
+    if (slab->kind == SHARED_SLAB_FREE) {
+        return 0;
+    }
+
+    if (slab->kind == SHARED_SLAB_LARGE) {
+        size_t first = slab->first;
+        uintptr_t end = slab_addr(shared_pool, first) +
+                        heap_slabs(shared_pool)[first].n_slabs *
+                            SHARED_SLAB_SIZE;
+        return end - (uintptr_t)ptr;
+    }
+
+    return (size_t)1 << (slab->kind - 1 + SHARED_MIN_CLASS_SHIFT);
+}
+
+static umf_result_t shared_free(void *pool, void *ptr) {
+    assert(pool);
+    shared_memory_pool_t *shared_pool = (shared_memory_pool_t *)pool;
+
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    size_t idx = shared_slab_index(shared_pool, ptr);
+    if (idx == SIZE_MAX) {
+        LOG_ERR("pointer %p does not belong to the heap", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    shared_slab_t *slab = &heap_slabs(shared_pool)[idx];
+    if (slab->kind == SHARED_SLAB_FREE) {
+        LOG_ERR("pointer %p is not allocated", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (slab->kind == SHARED_SLAB_LARGE) {
+        slabs_release(shared_pool, slab->first);
+        return UMF_RESULT_SUCCESS;
+    }
+
+    uint64_t offset = (uintptr_t)ptr - heap_base(shared_pool);
+    list_push(shared_pool, &shared_pool->heap->free_lists[slab->kind - 1],
+              offset, offset);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void *shared_realloc(void *pool, void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return shared_malloc(pool, size);
+    }
+
+    if (size == 0) {
+        TLS_last_allocation_error = shared_free(pool, ptr);
+        return NULL;
+    }
+
+    size_t old_size = shared_malloc_usable_size(pool, ptr);
+    if (old_size == 0) {
+        TLS_last_allocation_error = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    if (size <= old_size) {
+        TLS_last_allocation_error = UMF_RESULT_SUCCESS;
+        return ptr;
+    }
+
+    void *new_ptr = shared_malloc(pool, size);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+
+    utils_memcpy_nt(new_ptr, ptr, old_size);
+    shared_free(pool, ptr);
+
+    return new_ptr;
+}
+
+static umf_result_t shared_get_last_allocation_error(void *pool) {
+    (void)pool; // not used
+    return TLS_last_allocation_error;
+}
+
+static umf_result_t shared_open_heap(shared_memory_pool_t *pool,
+                                     umf_ipc_handle_t ipcHandle) {
+    void *base = NULL;
+    umf_result_t ret = umfMemoryProviderOpenIPCHandle(
+        pool->provider, (void *)ipcHandle->providerIpcData, &base);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("opening the IPC handle of the heap failed");
+        return ret;
+    }
+
+    shared_heap_header_t *heap = (shared_heap_header_t *)base;
+    uint64_t signature;
+    utils_atomic_load_acquire(&heap->signature, &signature);
+    if (signature != SHARED_HEAP_SIGNATURE ||
+        heap->size > ipcHandle->baseSize) {
+        LOG_ERR("the IPC handle does not point to a shared memory pool heap");
+        umfMemoryProviderCloseIPCHandle(pool->provider, base,
+                                        ipcHandle->baseSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pool->heap = heap;
+    pool->heap_size = ipcHandle->baseSize;
+    pool->owner = false;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t shared_create_heap(shared_memory_pool_t *pool,
+                                       size_t size) {
+    size = ALIGN_UP(size, SHARED_SLAB_SIZE);
+
+    void *base = NULL;
+    umf_result_t ret = umfMemoryProviderAlloc(pool->provider, size, 0, &base);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("allocation of the heap (size: %zu) failed", size);
+        return ret;
+    }
+
+    ret = heap_format((shared_heap_header_t *)base, size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        umfMemoryProviderFree(pool->provider, base, size);
+        return ret;
+    }
+
+    pool->heap = (shared_heap_header_t *)base;
+    pool->heap_size = size;
+    pool->owner = true;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static umf_result_t
+shared_pool_initialize(umf_memory_provider_handle_t provider, void *params,
+                       void **out_pool) {
+    if (params == NULL) {
+        LOG_ERR("shared memory pool params are missing");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_shared_pool_params_t *in_params = (umf_shared_pool_params_t *)params;
+
+    shared_memory_pool_t *pool =
+        umf_ba_global_alloc(sizeof(shared_memory_pool_t));
+    if (!pool) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    pool->provider = provider;
+
+    umf_result_t ret;
+    if (in_params->heap_ipc_handle) {
+        ret = shared_open_heap(pool, in_params->heap_ipc_handle);
+    } else {
+        ret = shared_create_heap(pool, in_params->heap_size);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        umf_ba_global_free(pool);
+        return ret;
+    }
+
+    *out_pool = (void *)pool;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+static void shared_pool_finalize(void *pool) {
+    shared_memory_pool_t *shared_pool = (shared_memory_pool_t *)pool;
+
+    // the heap can be still used by other processes, so only the mapping
+    // of this process is released
+    umf_result_t ret;
+    if (shared_pool->owner) {
+        ret = umfMemoryProviderFree(shared_pool->provider, shared_pool->heap,
+                                    shared_pool->heap_size);
+    } else {
+        ret = umfMemoryProviderCloseIPCHandle(
+            shared_pool->provider, shared_pool->heap, shared_pool->heap_size);
+    }
+
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("releasing the heap failed");
+    }
+
+    umf_ba_global_free(shared_pool);
+}
+
+static umf_memory_pool_ops_t UMF_SHARED_POOL_OPS = {
+    .version = UMF_VERSION_CURRENT,
+    .initialize = shared_pool_initialize,
+    .finalize = shared_pool_finalize,
+    .malloc = shared_malloc,
+    .calloc = shared_calloc,
+    .realloc = shared_realloc,
+    .aligned_malloc = shared_aligned_malloc,
+    .malloc_usable_size = shared_malloc_usable_size,
+    .free = shared_free,
+    .get_last_allocation_error = shared_get_last_allocation_error};
+
+umf_memory_pool_ops_t *umfSharedPoolOps(void) { return &UMF_SHARED_POOL_OPS; }
+
+static shared_memory_pool_t *shared_get_pool(umf_memory_pool_handle_t hPool) {
+    if (hPool->ops.initialize != shared_pool_initialize) {
+        LOG_ERR("the pool is not a shared memory pool.");
+        return NULL;
+    }
+
+    return (shared_memory_pool_t *)hPool->pool_priv;
+}
+
+umf_result_t umfSharedPoolGetIPCHandle(umf_memory_pool_handle_t hPool,
+                                       umf_ipc_handle_t *ipcHandle,
+                                       size_t *size) {
+    if (hPool == NULL || ipcHandle == NULL || size == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    shared_memory_pool_t *shared_pool = shared_get_pool(hPool);
+    if (shared_pool == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfGetIPCHandle(shared_pool->heap, ipcHandle, size);
+}
+
+umf_result_t umfSharedPoolGetOffset(umf_memory_pool_handle_t hPool,
+                                    const void *ptr, uint64_t *offset) {
+    if (hPool == NULL || ptr == NULL || offset == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    shared_memory_pool_t *shared_pool = shared_get_pool(hPool);
+    if (shared_pool == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uintptr_t base = heap_base(shared_pool);
+    if ((uintptr_t)ptr < base ||
+        (uintptr_t)ptr >= base + shared_pool->heap->size) {
+        LOG_ERR("pointer %p does not belong to the heap", ptr);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *offset = (uintptr_t)ptr - base;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfSharedPoolGetPtr(umf_memory_pool_handle_t hPool,
+                                 uint64_t offset, void **ptr) {
+    if (hPool == NULL || ptr == NULL) {
+        LOG_ERR("invalid argument.");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    shared_memory_pool_t *shared_pool = shared_get_pool(hPool);
+    if (shared_pool == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (offset >= shared_pool->heap->size) {
+        LOG_ERR("offset %llu exceeds the heap", (unsigned long long)offset);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *ptr = (void *)(heap_base(shared_pool) + offset);
+
+    return UMF_RESULT_SUCCESS;
+}
@@ -1206,9 +1206,12 @@ find_free_block(struct ravl *free_blocks, size_t size, size_t alignment,
     }
 }
 
-static umf_result_t coarse_memory_provider_alloc(void *provider, size_t size,
-                                                 size_t alignment,
-                                                 void **resultPtr) {
+// Only the memory allocated straight from the upstream provider can be
+// reported as zeroed, the content of reused blocks is unknown.
+static umf_result_t
+coarse_memory_provider_alloc_zero_info(void *provider, size_t size,
+                                       size_t alignment, void **resultPtr,
+                                       bool *zeroed) {
     umf_result_t umf_result = UMF_RESULT_SUCCESS;
 
     if (provider == NULL) {
@@ -1281,6 +1284,7 @@ static umf_result_t coarse_memory_provider_alloc(void *provider, size_t size,
 
         curr->used = true;
         *resultPtr = curr->data;
+        *zeroed = false;
         coarse_provider->used_size += size;
 
         assert(debug_check(coarse_provider));
@@ -1301,8 +1305,8 @@ static umf_result_t coarse_memory_provider_alloc(void *provider, size_t size,
         goto err_unlock;
     }
 
-    umfMemoryProviderAlloc(coarse_provider->upstream_memory_provider, size,
-                           alignment, resultPtr);
+    umfMemoryProviderAllocZeroInfo(coarse_provider->upstream_memory_provider,
+                                   size, alignment, resultPtr, zeroed);
     if (*resultPtr == NULL) {
         LOG_ERR("out of memory - upstream memory provider allocation failed");
         umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
@@ -1338,6 +1342,14 @@ err_unlock:
     return umf_result;
 }
 
+static umf_result_t coarse_memory_provider_alloc(void *provider, size_t size,
+                                                 size_t alignment,
+                                                 void **resultPtr) {
+    bool zeroed;
+    return coarse_memory_provider_alloc_zero_info(provider, size, alignment,
+                                                  resultPtr, &zeroed);
+}
+
 static umf_result_t coarse_memory_provider_free(void *provider, void *ptr,
                                                 size_t bytes) {
     if (provider == NULL) {
@@ -1569,6 +1581,166 @@ static umf_result_t coarse_memory_provider_purge_force(void *provider,
         coarse_provider->upstream_memory_provider, ptr, size);
 }
 
+static umf_result_t
+coarse_memory_provider_migrate(void *provider, void *ptr, size_t size,
+                               umf_const_memtarget_handle_t target) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    coarse_memory_provider_t *coarse_provider =
+        (struct coarse_memory_provider_t *)provider;
+    if (coarse_provider->upstream_memory_provider == NULL) {
+        LOG_ERR("no upstream memory provider given");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    return umfMemoryProviderMigrate(coarse_provider->upstream_memory_provider,
+                                    ptr, size, target);
+}
+
+static umf_result_t coarse_memory_provider_persist(void *provider,
+                                                   const void *ptr,
+                                                   size_t size) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    coarse_memory_provider_t *coarse_provider =
+        (struct coarse_memory_provider_t *)provider;
+    if (coarse_provider->upstream_memory_provider == NULL) {
+        LOG_ERR("no upstream memory provider given");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    return umfMemoryProviderPersist(coarse_provider->upstream_memory_provider,
+                                    ptr, size);
+}
+
+// Resize the used block in place: it is shrunk by returning its tail
+// to the free blocks or grown by taking the head of the following free block.
+static umf_result_t coarse_memory_provider_resize(void *provider, void *ptr,
+                                                  size_t oldSize,
+                                                  size_t newSize,
+                                                  void **newPtr) {
+    if (provider == NULL || ptr == NULL || newPtr == NULL || newSize == 0) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+    coarse_memory_provider_t *coarse_provider =
+        (struct coarse_memory_provider_t *)provider;
+
+    if (utils_mutex_lock(&coarse_provider->lock) != 0) {
+        LOG_ERR("locking the lock failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    assert(debug_check(coarse_provider));
+
+    ravl_node_t *node = coarse_ravl_find_node(coarse_provider->all_blocks, ptr);
+    if (node == NULL) {
+        LOG_ERR("memory block not found (ptr = %p, size = %zu)", ptr, oldSize);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_mutex_unlock;
+    }
+
+    block_t *block = get_node_block(node);
+    if (!block->used) {
+        LOG_ERR("block is not allocated");
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_mutex_unlock;
+    }
+
+    if (oldSize != block->size) {
+        LOG_ERR("wrong size of allocation");
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_mutex_unlock;
+    }
+
+    if (newSize < block->size) {
+        ravl_node_t *tail_node = NULL;
+        block_t *tail = coarse_ravl_add_new(coarse_provider->all_blocks,
+                                            block->data + newSize,
+                                            block->size - newSize, &tail_node);
+        if (tail == NULL) {
+            umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            goto err_mutex_unlock;
+        }
+
+        tail->used = false;
+        coarse_provider->used_size -= block->size - newSize;
+        block->size = newSize;
+
+        tail_node = free_block_merge_with_next(coarse_provider, tail_node);
+        if (free_blocks_add(coarse_provider->free_blocks,
+                            get_node_block(tail_node))) {
+            umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            goto err_mutex_unlock;
+        }
+    } else if (newSize > block->size) {
+        size_t grow = newSize - block->size;
+        ravl_node_t *next_node = get_node_next(node);
+        block_t *next = next_node ? get_node_block(next_node) : NULL;
+        if (next == NULL || next->used ||
+            block->data + block->size != next->data || next->size < grow ||
+            !is_same_origin(coarse_provider->upstream_blocks, block, next)) {
+            // the following free block is too small - the caller has to
+            // allocate a new block and copy the data
+            umf_result = UMF_RESULT_ERROR_NOT_SUPPORTED;
+            goto err_mutex_unlock;
+        }
+
+        free_blocks_rm_node(coarse_provider->free_blocks, next->free_list_ptr);
+
+        block_t *next_rm =
+            coarse_ravl_rm(coarse_provider->all_blocks, next->data);
+        assert(next_rm == next);
+        (void)next_rm; // WA for unused variable error
+
+        if (next->size > grow) {
+            // the key of the remaining free block changes, so re-insert it
+            block_t *rest = coarse_ravl_add_new(coarse_provider->all_blocks,
+                                                next->data + grow,
+                                                next->size - grow, NULL);
+            if (rest == NULL) {
+                umf_ba_global_free(next);
+                umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+                goto err_mutex_unlock;
+            }
+
+            rest->used = false;
+            if (free_blocks_add(coarse_provider->free_blocks, rest)) {
+                umf_ba_global_free(next);
+                umf_result = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+                goto err_mutex_unlock;
+            }
+        }
+
+        umf_ba_global_free(next);
+        coarse_provider->used_size += grow;
+        block->size = newSize;
+    }
+
+    LOG_DEBUG("coarse_RESIZE %zu -> %zu used %zu alloc %zu", oldSize, newSize,
+              coarse_provider->used_size, coarse_provider->alloc_size);
+
+    *newPtr = ptr;
+
+err_mutex_unlock:
+    assert(debug_check(coarse_provider));
+
+    if (utils_mutex_unlock(&coarse_provider->lock) != 0) {
+        LOG_ERR("unlocking the lock failed");
+        if (umf_result == UMF_RESULT_SUCCESS) {
+            umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        }
+    }
+
+    return umf_result;
+}
+
 static umf_result_t coarse_memory_provider_allocation_split(void *provider,
                                                             void *ptr,
                                                             size_t totalSize,
@@ -1757,6 +1929,10 @@ umf_memory_provider_ops_t UMF_COARSE_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = coarse_memory_provider_purge_force,
     .ext.allocation_merge = coarse_memory_provider_allocation_merge,
     .ext.allocation_split = coarse_memory_provider_allocation_split,
+    .ext.migrate = coarse_memory_provider_migrate,
+    .ext.resize = coarse_memory_provider_resize,
+    .ext.persist = coarse_memory_provider_persist,
+    .ext.alloc_zero_info = coarse_memory_provider_alloc_zero_info,
     // TODO
     /*
     .ipc.get_ipc_handle_size = coarse_memory_provider_get_ipc_handle_size,
@@ -26,7 +26,11 @@ umf_memory_provider_ops_t *umfDevDaxMemoryProviderOps(void) {
 
 #else // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
 
+#include <sys/mman.h>
+
 #include "base_alloc_global.h"
+#include "critnib.h"
+#include "ravl.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
@@ -35,13 +39,29 @@ umf_memory_provider_ops_t *umfDevDaxMemoryProviderOps(void) {
 
 #define TLS_MSG_BUF_LEN 1024
 
+// a free extent of the device DAX
+typedef struct devdax_extent_t {
+    size_t offset; // offset of the extent in the device DAX
+    size_t size;   // size of the extent
+} devdax_extent_t;
+
 typedef struct devdax_memory_provider_t {
     char path[PATH_MAX]; // a path to the device DAX
     size_t size;         // size of the file used for memory mapping
     void *base;          // base address of memory mapping
-    size_t offset;       // offset in the file used for memory mapping
-    utils_mutex_t lock;  // lock of ptr and offset
+    utils_mutex_t lock;  // lock of the free extents and the allocations
     unsigned protection; // combination of OS-specific protection flags
+    bool emulation;      // a regular file or a memfd emulates the device DAX
+    int fd;              // memfd emulating the device DAX (or -1)
+
+    // Free extents of the device DAX. They are stored in a critnib map
+    // (offset, devdax_extent_t *) used to coalesce neighbouring extents
+    // on free and in a RAVL tree sorted by (size, offset) used to find
+    // the best fitting extent on alloc.
+    critnib *free_extents;
+    struct ravl *free_extents_by_size;
+
+    critnib *allocs; // a critnib map of live allocations (addr, size)
 } devdax_memory_provider_t;
 
 typedef struct devdax_last_native_error_t {
@@ -63,6 +83,8 @@ static __TLS devdax_last_native_error_t TLS_last_native_error;
     (UMF_DEVDAX_RESULT_ERROR_FREE_FAILED - UMF_DEVDAX_RESULT_SUCCESS)
 #define _UMF_DEVDAX_RESULT_ERROR_PURGE_FORCE_FAILED                            \
     (UMF_DEVDAX_RESULT_ERROR_PURGE_FORCE_FAILED - UMF_DEVDAX_RESULT_SUCCESS)
+#define _UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED                                \
+    (UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED - UMF_DEVDAX_RESULT_SUCCESS)
 
 static const char *Native_error_str[] = {
     [_UMF_DEVDAX_RESULT_SUCCESS] = "success",
@@ -71,6 +93,7 @@ static const char *Native_error_str[] = {
         "allocated address is not aligned",
     [_UMF_DEVDAX_RESULT_ERROR_FREE_FAILED] = "memory deallocation failed",
     [_UMF_DEVDAX_RESULT_ERROR_PURGE_FORCE_FAILED] = "force purging failed",
+    [_UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED] = "persisting memory failed",
 };
 
 static void devdax_store_last_native_error(int32_t native_error,
@@ -94,6 +117,211 @@ devdax_translate_params(umf_devdax_memory_provider_params_t *in_params,
     return UMF_RESULT_SUCCESS;
 }
 
+// The compare function of the RAVL tree of free extents:
+// the extents are sorted by size first and then by the offset.
+static int devdax_extent_compare(const void *lhs, const void *rhs) {
+    const devdax_extent_t *lhs_extent = (const devdax_extent_t *)lhs;
+    const devdax_extent_t *rhs_extent = (const devdax_extent_t *)rhs;
+
+    if (lhs_extent->size != rhs_extent->size) {
+        return (lhs_extent->size < rhs_extent->size) ? -1 : 1;
+    }
+
+    if (lhs_extent->offset != rhs_extent->offset) {
+        return (lhs_extent->offset < rhs_extent->offset) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// devdax_extent_add - add a free extent without coalescing it with neighbours
+static umf_result_t devdax_extent_add(devdax_memory_provider_t *devdax_provider,
+                                      size_t offset, size_t size) {
+    devdax_extent_t *extent = umf_ba_global_alloc(sizeof(*extent));
+    if (!extent) {
+        LOG_ERR("allocation of a free extent failed");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    extent->offset = offset;
+    extent->size = size;
+
+    int ret = critnib_insert(devdax_provider->free_extents, offset, extent,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("inserting a value to the map of free extents failed "
+                "(offset=%zu, size=%zu)",
+                offset, size);
+        umf_ba_global_free(extent);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    ret = ravl_insert(devdax_provider->free_extents_by_size, extent);
+    if (ret) {
+        LOG_ERR("inserting a value to the tree of free extents failed "
+                "(offset=%zu, size=%zu)",
+                offset, size);
+        critnib_remove(devdax_provider->free_extents, offset);
+        umf_ba_global_free(extent);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// devdax_extent_remove - remove a free extent and release its descriptor
+static void devdax_extent_remove(devdax_memory_provider_t *devdax_provider,
+                                 devdax_extent_t *extent) {
+    struct ravl_node *node = ravl_find(devdax_provider->free_extents_by_size,
+                                       extent, RAVL_PREDICATE_EQUAL);
+    assert(node);
+    ravl_remove(devdax_provider->free_extents_by_size, node);
+
+    critnib_remove(devdax_provider->free_extents, extent->offset);
+    umf_ba_global_free(extent);
+}
+
+// devdax_extent_free - add a free extent coalescing it with the free neighbours
+static umf_result_t
+devdax_extent_free(devdax_memory_provider_t *devdax_provider, size_t offset,
+                   size_t size) {
+    size_t begin = offset;
+    size_t end = offset + size;
+    uintptr_t rkey;
+    void *rvalue;
+
+    if (begin > 0 && 1 == critnib_find(devdax_provider->free_extents,
+                                       begin - 1, FIND_LE, &rkey, &rvalue)) {
+        devdax_extent_t *prev = (devdax_extent_t *)rvalue;
+        assert(prev->offset + prev->size <= begin);
+        if (prev->offset + prev->size == begin) {
+            begin = prev->offset;
+            devdax_extent_remove(devdax_provider, prev);
+        }
+    }
+
+    devdax_extent_t *next = critnib_get(devdax_provider->free_extents, end);
+    if (next) {
+        end += next->size;
+        devdax_extent_remove(devdax_provider, next);
+    }
+
+    return devdax_extent_add(devdax_provider, begin, end - begin);
+}
+
+// devdax_extent_find - find the smallest free extent that can hold
+// an allocation of the given size and alignment
+static devdax_extent_t *
+devdax_extent_find(devdax_memory_provider_t *devdax_provider, size_t size,
+                   size_t alignment) {
+    devdax_extent_t key = {.offset = 0, .size = size};
+
+    struct ravl_node *node = ravl_find(devdax_provider->free_extents_by_size,
+                                       &key, RAVL_PREDICATE_GREATER_EQUAL);
+    for (; node; node = ravl_node_successor(node)) {
+        devdax_extent_t *extent = ravl_data(node);
+        uintptr_t addr = (uintptr_t)devdax_provider->base + extent->offset;
+        uintptr_t aligned_addr = ALIGN_UP(addr, alignment);
+        if (aligned_addr - addr <= extent->size - size) {
+            return extent;
+        }
+    }
+
+    return NULL;
+}
+
+// release all free extents (they are owned by the critnib map,
+// the RAVL tree stores only pointers to them)
+static void devdax_extents_delete(devdax_memory_provider_t *devdax_provider) {
+    uintptr_t rkey;
+    void *rvalue;
+
+    while (1 == critnib_find(devdax_provider->free_extents, 0, FIND_GE, &rkey,
+                             &rvalue)) {
+        struct ravl_node *node =
+            ravl_find(devdax_provider->free_extents_by_size, rvalue,
+                      RAVL_PREDICATE_EQUAL);
+        if (node) {
+            ravl_remove(devdax_provider->free_extents_by_size, node);
+        }
+        critnib_remove(devdax_provider->free_extents, rkey);
+        umf_ba_global_free(rvalue);
+    }
+}
+
+// open a regular file or create a memfd emulating the device DAX
+static int devdax_emulation_open(devdax_memory_provider_t *devdax_provider) {
+    int fd;
+
+    if (devdax_provider->path[0] == '\0') {
+        fd = utils_create_memfd();
+        if (fd == -1) {
+            LOG_ERR("cannot create a memfd");
+            return -1;
+        }
+    } else {
+        fd = utils_file_open_or_create(devdax_provider->path);
+        if (fd == -1) {
+            LOG_ERR("cannot open the file: %s", devdax_provider->path);
+            return -1;
+        }
+    }
+
+    size_t file_size = 0;
+    if (utils_get_file_size(fd, &file_size)) {
+        utils_close_fd(fd);
+        return -1;
+    }
+
+    if (file_size < devdax_provider->size &&
+        utils_set_file_size(fd, devdax_provider->size)) {
+        utils_close_fd(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// Map the file emulating the device DAX at an address aligned to 2 MB
+// like the kernel does for a device DAX. The mapping is padded
+// with an inaccessible range up to the next 2 MB boundary.
+static void *devdax_emulation_mmap(size_t size, unsigned protection, int fd,
+                                   size_t offset) {
+    size_t aligned_size = ALIGN_UP(size, DEVDAX_PAGE_SIZE_2MB);
+    size_t reserved_size = aligned_size + DEVDAX_PAGE_SIZE_2MB;
+
+    // reserve an address range large enough to hold an aligned mapping
+    void *reserved =
+        utils_mmap(NULL, reserved_size, PROT_NONE, MAP_PRIVATE, -1, 0);
+    if (reserved == NULL) {
+        LOG_PERR("reserving %zu bytes of the address space failed",
+                 reserved_size);
+        return NULL;
+    }
+
+    uintptr_t head = (uintptr_t)reserved;
+    uintptr_t aligned = ALIGN_UP(head, DEVDAX_PAGE_SIZE_2MB);
+    uintptr_t tail = aligned + aligned_size;
+
+    void *addr = utils_mmap_file((void *)aligned, size, protection, MAP_FIXED,
+                                 fd, offset, NULL);
+    if (addr == NULL) {
+        utils_munmap(reserved, reserved_size);
+        return NULL;
+    }
+
+    // release the unused head and tail of the reservation
+    if (aligned > head) {
+        utils_munmap(reserved, aligned - head);
+    }
+
+    if (head + reserved_size > tail) {
+        utils_munmap((void *)tail, head + reserved_size - tail);
+    }
+
+    return addr;
+}
+
 static umf_result_t devdax_initialize(void *params, void **provider) {
     umf_result_t ret;
 
@@ -104,7 +332,7 @@ static umf_result_t devdax_initialize(void *params, void **provider) {
     umf_devdax_memory_provider_params_t *in_params =
         (umf_devdax_memory_provider_params_t *)params;
 
-    if (in_params->path == NULL) {
+    if (in_params->path == NULL && !in_params->emulation) {
         LOG_ERR("devdax path is missing");
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
@@ -121,6 +349,7 @@ static umf_result_t devdax_initialize(void *params, void **provider) {
     }
 
     memset(devdax_provider, 0, sizeof(*devdax_provider));
+    devdax_provider->fd = -1;
 
     ret = devdax_translate_params(in_params, devdax_provider);
     if (ret != UMF_RESULT_SUCCESS) {
@@ -128,34 +357,60 @@ static umf_result_t devdax_initialize(void *params, void **provider) {
     }
 
     devdax_provider->size = in_params->size;
-    if (utils_copy_path(in_params->path, devdax_provider->path, PATH_MAX)) {
+    devdax_provider->emulation = in_params->emulation;
+    if (in_params->path &&
+        utils_copy_path(in_params->path, devdax_provider->path, PATH_MAX)) {
+        ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
         goto err_free_devdax_provider;
     }
 
-    int fd = utils_devdax_open(in_params->path);
-    if (fd == -1) {
-        LOG_ERR("cannot open the device DAX: %s", in_params->path);
-        ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
-        goto err_free_devdax_provider;
+    int fd;
+    if (devdax_provider->emulation) {
+        fd = devdax_emulation_open(devdax_provider);
+        if (fd == -1) {
+            LOG_ERR("cannot open the file emulating the device DAX: %s",
+                    devdax_provider->path);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_free_devdax_provider;
+        }
+
+        devdax_provider->base = devdax_emulation_mmap(
+            devdax_provider->size, devdax_provider->protection, fd, 0);
+    } else {
+        fd = utils_devdax_open(in_params->path);
+        if (fd == -1) {
+            LOG_ERR("cannot open the device DAX: %s", in_params->path);
+            ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_free_devdax_provider;
+        }
+
+        unsigned map_sync_flag = 0;
+        utils_translate_mem_visibility_flag(UMF_MEM_MAP_SYNC, &map_sync_flag);
+
+        // mmap /dev/dax with MAP_SYNC xor MAP_SHARED (if MAP_SYNC fails)
+        devdax_provider->base = utils_mmap_file(
+            NULL, devdax_provider->size, devdax_provider->protection,
+            map_sync_flag, fd, 0 /* offset */, NULL);
     }
 
-    unsigned map_sync_flag = 0;
-    utils_translate_mem_visibility_flag(UMF_MEM_MAP_SYNC, &map_sync_flag);
+    // the memfd has to be kept open to be shared with other processes
+    if (devdax_provider->emulation && devdax_provider->path[0] == '\0') {
+        devdax_provider->fd = fd;
+    } else {
+        utils_close_fd(fd);
+    }
 
-    // mmap /dev/dax with the MAP_SYNC xor MAP_SHARED flag (if MAP_SYNC fails)
-    devdax_provider->base = utils_mmap_file(NULL, devdax_provider->size,
-                                            devdax_provider->protection,
-                                            map_sync_flag, fd, 0 /* offset */);
-    utils_close_fd(fd);
     if (devdax_provider->base == NULL) {
         LOG_PDEBUG("devdax memory mapping failed (path=%s, size=%zu)",
-                   in_params->path, devdax_provider->size);
+                   devdax_provider->path, devdax_provider->size);
         ret = UMF_RESULT_ERROR_UNKNOWN;
-        goto err_free_devdax_provider;
+        goto err_close_fd;
     }
 
-    LOG_DEBUG("devdax memory mapped (path=%s, size=%zu, addr=%p)",
-              in_params->path, devdax_provider->size, devdax_provider->base);
+    LOG_DEBUG("devdax memory mapped (path=%s, size=%zu, addr=%p, "
+              "emulation=%i)",
+              devdax_provider->path, devdax_provider->size,
+              devdax_provider->base, devdax_provider->emulation);
 
     if (utils_mutex_init(&devdax_provider->lock) == NULL) {
         LOG_ERR("lock init failed");
@@ -163,12 +418,52 @@ static umf_result_t devdax_initialize(void *params, void **provider) {
         goto err_unmap_devdax;
     }
 
+    devdax_provider->free_extents = critnib_new();
+    if (!devdax_provider->free_extents) {
+        LOG_ERR("creating the map of free extents failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_mutex_destroy_not_free;
+    }
+
+    devdax_provider->free_extents_by_size = ravl_new(devdax_extent_compare);
+    if (!devdax_provider->free_extents_by_size) {
+        LOG_ERR("creating the tree of free extents failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_delete_free_extents;
+    }
+
+    devdax_provider->allocs = critnib_new();
+    if (!devdax_provider->allocs) {
+        LOG_ERR("creating the map of allocations failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_delete_free_extents_by_size;
+    }
+
+    // the whole device DAX is free at the beginning
+    ret = devdax_extent_add(devdax_provider, 0, devdax_provider->size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto err_delete_allocs;
+    }
+
     *provider = devdax_provider;
 
     return UMF_RESULT_SUCCESS;
 
+err_delete_allocs:
+    critnib_delete(devdax_provider->allocs);
+err_delete_free_extents_by_size:
+    ravl_delete(devdax_provider->free_extents_by_size);
+err_delete_free_extents:
+    critnib_delete(devdax_provider->free_extents);
+err_mutex_destroy_not_free:
+    utils_mutex_destroy_not_free(&devdax_provider->lock);
 err_unmap_devdax:
-    utils_munmap(devdax_provider->base, devdax_provider->size);
+    utils_munmap(devdax_provider->base,
+                 ALIGN_UP(devdax_provider->size, DEVDAX_PAGE_SIZE_2MB));
+err_close_fd:
+    if (devdax_provider->fd != -1) {
+        utils_close_fd(devdax_provider->fd);
+    }
 err_free_devdax_provider:
     umf_ba_global_free(devdax_provider);
     return ret;
@@ -181,49 +476,69 @@ static void devdax_finalize(void *provider) {
     }
 
     devdax_memory_provider_t *devdax_provider = provider;
+    devdax_extents_delete(devdax_provider);
+    critnib_delete(devdax_provider->allocs);
+    ravl_delete(devdax_provider->free_extents_by_size);
+    critnib_delete(devdax_provider->free_extents);
     utils_mutex_destroy_not_free(&devdax_provider->lock);
-    utils_munmap(devdax_provider->base, devdax_provider->size);
+    utils_munmap(devdax_provider->base,
+                 ALIGN_UP(devdax_provider->size, DEVDAX_PAGE_SIZE_2MB));
+    if (devdax_provider->fd != -1) {
+        utils_close_fd(devdax_provider->fd);
+    }
     umf_ba_global_free(devdax_provider);
 }
 
-static int devdax_alloc_aligned(size_t length, size_t alignment, void *base,
-                                size_t size, utils_mutex_t *lock,
-                                void **out_addr, size_t *offset) {
-    assert(out_addr);
-
-    if (utils_mutex_lock(lock)) {
-        LOG_ERR("locking file offset failed");
-        return -1;
+// devdax_alloc_extent - allocate 'size' bytes (a multiple of 2 MB)
+// from the best fitting free extent. It has to be called under the lock.
+static umf_result_t
+devdax_alloc_extent(devdax_memory_provider_t *devdax_provider, size_t size,
+                    size_t alignment, void **out_addr) {
+    devdax_extent_t *extent =
+        devdax_extent_find(devdax_provider, size, alignment);
+    if (extent == NULL) {
+        LOG_ERR("no free extent of the device DAX can hold %zu bytes "
+                "(alignment: %zu)",
+                size, alignment);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    uintptr_t ptr = (uintptr_t)base + *offset;
-    uintptr_t rest_of_div = alignment ? (ptr % alignment) : 0;
+    uintptr_t base = (uintptr_t)devdax_provider->base;
+    uintptr_t addr = ALIGN_UP(base + extent->offset, alignment);
+
+    size_t begin = extent->offset;
+    size_t end = extent->offset + extent->size;
+    size_t offset = addr - base;
 
-    if (alignment > 0 && rest_of_div > 0) {
-        ptr += alignment - rest_of_div;
+    int ret = critnib_insert(devdax_provider->allocs, addr, (void *)size,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("inserting a value to the map of allocations failed "
+                "(addr=%p, size=%zu)",
+                (void *)addr, size);
+        return UMF_RESULT_ERROR_UNKNOWN;
     }
 
-    size_t new_offset = ptr - (uintptr_t)base + length;
+    devdax_extent_remove(devdax_provider, extent);
 
-    if (new_offset > size) {
-        utils_mutex_unlock(lock);
-        LOG_ERR("cannot allocate more memory than the device DAX size: %zu",
-                size);
-        return -1;
+    // return the unused head and tail of the extent to the free extents
+    // (the space is lost only if the descriptor cannot be allocated)
+    if (offset > begin) {
+        (void)devdax_extent_add(devdax_provider, begin, offset - begin);
     }
 
-    *offset = new_offset;
-    *out_addr = (void *)ptr;
+    if (offset + size < end) {
+        (void)devdax_extent_add(devdax_provider, offset + size,
+                                end - (offset + size));
+    }
 
-    utils_mutex_unlock(lock);
+    *out_addr = (void *)addr;
 
-    return 0;
+    return UMF_RESULT_SUCCESS;
 }
 
 static umf_result_t devdax_alloc(void *provider, size_t size, size_t alignment,
                                  void **resultPtr) {
-    int ret;
-
     if (provider == NULL || resultPtr == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
@@ -238,19 +553,36 @@ static umf_result_t devdax_alloc(void *provider, size_t size, size_t alignment,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    if (IS_NOT_ALIGNED(alignment, DEVDAX_PAGE_SIZE_2MB)) {
-        alignment = ALIGN_UP(alignment, DEVDAX_PAGE_SIZE_2MB);
+    // all allocations are aligned at least to the page size
+    if (alignment < DEVDAX_PAGE_SIZE_2MB) {
+        alignment = DEVDAX_PAGE_SIZE_2MB;
     }
 
     devdax_memory_provider_t *devdax_provider =
         (devdax_memory_provider_t *)provider;
 
+    if (size > devdax_provider->size) {
+        devdax_store_last_native_error(UMF_DEVDAX_RESULT_ERROR_ALLOC_FAILED, 0);
+        LOG_ERR("cannot allocate more memory than the device DAX size: %zu",
+                devdax_provider->size);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    // the device DAX is allocated with the 2 MB granularity
+    size_t alloc_size = ALIGN_UP(size ? size : 1, DEVDAX_PAGE_SIZE_2MB);
+
+    if (utils_mutex_lock(&devdax_provider->lock)) {
+        LOG_ERR("locking the device DAX failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
     void *addr = NULL;
-    errno = 0;
-    ret = devdax_alloc_aligned(size, alignment, devdax_provider->base,
-                               devdax_provider->size, &devdax_provider->lock,
-                               &addr, &devdax_provider->offset);
-    if (ret) {
+    umf_result_t umf_result =
+        devdax_alloc_extent(devdax_provider, alloc_size, alignment, &addr);
+
+    utils_mutex_unlock(&devdax_provider->lock);
+
+    if (umf_result != UMF_RESULT_SUCCESS) {
         devdax_store_last_native_error(UMF_DEVDAX_RESULT_ERROR_ALLOC_FAILED, 0);
         LOG_ERR("memory allocation failed");
         return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
@@ -261,6 +593,57 @@ static umf_result_t devdax_alloc(void *provider, size_t size, size_t alignment,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t devdax_free(void *provider, void *ptr, size_t size) {
+    if (provider == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (size == 0) {
+        LOG_ERR("invalid size of deallocation: 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+    if (utils_mutex_lock(&devdax_provider->lock)) {
+        LOG_ERR("locking the device DAX failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    // the size of the allocation rounded up to 2 MB
+    size_t alloc_size =
+        (size_t)critnib_get(devdax_provider->allocs, (uintptr_t)ptr);
+    if (alloc_size == 0 || size > alloc_size) {
+        LOG_ERR("the memory is not allocated from the device DAX (addr=%p, "
+                "size=%zu)",
+                ptr, size);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_unlock;
+    }
+
+    critnib_remove(devdax_provider->allocs, (uintptr_t)ptr);
+
+    size_t offset = (uintptr_t)ptr - (uintptr_t)devdax_provider->base;
+    umf_result = devdax_extent_free(devdax_provider, offset, alloc_size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        devdax_store_last_native_error(UMF_DEVDAX_RESULT_ERROR_FREE_FAILED, 0);
+        LOG_ERR("adding a free extent failed (offset=%zu, size=%zu)", offset,
+                alloc_size);
+        umf_result = UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+err_unlock:
+    utils_mutex_unlock(&devdax_provider->lock);
+
+    return umf_result;
+}
+
 static void devdax_get_last_native_error(void *provider, const char **ppMessage,
                                          int32_t *pError) {
     (void)provider; // unused
@@ -342,6 +725,40 @@ static umf_result_t devdax_purge_force(void *provider, void *ptr, size_t size) {
     return UMF_RESULT_SUCCESS;
 }
 
+// The device DAX has no page cache, so its memory is durable once
+// the stores leave the CPU caches. The emulating file or memfd has to be
+// written back by the kernel instead.
+static umf_result_t devdax_persist(void *provider, const void *ptr,
+                                   size_t size) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+
+    uintptr_t base = (uintptr_t)devdax_provider->base;
+    if ((uintptr_t)ptr < base || (uintptr_t)ptr + size < (uintptr_t)ptr ||
+        (uintptr_t)ptr + size > base + devdax_provider->size) {
+        LOG_ERR("the memory does not belong to this provider (addr=%p, "
+                "size=%zu)",
+                ptr, size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!devdax_provider->emulation && utils_flush_cache(ptr, size) == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (utils_msync((void *)(uintptr_t)ptr, size)) {
+        devdax_store_last_native_error(UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED,
+                                       errno);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static const char *devdax_get_name(void *provider) {
     (void)provider; // unused
     return "DEVDAX";
@@ -350,27 +767,97 @@ static const char *devdax_get_name(void *provider) {
 static umf_result_t devdax_allocation_split(void *provider, void *ptr,
                                             size_t totalSize,
                                             size_t firstSize) {
-    (void)provider;
-    (void)ptr;
-    (void)totalSize;
-    (void)firstSize;
+    if (provider == NULL || ptr == NULL || firstSize == 0 ||
+        firstSize >= totalSize) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
-    return UMF_RESULT_SUCCESS;
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+    if (utils_mutex_lock(&devdax_provider->lock)) {
+        LOG_ERR("locking the device DAX failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    // the last part of the allocation keeps the rounded up tail
+    size_t alloc_size =
+        (size_t)critnib_get(devdax_provider->allocs, (uintptr_t)ptr);
+    if (alloc_size < totalSize) {
+        LOG_ERR("devdax_allocation_split(): the memory is not allocated "
+                "(addr=%p, size=%zu)",
+                ptr, totalSize);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_unlock;
+    }
+
+    int ret = critnib_insert(devdax_provider->allocs,
+                             (uintptr_t)ptr + firstSize,
+                             (void *)(alloc_size - firstSize), 0 /* update */);
+    if (ret) {
+        LOG_ERR("devdax_allocation_split(): inserting a value to the map of "
+                "allocations failed (addr=%p)",
+                (void *)((uintptr_t)ptr + firstSize));
+        umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_unlock;
+    }
+
+    critnib_insert(devdax_provider->allocs, (uintptr_t)ptr, (void *)firstSize,
+                   1 /* update */);
+
+err_unlock:
+    utils_mutex_unlock(&devdax_provider->lock);
+
+    return umf_result;
 }
 
 static umf_result_t devdax_allocation_merge(void *provider, void *lowPtr,
                                             void *highPtr, size_t totalSize) {
-    (void)provider;
+    if (provider == NULL || lowPtr == NULL || highPtr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
 
     if ((uintptr_t)highPtr <= (uintptr_t)lowPtr) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    if ((uintptr_t)highPtr - (uintptr_t)lowPtr <= totalSize) {
+    if ((uintptr_t)highPtr - (uintptr_t)lowPtr >= totalSize) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    return UMF_RESULT_SUCCESS;
+    devdax_memory_provider_t *devdax_provider =
+        (devdax_memory_provider_t *)provider;
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+
+    if (utils_mutex_lock(&devdax_provider->lock)) {
+        LOG_ERR("locking the device DAX failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    size_t low_size =
+        (size_t)critnib_get(devdax_provider->allocs, (uintptr_t)lowPtr);
+    size_t high_size =
+        (size_t)critnib_get(devdax_provider->allocs, (uintptr_t)highPtr);
+
+    // the rounded up tail of the lower allocation lies between them
+    if (low_size == 0 || high_size == 0 ||
+        (uintptr_t)lowPtr + low_size != (uintptr_t)highPtr) {
+        LOG_DEBUG("devdax_allocation_merge(): cannot merge allocations "
+                  "(low=%p, high=%p)",
+                  lowPtr, highPtr);
+        umf_result = UMF_RESULT_ERROR_NOT_SUPPORTED;
+        goto err_unlock;
+    }
+
+    critnib_remove(devdax_provider->allocs, (uintptr_t)highPtr);
+    critnib_insert(devdax_provider->allocs, (uintptr_t)lowPtr,
+                   (void *)(low_size + high_size), 1 /* update */);
+
+err_unlock:
+    utils_mutex_unlock(&devdax_provider->lock);
+
+    return umf_result;
 }
 
 typedef struct devdax_ipc_data_t {
@@ -378,7 +865,10 @@ typedef struct devdax_ipc_data_t {
     unsigned protection; // combination of OS-specific memory protection flags
     // offset of the data (from the beginning of the devdax mapping) - see devdax_get_ipc_handle()
     size_t offset;
-    size_t length; // length of the data
+    size_t length;  // length of the data
+    bool emulation; // a regular file or a memfd emulates the device DAX
+    int pid;        // pid of the process owning the memfd
+    int fd;         // memfd emulating the device DAX (or -1)
 } devdax_ipc_data_t;
 
 static umf_result_t devdax_get_ipc_handle_size(void *provider, size_t *size) {
@@ -407,6 +897,9 @@ static umf_result_t devdax_get_ipc_handle(void *provider, const void *ptr,
     devdax_ipc_data->offset =
         (size_t)((uintptr_t)ptr - (uintptr_t)devdax_provider->base);
     devdax_ipc_data->length = size;
+    devdax_ipc_data->emulation = devdax_provider->emulation;
+    devdax_ipc_data->pid = utils_getpid();
+    devdax_ipc_data->fd = devdax_provider->fd;
 
     return UMF_RESULT_SUCCESS;
 }
@@ -438,8 +931,23 @@ static umf_result_t devdax_open_ipc_handle(void *provider,
     }
 
     devdax_ipc_data_t *devdax_ipc_data = (devdax_ipc_data_t *)providerIpcData;
+    umf_result_t umf_result;
+    int fd;
+
+    if (devdax_ipc_data->fd != -1) {
+        umf_result = utils_duplicate_fd(devdax_ipc_data->pid,
+                                        devdax_ipc_data->fd, &fd);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_PERR("duplicating the memfd of the process %i failed",
+                     devdax_ipc_data->pid);
+            return umf_result;
+        }
+    } else if (devdax_ipc_data->emulation) {
+        fd = utils_file_open(devdax_ipc_data->path);
+    } else {
+        fd = utils_devdax_open(devdax_ipc_data->path);
+    }
 
-    int fd = utils_devdax_open(devdax_ipc_data->path);
     if (fd == -1) {
         LOG_PERR("opening the devdax (%s) failed", devdax_ipc_data->path);
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -448,18 +956,26 @@ static umf_result_t devdax_open_ipc_handle(void *provider,
     unsigned map_sync_flag = 0;
     utils_translate_mem_visibility_flag(UMF_MEM_MAP_SYNC, &map_sync_flag);
 
-    // It is just a workaround for case when
-    // devdax_alloc() was called with the size argument
-    // that is not a multiplier of DEVDAX_PAGE_SIZE_2MB.
+    // The data does not have to start at the page boundary (for example
+    // after devdax_allocation_split()), so the mapping starts at the page
+    // containing it. Its address is aligned to 2 MB, so that
+    // devdax_close_ipc_handle() can find the beginning of the mapping.
     size_t offset_aligned = devdax_ipc_data->offset;
     size_t length_aligned = devdax_ipc_data->length;
     utils_align_ptr_down_size_up((void **)&offset_aligned, &length_aligned,
                                  DEVDAX_PAGE_SIZE_2MB);
 
-    // mmap /dev/dax with the MAP_SYNC xor MAP_SHARED flag (if MAP_SYNC fails)
-    char *addr =
-        utils_mmap_file(NULL, length_aligned, devdax_ipc_data->protection,
-                        map_sync_flag, fd, offset_aligned);
+    char *addr;
+    if (devdax_ipc_data->emulation) {
+        addr = devdax_emulation_mmap(length_aligned,
+                                     devdax_ipc_data->protection, fd,
+                                     offset_aligned);
+    } else {
+        // mmap /dev/dax with MAP_SYNC xor MAP_SHARED (if MAP_SYNC fails)
+        addr = utils_mmap_file(NULL, length_aligned,
+                               devdax_ipc_data->protection, map_sync_flag, fd,
+                               offset_aligned, NULL);
+    }
     if (addr == NULL) {
         devdax_store_last_native_error(UMF_DEVDAX_RESULT_ERROR_ALLOC_FAILED,
                                        errno);
@@ -480,7 +996,7 @@ static umf_result_t devdax_open_ipc_handle(void *provider,
               devdax_ipc_data->path, length_aligned,
               devdax_ipc_data->protection, fd, offset_aligned, addr);
 
-    *ptr = addr;
+    *ptr = addr + (devdax_ipc_data->offset - offset_aligned);
 
     (void)utils_close_fd(fd);
 
@@ -493,7 +1009,8 @@ static umf_result_t devdax_close_ipc_handle(void *provider, void *ptr,
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
-    size = ALIGN_UP(size, DEVDAX_PAGE_SIZE_2MB);
+    // see devdax_open_ipc_handle()
+    utils_align_ptr_down_size_up(&ptr, &size, DEVDAX_PAGE_SIZE_2MB);
 
     errno = 0;
     int ret = utils_munmap(ptr, size);
@@ -518,10 +1035,12 @@ static umf_memory_provider_ops_t UMF_DEVDAX_MEMORY_PROVIDER_OPS = {
     .get_recommended_page_size = devdax_get_recommended_page_size,
     .get_min_page_size = devdax_get_min_page_size,
     .get_name = devdax_get_name,
+    .ext.free = devdax_free,
     .ext.purge_lazy = devdax_purge_lazy,
     .ext.purge_force = devdax_purge_force,
     .ext.allocation_merge = devdax_allocation_merge,
     .ext.allocation_split = devdax_allocation_split,
+    .ext.persist = devdax_persist,
     .ipc.get_ipc_handle_size = devdax_get_ipc_handle_size,
     .ipc.get_ipc_handle = devdax_get_ipc_handle,
     .ipc.put_ipc_handle = devdax_put_ipc_handle,
@@ -10,6 +10,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,36 +26,94 @@ umf_memory_provider_ops_t *umfFileMemoryProviderOps(void) {
     return NULL;
 }
 
+umf_result_t
+umfFileMemoryProviderSetRoot(umf_memory_provider_handle_t hProvider,
+                             void *ptr) {
+    // not supported
+    (void)hProvider; // unused
+    (void)ptr;       // unused
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
+umf_result_t
+umfFileMemoryProviderGetRoot(umf_memory_provider_handle_t hProvider,
+                             void **ptr) {
+    // not supported
+    (void)hProvider; // unused
+    (void)ptr;       // unused
+    return UMF_RESULT_ERROR_NOT_SUPPORTED;
+}
+
 #else // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
 
 #include "base_alloc_global.h"
 #include "critnib.h"
+#include "memory_provider_internal.h"
+#include "ravl.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
 
 #define TLS_MSG_BUF_LEN 1024
 
+// a memory mapping of a part of the file
+typedef struct file_mmap_t {
+    void *addr;       // address of the mapping
+    size_t size;      // size of the mapping
+    size_t offset_fd; // offset of the mapping in the file
+    size_t used;      // number of bytes allocated from the mapping
+    bool map_sync;    // the mapping was created with MAP_SYNC
+} file_mmap_t;
+
+// a free extent of the file
+typedef struct file_extent_t {
+    size_t offset_fd;  // offset of the extent in the file
+    size_t size;       // size of the extent
+    file_mmap_t *mmap; // mapping of the extent (NULL if it is not mapped)
+} file_extent_t;
+
 typedef struct file_memory_provider_t {
     utils_mutex_t lock; // lock for file parameters (size and offsets)
 
     char path[PATH_MAX]; // a path to the file
     int fd;              // file descriptor for memory mapping
     size_t size_fd;      // size of the file used for memory mappings
-    size_t offset_fd;    // offset in the file used for memory mappings
-
-    void *base_mmap;    // base address of the current memory mapping
-    size_t size_mmap;   // size of the current memory mapping
-    size_t offset_mmap; // data offset in the current memory mapping
+    size_t offset_fd;    // end of the part of the file used by memory mappings
 
     unsigned protection; // combination of OS-specific protection flags
     unsigned visibility; // memory visibility mode
     size_t page_size;    // minimum page size
 
+    size_t mmap_granularity; // minimum size of a memory mapping
+    size_t fallocate_ahead;  // size the file is extended by ahead of demand
+    unsigned prefetch;       // combination of 'umf_file_prefetch_flags_t'
+
     // IPC is enabled only for UMF_MEM_MAP_SHARED or UMF_MEM_MAP_SYNC visibility
     bool IPC_enabled;
 
-    critnib *mmaps; // a critnib map storing mmap mappings (addr, size)
+    // a critnib map storing mmap mappings (addr, file_mmap_t *)
+    critnib *mmaps;
+
+    // One empty memory mapping is kept mapped (with its pages released),
+    // so a loop of allocations and frees does not map and unmap
+    // the same window of the file over and over again.
+    file_mmap_t *empty_mmap;
+
+    // Free extents of the file below offset_fd. They are stored in a critnib
+    // map (offset_fd, file_extent_t *) used to coalesce neighbouring extents
+    // and in a RAVL tree sorted by (size, offset_fd) used to find
+    // the best fitting extent.
+    critnib *free_extents;
+    struct ravl *free_extents_by_size;
+
+    // the persistent heap mode (see file_heap_open())
+    bool persistent;
+    size_t persistent_max_allocs; // requested capacity of a new heap
+    size_t heap_header_size;      // size of the mapped header of the heap
+    size_t heap_n_allocs;         // number of live allocations of the heap
+    struct file_heap_header_t *heap; // the mapped header of the heap
+    critnib *allocs; // a critnib map of live allocations (fd_offset, size + 1)
+    void *root;      // the root object of the heap (NULL if not set)
 
     // A critnib map storing (ptr, fd_offset + 1) pairs. We add 1 to fd_offset
     // in order to be able to store fd_offset equal 0, because
@@ -81,12 +140,15 @@ static __TLS file_last_native_error_t TLS_last_native_error;
     (UMF_FILE_RESULT_ERROR_FREE_FAILED - UMF_FILE_RESULT_SUCCESS)
 #define _UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED                              \
     (UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED - UMF_FILE_RESULT_SUCCESS)
+#define _UMF_FILE_RESULT_ERROR_PERSIST_FAILED                                  \
+    (UMF_FILE_RESULT_ERROR_PERSIST_FAILED - UMF_FILE_RESULT_SUCCESS)
 
 static const char *Native_error_str[] = {
     [_UMF_FILE_RESULT_SUCCESS] = "success",
     [_UMF_FILE_RESULT_ERROR_ALLOC_FAILED] = "memory allocation failed",
     [_UMF_FILE_RESULT_ERROR_FREE_FAILED] = "memory deallocation failed",
     [_UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED] = "force purging failed",
+    [_UMF_FILE_RESULT_ERROR_PERSIST_FAILED] = "persisting memory failed",
 };
 
 static void file_store_last_native_error(int32_t native_error,
@@ -118,9 +180,832 @@ file_translate_params(umf_file_memory_provider_params_t *in_params,
     provider->IPC_enabled = (in_params->visibility == UMF_MEM_MAP_SHARED ||
                              in_params->visibility == UMF_MEM_MAP_SYNC);
 
+    if (in_params->mmap_granularity % provider->page_size) {
+        LOG_ERR("mmap granularity (%zu) is not a multiple of the page size "
+                "(%zu)",
+                in_params->mmap_granularity, provider->page_size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    provider->mmap_granularity = in_params->mmap_granularity
+                                     ? in_params->mmap_granularity
+                                     : provider->page_size;
+
+    provider->fallocate_ahead =
+        ALIGN_UP(in_params->fallocate_ahead, provider->page_size);
+    if (provider->fallocate_ahead < in_params->fallocate_ahead) {
+        LOG_ERR("invalid size of fallocate ahead: %zu",
+                in_params->fallocate_ahead);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (in_params->prefetch &
+        ~(unsigned)(UMF_FILE_PREFETCH_WILLNEED | UMF_FILE_PREFETCH_POPULATE)) {
+        LOG_ERR("incorrect prefetch flags: %u", in_params->prefetch);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((in_params->prefetch & UMF_FILE_PREFETCH_POPULATE) &&
+        !(in_params->protection & UMF_PROTECTION_READ)) {
+        LOG_ERR("populating memory requires the UMF_PROTECTION_READ "
+                "protection");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    provider->prefetch = in_params->prefetch;
+
+    // the persistent heap has to be written back to the file
+    if (in_params->persistent && !provider->IPC_enabled) {
+        LOG_ERR("the persistent heap mode requires UMF_MEM_MAP_SHARED "
+                "or UMF_MEM_MAP_SYNC visibility");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    provider->persistent = in_params->persistent;
+    provider->persistent_max_allocs =
+        in_params->persistent_max_allocs
+            ? in_params->persistent_max_allocs
+            : UMF_FILE_PERSISTENT_MAX_ALLOCS_DEFAULT;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// The compare function of the RAVL tree of free extents:
+// the extents are sorted by size first and then by the file offset.
+static int file_extent_compare(const void *lhs, const void *rhs) {
+    const file_extent_t *lhs_extent = (const file_extent_t *)lhs;
+    const file_extent_t *rhs_extent = (const file_extent_t *)rhs;
+
+    if (lhs_extent->size != rhs_extent->size) {
+        return (lhs_extent->size < rhs_extent->size) ? -1 : 1;
+    }
+
+    if (lhs_extent->offset_fd != rhs_extent->offset_fd) {
+        return (lhs_extent->offset_fd < rhs_extent->offset_fd) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static inline uintptr_t file_extent_addr(file_extent_t *extent) {
+    assert(extent->mmap);
+    return (uintptr_t)extent->mmap->addr +
+           (extent->offset_fd - extent->mmap->offset_fd);
+}
+
+// file_extent_add - add a free extent without coalescing it with its neighbours
+static umf_result_t file_extent_add(file_memory_provider_t *file_provider,
+                                    size_t offset_fd, size_t size,
+                                    file_mmap_t *map,
+                                    file_extent_t **out_extent) {
+    file_extent_t *extent = umf_ba_global_alloc(sizeof(*extent));
+    if (!extent) {
+        LOG_ERR("allocation of a free extent failed");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    extent->offset_fd = offset_fd;
+    extent->size = size;
+    extent->mmap = map;
+
+    int ret = critnib_insert(file_provider->free_extents, offset_fd, extent,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("inserting a value to the map of free extents failed "
+                "(offset=%zu, size=%zu)",
+                offset_fd, size);
+        umf_ba_global_free(extent);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    ret = ravl_insert(file_provider->free_extents_by_size, extent);
+    if (ret) {
+        LOG_ERR("inserting a value to the tree of free extents failed "
+                "(offset=%zu, size=%zu)",
+                offset_fd, size);
+        critnib_remove(file_provider->free_extents, offset_fd);
+        umf_ba_global_free(extent);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (out_extent) {
+        *out_extent = extent;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// file_extent_remove - remove a free extent and release its descriptor
+static void file_extent_remove(file_memory_provider_t *file_provider,
+                               file_extent_t *extent) {
+    struct ravl_node *node = ravl_find(file_provider->free_extents_by_size,
+                                       extent, RAVL_PREDICATE_EQUAL);
+    assert(node);
+    ravl_remove(file_provider->free_extents_by_size, node);
+
+    critnib_remove(file_provider->free_extents, extent->offset_fd);
+    umf_ba_global_free(extent);
+}
+
+// file_extent_free - add a free extent coalescing it with the free neighbours
+// of the same memory mapping (or with unmapped neighbours if map == NULL)
+static umf_result_t file_extent_free(file_memory_provider_t *file_provider,
+                                     size_t offset_fd, size_t size,
+                                     file_mmap_t *map,
+                                     file_extent_t **out_extent) {
+    size_t begin = offset_fd;
+    size_t end = offset_fd + size;
+    uintptr_t rkey;
+    void *rvalue;
+
+    if (begin > 0 && 1 == critnib_find(file_provider->free_extents, begin - 1,
+                                       FIND_LE, &rkey, &rvalue)) {
+        file_extent_t *prev = (file_extent_t *)rvalue;
+        assert(prev->offset_fd + prev->size <= begin);
+        if (prev->mmap == map && prev->offset_fd + prev->size == begin) {
+            begin = prev->offset_fd;
+            file_extent_remove(file_provider, prev);
+        }
+    }
+
+    file_extent_t *next = critnib_get(file_provider->free_extents, end);
+    if (next && next->mmap == map) {
+        end += next->size;
+        file_extent_remove(file_provider, next);
+    }
+
+    return file_extent_add(file_provider, begin, end - begin, map,
+                           out_extent);
+}
+
+// file_extent_find - find the smallest free extent that can hold
+// an allocation of the given size and alignment
+static file_extent_t *file_extent_find(file_memory_provider_t *file_provider,
+                                       size_t size, size_t alignment,
+                                       size_t window_size) {
+    file_extent_t key = {.offset_fd = 0, .size = size, .mmap = NULL};
+
+    struct ravl_node *node = ravl_find(file_provider->free_extents_by_size,
+                                       &key, RAVL_PREDICATE_GREATER_EQUAL);
+    for (; node; node = ravl_node_successor(node)) {
+        file_extent_t *extent = ravl_data(node);
+
+        // an unmapped extent has to hold a new memory mapping
+        if (extent->mmap == NULL) {
+            if (extent->size >= window_size) {
+                return extent;
+            }
+            continue;
+        }
+
+        uintptr_t addr = file_extent_addr(extent);
+        uintptr_t aligned_addr = ALIGN_UP(addr, alignment);
+        if (aligned_addr - addr <= extent->size - size) {
+            return extent;
+        }
+    }
+
+    return NULL;
+}
+
+// file_punch_hole - release the pages of the given free range of the file
+static void file_punch_hole(file_memory_provider_t *file_provider,
+                            file_mmap_t *map, size_t offset_fd, size_t size) {
+    ASSERT_IS_ALIGNED(offset_fd, file_provider->page_size);
+    ASSERT_IS_ALIGNED(size, file_provider->page_size);
+
+    if (map) {
+        // drop also private copies of the pages (UMF_MEM_MAP_PRIVATE)
+        void *addr = (char *)map->addr + (offset_fd - map->offset_fd);
+        if (utils_purge(addr, size, UMF_PURGE_FORCE)) {
+            LOG_PDEBUG("purging pages failed (addr=%p, size=%zu)", addr, size);
+        }
+    }
+
+    // a failure is not fatal here, the space stays allocated in the file
+    if (utils_punch_hole(file_provider->fd, offset_fd, size)) {
+        LOG_PDEBUG("punching a hole in the file failed (offset=%zu, size=%zu)",
+                   offset_fd, size);
+    }
+}
+
+// file_mmap_window - map the given page-aligned part of the file
+static umf_result_t file_mmap_window(file_memory_provider_t *file_provider,
+                                     size_t offset_fd, size_t size,
+                                     file_mmap_t **out_mmap) {
+    int prot = file_provider->protection;
+    int flag = file_provider->visibility;
+    int fd = file_provider->fd;
+
+    assert(fd > 0);
+    ASSERT_IS_ALIGNED(offset_fd, file_provider->page_size);
+    ASSERT_IS_ALIGNED(size, file_provider->page_size);
+
+    // The space of the file is allocated only for the allocated memory
+    // (see file_alloc_aligned()), so the file may be extended sparsely here
+    // unless it should be extended (and allocated) ahead of demand.
+    size_t size_fd = file_provider->size_fd;
+    if (offset_fd + size > size_fd) {
+        size_t new_size_fd = offset_fd + size + file_provider->fallocate_ahead;
+        if (new_size_fd < offset_fd + size) {
+            LOG_ERR("arithmetic overflow of file size");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        int ret;
+        if (file_provider->fallocate_ahead) {
+            ret = utils_fallocate(fd, (long)size_fd,
+                                  (long)(new_size_fd - size_fd));
+        } else {
+            ret = utils_set_file_size(fd, new_size_fd);
+        }
+        if (ret) {
+            LOG_ERR("cannot grow the file size from %zu to %zu", size_fd,
+                    new_size_fd);
+            return UMF_RESULT_ERROR_UNKNOWN;
+        }
+
+        LOG_DEBUG("file size grown from %zu to %zu", size_fd, new_size_fd);
+        file_provider->size_fd = new_size_fd;
+    }
+
+    file_mmap_t *map = umf_ba_global_alloc(sizeof(*map));
+    if (!map) {
+        LOG_ERR("allocation of a memory mapping descriptor failed");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    bool map_sync = false;
+    void *ptr =
+        utils_mmap_file(NULL, size, prot, flag, fd, offset_fd, &map_sync);
+    if (ptr == NULL) {
+        LOG_PERR("memory mapping failed");
+        umf_ba_global_free(map);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    map->addr = ptr;
+    map->size = size;
+    map->offset_fd = offset_fd;
+    map->used = 0;
+    map->map_sync = map_sync;
+
+    int ret = critnib_insert(file_provider->mmaps, (uintptr_t)ptr, map,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("inserting a value to the map of memory mapping failed "
+                "(addr=%p, size=%zu)",
+                ptr, size);
+        utils_munmap(ptr, size);
+        umf_ba_global_free(map);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    LOG_DEBUG(
+        "inserted a value to the map of memory mapping (addr=%p, size=%zu)",
+        ptr, size);
+
+    *out_mmap = map;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// file_munmap_window - unmap the given memory mapping and release its space
+static void file_munmap_window(file_memory_provider_t *file_provider,
+                               file_mmap_t *map) {
+    critnib_remove(file_provider->mmaps, (uintptr_t)map->addr);
+
+    if (utils_munmap(map->addr, map->size)) {
+        LOG_PERR("unmapping memory failed (addr=%p, size=%zu)", map->addr,
+                 map->size);
+    }
+
+    LOG_DEBUG("removed the memory mapping (addr=%p, size=%zu)", map->addr,
+              map->size);
+
+    file_punch_hole(file_provider, NULL, map->offset_fd, map->size);
+    umf_ba_global_free(map);
+}
+
+// file_release_empty_window - unmap the memory mapping of the given free
+// extent covering the whole mapping and keep its part of the file
+// as an unmapped free extent
+static void file_release_empty_window(file_memory_provider_t *file_provider,
+                                      file_extent_t *extent) {
+    file_mmap_t *map = extent->mmap;
+    size_t offset_fd = map->offset_fd;
+    size_t size = map->size;
+
+    assert(map->used == 0);
+    assert(extent->offset_fd == offset_fd);
+    assert(extent->size == size);
+
+    if (file_provider->empty_mmap == map) {
+        file_provider->empty_mmap = NULL;
+    }
+
+    file_extent_remove(file_provider, extent);
+    file_munmap_window(file_provider, map);
+
+    umf_result_t umf_result =
+        file_extent_free(file_provider, offset_fd, size, NULL, NULL);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        LOG_ERR("lost an unmapped free extent of the file");
+    }
+}
+
+// The persistent heap mode:
+// The file starts with a page-aligned header followed by the heap.
+// The header contains two logs of allocation operations, each of them
+// can hold the snapshot of persistent_max_allocs live allocations.
+// The active log is appended on every operation, and when it is full,
+// a snapshot of the live allocations is written to the other log
+// which becomes active then. On opening an existing heap file the active
+// log is replayed to rebuild the map of live allocations and the used part
+// of the heap is mapped as a single memory mapping.
+
+#define FILE_HEAP_SIGNATURE "UMF_FILE_HEAP"
+#define FILE_HEAP_SIGNATURE_LEN 16
+#define FILE_HEAP_VERSION 1
+
+typedef enum file_heap_op_t {
+    FILE_HEAP_OP_ALLOC = 1, // (offset, size)
+    FILE_HEAP_OP_FREE,      // (offset, size)
+    FILE_HEAP_OP_SPLIT,     // (offset, total size, first size)
+    FILE_HEAP_OP_MERGE,     // (low offset, total size, high offset)
+} file_heap_op_t;
+
+typedef struct file_heap_log_entry_t {
+    uint64_t op;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t arg;
+} file_heap_log_entry_t;
+
+typedef struct file_heap_header_t {
+    char signature[FILE_HEAP_SIGNATURE_LEN];
+    uint64_t version;
+    uint64_t header_size;   // size of the header (including the logs)
+    uint64_t heap_end;      // end of the part of the file used by the heap
+    uint64_t root_offset;   // offset of the root object + 1 (0 if not set)
+    uint64_t log_capacity;  // maximum number of entries of one log
+    uint64_t log_active;    // index of the active log (0 or 1)
+    uint64_t log_length[2]; // number of valid entries of the logs
+    file_heap_log_entry_t log[];
+} file_heap_header_t;
+
+// file_heap_header_size - size of the header of the heap with logs
+// of the given capacity or 0 on an arithmetic overflow
+static size_t file_heap_header_size(uint64_t log_capacity, size_t page_size) {
+    if (log_capacity > (SIZE_MAX - sizeof(file_heap_header_t) - page_size) /
+                           (2 * sizeof(file_heap_log_entry_t))) {
+        return 0;
+    }
+
+    return ALIGN_UP(sizeof(file_heap_header_t) +
+                        2 * (size_t)log_capacity * sizeof(file_heap_log_entry_t),
+                    page_size);
+}
+
+static inline file_heap_log_entry_t *file_heap_log_get(file_heap_header_t *heap,
+                                                       uint64_t log) {
+    return &heap->log[log * heap->log_capacity];
+}
+
+// file_heap_apply - apply the logged operation to the map of live allocations
+// (offset_fd, size + 1)
+static int file_heap_apply(critnib *allocs, file_heap_log_entry_t *entry) {
+    int ret = 0;
+
+    switch (entry->op) {
+    case FILE_HEAP_OP_ALLOC:
+        ret = critnib_insert(allocs, entry->offset,
+                             (void *)(uintptr_t)(entry->size + 1), 1);
+        break;
+    case FILE_HEAP_OP_FREE:
+        critnib_remove(allocs, entry->offset);
+        break;
+    case FILE_HEAP_OP_SPLIT:
+        if (entry->arg == 0 || entry->arg >= entry->size) {
+            return -1;
+        }
+        ret = critnib_insert(allocs, entry->offset,
+                             (void *)(uintptr_t)(entry->arg + 1), 1);
+        if (ret == 0) {
+            ret = critnib_insert(
+                allocs, entry->offset + entry->arg,
+                (void *)(uintptr_t)(entry->size - entry->arg + 1), 1);
+        }
+        break;
+    case FILE_HEAP_OP_MERGE:
+        critnib_remove(allocs, entry->arg);
+        ret = critnib_insert(allocs, entry->offset,
+                             (void *)(uintptr_t)(entry->size + 1), 1);
+        break;
+    default:
+        return -1;
+    }
+
+    return ret;
+}
+
+// file_heap_log_compact - write a snapshot of the live allocations
+// to the inactive log and make it active
+static umf_result_t
+file_heap_log_compact(file_memory_provider_t *file_provider) {
+    file_heap_header_t *heap = file_provider->heap;
+    uint64_t log = 1 - heap->log_active;
+    file_heap_log_entry_t *entries = file_heap_log_get(heap, log);
+    uint64_t length = 0;
+    uintptr_t rkey;
+    void *rvalue;
+
+    uintptr_t key = 0;
+    while (1 == critnib_find(file_provider->allocs, key, FIND_GE, &rkey,
+                             &rvalue)) {
+        if (length == heap->log_capacity) {
+            LOG_ERR("too many allocations in the persistent heap (%zu)",
+                    (size_t)length);
+            return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+        }
+
+        entries[length].op = FILE_HEAP_OP_ALLOC;
+        entries[length].offset = rkey;
+        entries[length].size = (uintptr_t)rvalue - 1;
+        entries[length].arg = 0;
+        length++;
+        key = rkey + 1;
+    }
+
+    heap->log_length[log] = length;
+    utils_atomic_store_release(&heap->log_active, log);
+    file_provider->heap_n_allocs = length;
+
+    LOG_DEBUG("compacted the log of the persistent heap (%zu entries)",
+              (size_t)length);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// file_heap_log_reserve - make room for one entry in the active log
+// of an operation adding the given number of allocations (0 or 1)
+static umf_result_t
+file_heap_log_reserve(file_memory_provider_t *file_provider,
+                      size_t new_allocs) {
+    if (!file_provider->persistent) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    file_heap_header_t *heap = file_provider->heap;
+
+    // A snapshot of all live allocations and one more entry have to fit
+    // in a log, so operations that do not add allocations never fail.
+    if (file_provider->heap_n_allocs + new_allocs > heap->log_capacity - 1) {
+        LOG_ERR("too many allocations in the persistent heap (max %zu)",
+                (size_t)heap->log_capacity - 1);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (heap->log_length[heap->log_active] < heap->log_capacity) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    umf_result_t umf_result = file_heap_log_compact(file_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    if (heap->log_length[heap->log_active] == heap->log_capacity) {
+        LOG_ERR("the log of the persistent heap is full");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// file_heap_log - log the operation (the room has to be reserved before)
+static void file_heap_log(file_memory_provider_t *file_provider,
+                          file_heap_op_t op, size_t offset_fd, size_t size,
+                          size_t arg) {
+    if (!file_provider->persistent) {
+        return;
+    }
+
+    file_heap_header_t *heap = file_provider->heap;
+    file_heap_log_entry_t entry = {op, offset_fd, size, arg};
+
+    if (file_heap_apply(file_provider->allocs, &entry)) {
+        LOG_ERR("updating the map of allocations failed (op=%i, offset=%zu, "
+                "size=%zu)",
+                (int)op, offset_fd, size);
+    }
+
+    switch (op) {
+    case FILE_HEAP_OP_ALLOC:
+    case FILE_HEAP_OP_SPLIT:
+        file_provider->heap_n_allocs++;
+        break;
+    case FILE_HEAP_OP_FREE:
+    case FILE_HEAP_OP_MERGE:
+        file_provider->heap_n_allocs--;
+        break;
+    }
+
+    uint64_t log = heap->log_active;
+    uint64_t length = heap->log_length[log];
+    assert(length < heap->log_capacity);
+
+    file_heap_log_get(heap, log)[length] = entry;
+    utils_atomic_store_release(&heap->log_length[log], length + 1);
+}
+
+// file_heap_rebuild - map the used part of the heap and rebuild the free
+// extents and the file descriptor offset map from the map of allocations
+static umf_result_t file_heap_rebuild(file_memory_provider_t *file_provider) {
+    file_heap_header_t *heap = file_provider->heap;
+    size_t begin = heap->header_size;
+    size_t end = heap->heap_end;
+    umf_result_t umf_result;
+    file_mmap_t *map;
+    file_extent_t *extent = NULL;
+    uintptr_t rkey;
+    void *rvalue;
+
+    file_provider->offset_fd = end;
+    if (end == begin) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    umf_result = file_mmap_window(file_provider, begin, end - begin, &map);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    size_t offset_fd = begin; // end of the previous allocation
+    uintptr_t key = 0;
+    while (1 == critnib_find(file_provider->allocs, key, FIND_GE, &rkey,
+                             &rvalue)) {
+        size_t size = (uintptr_t)rvalue - 1;
+        if (rkey < offset_fd || rkey + size < rkey || rkey + size > end) {
+            LOG_ERR("invalid allocation in the persistent heap (offset=%zu, "
+                    "size=%zu)",
+                    (size_t)rkey, size);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (rkey > offset_fd) {
+            umf_result = file_extent_add(file_provider, offset_fd,
+                                         rkey - offset_fd, map, NULL);
+            if (umf_result != UMF_RESULT_SUCCESS) {
+                return umf_result;
+            }
+        }
+
+        void *addr = (char *)map->addr + (rkey - begin);
+        int ret = critnib_insert(file_provider->fd_offset_map, (uintptr_t)addr,
+                                 (void *)(uintptr_t)(rkey + 1), 0 /* update */);
+        if (ret) {
+            LOG_ERR("inserting a value to the file descriptor offset map "
+                    "failed (addr=%p, offset=%zu)",
+                    addr, (size_t)rkey);
+            return UMF_RESULT_ERROR_UNKNOWN;
+        }
+
+        map->used += size;
+        offset_fd = rkey + size;
+        key = rkey + 1;
+    }
+
+    if (end > offset_fd) {
+        umf_result = file_extent_add(file_provider, offset_fd, end - offset_fd,
+                                     map, &extent);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            return umf_result;
+        }
+    }
+
+    if (map->used == 0) {
+        // the heap is empty
+        file_release_empty_window(file_provider, extent);
+    }
+
+    if (heap->root_offset) {
+        size_t root_offset = heap->root_offset - 1;
+        if (critnib_get(file_provider->allocs, root_offset) == NULL) {
+            LOG_ERR("invalid root object of the persistent heap (offset=%zu)",
+                    root_offset);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        file_provider->root = (char *)map->addr + (root_offset - begin);
+    }
+
     return UMF_RESULT_SUCCESS;
 }
 
+// file_heap_get_header_size - get the size of the header of the existing
+// heap from its first page
+static umf_result_t
+file_heap_get_header_size(file_memory_provider_t *file_provider,
+                          unsigned protection, size_t file_size,
+                          size_t *header_size) {
+    size_t page_size = file_provider->page_size;
+
+    if (file_size < page_size) {
+        LOG_ERR("the file is not a persistent heap: %s", file_provider->path);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    file_heap_header_t *heap =
+        utils_mmap_file(NULL, page_size, protection, file_provider->visibility,
+                        file_provider->fd, 0, NULL);
+    if (heap == NULL) {
+        LOG_PERR("mapping the header of the persistent heap failed");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    umf_result_t umf_result = UMF_RESULT_SUCCESS;
+    if (memcmp(heap->signature, FILE_HEAP_SIGNATURE,
+               sizeof(FILE_HEAP_SIGNATURE)) ||
+        heap->version != FILE_HEAP_VERSION || heap->log_capacity == 0 ||
+        heap->header_size !=
+            file_heap_header_size(heap->log_capacity, page_size) ||
+        heap->header_size > file_size) {
+        LOG_ERR("the file is not a valid persistent heap: %s",
+                file_provider->path);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    } else {
+        *header_size = heap->header_size;
+    }
+
+    utils_munmap(heap, page_size);
+
+    return umf_result;
+}
+
+// file_heap_open - create a new persistent heap in an empty file
+// or open the existing one
+static umf_result_t file_heap_open(file_memory_provider_t *file_provider) {
+    int fd = file_provider->fd;
+    size_t file_size;
+    size_t header_size = 0;
+    uint64_t log_capacity = 0;
+    umf_result_t umf_result;
+    unsigned protection;
+
+    // Concurrent writers would corrupt the log, so the heap can be opened
+    // by one provider at a time. The lock is released when the file is closed.
+    if (utils_file_lock_exclusive(fd)) {
+        LOG_PERR("cannot lock the file of the persistent heap, it can be "
+                 "opened by another provider: %s",
+                 file_provider->path);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (utils_get_file_size(fd, &file_size)) {
+        LOG_ERR("cannot get size of the file: %s", file_provider->path);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    umf_result = utils_translate_mem_protection_flags(
+        UMF_PROTECTION_READ | UMF_PROTECTION_WRITE, &protection);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    bool create = (file_size == 0);
+    if (create) {
+        // one more entry, so the next operation can be logged
+        // after a snapshot of persistent_max_allocs allocations
+        log_capacity = (uint64_t)file_provider->persistent_max_allocs + 1;
+        header_size = file_heap_header_size(log_capacity,
+                                            file_provider->page_size);
+        if (log_capacity == 0 || header_size == 0) {
+            LOG_ERR("invalid maximum number of allocations of the persistent "
+                    "heap: %zu",
+                    file_provider->persistent_max_allocs);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+
+        file_size = header_size;
+        if (utils_set_file_size(fd, file_size)) {
+            LOG_ERR("cannot set size of the file: %s", file_provider->path);
+            return UMF_RESULT_ERROR_UNKNOWN;
+        }
+    } else {
+        umf_result = file_heap_get_header_size(file_provider, protection,
+                                               file_size, &header_size);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            return umf_result;
+        }
+    }
+
+    file_provider->size_fd = file_size;
+
+    file_heap_header_t *heap =
+        utils_mmap_file(NULL, header_size, protection,
+                        file_provider->visibility, fd, 0, NULL);
+    if (heap == NULL) {
+        LOG_PERR("mapping the header of the persistent heap failed");
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    file_provider->heap = heap;
+    file_provider->heap_header_size = header_size;
+
+    if (create) {
+        heap->version = FILE_HEAP_VERSION;
+        heap->header_size = header_size;
+        heap->heap_end = header_size;
+        heap->root_offset = 0;
+        heap->log_capacity = log_capacity;
+        heap->log_active = 0;
+        heap->log_length[0] = 0;
+        heap->log_length[1] = 0;
+        // the signature is written as the last one
+        memcpy(heap->signature, FILE_HEAP_SIGNATURE,
+               sizeof(FILE_HEAP_SIGNATURE));
+
+        file_provider->offset_fd = header_size;
+
+        LOG_DEBUG("created a persistent heap in the file: %s",
+                  file_provider->path);
+
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (memcmp(heap->signature, FILE_HEAP_SIGNATURE,
+               sizeof(FILE_HEAP_SIGNATURE)) ||
+        heap->version != FILE_HEAP_VERSION ||
+        heap->header_size != header_size ||
+        heap->header_size !=
+            file_heap_header_size(heap->log_capacity,
+                                  file_provider->page_size) ||
+        heap->log_active > 1 ||
+        heap->log_length[heap->log_active] > heap->log_capacity ||
+        heap->heap_end < heap->header_size || heap->heap_end > file_size ||
+        !IS_ALIGNED(heap->heap_end, file_provider->page_size)) {
+        LOG_ERR("the file is not a valid persistent heap: %s",
+                file_provider->path);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // replay the active log
+    uint64_t log = heap->log_active;
+    file_heap_log_entry_t *entries = file_heap_log_get(heap, log);
+    for (uint64_t i = 0; i < heap->log_length[log]; i++) {
+        if (file_heap_apply(file_provider->allocs, &entries[i])) {
+            LOG_ERR("invalid entry %zu of the log of the persistent heap: %s",
+                    (size_t)i, file_provider->path);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    umf_result = file_heap_rebuild(file_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    LOG_DEBUG("opened the persistent heap in the file: %s (size=%zu)",
+              file_provider->path, (size_t)heap->heap_end);
+
+    // start with a compact log
+    return file_heap_log_compact(file_provider);
+}
+
+// file_release_mappings - unmap all memory mappings of the file
+// (without releasing the space of the file) and drop the free extents
+static void file_release_mappings(file_memory_provider_t *file_provider) {
+    uintptr_t key = 0;
+    uintptr_t rkey = 0;
+    void *rvalue = NULL;
+    while (1 ==
+           critnib_find(file_provider->mmaps, key, FIND_G, &rkey, &rvalue)) {
+        file_mmap_t *map = (file_mmap_t *)rvalue;
+        utils_munmap(map->addr, map->size);
+        critnib_remove(file_provider->mmaps, rkey);
+        umf_ba_global_free(map);
+        key = rkey;
+    }
+
+    // the free extents are owned by the critnib map,
+    // the RAVL tree stores only pointers to them
+    while (1 == critnib_find(file_provider->free_extents, 0, FIND_GE, &rkey,
+                             &rvalue)) {
+        struct ravl_node *node = ravl_find(file_provider->free_extents_by_size,
+                                           rvalue, RAVL_PREDICATE_EQUAL);
+        if (node) {
+            ravl_remove(file_provider->free_extents_by_size, node);
+        }
+        critnib_remove(file_provider->free_extents, rkey);
+        umf_ba_global_free(rvalue);
+    }
+
+    if (file_provider->heap) {
+        utils_munmap(file_provider->heap, file_provider->heap_header_size);
+        file_provider->heap = NULL;
+    }
+}
+
 static umf_result_t file_initialize(void *params, void **provider) {
     umf_result_t ret;
 
@@ -164,16 +1049,19 @@ static umf_result_t file_initialize(void *params, void **provider) {
         goto err_free_file_provider;
     }
 
-    if (utils_set_file_size(file_provider->fd, page_size)) {
-        LOG_ERR("cannot set size of the file: %s", in_params->path);
-        ret = UMF_RESULT_ERROR_UNKNOWN;
-        goto err_close_fd;
-    }
+    // the file of the persistent heap is set up by file_heap_open()
+    if (!file_provider->persistent) {
+        if (utils_set_file_size(file_provider->fd, page_size)) {
+            LOG_ERR("cannot set size of the file: %s", in_params->path);
+            ret = UMF_RESULT_ERROR_UNKNOWN;
+            goto err_close_fd;
+        }
 
-    file_provider->size_fd = page_size;
+        file_provider->size_fd = page_size;
 
-    LOG_DEBUG("size of the file %s is: %zu", in_params->path,
-              file_provider->size_fd);
+        LOG_DEBUG("size of the file %s is: %zu", in_params->path,
+                  file_provider->size_fd);
+    }
 
     if (utils_mutex_init(&file_provider->lock) == NULL) {
         LOG_ERR("lock init failed");
@@ -195,10 +1083,48 @@ static umf_result_t file_initialize(void *params, void **provider) {
         goto err_delete_fd_offset_map;
     }
 
+    file_provider->free_extents = critnib_new();
+    if (!file_provider->free_extents) {
+        LOG_ERR("creating the map of free extents failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_delete_mmaps;
+    }
+
+    file_provider->free_extents_by_size = ravl_new(file_extent_compare);
+    if (!file_provider->free_extents_by_size) {
+        LOG_ERR("creating the tree of free extents failed");
+        ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        goto err_delete_free_extents;
+    }
+
+    if (file_provider->persistent) {
+        file_provider->allocs = critnib_new();
+        if (!file_provider->allocs) {
+            LOG_ERR("creating the map of allocations failed");
+            ret = UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+            goto err_delete_free_extents_by_size;
+        }
+
+        ret = file_heap_open(file_provider);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("opening the persistent heap failed: %s", in_params->path);
+            goto err_release_mappings;
+        }
+    }
+
     *provider = file_provider;
 
     return UMF_RESULT_SUCCESS;
 
+err_release_mappings:
+    file_release_mappings(file_provider);
+    critnib_delete(file_provider->allocs);
+err_delete_free_extents_by_size:
+    ravl_delete(file_provider->free_extents_by_size);
+err_delete_free_extents:
+    critnib_delete(file_provider->free_extents);
+err_delete_mmaps:
+    critnib_delete(file_provider->mmaps);
 err_delete_fd_offset_map:
     critnib_delete(file_provider->fd_offset_map);
 err_mutex_destroy_not_free:
@@ -213,110 +1139,28 @@ err_free_file_provider:
 static void file_finalize(void *provider) {
     if (provider == NULL) {
         assert(0);
-        return;
-    }
-
-    file_memory_provider_t *file_provider = provider;
-
-    uintptr_t key = 0;
-    uintptr_t rkey = 0;
-    void *rvalue = NULL;
-    while (1 ==
-           critnib_find(file_provider->mmaps, key, FIND_G, &rkey, &rvalue)) {
-        utils_munmap((void *)rkey, (size_t)rvalue);
-        critnib_remove(file_provider->mmaps, rkey);
-        key = rkey;
-    }
-
-    utils_mutex_destroy_not_free(&file_provider->lock);
-    utils_close_fd(file_provider->fd);
-    critnib_delete(file_provider->fd_offset_map);
-    critnib_delete(file_provider->mmaps);
-    umf_ba_global_free(file_provider);
-}
-
-static umf_result_t file_mmap_aligned(file_memory_provider_t *file_provider,
-                                      size_t size, size_t alignment) {
-    int prot = file_provider->protection;
-    int flag = file_provider->visibility;
-    int fd = file_provider->fd;
-    size_t size_fd = file_provider->size_fd;
-    size_t offset_fd = file_provider->offset_fd;
-    size_t page_size = file_provider->page_size;
-
-    assert(fd > 0);
-
-    // We have to increase size by alignment to be able to "cut out"
-    // the correctly aligned part of the memory
-    size_t extended_size = size + alignment;
-    if (extended_size < size) {
-        LOG_ERR("invalid size of allocation");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
-    }
-
-    size_t rest = extended_size & (page_size - 1);
-    if (rest) {
-        extended_size += page_size - rest;
-    }
-    if (extended_size < size) {
-        LOG_ERR("invalid size of allocation");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
-    }
-
-    // offset_fd has to be also page-aligned since it is the offset of mmap()
-    size_t aligned_offset_fd = offset_fd;
-    rest = aligned_offset_fd & (page_size - 1);
-    if (rest) {
-        aligned_offset_fd += page_size - rest;
-    }
-    if (aligned_offset_fd < offset_fd) {
-        LOG_ERR("arithmetic overflow of file offset");
-        return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
-    }
-
-    if (aligned_offset_fd + extended_size > size_fd) {
-        size_t new_size_fd = aligned_offset_fd + extended_size;
-        if (utils_fallocate(fd, size_fd, new_size_fd - size_fd)) {
-            LOG_ERR("cannot grow the file size from %zu to %zu", size_fd,
-                    new_size_fd);
-            return UMF_RESULT_ERROR_UNKNOWN;
-        }
-
-        LOG_DEBUG("file size grown from %zu to %zu", size_fd, new_size_fd);
-        file_provider->size_fd = new_size_fd;
-    }
-
-    if (aligned_offset_fd > offset_fd) {
-        file_provider->offset_fd = aligned_offset_fd;
-    }
-
-    ASSERT_IS_ALIGNED(extended_size, page_size);
-    ASSERT_IS_ALIGNED(aligned_offset_fd, page_size);
-
-    void *ptr =
-        utils_mmap_file(NULL, extended_size, prot, flag, fd, aligned_offset_fd);
-    if (ptr == NULL) {
-        LOG_PERR("memory mapping failed");
-        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
-    }
-
-    int ret = critnib_insert(file_provider->mmaps, (uintptr_t)ptr,
-                             (void *)(uintptr_t)extended_size, 0 /* update */);
-    if (ret) {
-        LOG_ERR("inserting a value to the map of memory mapping failed "
-                "(addr=%p, size=%zu)",
-                ptr, extended_size);
+        return;
     }
 
-    LOG_DEBUG(
-        "inserted a value to the map of memory mapping (addr=%p, size=%zu)",
-        ptr, extended_size);
+    file_memory_provider_t *file_provider = provider;
 
-    file_provider->base_mmap = ptr;
-    file_provider->size_mmap = extended_size;
-    file_provider->offset_mmap = 0;
+    if (file_provider->persistent) {
+        // leave a compact log in the file
+        (void)file_heap_log_compact(file_provider);
+    }
 
-    return UMF_RESULT_SUCCESS;
+    file_release_mappings(file_provider);
+
+    utils_mutex_destroy_not_free(&file_provider->lock);
+    utils_close_fd(file_provider->fd);
+    critnib_delete(file_provider->fd_offset_map);
+    critnib_delete(file_provider->mmaps);
+    critnib_delete(file_provider->free_extents);
+    ravl_delete(file_provider->free_extents_by_size);
+    if (file_provider->allocs) {
+        critnib_delete(file_provider->allocs);
+    }
+    umf_ba_global_free(file_provider);
 }
 
 static umf_result_t file_alloc_aligned(file_memory_provider_t *file_provider,
@@ -327,65 +1171,167 @@ static umf_result_t file_alloc_aligned(file_memory_provider_t *file_provider,
     assert(out_addr);
 
     umf_result_t umf_result;
+    size_t page_size = file_provider->page_size;
+
+    if (alignment == 0) {
+        alignment = 1;
+    }
+
+    // A new memory mapping is page-aligned, so it has to be increased
+    // by alignment only if the alignment is bigger than the page size
+    // to be able to "cut out" the correctly aligned part of the memory
+    size_t window_size = size;
+    if (alignment > page_size) {
+        window_size += alignment;
+    }
+    if (window_size < size) {
+        LOG_ERR("invalid size of allocation");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
+    }
+
+    window_size = ALIGN_UP(window_size, page_size);
+    if (window_size < size) {
+        LOG_ERR("invalid size of allocation");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
+    }
+
+    // create big memory mappings to limit their number
+    size_t rest = window_size % file_provider->mmap_granularity;
+    if (rest) {
+        window_size += file_provider->mmap_granularity - rest;
+        if (window_size < size) {
+            LOG_ERR("invalid size of allocation");
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT; // arithmetic overflow
+        }
+    }
 
     if (utils_mutex_lock(&file_provider->lock)) {
         LOG_ERR("locking file data failed");
         return UMF_RESULT_ERROR_UNKNOWN;
     }
 
-    if (file_provider->size_mmap - file_provider->offset_mmap < size) {
-        umf_result = file_mmap_aligned(file_provider, size, alignment);
+    umf_result = file_heap_log_reserve(file_provider, 1);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        goto err_unlock;
+    }
+
+    file_mmap_t *map = NULL;
+    file_extent_t *extent =
+        file_extent_find(file_provider, size, alignment, window_size);
+
+    if (extent == NULL) {
+        // no free extent fits - map a new part of the file at its end
+        size_t offset_fd = file_provider->offset_fd;
+        if (offset_fd + window_size < offset_fd) {
+            LOG_ERR("arithmetic overflow of file offset");
+            umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+            goto err_unlock;
+        }
+
+        umf_result =
+            file_mmap_window(file_provider, offset_fd, window_size, &map);
         if (umf_result != UMF_RESULT_SUCCESS) {
-            utils_mutex_unlock(&file_provider->lock);
-            return umf_result;
+            goto err_unlock;
         }
-    }
 
-    void *base_mmap = file_provider->base_mmap;
-    assert(base_mmap);
+        umf_result = file_extent_add(file_provider, offset_fd, window_size,
+                                     map, &extent);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            file_munmap_window(file_provider, map);
+            goto err_unlock;
+        }
 
-    uintptr_t new_aligned_ptr =
-        (uintptr_t)base_mmap + file_provider->offset_mmap;
-    if (alignment) {
-        uintptr_t rest = new_aligned_ptr & (alignment - 1);
-        if (rest) {
-            new_aligned_ptr += alignment - rest;
+        file_provider->offset_fd = offset_fd + window_size;
+        if (file_provider->persistent) {
+            file_provider->heap->heap_end = file_provider->offset_fd;
         }
-        ASSERT_IS_ALIGNED(new_aligned_ptr, alignment);
-    }
+    } else if (extent->mmap == NULL) {
+        // map a new part of the file at the beginning of the unmapped extent
+        size_t offset_fd = extent->offset_fd;
+        size_t extent_size = extent->size;
 
-    size_t new_offset_mmap = new_aligned_ptr - (uintptr_t)base_mmap;
-    size_t new_offset_fd =
-        file_provider->offset_fd + new_offset_mmap - file_provider->offset_mmap;
+        umf_result =
+            file_mmap_window(file_provider, offset_fd, window_size, &map);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            goto err_unlock;
+        }
+
+        file_extent_remove(file_provider, extent);
+        if (extent_size > window_size) {
+            umf_result = file_extent_add(file_provider, offset_fd + window_size,
+                                         extent_size - window_size, NULL, NULL);
+            if (umf_result != UMF_RESULT_SUCCESS) {
+                LOG_ERR("lost an unmapped free extent of the file");
+            }
+        }
 
-    if (file_provider->size_mmap - new_offset_mmap < size) {
-        umf_result = file_mmap_aligned(file_provider, size, alignment);
+        umf_result = file_extent_add(file_provider, offset_fd, window_size,
+                                     map, &extent);
         if (umf_result != UMF_RESULT_SUCCESS) {
-            utils_mutex_unlock(&file_provider->lock);
-            return umf_result;
+            file_munmap_window(file_provider, map);
+            goto err_unlock;
+        }
+    }
+
+    // cut out the allocation from the mapped free extent
+    map = extent->mmap;
+    uintptr_t extent_addr = file_extent_addr(extent);
+    uintptr_t new_aligned_ptr = ALIGN_UP(extent_addr, alignment);
+    size_t head_size = new_aligned_ptr - extent_addr;
+    size_t tail_size = extent->size - head_size - size;
+    size_t new_offset_fd = extent->offset_fd + head_size;
+
+    // allocate space of the file for the allocated memory
+    // (the file could have been extended sparsely or hole-punched)
+    size_t falloc_begin = ALIGN_DOWN(new_offset_fd, page_size);
+    size_t falloc_end = ALIGN_UP(new_offset_fd + size, page_size);
+    if (falloc_end > falloc_begin &&
+        utils_fallocate(file_provider->fd, (long)falloc_begin,
+                        (long)(falloc_end - falloc_begin))) {
+        LOG_ERR("cannot allocate space of the file (offset=%zu, size=%zu)",
+                falloc_begin, falloc_end - falloc_begin);
+        if (map->used == 0 && extent->size == map->size) {
+            file_release_empty_window(file_provider, extent);
         }
+        umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_unlock;
+    }
 
-        assert(file_provider->base_mmap);
+    file_extent_remove(file_provider, extent);
 
-        // file_provider-> base_mmap, offset_mmap, offset_fd
-        // were updated by file_mmap_aligned():
-        new_aligned_ptr = (uintptr_t)file_provider->base_mmap;
-        new_offset_mmap = 0; // == file_provider->offset_mmap
-        new_offset_fd = file_provider->offset_fd;
+    if (head_size) {
+        umf_result = file_extent_add(file_provider, new_offset_fd - head_size,
+                                     head_size, map, NULL);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_ERR("lost a free extent of the file");
+        }
+    }
 
-        ASSERT_IS_ALIGNED(new_aligned_ptr, alignment);
+    if (tail_size) {
+        umf_result = file_extent_add(file_provider, new_offset_fd + size,
+                                     tail_size, map, NULL);
+        if (umf_result != UMF_RESULT_SUCCESS) {
+            LOG_ERR("lost a free extent of the file");
+        }
     }
 
-    *alloc_offset_fd = new_offset_fd;
+    map->used += size;
+    if (file_provider->empty_mmap == map) {
+        file_provider->empty_mmap = NULL;
+    }
 
-    file_provider->offset_fd = new_offset_fd + size;
-    file_provider->offset_mmap = new_offset_mmap + size;
+    file_heap_log(file_provider, FILE_HEAP_OP_ALLOC, new_offset_fd, size, 0);
 
+    *alloc_offset_fd = new_offset_fd;
     *out_addr = (void *)new_aligned_ptr;
 
     utils_mutex_unlock(&file_provider->lock);
 
     return UMF_RESULT_SUCCESS;
+
+err_unlock:
+    utils_mutex_unlock(&file_provider->lock);
+    return umf_result;
 }
 
 static umf_result_t file_alloc(void *provider, size_t size, size_t alignment,
@@ -408,6 +1354,12 @@ static umf_result_t file_alloc(void *provider, size_t size, size_t alignment,
 
     file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
 
+    // zero-sized allocations cannot be told apart in the persistent heap
+    if (size == 0 && file_provider->persistent) {
+        LOG_ERR("invalid size of allocation: 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
     void *addr = NULL;
     size_t alloc_offset_fd; // needed for critnib_insert()
     umf_result = file_alloc_aligned(file_provider, size, alignment, &addr,
@@ -418,6 +1370,23 @@ static umf_result_t file_alloc(void *provider, size_t size, size_t alignment,
         return umf_result;
     }
 
+    size_t page_size = file_provider->page_size;
+    void *prefetch_addr = (void *)ALIGN_DOWN((uintptr_t)addr, page_size);
+    size_t prefetch_size =
+        ALIGN_UP((uintptr_t)addr + size, page_size) - (uintptr_t)prefetch_addr;
+
+    if ((file_provider->prefetch & UMF_FILE_PREFETCH_WILLNEED) &&
+        utils_prefetch(prefetch_addr, prefetch_size, UMF_PREFETCH_WILLNEED)) {
+        LOG_PDEBUG("reading ahead memory failed (addr=%p, size=%zu)",
+                   prefetch_addr, prefetch_size);
+    }
+
+    if ((file_provider->prefetch & UMF_FILE_PREFETCH_POPULATE) &&
+        utils_prefetch(prefetch_addr, prefetch_size, UMF_PREFETCH_POPULATE)) {
+        LOG_PDEBUG("populating memory failed (addr=%p, size=%zu)",
+                   prefetch_addr, prefetch_size);
+    }
+
     // store (offset_fd + 1) to be able to store offset_fd == 0
     ret = critnib_insert(file_provider->fd_offset_map, (uintptr_t)addr,
                          (void *)(uintptr_t)(alloc_offset_fd + 1),
@@ -433,6 +1402,107 @@ static umf_result_t file_alloc(void *provider, size_t size, size_t alignment,
     return UMF_RESULT_SUCCESS;
 }
 
+static umf_result_t file_free(void *provider, void *ptr, size_t size) {
+    if (provider == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ptr == NULL) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (size == 0) {
+        LOG_ERR("invalid size of deallocation: 0");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
+    umf_result_t umf_result;
+    uintptr_t rkey;
+    void *rvalue;
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (1 != critnib_find(file_provider->mmaps, (uintptr_t)ptr, FIND_LE, &rkey,
+                          &rvalue) ||
+        (uintptr_t)ptr + size < (uintptr_t)ptr ||
+        (uintptr_t)ptr + size > rkey + ((file_mmap_t *)rvalue)->size) {
+        LOG_ERR("the memory does not belong to this provider (addr=%p, "
+                "size=%zu)",
+                ptr, size);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_unlock;
+    }
+
+    umf_result = file_heap_log_reserve(file_provider, 0);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        goto err_unlock;
+    }
+
+    if (critnib_remove(file_provider->fd_offset_map, (uintptr_t)ptr) == NULL) {
+        LOG_ERR("the memory is not allocated (addr=%p)", ptr);
+        umf_result = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto err_unlock;
+    }
+
+    file_mmap_t *map = (file_mmap_t *)rvalue;
+    size_t offset_fd = map->offset_fd + ((uintptr_t)ptr - rkey);
+
+    if (file_provider->persistent) {
+        if (ptr == file_provider->root) {
+            file_provider->root = NULL;
+            file_provider->heap->root_offset = 0;
+        }
+        file_heap_log(file_provider, FILE_HEAP_OP_FREE, offset_fd, size, 0);
+    }
+
+    assert(map->used >= size);
+    map->used -= size;
+
+    file_extent_t *extent;
+    umf_result = file_extent_free(file_provider, offset_fd, size, map, &extent);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        goto err_unlock;
+    }
+
+    if (map->used == 0 && file_provider->empty_mmap &&
+        file_provider->empty_mmap != map) {
+        // the whole memory mapping is free and another empty one
+        // is kept already - unmap it
+        file_release_empty_window(file_provider, extent);
+    } else {
+        if (map->used == 0) {
+            file_provider->empty_mmap = map;
+        }
+
+        // release only the pages that are completely free now
+        size_t page_size = file_provider->page_size;
+        size_t begin = ALIGN_DOWN(offset_fd, page_size);
+        size_t end = ALIGN_UP(offset_fd + size, page_size);
+        if (begin < ALIGN_UP(extent->offset_fd, page_size)) {
+            begin = ALIGN_UP(extent->offset_fd, page_size);
+        }
+        if (end > ALIGN_DOWN(extent->offset_fd + extent->size, page_size)) {
+            end = ALIGN_DOWN(extent->offset_fd + extent->size, page_size);
+        }
+        if (begin < end) {
+            file_punch_hole(file_provider, map, begin, end - begin);
+        }
+    }
+
+    utils_mutex_unlock(&file_provider->lock);
+
+    return UMF_RESULT_SUCCESS;
+
+err_unlock:
+    utils_mutex_unlock(&file_provider->lock);
+    file_store_last_native_error(UMF_FILE_RESULT_ERROR_FREE_FAILED, 0);
+    return umf_result;
+}
+
 static void file_get_last_native_error(void *provider, const char **ppMessage,
                                        int32_t *pError) {
     (void)provider; // unused
@@ -513,6 +1583,143 @@ static umf_result_t file_purge_force(void *provider, void *ptr, size_t size) {
     return UMF_RESULT_SUCCESS;
 }
 
+// file_heap_allocation_split - split the allocation of the persistent heap
+// and log it under the lock
+static umf_result_t
+file_heap_allocation_split(file_memory_provider_t *file_provider, void *ptr,
+                           size_t totalSize, size_t firstSize) {
+    umf_result_t umf_result;
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    umf_result = file_heap_log_reserve(file_provider, 1);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        goto err_unlock;
+    }
+
+    void *value = critnib_get(file_provider->fd_offset_map, (uintptr_t)ptr);
+    if (value == NULL) {
+        LOG_ERR("file_allocation_split(): getting a value from the file "
+                "descriptor offset map failed (addr=%p)",
+                ptr);
+        umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_unlock;
+    }
+
+    uintptr_t new_key = (uintptr_t)ptr + firstSize;
+    void *new_value = (void *)((uintptr_t)value + firstSize);
+    int ret = critnib_insert(file_provider->fd_offset_map, new_key, new_value,
+                             0 /* update */);
+    if (ret) {
+        LOG_ERR("file_allocation_split(): inserting a value to the file "
+                "descriptor offset map failed (addr=%p, offset=%zu)",
+                (void *)new_key, (size_t)new_value - 1);
+        umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_unlock;
+    }
+
+    file_heap_log(file_provider, FILE_HEAP_OP_SPLIT, (uintptr_t)value - 1,
+                  totalSize, firstSize);
+
+err_unlock:
+    utils_mutex_unlock(&file_provider->lock);
+    return umf_result;
+}
+
+// file_heap_allocation_merge - merge the allocations of the persistent heap
+// and log it under the lock
+static umf_result_t
+file_heap_allocation_merge(file_memory_provider_t *file_provider, void *lowPtr,
+                           void *highPtr, size_t totalSize) {
+    umf_result_t umf_result;
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    umf_result = file_heap_log_reserve(file_provider, 0);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        goto err_unlock;
+    }
+
+    void *low_value =
+        critnib_get(file_provider->fd_offset_map, (uintptr_t)lowPtr);
+    void *high_value =
+        critnib_remove(file_provider->fd_offset_map, (uintptr_t)highPtr);
+    if (low_value == NULL || high_value == NULL) {
+        LOG_ERR("file_allocation_merge(): getting a value from the file "
+                "descriptor offset map failed (low=%p, high=%p)",
+                lowPtr, highPtr);
+        umf_result = UMF_RESULT_ERROR_UNKNOWN;
+        goto err_unlock;
+    }
+
+    file_heap_log(file_provider, FILE_HEAP_OP_MERGE, (uintptr_t)low_value - 1,
+                  totalSize, (uintptr_t)high_value - 1);
+
+err_unlock:
+    utils_mutex_unlock(&file_provider->lock);
+    return umf_result;
+}
+
+// Stores to MAP_SYNC mappings are durable once they leave the CPU caches,
+// so flushing the cache lines is enough. Other shared mappings have to be
+// written back to the file by the kernel.
+static umf_result_t file_persist(void *provider, const void *ptr,
+                                 size_t size) {
+    if (provider == NULL || ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
+
+    // changes of private mappings are never written back to the file
+    if (!file_provider->IPC_enabled) {
+        LOG_ERR("memory visibility mode is not UMF_MEM_MAP_SHARED nor "
+                "UMF_MEM_MAP_SYNC");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    uintptr_t rkey;
+    void *rvalue;
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    if (1 != critnib_find(file_provider->mmaps, (uintptr_t)ptr, FIND_LE, &rkey,
+                          &rvalue) ||
+        (uintptr_t)ptr + size < (uintptr_t)ptr ||
+        (uintptr_t)ptr + size > rkey + ((file_mmap_t *)rvalue)->size) {
+        utils_mutex_unlock(&file_provider->lock);
+        LOG_ERR("the memory does not belong to this provider (addr=%p, "
+                "size=%zu)",
+                ptr, size);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    bool map_sync = ((file_mmap_t *)rvalue)->map_sync;
+
+    utils_mutex_unlock(&file_provider->lock);
+
+    if (map_sync && utils_flush_cache(ptr, size) == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    if (utils_msync((void *)(uintptr_t)ptr, size)) {
+        file_store_last_native_error(UMF_FILE_RESULT_ERROR_PERSIST_FAILED,
+                                     errno);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static const char *file_get_name(void *provider) {
     (void)provider; // unused
     return "FILE";
@@ -522,13 +1729,16 @@ static const char *file_get_name(void *provider) {
 // with file_allocation_merge() with the same pointer.
 static umf_result_t file_allocation_split(void *provider, void *ptr,
                                           size_t totalSize, size_t firstSize) {
-    (void)totalSize;
-
     file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
     if (file_provider->fd <= 0) {
         return UMF_RESULT_SUCCESS;
     }
 
+    if (file_provider->persistent) {
+        return file_heap_allocation_split(file_provider, ptr, totalSize,
+                                          firstSize);
+    }
+
     void *value = critnib_get(file_provider->fd_offset_map, (uintptr_t)ptr);
     if (value == NULL) {
         LOG_ERR("file_allocation_split(): getting a value from the file "
@@ -554,14 +1764,29 @@ static umf_result_t file_allocation_split(void *provider, void *ptr,
 // It should NOT be called concurrently with file_allocation_split() with the same pointer.
 static umf_result_t file_allocation_merge(void *provider, void *lowPtr,
                                           void *highPtr, size_t totalSize) {
-    (void)lowPtr;
-    (void)totalSize;
-
     file_memory_provider_t *file_provider = (file_memory_provider_t *)provider;
     if (file_provider->fd <= 0) {
         return UMF_RESULT_SUCCESS;
     }
 
+    // allocations from different memory mappings cannot be merged,
+    // because they could not be freed together
+    uintptr_t rkey;
+    void *rvalue;
+    if (1 != critnib_find(file_provider->mmaps, (uintptr_t)lowPtr, FIND_LE,
+                          &rkey, &rvalue) ||
+        (uintptr_t)lowPtr + totalSize > rkey + ((file_mmap_t *)rvalue)->size) {
+        LOG_DEBUG("file_allocation_merge(): cannot merge allocations from "
+                  "different memory mappings (low=%p, high=%p)",
+                  lowPtr, highPtr);
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    if (file_provider->persistent) {
+        return file_heap_allocation_merge(file_provider, lowPtr, highPtr,
+                                          totalSize);
+    }
+
     void *value =
         critnib_remove(file_provider->fd_offset_map, (uintptr_t)highPtr);
     if (value == NULL) {
@@ -674,7 +1899,7 @@ static umf_result_t file_open_ipc_handle(void *provider, void *providerIpcData,
 
     *ptr = utils_mmap_file(NULL, file_ipc_data->size, file_provider->protection,
                            file_provider->visibility, fd,
-                           file_ipc_data->offset_fd);
+                           file_ipc_data->offset_fd, NULL);
     (void)utils_close_fd(fd);
     if (*ptr == NULL) {
         file_store_last_native_error(UMF_FILE_RESULT_ERROR_ALLOC_FAILED, errno);
@@ -720,10 +1945,12 @@ static umf_memory_provider_ops_t UMF_FILE_MEMORY_PROVIDER_OPS = {
     .get_recommended_page_size = file_get_recommended_page_size,
     .get_min_page_size = file_get_min_page_size,
     .get_name = file_get_name,
+    .ext.free = file_free,
     .ext.purge_lazy = file_purge_lazy,
     .ext.purge_force = file_purge_force,
     .ext.allocation_merge = file_allocation_merge,
     .ext.allocation_split = file_allocation_split,
+    .ext.persist = file_persist,
     .ipc.get_ipc_handle_size = file_get_ipc_handle_size,
     .ipc.get_ipc_handle = file_get_ipc_handle,
     .ipc.put_ipc_handle = file_put_ipc_handle,
@@ -734,4 +1961,92 @@ umf_memory_provider_ops_t *umfFileMemoryProviderOps(void) {
     return &UMF_FILE_MEMORY_PROVIDER_OPS;
 }
 
+// file_get_persistent_provider - get the file memory provider
+// of the persistent heap from the provider handle
+static umf_result_t
+file_get_persistent_provider(umf_memory_provider_handle_t hProvider,
+                             file_memory_provider_t **file_provider) {
+    if (hProvider == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    const char *name = umfMemoryProviderGetName(hProvider);
+    if (name == NULL || strcmp(name, file_get_name(NULL)) != 0) {
+        LOG_ERR("not a file memory provider");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    *file_provider =
+        (file_memory_provider_t *)umfMemoryProviderGetPriv(hProvider);
+    if (!(*file_provider)->persistent) {
+        LOG_ERR("the file memory provider has no persistent heap");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfFileMemoryProviderSetRoot(umf_memory_provider_handle_t hProvider,
+                             void *ptr) {
+    file_memory_provider_t *file_provider;
+    umf_result_t umf_result =
+        file_get_persistent_provider(hProvider, &file_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    uint64_t root_offset = 0;
+    if (ptr) {
+        void *value = critnib_get(file_provider->fd_offset_map, (uintptr_t)ptr);
+        if (value == NULL) {
+            LOG_ERR("the root object is not an allocation of the provider "
+                    "(addr=%p)",
+                    ptr);
+            utils_mutex_unlock(&file_provider->lock);
+            return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        // (offset_fd + 1) is stored in the map as well as in the header
+        root_offset = (uintptr_t)value;
+    }
+
+    file_provider->root = ptr;
+    utils_atomic_store_release(&file_provider->heap->root_offset, root_offset);
+
+    utils_mutex_unlock(&file_provider->lock);
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t
+umfFileMemoryProviderGetRoot(umf_memory_provider_handle_t hProvider,
+                             void **ptr) {
+    if (ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    file_memory_provider_t *file_provider;
+    umf_result_t umf_result =
+        file_get_persistent_provider(hProvider, &file_provider);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    if (utils_mutex_lock(&file_provider->lock)) {
+        LOG_ERR("locking file data failed");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    *ptr = file_provider->root;
+
+    utils_mutex_unlock(&file_provider->lock);
+
+    return UMF_RESULT_SUCCESS;
+}
+
 #endif // !defined(_WIN32) && !defined(UMF_NO_HWLOC)
@@ -59,6 +59,10 @@ static __TLS os_last_native_error_t TLS_last_native_error;
     (UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED - UMF_OS_RESULT_SUCCESS)
 #define _UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED                             \
     (UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED - UMF_OS_RESULT_SUCCESS)
+#define _UMF_OS_RESULT_ERROR_MIGRATE_FAILED                                    \
+    (UMF_OS_RESULT_ERROR_MIGRATE_FAILED - UMF_OS_RESULT_SUCCESS)
+#define _UMF_OS_RESULT_ERROR_RESIZE_FAILED                                     \
+    (UMF_OS_RESULT_ERROR_RESIZE_FAILED - UMF_OS_RESULT_SUCCESS)
 
 static const char *Native_error_str[] = {
     [_UMF_OS_RESULT_SUCCESS] = "success",
@@ -71,6 +75,9 @@ static const char *Native_error_str[] = {
     [_UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED] = "force purging failed",
     [_UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED] =
         "HWLOC topology discovery failed",
+    [_UMF_OS_RESULT_ERROR_MIGRATE_FAILED] =
+        "migrating memory to NUMA node failed",
+    [_UMF_OS_RESULT_ERROR_RESIZE_FAILED] = "resizing memory mapping failed",
 };
 
 static void os_store_last_native_error(int32_t native_error, int errno_value) {
@@ -559,6 +566,12 @@ static void os_finalize(void *provider) {
         utils_mutex_destroy_not_free(&os_provider->lock_fd);
     }
 
+    // The shared memory file can be opened by many consumers, so it is
+    // removed by its creator. The existing mappings stay valid.
+    if (os_provider->shm_name[0]) {
+        (void)utils_shm_unlink(os_provider->shm_name);
+    }
+
     critnib_delete(os_provider->fd_offset_map);
 
     free_bitmaps(os_provider);
@@ -974,6 +987,20 @@ err_unmap:
     return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
 }
 
+// The OS memory provider never reuses memory: every allocation is a fresh
+// anonymous mapping (or a never used range of the anonymous file),
+// so it is always zeroed.
+static umf_result_t os_alloc_zero_info(void *provider, size_t size,
+                                       size_t alignment, void **resultPtr,
+                                       bool *zeroed) {
+    umf_result_t umf_result = os_alloc(provider, size, alignment, resultPtr);
+    if (umf_result == UMF_RESULT_SUCCESS) {
+        *zeroed = true;
+    }
+
+    return umf_result;
+}
+
 static umf_result_t os_free(void *provider, void *ptr, size_t size) {
     if (provider == NULL) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
@@ -1087,6 +1114,128 @@ static umf_result_t os_purge_force(void *provider, void *ptr, size_t size) {
     return UMF_RESULT_SUCCESS;
 }
 
+// Move pages of the given range to the NUMA node of the target.
+// The range is bound to this node afterwards (MPOL_BIND with MPOL_MF_MOVE),
+// so the binding reported by the kernel for the range stays consistent
+// with the placement of its pages.
+static umf_result_t os_migrate(void *provider, void *ptr, size_t size,
+                               umf_const_memtarget_handle_t target) {
+    if (provider == NULL || ptr == NULL || target == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+
+    umf_memtarget_type_t type;
+    umf_result_t umf_result = umfMemtargetGetType(target, &type);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    if (type != UMF_MEMTARGET_TYPE_NUMA) {
+        LOG_ERR("only NUMA memory targets are supported");
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    unsigned node_id;
+    umf_result = umfMemtargetGetId(target, &node_id);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    size_t page_size = utils_get_page_size();
+    if (IS_NOT_ALIGNED((uintptr_t)ptr, page_size)) {
+        LOG_ERR("address %p is not aligned to the page size (%zu)", ptr,
+                page_size);
+        return UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+    }
+
+    hwloc_bitmap_t nodeset = hwloc_bitmap_alloc();
+    if (!nodeset) {
+        LOG_ERR("allocating a hwloc bitmap failed");
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (hwloc_bitmap_set(nodeset, node_id)) {
+        hwloc_bitmap_free(nodeset);
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    errno = 0;
+    int ret = hwloc_set_area_membind(
+        os_provider->topo, ptr, ALIGN_UP(size, page_size), nodeset,
+        HWLOC_MEMBIND_BIND,
+        HWLOC_MEMBIND_BYNODESET | HWLOC_MEMBIND_STRICT | HWLOC_MEMBIND_MIGRATE);
+    hwloc_bitmap_free(nodeset);
+    if (ret) {
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_MIGRATE_FAILED, errno);
+        LOG_PERR("migrating memory to NUMA node %u failed", node_id);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    return UMF_RESULT_SUCCESS;
+}
+
+// Resize the mapping in the page tables (mremap) instead of copying its content.
+// The NUMA memory policy of the mapping is moved together with it.
+static umf_result_t os_resize(void *provider, void *ptr, size_t old_size,
+                              size_t new_size, void **new_ptr) {
+    if (provider == NULL || ptr == NULL || new_ptr == NULL) {
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    os_memory_provider_t *os_provider = (os_memory_provider_t *)provider;
+
+    // Memory mapped from a file descriptor cannot be extended,
+    // because the following part of the file can be used by other allocations.
+    if (os_provider->fd > 0) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    // Pages of a grown mapping would not follow the manual interleaving
+    // or splitting of the memory across many NUMA nodes.
+    if (os_provider->nodeset_len > 1) {
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+
+    size_t page_size;
+    umf_result_t umf_result = os_get_min_page_size(provider, NULL, &page_size);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        return umf_result;
+    }
+
+    if (IS_NOT_ALIGNED((uintptr_t)ptr, page_size)) {
+        LOG_ERR("address %p is not aligned to the page size (%zu)", ptr,
+                page_size);
+        return UMF_RESULT_ERROR_INVALID_ALIGNMENT;
+    }
+
+    size_t old_aligned = ALIGN_UP(old_size, page_size);
+    size_t new_aligned = ALIGN_UP(new_size, page_size);
+    if (old_aligned == new_aligned) {
+        *new_ptr = ptr;
+        return UMF_RESULT_SUCCESS;
+    }
+
+    errno = 0;
+    void *addr = utils_mremap(ptr, old_aligned, new_aligned);
+    if (addr == NULL) {
+        if (errno == ENOTSUP) {
+            return UMF_RESULT_ERROR_NOT_SUPPORTED;
+        }
+
+        os_store_last_native_error(UMF_OS_RESULT_ERROR_RESIZE_FAILED, errno);
+        LOG_PERR("resizing memory mapping failed (ptr=%p, old size=%zu, new "
+                 "size=%zu)",
+                 ptr, old_size, new_size);
+        return UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC;
+    }
+
+    *new_ptr = addr;
+
+    return UMF_RESULT_SUCCESS;
+}
+
 static const char *os_get_name(void *provider) {
     (void)provider; // unused
     return "OS";
@@ -1202,8 +1351,9 @@ static umf_result_t os_get_ipc_handle(void *provider, const void *ptr,
     os_ipc_data->size = size;
     os_ipc_data->shm_name_len = strlen(os_provider->shm_name);
     if (os_ipc_data->shm_name_len > 0) {
+        // copy the terminating null byte too
         strncpy(os_ipc_data->shm_name, os_provider->shm_name,
-                os_ipc_data->shm_name_len);
+                os_ipc_data->shm_name_len + 1);
     } else {
         os_ipc_data->fd = os_provider->fd;
     }
@@ -1268,7 +1418,6 @@ static umf_result_t os_open_ipc_handle(void *provider, void *providerIpcData,
                      os_ipc_data->shm_name);
             return UMF_RESULT_ERROR_UNKNOWN;
         }
-        (void)utils_shm_unlink(os_ipc_data->shm_name);
     } else {
         umf_result_t umf_result =
             utils_duplicate_fd(os_ipc_data->pid, os_ipc_data->fd, &fd);
@@ -1330,6 +1479,9 @@ static umf_memory_provider_ops_t UMF_OS_MEMORY_PROVIDER_OPS = {
     .ext.purge_force = os_purge_force,
     .ext.allocation_merge = os_allocation_merge,
     .ext.allocation_split = os_allocation_split,
+    .ext.migrate = os_migrate,
+    .ext.resize = os_resize,
+    .ext.alloc_zero_info = os_alloc_zero_info,
     .ipc.get_ipc_handle_size = os_get_ipc_handle_size,
     .ipc.get_ipc_handle = os_get_ipc_handle,
     .ipc.put_ipc_handle = os_put_ipc_handle,
@@ -11,6 +11,7 @@
 #include "base_alloc_global.h"
 #include "critnib.h"
 #include "ipc_internal.h"
+#include "ravl.h"
 #include "utils_common.h"
 #include "utils_concurrency.h"
 #include "utils_log.h"
@@ -24,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 typedef struct tracker_value_t {
     umf_memory_pool_handle_t pool;
@@ -133,19 +135,90 @@ umf_result_t umfMemoryTrackerGetAllocInfo(const void *ptr,
     return UMF_RESULT_SUCCESS;
 }
 
-// Cache entry structure to store provider-specific IPC data.
-// providerIpcData is a Flexible Array Member because its size varies
-// depending on the provider.
+// Cache entry structure to store the IPC handle of the base allocation
+// in its final format (umf_ipc_data_t with the offset equal to 0),
+// so getting a cached IPC handle does not call the upstream provider.
+// ipcData is a Flexible Array Member because the size of the
+// provider-specific IPC data varies depending on the provider.
 typedef struct ipc_cache_value_t {
-    uint64_t ipcDataSize;
-    char providerIpcData[];
+    uint64_t ipcDataSize; // size of the whole IPC handle
+    uint64_t ipcData[];   // umf_ipc_data_t
 } ipc_cache_value_t;
 
+static inline umf_ipc_data_t *
+getIpcDataFromCacheValue(ipc_cache_value_t *cache_value) {
+    return (umf_ipc_data_t *)cache_value->ipcData;
+}
+
+// source of unique IDs of IPC handles created in this process
+static uint64_t IpcHandleIdCounter = 0;
+
+// The IDs of IPC handles start from 1 in every process and the pid
+// of the producer can be reused by a new process after the producer exits,
+// so handles of different processes are told apart by a random nonce too.
+static uint64_t IpcProcessNonce = 0;
+static UTIL_ONCE_FLAG IpcProcessNonceInitialized = UTIL_ONCE_FLAG_INIT;
+
+static void ipc_init_process_nonce(void) {
+    struct timespec ts = {0};
+    (void)timespec_get(&ts, TIME_UTC);
+
+    uint64_t x = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    x ^= ((uint64_t)utils_getpid() << 32) ^ (uint64_t)(uintptr_t)&ts;
+
+    // the finalizer of splitmix64
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    IpcProcessNonce = x;
+}
+
+#define IPC_OPENED_CACHE_DEFAULT_SIZE 64
+
+// Entry of the cache of IPC handles opened in the pool. The opened
+// handle is identified by the producer's process ID and nonce, the ID
+// of the handle in the producer process and the address of the base
+// allocation there.
+typedef struct ipc_opened_cache_value_t {
+    int remote_pid;
+    uint64_t remote_nonce;
+    uint64_t handle_id;
+    uint64_t remote_base;
+
+    void *mapped_base;
+    size_t mapped_size;
+    size_t ref_count;
+
+    // list of the unused entries (ref_count == 0) in the LRU order
+    struct ipc_opened_cache_value_t *prev;
+    struct ipc_opened_cache_value_t *next;
+} ipc_opened_cache_value_t;
+
+typedef struct ipc_opened_cache_t {
+    utils_mutex_t lock;
+    struct ravl *entries; // the entries sorted by the key
+    critnib *mappings;    // mapped base -> entry
+    ipc_opened_cache_value_t *lru_first; // the least recently used entry
+    ipc_opened_cache_value_t *lru_last;  // the most recently used entry
+    size_t n_unused;
+    size_t max_unused;
+} ipc_opened_cache_t;
+
 typedef struct umf_tracking_memory_provider_t {
     umf_memory_provider_handle_t hUpstream;
     umf_memory_tracker_handle_t hTracker;
     umf_memory_pool_handle_t pool;
     critnib *ipcCache;
+    ipc_opened_cache_t ipcOpenedCache;
+
+    // statistics of the IPC caches
+    uint64_t ipcCacheHits;
+    uint64_t ipcCacheMisses;
+    uint64_t ipcOpenedCacheHits;
+    uint64_t ipcOpenedCacheMisses;
 
     // the upstream provider does not support the free() operation
     bool upstreamDoesNotFree;
@@ -153,15 +226,20 @@ typedef struct umf_tracking_memory_provider_t {
 
 typedef struct umf_tracking_memory_provider_t umf_tracking_memory_provider_t;
 
-static umf_result_t trackingAlloc(void *hProvider, size_t size,
-                                  size_t alignment, void **ptr) {
-    umf_tracking_memory_provider_t *p =
-        (umf_tracking_memory_provider_t *)hProvider;
+// zeroed can be NULL if the caller is not interested in it
+static umf_result_t trackingAllocImpl(umf_tracking_memory_provider_t *p,
+                                      size_t size, size_t alignment,
+                                      void **ptr, bool *zeroed) {
     umf_result_t ret = UMF_RESULT_SUCCESS;
 
     assert(p->hUpstream);
 
-    ret = umfMemoryProviderAlloc(p->hUpstream, size, alignment, ptr);
+    if (zeroed) {
+        ret = umfMemoryProviderAllocZeroInfo(p->hUpstream, size, alignment, ptr,
+                                             zeroed);
+    } else {
+        ret = umfMemoryProviderAlloc(p->hUpstream, size, alignment, ptr);
+    }
     if (ret != UMF_RESULT_SUCCESS || !*ptr) {
         return ret;
     }
@@ -176,6 +254,19 @@ static umf_result_t trackingAlloc(void *hProvider, size_t size,
     return ret;
 }
 
+static umf_result_t trackingAlloc(void *hProvider, size_t size,
+                                  size_t alignment, void **ptr) {
+    return trackingAllocImpl((umf_tracking_memory_provider_t *)hProvider, size,
+                             alignment, ptr, NULL);
+}
+
+static umf_result_t trackingAllocZeroInfo(void *hProvider, size_t size,
+                                          size_t alignment, void **ptr,
+                                          bool *zeroed) {
+    return trackingAllocImpl((umf_tracking_memory_provider_t *)hProvider, size,
+                             alignment, ptr, zeroed);
+}
+
 static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
                                             size_t totalSize,
                                             size_t firstSize) {
@@ -213,6 +304,11 @@ static umf_result_t trackingAllocationSplit(void *hProvider, void *ptr,
 
     ret = umfMemoryProviderAllocationSplit(provider->hUpstream, ptr, totalSize,
                                            firstSize);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        // not an error - the caller has to operate on the whole region
+        LOG_DEBUG("upstream provider does not support splitting regions");
+        goto err;
+    }
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("upstream provider failed to split the region");
         goto err;
@@ -302,6 +398,11 @@ static umf_result_t trackingAllocationMerge(void *hProvider, void *lowPtr,
 
     ret = umfMemoryProviderAllocationMerge(provider->hUpstream, lowPtr, highPtr,
                                            totalSize);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        // not an error - the caller has to operate on the regions separately
+        LOG_DEBUG("upstream provider does not support merging regions");
+        goto err;
+    }
     if (ret != UMF_RESULT_SUCCESS) {
         LOG_ERR("upstream provider failed to merge regions");
         goto err;
@@ -358,9 +459,10 @@ static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
 
     void *value = critnib_remove(p->ipcCache, (uintptr_t)ptr);
     if (value) {
-        ipc_cache_value_t *cache_value = (ipc_cache_value_t *)value;
+        umf_ipc_data_t *ipcData =
+            getIpcDataFromCacheValue((ipc_cache_value_t *)value);
         ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
-                                            cache_value->providerIpcData);
+                                            ipcData->providerIpcData);
         if (ret != UMF_RESULT_SUCCESS) {
             LOG_ERR("upstream provider failed to put IPC handle, ptr=%p, "
                     "size=%zu, ret = %d",
@@ -390,6 +492,184 @@ static umf_result_t trackingFree(void *hProvider, void *ptr, size_t size) {
     return ret;
 }
 
+static int ipc_opened_cache_compare(const void *lhs, const void *rhs) {
+    const ipc_opened_cache_value_t *l = lhs;
+    const ipc_opened_cache_value_t *r = rhs;
+
+    if (l->remote_pid != r->remote_pid) {
+        return l->remote_pid < r->remote_pid ? -1 : 1;
+    }
+    if (l->remote_nonce != r->remote_nonce) {
+        return l->remote_nonce < r->remote_nonce ? -1 : 1;
+    }
+    if (l->handle_id != r->handle_id) {
+        return l->handle_id < r->handle_id ? -1 : 1;
+    }
+    if (l->remote_base != r->remote_base) {
+        return l->remote_base < r->remote_base ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static umf_result_t ipc_opened_cache_init(ipc_opened_cache_t *cache) {
+    memset(cache, 0, sizeof(*cache));
+
+    cache->entries = ravl_new(ipc_opened_cache_compare);
+    if (!cache->entries) {
+        return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    cache->mappings = critnib_new();
+    if (!cache->mappings) {
+        goto err_delete_entries;
+    }
+
+    if (utils_mutex_init(&cache->lock) == NULL) {
+        goto err_delete_mappings;
+    }
+
+    cache->max_unused = IPC_OPENED_CACHE_DEFAULT_SIZE;
+
+    return UMF_RESULT_SUCCESS;
+
+err_delete_mappings:
+    critnib_delete(cache->mappings);
+err_delete_entries:
+    ravl_delete(cache->entries);
+    return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
+
+static void ipc_opened_cache_lru_remove(ipc_opened_cache_t *cache,
+                                        ipc_opened_cache_value_t *value) {
+    if (value->prev) {
+        value->prev->next = value->next;
+    } else {
+        cache->lru_first = value->next;
+    }
+
+    if (value->next) {
+        value->next->prev = value->prev;
+    } else {
+        cache->lru_last = value->prev;
+    }
+
+    value->prev = NULL;
+    value->next = NULL;
+    cache->n_unused--;
+}
+
+static void ipc_opened_cache_lru_append(ipc_opened_cache_t *cache,
+                                        ipc_opened_cache_value_t *value) {
+    value->prev = cache->lru_last;
+    value->next = NULL;
+
+    if (cache->lru_last) {
+        cache->lru_last->next = value;
+    } else {
+        cache->lru_first = value;
+    }
+
+    cache->lru_last = value;
+    cache->n_unused++;
+}
+
+// close the IPC handle opened by the upstream provider
+static umf_result_t ipc_close_upstream(umf_tracking_memory_provider_t *p,
+                                       void *ptr, size_t size) {
+    // umfMemoryTrackerRemove should be called before umfMemoryProviderCloseIPCHandle
+    // to avoid a race condition. If the order would be different, other thread
+    // could allocate the memory at address `ptr` before a call to umfMemoryTrackerRemove
+    // resulting in inconsistent state.
+    if (ptr) {
+        umf_result_t ret = umfMemoryTrackerRemove(p->hTracker, ptr);
+        if (ret != UMF_RESULT_SUCCESS) {
+            // DO NOT return an error here, because the tracking provider
+            // cannot change behaviour of the upstream provider.
+            LOG_ERR("failed to remove the region from the tracker, ptr=%p, "
+                    "size=%zu, ret = %d",
+                    ptr, size, ret);
+        }
+    }
+    return umfMemoryProviderCloseIPCHandle(p->hUpstream, ptr, size);
+}
+
+// remove the entry from the cache (it has to be unused) and close its mapping
+static umf_result_t
+ipc_opened_cache_remove(umf_tracking_memory_provider_t *p,
+                        ipc_opened_cache_value_t *value) {
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+
+    assert(value->ref_count == 0);
+
+    ipc_opened_cache_lru_remove(cache, value);
+    critnib_remove(cache->mappings, (uintptr_t)value->mapped_base);
+
+    struct ravl_node *node =
+        ravl_find(cache->entries, value, RAVL_PREDICATE_EQUAL);
+    assert(node);
+    ravl_remove(cache->entries, node);
+
+    umf_result_t ret =
+        ipc_close_upstream(p, value->mapped_base, value->mapped_size);
+    if (ret != UMF_RESULT_SUCCESS) {
+        LOG_ERR("upstream provider failed to close IPC handle, ptr=%p, "
+                "size=%zu",
+                value->mapped_base, value->mapped_size);
+    }
+
+    umf_ba_global_free(value);
+
+    return ret;
+}
+
+// close the least recently used entries above the limit of the cache
+static umf_result_t ipc_opened_cache_evict(umf_tracking_memory_provider_t *p) {
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+
+    while (cache->n_unused > cache->max_unused) {
+        umf_result_t ret_remove = ipc_opened_cache_remove(p, cache->lru_first);
+        if (ret_remove != UMF_RESULT_SUCCESS) {
+            ret = ret_remove;
+        }
+    }
+
+    return ret;
+}
+
+static void ipc_opened_cache_destroy(umf_tracking_memory_provider_t *p) {
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+    struct ravl_node *node;
+
+    while ((node = ravl_first(cache->entries)) != NULL) {
+        ipc_opened_cache_value_t *value = ravl_data(node);
+        if (value->ref_count == 0) {
+            (void)ipc_opened_cache_remove(p, value);
+            continue;
+        }
+
+        // the pool is destroyed, so the mapping is closed anyway
+        // (see umfPoolSetOpenedIPCCacheSize())
+        LOG_WARN("IPC handle is not closed, it is closed with the pool, "
+                 "ptr=%p, size=%zu",
+                 value->mapped_base, value->mapped_size);
+        ravl_remove(cache->entries, node);
+        critnib_remove(cache->mappings, (uintptr_t)value->mapped_base);
+        if (ipc_close_upstream(p, value->mapped_base, value->mapped_size) !=
+            UMF_RESULT_SUCCESS) {
+            LOG_ERR("upstream provider failed to close IPC handle, ptr=%p, "
+                    "size=%zu",
+                    value->mapped_base, value->mapped_size);
+        }
+        umf_ba_global_free(value);
+    }
+
+    ravl_delete(cache->entries);
+    critnib_delete(cache->mappings);
+    utils_mutex_destroy_not_free(&cache->lock);
+}
+
 static umf_result_t trackingInitialize(void *params, void **ret) {
     umf_tracking_memory_provider_t *provider =
         umf_ba_global_alloc(sizeof(umf_tracking_memory_provider_t));
@@ -403,6 +683,13 @@ static umf_result_t trackingInitialize(void *params, void **ret) {
         return UMF_RESULT_ERROR_INVALID_ARGUMENT;
     }
 
+    umf_result_t umf_result = ipc_opened_cache_init(&provider->ipcOpenedCache);
+    if (umf_result != UMF_RESULT_SUCCESS) {
+        LOG_ERR("failed to create the cache of opened IPC handles");
+        umf_ba_global_free(provider);
+        return umf_result;
+    }
+
     *ret = provider;
     return UMF_RESULT_SUCCESS;
 }
@@ -461,6 +748,7 @@ static void trackingFinalize(void *provider) {
         (umf_tracking_memory_provider_t *)provider;
 
     critnib_delete(p->ipcCache);
+    ipc_opened_cache_destroy(p);
 
     // Do not clear the tracker if we are running in the proxy library,
     // because it may need those resources till
@@ -507,6 +795,140 @@ static umf_result_t trackingPurgeForce(void *provider, void *ptr, size_t size) {
     return umfMemoryProviderPurgeForce(p->hUpstream, ptr, size);
 }
 
+static umf_result_t trackingMigrate(void *provider, void *ptr, size_t size,
+                                    umf_const_memtarget_handle_t target) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+
+    uintptr_t rkey;
+    tracker_value_t *rvalue;
+    int found = critnib_find(p->hTracker->map, (uintptr_t)ptr, FIND_LE,
+                             (void *)&rkey, (void **)&rvalue);
+    if (!found || rvalue->pool != p->pool ||
+        (uintptr_t)ptr + size > rkey + rvalue->size) {
+        LOG_ERR("range (ptr=%p, size=%zu) does not belong to a single "
+                "allocation of the pool %p",
+                ptr, size, (void *)p->pool);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfMemoryProviderMigrate(p->hUpstream, ptr, size, target);
+}
+
+static umf_result_t trackingPersist(void *provider, const void *ptr,
+                                    size_t size) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+
+    uintptr_t rkey;
+    tracker_value_t *rvalue;
+    int found = critnib_find(p->hTracker->map, (uintptr_t)ptr, FIND_LE,
+                             (void *)&rkey, (void **)&rvalue);
+    if (!found || rvalue->pool != p->pool ||
+        (uintptr_t)ptr + size > rkey + rvalue->size) {
+        LOG_ERR("range (ptr=%p, size=%zu) does not belong to a single "
+                "allocation of the pool %p",
+                ptr, size, (void *)p->pool);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    return umfMemoryProviderPersist(p->hUpstream, ptr, size);
+}
+
+static umf_result_t trackingResize(void *hProvider, void *ptr, size_t oldSize,
+                                   size_t newSize, void **newPtr) {
+    umf_result_t ret;
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hProvider;
+
+    tracker_value_t *value =
+        (tracker_value_t *)critnib_get(p->hTracker->map, (uintptr_t)ptr);
+    if (!value || value->pool != p->pool) {
+        LOG_ERR("region for resize is not found in the tracker");
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (value->size != oldSize) {
+        LOG_ERR("tracked size %zu does not match the size to resize: %zu",
+                value->size, oldSize);
+        return UMF_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // The region is removed from the tracker before it is resized
+    // for the same reason as in trackingFree() - the upstream provider
+    // can release the old address range, so it can be reused by other thread.
+    value = critnib_remove(p->hTracker->map, (uintptr_t)ptr);
+    assert(value);
+
+    ret = umfMemoryProviderResize(p->hUpstream, ptr, oldSize, newSize, newPtr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        int cret =
+            critnib_insert(p->hTracker->map, (uintptr_t)ptr, value, 0);
+        if (cret) {
+            LOG_ERR("cannot add memory back to the tracker, ptr = %p, size = "
+                    "%zu",
+                    ptr, oldSize);
+            umf_ba_free(p->hTracker->tracker_allocator, value);
+        }
+        return ret;
+    }
+
+    // IPC handles of the old region are not valid anymore
+    void *cached = critnib_remove(p->ipcCache, (uintptr_t)ptr);
+    if (cached) {
+        ipc_cache_value_t *cache_value = (ipc_cache_value_t *)cached;
+        if (umfMemoryProviderPutIPCHandle(
+                p->hUpstream,
+                getIpcDataFromCacheValue(cache_value)->providerIpcData)) {
+            LOG_ERR("upstream provider failed to put IPC handle, ptr=%p", ptr);
+        }
+        umf_ba_global_free(cached);
+    }
+
+    value->size = newSize;
+    int cret = critnib_insert(p->hTracker->map, (uintptr_t)*newPtr, value, 0);
+    if (cret == 0) {
+        return UMF_RESULT_SUCCESS;
+    }
+
+    LOG_ERR("failed to add resized region to the tracker, ptr = %p, size = "
+            "%zu, ret = %d",
+            *newPtr, newSize, cret);
+
+    // An untracked region could not be freed by umfFree() nor found
+    // by umfPoolByPtr(), so resize it back and track it at the old address.
+    void *oldPtr = NULL;
+    ret = umfMemoryProviderResize(p->hUpstream, *newPtr, newSize, oldSize,
+                                  &oldPtr);
+    if (ret == UMF_RESULT_SUCCESS && oldPtr == ptr) {
+        *newPtr = NULL;
+        value->size = oldSize;
+        cret = critnib_insert(p->hTracker->map, (uintptr_t)ptr, value, 0);
+        if (cret == 0) {
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        LOG_FATAL("cannot add memory back to the tracker, ptr = %p, size = "
+                  "%zu",
+                  ptr, oldSize);
+        umf_ba_free(p->hTracker->tracker_allocator, value);
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    // the region has been moved and its old address cannot be restored
+    LOG_FATAL("cannot restore the region after a failed resize, ptr = %p, "
+              "size = %zu",
+              ptr, oldSize);
+    if (ret == UMF_RESULT_SUCCESS) {
+        umfMemoryProviderFree(p->hUpstream, oldPtr, oldSize);
+    } else {
+        umfMemoryProviderFree(p->hUpstream, *newPtr, newSize);
+    }
+    umf_ba_free(p->hTracker->tracker_allocator, value);
+    *newPtr = NULL;
+
+    return UMF_RESULT_ERROR_UNKNOWN;
+}
+
 static const char *trackingName(void *provider) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
@@ -519,85 +941,120 @@ static umf_result_t trackingGetIpcHandleSize(void *provider, size_t *size) {
     return umfMemoryProviderGetIPCHandleSize(p->hUpstream, size);
 }
 
-static umf_result_t trackingGetIpcHandle(void *provider, const void *ptr,
-                                         size_t size, void *providerIpcData) {
-    umf_tracking_memory_provider_t *p =
-        (umf_tracking_memory_provider_t *)provider;
+static umf_ipc_data_t *getIpcDataFromProviderIpcData(void *providerIpcData) {
+    // This is hack to get the UMF-specific data of the IPC handle
+    // (e.g. size of memory pointed by IPC handle).
+    // tracking memory provider gets only provider-specific data
+    // pointed by providerIpcData, but the size of allocation tracked
+    // by umf_ipc_data_t. We use this trick to get pointer to
+    // umf_ipc_data_t data because the providerIpcData is
+    // the Flexible Array Member of umf_ipc_data_t.
+    return (umf_ipc_data_t *)((uint8_t *)providerIpcData -
+                              sizeof(umf_ipc_data_t));
+}
+
+// trackingGetIpcCacheValue - get the cached IPC handle of the base
+// allocation, the handle is got from the upstream provider on a cache miss
+static umf_result_t
+trackingGetIpcCacheValue(umf_tracking_memory_provider_t *p, const void *ptr,
+                         size_t size, ipc_cache_value_t **cache_value_out) {
     umf_result_t ret = UMF_RESULT_SUCCESS;
-    size_t ipcDataSize = 0;
-    int cached = 0;
+    size_t providerIpcDataSize = 0;
     do {
         void *value = critnib_get(p->ipcCache, (uintptr_t)ptr);
         if (value) { //cache hit
-            ipc_cache_value_t *cache_value = (ipc_cache_value_t *)value;
-            memcpy(providerIpcData, cache_value->providerIpcData,
-                   cache_value->ipcDataSize);
-            cached = 1;
-        } else {
-            ret = umfMemoryProviderGetIPCHandle(p->hUpstream, ptr, size,
-                                                providerIpcData);
-            if (ret != UMF_RESULT_SUCCESS) {
-                LOG_ERR("upstream provider failed to get IPC handle");
-                return ret;
-            }
-
-            ret = umfMemoryProviderGetIPCHandleSize(p->hUpstream, &ipcDataSize);
-            if (ret != UMF_RESULT_SUCCESS) {
-                LOG_ERR("upstream provider failed to get the size of IPC "
-                        "handle");
-                ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
-                                                    providerIpcData);
-                if (ret != UMF_RESULT_SUCCESS) {
-                    LOG_ERR("upstream provider failed to put IPC handle");
-                }
-                return ret;
-            }
-
-            size_t value_size = sizeof(ipc_cache_value_t) + ipcDataSize;
-            ipc_cache_value_t *cache_value = umf_ba_global_alloc(value_size);
-            if (!cache_value) {
-                LOG_ERR("failed to allocate cache_value");
-                ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
-                                                    providerIpcData);
-                if (ret != UMF_RESULT_SUCCESS) {
-                    LOG_ERR("upstream provider failed to put IPC handle");
-                }
-                return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-            }
-
-            cache_value->ipcDataSize = ipcDataSize;
-            memcpy(cache_value->providerIpcData, providerIpcData, ipcDataSize);
-
-            int insRes = critnib_insert(p->ipcCache, (uintptr_t)ptr,
-                                        (void *)cache_value, 0 /*update*/);
-            if (insRes == 0) {
-                cached = 1;
-            } else {
-                // critnib_insert might fail in 2 cases:
-                // 1. Another thread created cache entry. So we need to
-                //    clean up allocated handle and try to read again from
-                //    the cache. Alternative approach could be insert empty
-                //    cache_value and only if insert succeed get actual IPC
-                //    handle and fill the cache_value structure under the lock.
-                //    But this case should be rare enough.
-                // 2. critnib failed to allocate memory internally. We need
-                //    to cleanup and return corresponding error.
-                umf_ba_global_free(cache_value);
-                ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
-                                                    providerIpcData);
-                if (ret != UMF_RESULT_SUCCESS) {
-                    LOG_ERR("upstream provider failed to put IPC handle");
-                    return ret;
-                }
-                if (insRes == ENOMEM) {
-                    LOG_ERR("insert to IPC cache failed due to OOM");
-                    return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-                }
-            }
+            utils_atomic_increment(&p->ipcCacheHits);
+            *cache_value_out = (ipc_cache_value_t *)value;
+            return UMF_RESULT_SUCCESS;
         }
-    } while (!cached);
 
-    return ret;
+        ret = umfMemoryProviderGetIPCHandleSize(p->hUpstream,
+                                                &providerIpcDataSize);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("upstream provider failed to get the size of IPC "
+                    "handle");
+            return ret;
+        }
+
+        size_t ipcDataSize = sizeof(umf_ipc_data_t) + providerIpcDataSize;
+        size_t value_size = sizeof(ipc_cache_value_t) + ipcDataSize;
+        ipc_cache_value_t *cache_value = umf_ba_global_alloc(value_size);
+        if (!cache_value) {
+            LOG_ERR("failed to allocate cache_value");
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        umf_ipc_data_t *ipcData = getIpcDataFromCacheValue(cache_value);
+        ret = umfMemoryProviderGetIPCHandle(p->hUpstream, ptr, size,
+                                            ipcData->providerIpcData);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("upstream provider failed to get IPC handle");
+            umf_ba_global_free(cache_value);
+            return ret;
+        }
+
+        cache_value->ipcDataSize = ipcDataSize;
+        ipcData->pid = utils_getpid();
+        ipcData->baseSize = size;
+        ipcData->offset = 0;
+        // the handle ID identifies the handle in the consumer's cache
+        // of opened IPC handles
+        ipcData->handle_id = utils_atomic_increment(&IpcHandleIdCounter);
+        utils_init_once(&IpcProcessNonceInitialized, ipc_init_process_nonce);
+        ipcData->process_nonce = IpcProcessNonce;
+        ipcData->base = (uintptr_t)ptr;
+
+        int insRes = critnib_insert(p->ipcCache, (uintptr_t)ptr,
+                                    (void *)cache_value, 0 /*update*/);
+        if (insRes == 0) {
+            utils_atomic_increment(&p->ipcCacheMisses);
+            *cache_value_out = cache_value;
+            return UMF_RESULT_SUCCESS;
+        }
+
+        // critnib_insert might fail in 2 cases:
+        // 1. Another thread created cache entry. So we need to
+        //    clean up allocated handle and try to read again from
+        //    the cache. Alternative approach could be insert empty
+        //    cache_value and only if insert succeed get actual IPC
+        //    handle and fill the cache_value structure under the lock.
+        //    But this case should be rare enough.
+        // 2. critnib failed to allocate memory internally. We need
+        //    to cleanup and return corresponding error.
+        ret = umfMemoryProviderPutIPCHandle(p->hUpstream,
+                                            ipcData->providerIpcData);
+        umf_ba_global_free(cache_value);
+        if (ret != UMF_RESULT_SUCCESS) {
+            LOG_ERR("upstream provider failed to put IPC handle");
+            return ret;
+        }
+        if (insRes == ENOMEM) {
+            LOG_ERR("insert to IPC cache failed due to OOM");
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    } while (1);
+}
+
+static umf_result_t trackingGetIpcHandle(void *provider, const void *ptr,
+                                         size_t size, void *providerIpcData) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    ipc_cache_value_t *cache_value = NULL;
+
+    umf_result_t ret = trackingGetIpcCacheValue(p, ptr, size, &cache_value);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    const umf_ipc_data_t *ipcData = getIpcDataFromCacheValue(cache_value);
+    memcpy(providerIpcData, ipcData->providerIpcData,
+           cache_value->ipcDataSize - sizeof(umf_ipc_data_t));
+
+    umf_ipc_data_t *outIpcData = getIpcDataFromProviderIpcData(providerIpcData);
+    outIpcData->handle_id = ipcData->handle_id;
+    outIpcData->process_nonce = ipcData->process_nonce;
+
+    return UMF_RESULT_SUCCESS;
 }
 
 static umf_result_t trackingPutIpcHandle(void *provider,
@@ -609,21 +1066,13 @@ static umf_result_t trackingPutIpcHandle(void *provider,
     return UMF_RESULT_SUCCESS;
 }
 
-static size_t getDataSizeFromIpcHandle(const void *providerIpcData) {
-    // This is hack to get size of memory pointed by IPC handle.
-    // tracking memory provider gets only provider-specific data
-    // pointed by providerIpcData, but the size of allocation tracked
-    // by umf_ipc_data_t. We use this trick to get pointer to
-    // umf_ipc_data_t data because the providerIpcData is
-    // the Flexible Array Member of umf_ipc_data_t.
-    const umf_ipc_data_t *ipcUmfData =
-        (const umf_ipc_data_t *)((const uint8_t *)providerIpcData -
-                                 sizeof(umf_ipc_data_t));
-    return ipcUmfData->baseSize;
+static size_t getDataSizeFromIpcHandle(void *providerIpcData) {
+    return getIpcDataFromProviderIpcData(providerIpcData)->baseSize;
 }
 
-static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
-                                          void **ptr) {
+static umf_result_t trackingOpenIpcHandleUpstream(void *provider,
+                                                  void *providerIpcData,
+                                                  void **ptr) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
     umf_result_t ret = UMF_RESULT_SUCCESS;
@@ -650,26 +1099,123 @@ static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
     return ret;
 }
 
+static umf_result_t trackingOpenIpcHandle(void *provider, void *providerIpcData,
+                                          void **ptr) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)provider;
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
+
+    const umf_ipc_data_t *ipcUmfData =
+        getIpcDataFromProviderIpcData(providerIpcData);
+
+    ipc_opened_cache_value_t key = {0};
+    key.remote_pid = ipcUmfData->pid;
+    key.remote_nonce = ipcUmfData->process_nonce;
+    key.handle_id = ipcUmfData->handle_id;
+    key.remote_base = ipcUmfData->base;
+
+    // the handle ID is not set if the producer did not use the tracking
+    // provider, so such a handle cannot be cached
+    if (key.handle_id == 0) {
+        utils_atomic_increment(&p->ipcOpenedCacheMisses);
+        return trackingOpenIpcHandleUpstream(provider, providerIpcData, ptr);
+    }
+
+    if (utils_mutex_lock(&cache->lock)) {
+        LOG_ERR("failed to lock the cache of opened IPC handles");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    struct ravl_node *node =
+        ravl_find(cache->entries, &key, RAVL_PREDICATE_EQUAL);
+    if (node) { // cache hit
+        utils_atomic_increment(&p->ipcOpenedCacheHits);
+        ipc_opened_cache_value_t *value = ravl_data(node);
+        if (value->ref_count == 0) {
+            ipc_opened_cache_lru_remove(cache, value);
+        }
+        value->ref_count++;
+        *ptr = value->mapped_base;
+        goto unlock;
+    }
+
+    utils_atomic_increment(&p->ipcOpenedCacheMisses);
+    ret = trackingOpenIpcHandleUpstream(provider, providerIpcData, ptr);
+    if (ret != UMF_RESULT_SUCCESS) {
+        goto unlock;
+    }
+
+    ipc_opened_cache_value_t *value =
+        umf_ba_global_alloc(sizeof(ipc_opened_cache_value_t));
+    if (!value) {
+        // the mapping is just not cached
+        LOG_WARN("failed to allocate an entry of the cache of opened IPC "
+                 "handles");
+        goto unlock;
+    }
+
+    *value = key;
+    value->mapped_base = *ptr;
+    value->mapped_size = getDataSizeFromIpcHandle(providerIpcData);
+    value->ref_count = 1;
+
+    if (ravl_insert(cache->entries, value)) {
+        LOG_WARN("failed to insert an entry to the cache of opened IPC "
+                 "handles");
+        umf_ba_global_free(value);
+        goto unlock;
+    }
+
+    if (critnib_insert(cache->mappings, (uintptr_t)*ptr, value, 0)) {
+        LOG_WARN("failed to insert an entry to the cache of opened IPC "
+                 "handles");
+        ravl_remove(cache->entries,
+                    ravl_find(cache->entries, value, RAVL_PREDICATE_EQUAL));
+        umf_ba_global_free(value);
+    }
+
+unlock:
+    utils_mutex_unlock(&cache->lock);
+    return ret;
+}
+
 static umf_result_t trackingCloseIpcHandle(void *provider, void *ptr,
                                            size_t size) {
     umf_tracking_memory_provider_t *p =
         (umf_tracking_memory_provider_t *)provider;
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+    umf_result_t ret = UMF_RESULT_SUCCESS;
 
-    // umfMemoryTrackerRemove should be called before umfMemoryProviderCloseIPCHandle
-    // to avoid a race condition. If the order would be different, other thread
-    // could allocate the memory at address `ptr` before a call to umfMemoryTrackerRemove
-    // resulting in inconsistent state.
-    if (ptr) {
-        umf_result_t ret = umfMemoryTrackerRemove(p->hTracker, ptr);
-        if (ret != UMF_RESULT_SUCCESS) {
-            // DO NOT return an error here, because the tracking provider
-            // cannot change behaviour of the upstream provider.
-            LOG_ERR("failed to remove the region from the tracker, ptr=%p, "
-                    "size=%zu, ret = %d",
-                    ptr, size, ret);
-        }
+    if (utils_mutex_lock(&cache->lock)) {
+        LOG_ERR("failed to lock the cache of opened IPC handles");
+        return UMF_RESULT_ERROR_UNKNOWN;
     }
-    return umfMemoryProviderCloseIPCHandle(p->hUpstream, ptr, size);
+
+    ipc_opened_cache_value_t *value =
+        (ipc_opened_cache_value_t *)critnib_get(cache->mappings,
+                                                (uintptr_t)ptr);
+    if (value == NULL) {
+        // the mapping is not cached
+        utils_mutex_unlock(&cache->lock);
+        return ipc_close_upstream(p, ptr, size);
+    }
+
+    if (value->ref_count == 0) {
+        LOG_ERR("IPC handle is already closed, ptr=%p", ptr);
+        ret = UMF_RESULT_ERROR_INVALID_ARGUMENT;
+        goto unlock;
+    }
+
+    // the mapping is closed only when it is evicted from the cache
+    if (--value->ref_count == 0) {
+        ipc_opened_cache_lru_append(cache, value);
+        ret = ipc_opened_cache_evict(p);
+    }
+
+unlock:
+    utils_mutex_unlock(&cache->lock);
+    return ret;
 }
 
 umf_memory_provider_ops_t UMF_TRACKING_MEMORY_PROVIDER_OPS = {
@@ -686,6 +1232,10 @@ umf_memory_provider_ops_t UMF_TRACKING_MEMORY_PROVIDER_OPS = {
     .ext.purge_lazy = trackingPurgeLazy,
     .ext.allocation_split = trackingAllocationSplit,
     .ext.allocation_merge = trackingAllocationMerge,
+    .ext.migrate = trackingMigrate,
+    .ext.resize = trackingResize,
+    .ext.persist = trackingPersist,
+    .ext.alloc_zero_info = trackingAllocZeroInfo,
     .ipc.get_ipc_handle_size = trackingGetIpcHandleSize,
     .ipc.get_ipc_handle = trackingGetIpcHandle,
     .ipc.put_ipc_handle = trackingPutIpcHandle,
@@ -705,6 +1255,10 @@ umf_result_t umfTrackingMemoryProviderCreate(
         return UMF_RESULT_ERROR_UNKNOWN;
     }
     params.pool = hPool;
+    params.ipcCacheHits = 0;
+    params.ipcCacheMisses = 0;
+    params.ipcOpenedCacheHits = 0;
+    params.ipcOpenedCacheMisses = 0;
     params.ipcCache = critnib_new();
     if (!params.ipcCache) {
         LOG_ERR("failed to create IPC cache");
@@ -729,6 +1283,72 @@ void umfTrackingMemoryProviderGetUpstreamProvider(
     *hUpstream = p->hUpstream;
 }
 
+umf_result_t umfTrackingMemoryProviderSetOpenedIPCCacheSize(
+    umf_memory_provider_handle_t hTrackingProvider, size_t size) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hTrackingProvider;
+    ipc_opened_cache_t *cache = &p->ipcOpenedCache;
+
+    if (utils_mutex_lock(&cache->lock)) {
+        LOG_ERR("failed to lock the cache of opened IPC handles");
+        return UMF_RESULT_ERROR_UNKNOWN;
+    }
+
+    cache->max_unused = size;
+    umf_result_t ret = ipc_opened_cache_evict(p);
+
+    utils_mutex_unlock(&cache->lock);
+
+    return ret;
+}
+
+umf_result_t umfTrackingMemoryProviderGetIPCHandleId(
+    umf_memory_provider_handle_t hTrackingProvider, const void *ptr,
+    size_t size, uint64_t *handleId) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hTrackingProvider;
+    ipc_cache_value_t *cache_value = NULL;
+
+    umf_result_t ret = trackingGetIpcCacheValue(p, ptr, size, &cache_value);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    *handleId = getIpcDataFromCacheValue(cache_value)->handle_id;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+umf_result_t umfTrackingMemoryProviderGetIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, const void *ptr,
+    size_t size, const umf_ipc_data_t **ipcData, size_t *ipcDataSize) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hTrackingProvider;
+    ipc_cache_value_t *cache_value = NULL;
+
+    umf_result_t ret = trackingGetIpcCacheValue(p, ptr, size, &cache_value);
+    if (ret != UMF_RESULT_SUCCESS) {
+        return ret;
+    }
+
+    *ipcData = getIpcDataFromCacheValue(cache_value);
+    *ipcDataSize = cache_value->ipcDataSize;
+
+    return UMF_RESULT_SUCCESS;
+}
+
+void umfTrackingMemoryProviderGetIPCCacheStats(
+    umf_memory_provider_handle_t hTrackingProvider,
+    umf_ipc_cache_stats_t *stats) {
+    umf_tracking_memory_provider_t *p =
+        (umf_tracking_memory_provider_t *)hTrackingProvider;
+
+    utils_atomic_load_acquire(&p->ipcCacheHits, &stats->get_hits);
+    utils_atomic_load_acquire(&p->ipcCacheMisses, &stats->get_misses);
+    utils_atomic_load_acquire(&p->ipcOpenedCacheHits, &stats->open_hits);
+    utils_atomic_load_acquire(&p->ipcOpenedCacheMisses, &stats->open_misses);
+}
+
 umf_memory_tracker_handle_t umfMemoryTrackerCreate(void) {
     umf_memory_tracker_handle_t handle =
         umf_ba_global_alloc(sizeof(struct umf_memory_tracker_t));
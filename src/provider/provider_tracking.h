@@ -15,6 +15,7 @@
 #include <stdlib.h>
 
 #include <umf/base.h>
+#include <umf/ipc.h>
 #include <umf/memory_pool.h>
 #include <umf/memory_provider.h>
 
@@ -60,6 +61,30 @@ void umfTrackingMemoryProviderGetUpstreamProvider(
     umf_memory_provider_handle_t hTrackingProvider,
     umf_memory_provider_handle_t *hUpstream);
 
+// Sets the maximum number of the unused (closed) IPC mappings kept open
+// in the cache of the tracking provider. The least recently used ones
+// above the limit are closed.
+umf_result_t umfTrackingMemoryProviderSetOpenedIPCCacheSize(
+    umf_memory_provider_handle_t hTrackingProvider, size_t size);
+
+// Gets the ID of the IPC handle of the base allocation (the IPC handle
+// is created if it does not exist yet).
+umf_result_t umfTrackingMemoryProviderGetIPCHandleId(
+    umf_memory_provider_handle_t hTrackingProvider, const void *ptr,
+    size_t size, uint64_t *handleId);
+
+// Gets the cached IPC handle of the base allocation (with the offset
+// equal to 0), the IPC handle is created if it does not exist yet.
+// The returned handle is valid until the base allocation is freed.
+umf_result_t umfTrackingMemoryProviderGetIPCHandle(
+    umf_memory_provider_handle_t hTrackingProvider, const void *ptr,
+    size_t size, const struct umf_ipc_data_t **ipcData,
+    size_t *ipcDataSize);
+
+void umfTrackingMemoryProviderGetIPCCacheStats(
+    umf_memory_provider_handle_t hTrackingProvider,
+    umf_ipc_cache_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,8 +9,27 @@
 
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define UTILS_X86_CACHE_FLUSH 1
+// the non-temporal kernels rely on SSE2, which is a part of
+// the x86-64 baseline, but not of the i386 one
+#if defined(__x86_64__) || defined(_M_X64)
+#define UTILS_X86_64 1
+#endif
+#if defined(_MSC_VER) || defined(UTILS_X86_64)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 #include "utils_assert.h"
 #include "utils_common.h"
+#include "utils_concurrency.h"
+#include "utils_log.h"
 
 // align a pointer up and a size down
 void utils_align_ptr_up_size_down(void **ptr, size_t *size, size_t alignment) {
@@ -138,3 +157,307 @@ umf_result_t utils_translate_flags(unsigned in_flags, unsigned max,
     *out_flags = out_f;
     return UMF_RESULT_SUCCESS;
 }
+
+#define CACHE_LINE_SIZE 64
+
+// sizes below this threshold are expected to fit in the CPU caches,
+// so regular (cached) stores are used for them
+#define NON_TEMPORAL_THRESHOLD (1024 * 1024)
+
+#ifdef UTILS_X86_CACHE_FLUSH
+
+// CPUID.1:ECX, CPUID.1:EDX, CPUID.(EAX=7,ECX=0):EBX
+#define CPUID_ECX_OSXSAVE (1u << 27)
+#define CPUID_ECX_AVX (1u << 28)
+#define CPUID_EDX_CLFLUSH (1u << 19)
+#define CPUID_EBX_AVX2 (1u << 5)
+#define CPUID_EBX_AVX512F (1u << 16)
+#define CPUID_EBX_CLFLUSHOPT (1u << 23)
+#define CPUID_EBX_CLWB (1u << 24)
+
+// XCR0: the OS saves the SSE and AVX (and AVX-512) registers
+#define XCR0_AVX_STATE 0x06u
+#define XCR0_AVX512_STATE 0xE6u
+
+typedef void (*flush_line_t)(const char *addr);
+
+#ifdef UTILS_X86_64
+// dst is aligned to and size is a multiple of CACHE_LINE_SIZE
+typedef void (*memzero_nt_t)(char *dst, size_t size);
+typedef void (*memcpy_nt_t)(char *dst, const char *src, size_t size);
+#endif
+
+#if defined(_MSC_VER)
+#define UTILS_TARGET(isa)
+
+static void flush_clflush(const char *addr) { _mm_clflush(addr); }
+static void flush_clflushopt(const char *addr) {
+    _mm_clflushopt((void *)addr);
+}
+static void flush_clwb(const char *addr) { _mm_clwb((void *)addr); }
+static void store_fence(void) { _mm_sfence(); }
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) {
+        regs[i] = (unsigned)r[i];
+    }
+}
+
+static unsigned cpuid_max(void) {
+    int r[4];
+    __cpuid(r, 0);
+    return (unsigned)r[0];
+}
+
+#ifdef UTILS_X86_64
+static uint64_t xgetbv0(void) { return _xgetbv(0); }
+#endif
+#else
+#define UTILS_TARGET(isa) __attribute__((target(isa)))
+
+// the byte prefixes allow assemblers not knowing CLFLUSHOPT and CLWB
+static void flush_clflush(const char *addr) {
+    __asm__ volatile("clflush %0" ::"m"(*addr) : "memory");
+}
+static void flush_clflushopt(const char *addr) {
+    __asm__ volatile(".byte 0x66; clflush %0" ::"m"(*addr) : "memory");
+}
+static void flush_clwb(const char *addr) {
+    __asm__ volatile(".byte 0x66; xsaveopt %0" ::"m"(*addr) : "memory");
+}
+static void store_fence(void) { __asm__ volatile("sfence" ::: "memory"); }
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+
+static unsigned cpuid_max(void) { return __get_cpuid_max(0, NULL); }
+
+#ifdef UTILS_X86_64
+static uint64_t xgetbv0(void) {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
+#endif
+
+#ifdef UTILS_X86_64
+// SSE2 is a part of the x86-64 baseline
+static void memzero_nt_sse2(char *dst, size_t size) {
+    __m128i zero = _mm_setzero_si128();
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        _mm_stream_si128((__m128i *)(dst + i), zero);
+        _mm_stream_si128((__m128i *)(dst + i + 16), zero);
+        _mm_stream_si128((__m128i *)(dst + i + 32), zero);
+        _mm_stream_si128((__m128i *)(dst + i + 48), zero);
+    }
+}
+
+static void memcpy_nt_sse2(char *dst, const char *src, size_t size) {
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 48));
+        _mm_stream_si128((__m128i *)(dst + i), a);
+        _mm_stream_si128((__m128i *)(dst + i + 16), b);
+        _mm_stream_si128((__m128i *)(dst + i + 32), c);
+        _mm_stream_si128((__m128i *)(dst + i + 48), d);
+    }
+}
+
+UTILS_TARGET("avx2")
+static void memzero_nt_avx2(char *dst, size_t size) {
+    __m256i zero = _mm256_setzero_si256();
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        _mm256_stream_si256((__m256i *)(dst + i), zero);
+        _mm256_stream_si256((__m256i *)(dst + i + 32), zero);
+    }
+}
+
+UTILS_TARGET("avx2")
+static void memcpy_nt_avx2(char *dst, const char *src, size_t size) {
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+        _mm256_stream_si256((__m256i *)(dst + i), a);
+        _mm256_stream_si256((__m256i *)(dst + i + 32), b);
+    }
+}
+
+UTILS_TARGET("avx512f")
+static void memzero_nt_avx512(char *dst, size_t size) {
+    __m512i zero = _mm512_setzero_si512();
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        _mm512_stream_si512((__m512i *)(dst + i), zero);
+    }
+}
+
+UTILS_TARGET("avx512f")
+static void memcpy_nt_avx512(char *dst, const char *src, size_t size) {
+    for (size_t i = 0; i < size; i += CACHE_LINE_SIZE) {
+        __m512i a = _mm512_loadu_si512((const void *)(src + i));
+        _mm512_stream_si512((__m512i *)(dst + i), a);
+    }
+}
+
+static memzero_nt_t Memzero_nt = memzero_nt_sse2;
+static memcpy_nt_t Memcpy_nt = memcpy_nt_sse2;
+static const char *Non_temporal_isa = "sse2";
+#else
+static const char *Non_temporal_isa = NULL;
+#endif /* UTILS_X86_64 */
+
+static UTIL_ONCE_FLAG Cpu_features_init_once = UTIL_ONCE_FLAG_INIT;
+static flush_line_t Flush_line;
+static const char *Flush_instruction;
+
+static void cpu_features_init(void) {
+    unsigned regs[4] = {0}; // EAX, EBX, ECX, EDX
+    unsigned leaf1[4] = {0};
+    unsigned max_leaf = cpuid_max();
+
+    if (max_leaf >= 1) {
+        cpuid(1, 0, leaf1);
+    }
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        if (regs[1] & CPUID_EBX_CLWB) {
+            Flush_line = flush_clwb;
+            Flush_instruction = "clwb";
+        } else if (regs[1] & CPUID_EBX_CLFLUSHOPT) {
+            Flush_line = flush_clflushopt;
+            Flush_instruction = "clflushopt";
+        }
+    }
+
+    if (Flush_line == NULL && (leaf1[3] & CPUID_EDX_CLFLUSH)) {
+        Flush_line = flush_clflush;
+        Flush_instruction = "clflush";
+    }
+
+#ifdef UTILS_X86_64
+    // the wider registers can be used only if the OS saves them
+    uint64_t xcr0 = 0;
+    if ((leaf1[2] & CPUID_ECX_OSXSAVE) && (leaf1[2] & CPUID_ECX_AVX)) {
+        xcr0 = xgetbv0();
+    }
+
+    if ((xcr0 & XCR0_AVX512_STATE) == XCR0_AVX512_STATE &&
+        (regs[1] & CPUID_EBX_AVX512F)) {
+        Memzero_nt = memzero_nt_avx512;
+        Memcpy_nt = memcpy_nt_avx512;
+        Non_temporal_isa = "avx512f";
+    } else if ((xcr0 & XCR0_AVX_STATE) == XCR0_AVX_STATE &&
+               (regs[1] & CPUID_EBX_AVX2)) {
+        Memzero_nt = memzero_nt_avx2;
+        Memcpy_nt = memcpy_nt_avx2;
+        Non_temporal_isa = "avx2";
+    }
+#endif
+
+    LOG_DEBUG("CPU cache flush instruction: %s, non-temporal stores: %s",
+              Flush_instruction ? Flush_instruction : "none",
+              Non_temporal_isa ? Non_temporal_isa : "none");
+}
+
+int utils_flush_cache(const void *addr, size_t length) {
+    utils_init_once(&Cpu_features_init_once, cpu_features_init);
+    if (Flush_line == NULL) {
+        return -1;
+    }
+
+    uintptr_t end = (uintptr_t)addr + length;
+    for (uintptr_t p = ALIGN_DOWN((uintptr_t)addr, CACHE_LINE_SIZE); p < end;
+         p += CACHE_LINE_SIZE) {
+        Flush_line((const char *)p);
+    }
+
+    // order the flushes with the later stores
+    store_fence();
+
+    return 0;
+}
+
+const char *utils_flush_cache_instruction(void) {
+    utils_init_once(&Cpu_features_init_once, cpu_features_init);
+    return Flush_instruction;
+}
+
+const char *utils_non_temporal_isa(void) {
+    utils_init_once(&Cpu_features_init_once, cpu_features_init);
+    return Non_temporal_isa;
+}
+
+#else /* !UTILS_X86_CACHE_FLUSH */
+
+int utils_flush_cache(const void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    return -1;    // not supported on this platform
+}
+
+const char *utils_flush_cache_instruction(void) { return NULL; }
+
+const char *utils_non_temporal_isa(void) { return NULL; }
+
+#endif /* !UTILS_X86_CACHE_FLUSH */
+
+#ifdef UTILS_X86_64
+
+void utils_memzero_nt(void *ptr, size_t size) {
+    if (size < NON_TEMPORAL_THRESHOLD) {
+        memset(ptr, 0, size);
+        return;
+    }
+
+    utils_init_once(&Cpu_features_init_once, cpu_features_init);
+
+    // the unaligned head and tail are zeroed with regular stores
+    char *dst = (char *)ptr;
+    size_t head = ALIGN_UP((uintptr_t)dst, CACHE_LINE_SIZE) - (uintptr_t)dst;
+    size_t body = ALIGN_DOWN(size - head, CACHE_LINE_SIZE);
+
+    memset(dst, 0, head);
+    Memzero_nt(dst + head, body);
+    memset(dst + head + body, 0, size - head - body);
+
+    // non-temporal stores are weakly ordered
+    _mm_sfence();
+}
+
+void utils_memcpy_nt(void *dst, const void *src, size_t size) {
+    if (size < NON_TEMPORAL_THRESHOLD) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    utils_init_once(&Cpu_features_init_once, cpu_features_init);
+
+    // the unaligned head and tail are copied with regular stores
+    char *d = (char *)dst;
+    const char *s = (const char *)src;
+    size_t head = ALIGN_UP((uintptr_t)d, CACHE_LINE_SIZE) - (uintptr_t)d;
+    size_t body = ALIGN_DOWN(size - head, CACHE_LINE_SIZE);
+
+    memcpy(d, s, head);
+    Memcpy_nt(d + head, s + head, body);
+    memcpy(d + head + body, s + head + body, size - head - body);
+
+    // non-temporal stores are weakly ordered
+    _mm_sfence();
+}
+
+#else /* !UTILS_X86_64 */
+
+void utils_memzero_nt(void *ptr, size_t size) { memset(ptr, 0, size); }
+
+void utils_memcpy_nt(void *dst, const void *src, size_t size) {
+    memcpy(dst, src, size);
+}
+
+#endif /* !UTILS_X86_64 */
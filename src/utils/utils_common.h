@@ -11,6 +11,7 @@
 #define UMF_COMMON_H 1
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,6 +27,11 @@ typedef enum umf_purge_advise_t {
     UMF_PURGE_FORCE,
 } umf_purge_advise_t;
 
+typedef enum umf_prefetch_advise_t {
+    UMF_PREFETCH_WILLNEED, // read ahead the backing file
+    UMF_PREFETCH_POPULATE, // prefault page tables (for reading)
+} umf_prefetch_advise_t;
+
 #define DO_WHILE_EMPTY                                                         \
     do {                                                                       \
     } while (0)
@@ -94,6 +100,16 @@ int utils_getpid(void);
 // get the current thread ID
 int utils_gettid(void);
 
+// get the number of online CPUs (at least 1)
+unsigned utils_get_num_cpus(void);
+
+// get the number of possible NUMA nodes (at least 1)
+unsigned utils_get_num_numa_nodes(void);
+
+// get the CPU and the NUMA node the calling thread is running on,
+// returns 0 on success or -1 if it is not supported
+int utils_getcpu(unsigned *cpu, unsigned *node);
+
 // close file descriptor
 int utils_close_fd(int fd);
 
@@ -116,12 +132,27 @@ utils_translate_mem_visibility_flag(umf_memory_visibility_t in_flag,
 
 int utils_create_anonymous_fd(void);
 
+// create an anonymous file descriptor with memfd_create() only
+// (the memory of memfd_secret() cannot be purged with madvise())
+int utils_create_memfd(void);
+
 int utils_shm_create(const char *shm_name, size_t size);
 
 int utils_shm_open(const char *shm_name);
 
 int utils_shm_unlink(const char *shm_name);
 
+// wait (up to timeout_ms, forever if timeout_ms < 0) until *addr
+// is changed from 'expected' and woken up by utils_futex_wake(),
+// works also for addresses shared between processes
+int utils_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms);
+
+// wake up to 'count' waiters of the futex
+int utils_futex_wake(uint32_t *addr, int count);
+
+// milliseconds of a monotonic clock (for computing timeouts)
+uint64_t utils_get_time_ms(void);
+
 size_t get_max_file_size(void);
 
 int utils_get_file_size(int fd, size_t *size);
@@ -131,13 +162,51 @@ int utils_set_file_size(int fd, size_t size);
 void *utils_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
                  size_t fd_offset);
 
+// Maps the given file into memory (see utils_linux_common.c).
+// If map_sync is not NULL, it is set to true if the file was mapped
+// with the MAP_SYNC flag (so the CPU cache flush is enough to persist it).
 void *utils_mmap_file(void *hint_addr, size_t length, int prot, int flags,
-                      int fd, size_t fd_offset);
+                      int fd, size_t fd_offset, bool *map_sync);
+
+// Writes back the dirty pages of the given range of a file mapping
+// (msync(MS_SYNC)). Returns 0 on success or -1 on failure (errno is set).
+int utils_msync(void *addr, size_t length);
+
+// Flushes the CPU caches of the given range with the fastest instruction
+// supported by the CPU (CLWB, CLFLUSHOPT or CLFLUSH) followed by SFENCE.
+// The instruction is detected once. Returns 0 on success or -1 if the cache
+// flush is not supported on this platform.
+int utils_flush_cache(const void *addr, size_t length);
+
+// Returns the name of the instruction used by utils_flush_cache()
+// or NULL if the cache flush is not supported on this platform.
+const char *utils_flush_cache_instruction(void);
+
+// Zeroes the given range. Large ranges are zeroed with non-temporal
+// (streaming) SIMD stores (SSE2, AVX2 or AVX-512F, detected once),
+// so they do not evict the working set from the CPU caches.
+void utils_memzero_nt(void *ptr, size_t size);
+
+// Copies the given range like memcpy(). Large ranges are copied
+// with non-temporal SIMD stores (see utils_memzero_nt()).
+void utils_memcpy_nt(void *dst, const void *src, size_t size);
+
+// Returns the name of the instruction set used for non-temporal stores
+// or NULL if they are not supported on this platform.
+const char *utils_non_temporal_isa(void);
 
 int utils_munmap(void *addr, size_t length);
 
+// Resizes an anonymous memory mapping, the mapping can be moved.
+// Returns the new address of the mapping or NULL on failure (errno is set).
+void *utils_mremap(void *old_addr, size_t old_length, size_t new_length);
+
 int utils_purge(void *addr, size_t length, int advice);
 
+// Prefetches the given page-aligned memory range.
+// Returns 0 on success or -1 on failure (errno is set).
+int utils_prefetch(void *addr, size_t length, umf_prefetch_advise_t advice);
+
 void utils_strerror(int errnum, char *buf, size_t buflen);
 
 int utils_devdax_open(const char *path);
@@ -146,8 +215,17 @@ int utils_file_open(const char *path);
 
 int utils_file_open_or_create(const char *path);
 
+// Takes an exclusive advisory lock of the file without waiting for it.
+// The lock is released when the file is closed.
+// Returns 0 on success or -1 on failure (errno is set).
+int utils_file_lock_exclusive(int fd);
+
 int utils_fallocate(int fd, long offset, long len);
 
+// Deallocates the space of the given range of a file (the file size is kept).
+// Returns 0 on success or -1 on failure (errno is set).
+int utils_punch_hole(int fd, size_t offset, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
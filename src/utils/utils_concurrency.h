@@ -10,6 +10,8 @@
 #ifndef UMF_UTILS_CONCURRENCY_H
 #define UMF_UTILS_CONCURRENCY_H 1
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #ifdef _WIN32
@@ -50,6 +52,25 @@ void utils_mutex_destroy_not_free(utils_mutex_t *m);
 int utils_mutex_lock(utils_mutex_t *mutex);
 int utils_mutex_unlock(utils_mutex_t *mutex);
 
+// A mutex that can be placed in memory shared between processes
+// (also mapped at different addresses). On Linux it is robust: if its owner
+// dies holding it, the next utils_shared_mutex_lock() takes it over
+// and returns EOWNERDEAD. On Windows it is a spin lock with a backoff.
+typedef struct utils_shared_mutex_t {
+#ifdef _WIN32
+    LONG64 lock;
+#else
+    pthread_mutex_t lock;
+#endif
+} utils_shared_mutex_t;
+
+// Returns 0 on success or an error number.
+int utils_shared_mutex_init(utils_shared_mutex_t *mutex);
+// Returns 0 or EOWNERDEAD when the mutex is locked by the caller
+// or another error number when it is not.
+int utils_shared_mutex_lock(utils_shared_mutex_t *mutex);
+int utils_shared_mutex_unlock(utils_shared_mutex_t *mutex);
+
 #if defined(_WIN32)
 #define UTIL_ONCE_FLAG INIT_ONCE
 #define UTIL_ONCE_FLAG_INIT INIT_ONCE_STATIC_INIT
@@ -84,6 +105,29 @@ static __inline unsigned char utils_mssb_index(long long value) {
     InterlockedIncrement64((LONG64 volatile *)object)
 #define utils_fetch_and_add64(ptr, value)                                      \
     InterlockedExchangeAdd64((LONG64 *)(ptr), value)
+
+#define utils_atomic_load_acquire_u32(object, dest)                            \
+    do {                                                                       \
+        *dest = (uint32_t)InterlockedOr((LONG volatile *)object, 0);           \
+    } while (0)
+#define utils_atomic_store_release_u32(object, desired)                        \
+    InterlockedExchange((LONG volatile *)object, (LONG)desired)
+#define utils_atomic_increment_u32(object)                                     \
+    InterlockedIncrement((LONG volatile *)object)
+#define utils_atomic_fence() MemoryBarrier()
+
+static __inline bool utils_compare_exchange(uint64_t *object,
+                                            uint64_t *expected,
+                                            uint64_t desired) {
+    LONG64 old = InterlockedCompareExchange64(
+        (LONG64 volatile *)object, (LONG64)desired, (LONG64)*expected);
+    if ((uint64_t)old == *expected) {
+        return true;
+    }
+
+    *expected = (uint64_t)old;
+    return false;
+}
 #else
 #define utils_lssb_index(x) ((unsigned char)__builtin_ctzll(x))
 #define utils_mssb_index(x) ((unsigned char)(63 - __builtin_clzll(x)))
@@ -102,6 +146,15 @@ static __inline unsigned char utils_mssb_index(long long value) {
 #define utils_atomic_increment(object)                                         \
     __atomic_add_fetch(object, 1, __ATOMIC_ACQ_REL)
 #define utils_fetch_and_add64 __sync_fetch_and_add
+
+#define utils_compare_exchange(object, expected, desired)                      \
+    __atomic_compare_exchange_n(object, expected, desired, 0 /* strong */,     \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define utils_atomic_load_acquire_u32 utils_atomic_load_acquire
+#define utils_atomic_store_release_u32 utils_atomic_store_release
+#define utils_atomic_increment_u32 utils_atomic_increment
+#define utils_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
 #endif
 
 #ifdef __cplusplus
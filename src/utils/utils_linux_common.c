@@ -7,12 +7,19 @@
  *
  */
 
+#define _GNU_SOURCE 1
+
+#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <umf/base.h>
@@ -21,6 +28,13 @@
 #include "utils_common.h"
 #include "utils_log.h"
 
+// getcpu() was added in glibc 2.29
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 29)
+#define UTILS_HAVE_GETCPU 1
+#endif
+#endif
+
 umf_result_t
 utils_translate_mem_visibility_flag(umf_memory_visibility_t in_flag,
                                     unsigned *out_flag) {
@@ -46,9 +60,13 @@ utils_translate_mem_visibility_flag(umf_memory_visibility_t in_flag,
  * did not specify it by himself it tries to mmap with (flags | MAP_SHARED).
  */
 void *utils_mmap_file(void *hint_addr, size_t length, int prot, int flags,
-                      int fd, size_t fd_offset) {
+                      int fd, size_t fd_offset, bool *map_sync) {
     void *addr;
 
+    if (map_sync) {
+        *map_sync = false;
+    }
+
     /*
      * MAP_PRIVATE and MAP_SHARED are mutually exclusive,
      * therefore mmap with MAP_PRIVATE is executed separately.
@@ -78,6 +96,9 @@ void *utils_mmap_file(void *hint_addr, size_t length, int prot, int flags,
             LOG_DEBUG("file mapped with the MAP_SYNC flag (fd=%i, offset=%zu, "
                       "length=%zu)",
                       fd, fd_offset, length);
+            if (map_sync) {
+                *map_sync = true;
+            }
             return addr;
         }
 
@@ -126,10 +147,24 @@ int utils_set_file_size(int fd, size_t size) {
     return ret;
 }
 
+void *utils_mremap(void *old_addr, size_t old_length, size_t new_length) {
+    void *addr = mremap(old_addr, old_length, new_length, MREMAP_MAYMOVE);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+
+    return addr;
+}
+
 int utils_fallocate(int fd, long offset, long len) {
     return posix_fallocate(fd, offset, len);
 }
 
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    return fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                     (off_t)offset, (off_t)len);
+}
+
 // create a shared memory file
 int utils_shm_create(const char *shm_name, size_t size) {
     if (shm_name == NULL) {
@@ -175,6 +210,59 @@ int utils_shm_open(const char *shm_name) {
 // unlink a shared memory file
 int utils_shm_unlink(const char *shm_name) { return shm_unlink(shm_name); }
 
+unsigned utils_get_num_numa_nodes(void) {
+    // the format is a list of ranges, e.g. "0" or "0-3"
+    char buf[64] = {0};
+    int fd = open("/sys/devices/system/node/possible", O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) {
+        return 1;
+    }
+
+    // the last number is the highest node ID
+    char *last = buf + len;
+    while (last > buf && !isdigit((unsigned char)last[-1])) {
+        last--;
+    }
+    while (last > buf && isdigit((unsigned char)last[-1])) {
+        last--;
+    }
+
+    return (unsigned)strtoul(last, NULL, 10) + 1;
+}
+
+int utils_getcpu(unsigned *cpu, unsigned *node) {
+    // getcpu() goes through vDSO, so it is cheap enough for a hot path
+#ifdef UTILS_HAVE_GETCPU
+    return getcpu(cpu, node);
+#else
+    return (int)syscall(SYS_getcpu, cpu, node, NULL);
+#endif
+}
+
+int utils_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    struct timespec *timeout = NULL;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000;
+        timeout = &ts;
+    }
+
+    // not FUTEX_WAIT_PRIVATE - the futex can be shared between processes
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT, expected, timeout, NULL,
+                        0);
+}
+
+int utils_futex_wake(uint32_t *addr, int count) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
 static int syscall_memfd_secret(void) {
     int fd = -1;
 #ifdef __NR_memfd_secret
@@ -232,3 +320,5 @@ int utils_create_anonymous_fd(void) {
 
     return fd;
 }
+
+int utils_create_memfd(void) { return syscall_memfd_create(); }
@@ -7,6 +7,7 @@
  *
  */
 
+#include <errno.h>
 #include <sys/mman.h>
 
 #include <umf/base.h>
@@ -30,13 +31,14 @@ utils_translate_mem_visibility_flag(umf_memory_visibility_t in_flag,
 }
 
 void *utils_mmap_file(void *hint_addr, size_t length, int prot, int flags,
-                      int fd, size_t fd_offset) {
+                      int fd, size_t fd_offset, bool *map_sync) {
     (void)hint_addr; // unused
     (void)length;    // unused
     (void)prot;      // unused
     (void)flags;     // unused
     (void)fd;        // unused
     (void)fd_offset; // unused
+    (void)map_sync;  // unused
     return NULL;     // not supported
 }
 
@@ -52,6 +54,15 @@ int utils_set_file_size(int fd, size_t size) {
     return 0;   // ignored on MacOSX
 }
 
+void *utils_mremap(void *old_addr, size_t old_length, size_t new_length) {
+    (void)old_addr;   // unused
+    (void)old_length; // unused
+    (void)new_length; // unused
+
+    errno = ENOTSUP; // not supported on MacOSX
+    return NULL;
+}
+
 int utils_fallocate(int fd, long offset, long len) {
     (void)fd;     // unused
     (void)offset; // unused
@@ -60,6 +71,15 @@ int utils_fallocate(int fd, long offset, long len) {
     return -1;
 }
 
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)len;    // unused
+
+    errno = ENOTSUP; // not supported on MacOSX
+    return -1;
+}
+
 // create a shared memory file
 int utils_shm_create(const char *shm_name, size_t size) {
     (void)shm_name; // unused
@@ -79,7 +99,34 @@ int utils_shm_unlink(const char *shm_name) {
     return 0;       // ignored on MacOSX
 }
 
+int utils_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    (void)addr;       // unused
+    (void)expected;   // unused
+    (void)timeout_ms; // unused
+    errno = ENOSYS;
+    return -1; // not supported on MacOSX
+}
+
+int utils_futex_wake(uint32_t *addr, int count) {
+    (void)addr;  // unused
+    (void)count; // unused
+    errno = ENOSYS;
+    return -1; // not supported on MacOSX
+}
+
+unsigned utils_get_num_numa_nodes(void) { return 1; }
+
+int utils_getcpu(unsigned *cpu, unsigned *node) {
+    (void)cpu;  // unused
+    (void)node; // unused
+    return -1;  // not supported on MacOSX
+}
+
 // create an anonymous file descriptor
 int utils_create_anonymous_fd(void) {
     return 0; // ignored on MacOSX
 }
+
+int utils_create_memfd(void) {
+    return -1; // not supported on MacOSX
+}
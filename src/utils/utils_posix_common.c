@@ -12,10 +12,12 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "utils_common.h"
@@ -61,6 +63,11 @@ int utils_gettid(void) {
 #endif
 }
 
+unsigned utils_get_num_cpus(void) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (ncpus > 0) ? (unsigned)ncpus : 1;
+}
+
 int utils_close_fd(int fd) { return close(fd); }
 
 #ifndef __APPLE__
@@ -175,6 +182,19 @@ void *utils_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
     return ptr;
 }
 
+int utils_msync(void *addr, size_t length) {
+    // msync() requires a page-aligned address
+    utils_align_ptr_down_size_up(&addr, &length, utils_get_page_size());
+
+    errno = 0;
+    int ret = msync(addr, length, MS_SYNC);
+    if (ret) {
+        LOG_PERR("msync(%p, %zu) failed", addr, length);
+    }
+
+    return ret;
+}
+
 int utils_munmap(void *addr, size_t length) {
     // this should be unnecessary but pairs of mmap/munmap do not reset
     // asan's user-poisoning flags, leading to invalid error reports
@@ -187,6 +207,33 @@ int utils_purge(void *addr, size_t length, int advice) {
     return madvise(addr, length, utils_translate_purge_advise(advice));
 }
 
+int utils_prefetch(void *addr, size_t length, umf_prefetch_advise_t advice) {
+    switch (advice) {
+    case UMF_PREFETCH_WILLNEED:
+        return madvise(addr, length, MADV_WILLNEED);
+    case UMF_PREFETCH_POPULATE:
+#ifdef MADV_POPULATE_READ
+        if (madvise(addr, length, MADV_POPULATE_READ) == 0) {
+            return 0;
+        }
+        if (errno != EINVAL) {
+            return -1;
+        }
+        // MADV_POPULATE_READ is not supported by the kernel (Linux < 5.14)
+#endif
+        {
+            size_t page_size = utils_get_page_size();
+            for (size_t off = 0; off < length; off += page_size) {
+                (void)*((volatile char *)addr + off);
+            }
+        }
+        return 0;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
 void utils_strerror(int errnum, char *buf, size_t buflen) {
 // 'strerror_r' implementation is XSI-compliant (returns 0 on success)
 #if (_POSIX_C_SOURCE >= 200112L || _XOPEN_SOURCE >= 600) && !_GNU_SOURCE
@@ -266,3 +313,11 @@ int utils_file_open_or_create(const char *path) {
 
     return fd;
 }
+
+int utils_file_lock_exclusive(int fd) { return flock(fd, LOCK_EX | LOCK_NB); }
+
+uint64_t utils_get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
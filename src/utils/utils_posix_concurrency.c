@@ -7,6 +7,7 @@
  *
  */
 
+#include <errno.h>
 #include <pthread.h>
 #include <stdlib.h>
 
@@ -34,6 +35,48 @@ int utils_mutex_unlock(utils_mutex_t *m) {
     return pthread_mutex_unlock((pthread_mutex_t *)m);
 }
 
+int utils_shared_mutex_init(utils_shared_mutex_t *m) {
+    pthread_mutexattr_t attr;
+    int ret = pthread_mutexattr_init(&attr);
+    if (ret) {
+        return ret;
+    }
+
+    ret = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifndef __APPLE__
+    // robust mutexes are not supported on macOS
+    if (ret == 0) {
+        ret = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    }
+#endif
+    if (ret == 0) {
+        ret = pthread_mutex_init(&m->lock, &attr);
+    }
+
+    pthread_mutexattr_destroy(&attr);
+    return ret;
+}
+
+int utils_shared_mutex_lock(utils_shared_mutex_t *m) {
+    int ret = pthread_mutex_lock(&m->lock);
+#ifndef __APPLE__
+    if (ret == EOWNERDEAD) {
+        // the owner died holding the mutex - the caller owns it now
+        // and it can be used again after it is unlocked
+        int err = pthread_mutex_consistent(&m->lock);
+        if (err) {
+            pthread_mutex_unlock(&m->lock);
+            return err;
+        }
+    }
+#endif
+    return ret;
+}
+
+int utils_shared_mutex_unlock(utils_shared_mutex_t *m) {
+    return pthread_mutex_unlock(&m->lock);
+}
+
 void utils_init_once(UTIL_ONCE_FLAG *flag, void (*oneCb)(void)) {
     pthread_once(flag, oneCb);
 }
@@ -10,6 +10,7 @@
 #include <windows.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <processenv.h>
 #include <processthreadsapi.h>
 #include <stdio.h>
@@ -40,6 +41,33 @@ int utils_getpid(void) { return GetCurrentProcessId(); }
 
 int utils_gettid(void) { return GetCurrentThreadId(); }
 
+unsigned utils_get_num_cpus(void) {
+    DWORD ncpus = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    return (ncpus > 0) ? (unsigned)ncpus : 1;
+}
+
+unsigned utils_get_num_numa_nodes(void) {
+    ULONG highest_node = 0;
+    if (!GetNumaHighestNodeNumber(&highest_node)) {
+        return 1;
+    }
+    return (unsigned)highest_node + 1;
+}
+
+int utils_getcpu(unsigned *cpu, unsigned *node) {
+    PROCESSOR_NUMBER proc_number;
+    USHORT node_number = 0;
+
+    GetCurrentProcessorNumberEx(&proc_number);
+    if (!GetNumaProcessorNodeEx(&proc_number, &node_number)) {
+        return -1;
+    }
+
+    *cpu = (unsigned)proc_number.Group * 64 + proc_number.Number;
+    *node = node_number;
+    return 0;
+}
+
 int utils_close_fd(int fd) {
     (void)fd; // unused
     return -1;
@@ -121,10 +149,29 @@ int utils_shm_unlink(const char *shm_name) {
     return 0;       // ignored on Windows
 }
 
+int utils_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    (void)addr;       // unused
+    (void)expected;   // unused
+    (void)timeout_ms; // unused
+    errno = ENOSYS;   // not supported on Windows yet
+    return -1;
+}
+
+int utils_futex_wake(uint32_t *addr, int count) {
+    (void)addr;  // unused
+    (void)count; // unused
+    errno = ENOSYS; // not supported on Windows yet
+    return -1;
+}
+
 int utils_create_anonymous_fd(void) {
     return 0; // ignored on Windows
 }
 
+int utils_create_memfd(void) {
+    return -1; // not supported on Windows
+}
+
 size_t get_max_file_size(void) { return SIZE_MAX; }
 
 int utils_get_file_size(int fd, size_t *size) {
@@ -148,16 +195,24 @@ void *utils_mmap(void *hint_addr, size_t length, int prot, int flag, int fd,
 }
 
 void *utils_mmap_file(void *hint_addr, size_t length, int prot, int flags,
-                      int fd, size_t fd_offset) {
+                      int fd, size_t fd_offset, bool *map_sync) {
     (void)hint_addr; // unused
     (void)length;    // unused
     (void)prot;      // unused
     (void)flags;     // unused
     (void)fd;        // unused
     (void)fd_offset; // unused
+    (void)map_sync;  // unused
     return NULL;     // not supported
 }
 
+int utils_msync(void *addr, size_t length) {
+    (void)addr;   // unused
+    (void)length; // unused
+    errno = ENOSYS;
+    return -1; // not supported on Windows
+}
+
 int utils_munmap(void *addr, size_t length) {
     // If VirtualFree() succeeds, the return value is nonzero.
     // If VirtualFree() fails, the return value is 0 (zero).
@@ -209,6 +264,33 @@ int utils_file_open_or_create(const char *path) {
     return -1;
 }
 
+int utils_file_lock_exclusive(int fd) {
+    (void)fd; // unused
+
+    errno = ENOTSUP; // not supported on Windows
+    return -1;
+}
+
+uint64_t utils_get_time_ms(void) { return GetTickCount64(); }
+
+int utils_prefetch(void *addr, size_t length, umf_prefetch_advise_t advice) {
+    (void)addr;   // unused
+    (void)length; // unused
+    (void)advice; // unused
+
+    errno = ENOTSUP; // not supported on Windows
+    return -1;
+}
+
+void *utils_mremap(void *old_addr, size_t old_length, size_t new_length) {
+    (void)old_addr;   // unused
+    (void)old_length; // unused
+    (void)new_length; // unused
+
+    errno = ENOTSUP; // not supported on Windows
+    return NULL;
+}
+
 int utils_fallocate(int fd, long offset, long len) {
     (void)fd;     // unused
     (void)offset; // unused
@@ -216,3 +298,12 @@ int utils_fallocate(int fd, long offset, long len) {
 
     return -1;
 }
+
+int utils_punch_hole(int fd, size_t offset, size_t len) {
+    (void)fd;     // unused
+    (void)offset; // unused
+    (void)len;    // unused
+
+    errno = ENOTSUP; // not supported on Windows
+    return -1;
+}
@@ -40,6 +40,31 @@ int utils_mutex_unlock(utils_mutex_t *mutex) {
     return 0;
 }
 
+// SRWLOCK and CRITICAL_SECTION cannot be shared between processes
+#define SHARED_MUTEX_SPIN_COUNT 64
+
+int utils_shared_mutex_init(utils_shared_mutex_t *mutex) {
+    InterlockedExchange64(&mutex->lock, 0);
+    return 0;
+}
+
+int utils_shared_mutex_lock(utils_shared_mutex_t *mutex) {
+    for (unsigned spin = 0;
+         InterlockedCompareExchange64(&mutex->lock, 1, 0) != 0; spin++) {
+        if (spin < SHARED_MUTEX_SPIN_COUNT) {
+            YieldProcessor();
+        } else {
+            SwitchToThread();
+        }
+    }
+    return 0;
+}
+
+int utils_shared_mutex_unlock(utils_shared_mutex_t *mutex) {
+    InterlockedExchange64(&mutex->lock, 0);
+    return 0;
+}
+
 static BOOL CALLBACK initOnceCb(PINIT_ONCE InitOnce, PVOID Parameter,
                                 PVOID *lpContext) {
     (void)InitOnce;  // unused
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <numeric>
 #include <tuple>
+#include <unordered_map>
 
 class MemoryAccessor {
   public:
@@ -223,8 +224,7 @@ TEST_P(umfIpcTest, BasicFlow) {
     pool.reset(nullptr);
     EXPECT_EQ(stat.getCount, 1);
     EXPECT_EQ(stat.putCount, stat.getCount);
-    // TODO: enale check below once cache for open IPC handles is implemented
-    // EXPECT_EQ(stat.openCount, 1);
+    EXPECT_EQ(stat.openCount, 1);
     EXPECT_EQ(stat.closeCount, stat.openCount);
 }
 
@@ -392,6 +392,399 @@ TEST_P(umfIpcTest, openInTwoPools) {
     EXPECT_EQ(stat.closeCount, stat.openCount);
 }
 
+TEST_P(umfIpcTest, BatchedHandles) {
+    constexpr size_t SIZE = 100;
+    constexpr size_t NUM_ALLOCS = 50;
+    umf::pool_unique_handle_t pool = makePool();
+
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        void *ptr = umfPoolMalloc(pool.get(), SIZE * sizeof(int));
+        ASSERT_NE(ptr, nullptr);
+        ptrs.push_back(ptr);
+
+        std::vector<int> data(SIZE, (int)i);
+        memAccessor->copy(ptr, data.data(), SIZE * sizeof(int));
+    }
+
+    // pointers inside of the allocations share their IPC handles
+    std::vector<const void *> exported;
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        exported.push_back(ptrs[i]);
+        exported.push_back((int *)ptrs[i] + SIZE / 2);
+    }
+
+    void *batch = nullptr;
+    size_t batchSize = 0;
+    umf_result_t ret =
+        umfGetIPCHandles(exported.data(), exported.size(), &batch, &batchSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_NE(batch, nullptr);
+    EXPECT_LE(stat.getCount, NUM_ALLOCS);
+
+    size_t handleSize = 0;
+    ret = umfPoolGetIPCHandleSize(pool.get(), &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_LT(batchSize, exported.size() * handleSize);
+
+    // the batch is sent as a single buffer
+    std::vector<uint64_t> received(batchSize / sizeof(uint64_t) + 1);
+    memcpy(received.data(), batch, batchSize);
+
+    ret = umfPutIPCHandles(batch);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::vector<void *> opened(exported.size());
+    ret = umfOpenIPCHandles(pool.get(), received.data(), batchSize,
+                            opened.data(), opened.size() - 1);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the batch starts with: signature, size, n_regions, region_size, n_ptrs;
+    // a region_size that wraps n_regions * region_size has to be rejected
+    std::vector<uint64_t> forged(received);
+    forged[2] = 2;
+    forged[3] = (1ULL << 63) + (batchSize - 5 * sizeof(uint64_t) -
+                                exported.size() * 2 * sizeof(uint64_t)) /
+                                   2;
+    ret = umfOpenIPCHandles(pool.get(), forged.data(), batchSize,
+                            opened.data(), opened.size());
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfOpenIPCHandles(pool.get(), received.data(), batchSize,
+                            opened.data(), opened.size());
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        std::vector<int> data(SIZE);
+        memAccessor->copy(data.data(), opened[2 * i], SIZE * sizeof(int));
+        EXPECT_EQ(data[0], (int)i);
+        EXPECT_EQ(data[SIZE - 1], (int)i);
+
+        memAccessor->copy(data.data(), opened[2 * i + 1],
+                          SIZE / 2 * sizeof(int));
+        EXPECT_EQ(data[0], (int)i);
+        EXPECT_EQ((int *)opened[2 * i] + SIZE / 2, opened[2 * i + 1]);
+    }
+
+    ret = umfCloseIPCHandles(opened.data(), opened.size());
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    for (void *ptr : ptrs) {
+        ret = umfPoolFree(pool.get(), ptr);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+    EXPECT_EQ(stat.openCount, stat.getCount);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
+TEST_P(umfIpcTest, RegionRefs) {
+    constexpr size_t SIZE = 16;
+    constexpr size_t NUM_ALLOCS = 100;
+    umf::pool_unique_handle_t pool = makePool();
+
+    std::vector<void *> ptrs;
+    std::vector<umf_ipc_region_ref_t> refs(NUM_ALLOCS);
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        void *ptr = umfPoolMalloc(pool.get(), SIZE * sizeof(int));
+        ASSERT_NE(ptr, nullptr);
+        ptrs.push_back(ptr);
+
+        std::vector<int> data(SIZE, (int)i);
+        memAccessor->copy(ptr, data.data(), SIZE * sizeof(int));
+
+        umf_result_t ret =
+            umfGetIPCRegionRef(ptr, SIZE * sizeof(int), &refs[i]);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(refs[i].size, SIZE * sizeof(int));
+    }
+
+    // each region is exported and opened only once
+    std::unordered_map<uint64_t, umf_ipc_region_handle_t> regions;
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        if (regions.count(refs[i].region_id)) {
+            continue;
+        }
+
+        umf_ipc_handle_t ipcHandle = nullptr;
+        size_t handleSize = 0;
+        umf_result_t ret = umfGetIPCHandle(ptrs[i], &ipcHandle, &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        umf_ipc_region_handle_t region = nullptr;
+        ret = umfOpenIPCRegion(pool.get(), ipcHandle, &region);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        uint64_t regionId = 0;
+        ret = umfIPCRegionGetId(region, &regionId);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(regionId, refs[i].region_id);
+        regions[regionId] = region;
+
+        ret = umfPutIPCHandle(ipcHandle);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+    EXPECT_EQ(stat.openCount, regions.size());
+
+    for (size_t i = 0; i < NUM_ALLOCS; ++i) {
+        void *ptr = nullptr;
+        umf_result_t ret =
+            umfIPCRegionGetPtr(regions[refs[i].region_id], &refs[i], &ptr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        std::vector<int> data(SIZE);
+        memAccessor->copy(data.data(), ptr, SIZE * sizeof(int));
+        EXPECT_EQ(data[0], (int)i);
+        EXPECT_EQ(data[SIZE - 1], (int)i);
+    }
+
+    // references are resolved only against their own region
+    umf_ipc_region_handle_t region = regions.begin()->second;
+    umf_ipc_region_ref_t badRef = refs[0];
+    badRef.region_id = regions.begin()->first + 1;
+    void *ptr = nullptr;
+    umf_result_t ret = umfIPCRegionGetPtr(region, &badRef, &ptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    badRef.region_id = regions.begin()->first;
+    badRef.offset = UINT64_MAX;
+    ret = umfIPCRegionGetPtr(region, &badRef, &ptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfGetIPCRegionRef(ptrs[0], SIZE_MAX, &badRef);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    for (auto &r : regions) {
+        ret = umfCloseIPCRegion(r.second);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    for (void *p : ptrs) {
+        ret = umfPoolFree(pool.get(), p);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+    EXPECT_EQ(stat.closeCount, stat.openCount);
+}
+
+TEST_P(umfIpcTest, OpenedCacheSize) {
+    constexpr size_t SIZE = 100;
+    umf::pool_unique_handle_t pool = makePool();
+    void *ptr = umfPoolMalloc(pool.get(), SIZE);
+    EXPECT_NE(ptr, nullptr);
+
+    umf_ipc_handle_t ipcHandle = nullptr;
+    size_t handleSize = 0;
+    umf_result_t ret = umfGetIPCHandle(ptr, &ipcHandle, &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the mapping is closed on the last close
+    ret = umfPoolSetOpenedIPCCacheSize(pool.get(), 0);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    for (int i = 0; i < 2; i++) {
+        void *openedPtr1 = nullptr;
+        ret = umfOpenIPCHandle(pool.get(), ipcHandle, &openedPtr1);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        void *openedPtr2 = nullptr;
+        ret = umfOpenIPCHandle(pool.get(), ipcHandle, &openedPtr2);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(openedPtr1, openedPtr2);
+
+        ret = umfCloseIPCHandle(openedPtr1);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(stat.closeCount, (size_t)i);
+
+        ret = umfCloseIPCHandle(openedPtr2);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(stat.closeCount, (size_t)i + 1);
+    }
+    EXPECT_EQ(stat.openCount, 2);
+
+    // the mapping is kept open after the last close
+    ret = umfPoolSetOpenedIPCCacheSize(pool.get(), 1);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    for (int i = 0; i < 2; i++) {
+        void *openedPtr = nullptr;
+        ret = umfOpenIPCHandle(pool.get(), ipcHandle, &openedPtr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfCloseIPCHandle(openedPtr);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+    EXPECT_EQ(stat.openCount, 3);
+    EXPECT_EQ(stat.closeCount, 2);
+
+    // shrinking the cache closes the unused mapping
+    ret = umfPoolSetOpenedIPCCacheSize(pool.get(), 0);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stat.closeCount, 3);
+
+    ret = umfPutIPCHandle(ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPoolFree(pool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPoolSetOpenedIPCCacheSize(nullptr, 0);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.openCount, stat.closeCount);
+}
+
+TEST_P(umfIpcTest, OpenedNotClosed) {
+    constexpr size_t SIZE = 100;
+    umf::pool_unique_handle_t pool = makePool();
+    void *ptr = umfPoolMalloc(pool.get(), SIZE);
+    EXPECT_NE(ptr, nullptr);
+
+    umf_ipc_handle_t ipcHandle = nullptr;
+    size_t handleSize = 0;
+    umf_result_t ret = umfGetIPCHandle(ptr, &ipcHandle, &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *openedPtr = nullptr;
+    ret = umfOpenIPCHandle(pool.get(), ipcHandle, &openedPtr);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stat.openCount, 1);
+
+    // the handle is not closed, so it is closed when the pool is destroyed
+
+    ret = umfPutIPCHandle(ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPoolFree(pool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.openCount, stat.closeCount);
+}
+
+TEST_P(umfIpcTest, GetIPCHandleToBuffer) {
+    constexpr size_t SIZE = 100;
+    umf::pool_unique_handle_t pool = makePool();
+    int *ptr = (int *)umfPoolMalloc(pool.get(), SIZE * sizeof(int));
+    EXPECT_NE(ptr, nullptr);
+
+    std::vector<int> expected_data(SIZE);
+    std::iota(expected_data.begin(), expected_data.end(), 0);
+    memAccessor->copy(ptr, expected_data.data(), SIZE * sizeof(int));
+
+    size_t handleSize = 0;
+    umf_result_t ret = umfPoolGetIPCHandleSize(pool.get(), &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the required size is returned if the buffer is too small
+    std::vector<uint64_t> buffer(handleSize / sizeof(uint64_t) + 1);
+    size_t size = 0;
+    ret = umfGetIPCHandleToBuffer(ptr, buffer.data(), handleSize - 1, &size);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(size, handleSize);
+
+    ret = umfGetIPCHandleToBuffer(ptr + SIZE / 2, buffer.data(),
+                                  buffer.size() * sizeof(uint64_t), &size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(size, handleSize);
+
+    // the same handle as the one returned by umfGetIPCHandle()
+    umf_ipc_handle_t ipcHandle = nullptr;
+    ret = umfGetIPCHandle(ptr + SIZE / 2, &ipcHandle, &size);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(std::memcmp(ipcHandle, buffer.data(), size), 0);
+
+    void *halfArray = nullptr;
+    ret = umfOpenIPCHandle(pool.get(), (umf_ipc_handle_t)buffer.data(),
+                           &halfArray);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    std::vector<int> actual_data(SIZE / 2);
+    memAccessor->copy(actual_data.data(), halfArray, SIZE / 2 * sizeof(int));
+    ASSERT_TRUE(std::equal(expected_data.begin() + SIZE / 2,
+                           expected_data.end(), actual_data.begin()));
+
+    ret = umfCloseIPCHandle(halfArray);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPutIPCHandle(ipcHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfGetIPCHandleToBuffer(nullptr, buffer.data(), handleSize, &size);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ret = umfGetIPCHandleToBuffer(ptr, nullptr, handleSize, &size);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ret = umfGetIPCHandleToBuffer(ptr, buffer.data(), handleSize, nullptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfPoolFree(pool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    pool.reset(nullptr);
+    EXPECT_EQ(stat.getCount, 1);
+    EXPECT_EQ(stat.putCount, stat.getCount);
+}
+
+TEST_P(umfIpcTest, IPCCacheStats) {
+    constexpr size_t SIZE = 100;
+    umf::pool_unique_handle_t pool = makePool();
+    void *ptr = umfPoolMalloc(pool.get(), SIZE);
+    EXPECT_NE(ptr, nullptr);
+
+    umf_ipc_cache_stats_t stats;
+    umf_result_t ret = umfPoolGetIPCCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stats.get_hits, 0);
+    EXPECT_EQ(stats.get_misses, 0);
+    EXPECT_EQ(stats.open_hits, 0);
+    EXPECT_EQ(stats.open_misses, 0);
+
+    umf_ipc_handle_t ipcHandles[2];
+    size_t handleSize = 0;
+    for (auto &ipcHandle : ipcHandles) {
+        ret = umfGetIPCHandle(ptr, &ipcHandle, &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    void *openedPtrs[2];
+    for (auto &openedPtr : openedPtrs) {
+        ret = umfOpenIPCHandle(pool.get(), ipcHandles[0], &openedPtr);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ret = umfPoolGetIPCCacheStats(pool.get(), &stats);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    EXPECT_EQ(stats.get_hits, 1);
+    EXPECT_EQ(stats.get_misses, 1);
+    EXPECT_EQ(stats.open_hits, 1);
+    EXPECT_EQ(stats.open_misses, 1);
+    EXPECT_EQ(stat.getCount, 1);
+    EXPECT_EQ(stat.openCount, 1);
+
+    for (auto openedPtr : openedPtrs) {
+        ret = umfCloseIPCHandle(openedPtr);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    for (auto ipcHandle : ipcHandles) {
+        ret = umfPutIPCHandle(ipcHandle);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ret = umfPoolFree(pool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPoolGetIPCCacheStats(nullptr, &stats);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ret = umfPoolGetIPCCacheStats(pool.get(), nullptr);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
 TEST_P(umfIpcTest, ConcurrentGetPutHandles) {
     std::vector<void *> ptrs;
     constexpr size_t ALLOC_SIZE = 100;
@@ -501,8 +894,7 @@ TEST_P(umfIpcTest, ConcurrentOpenCloseHandles) {
     pool.reset(nullptr);
     EXPECT_EQ(stat.getCount, stat.allocCount);
     EXPECT_EQ(stat.putCount, stat.getCount);
-    // TODO: enale check below once cache for open IPC handles is implemented
-    // EXPECT_EQ(stat.openCount, stat.allocCount);
+    EXPECT_EQ(stat.openCount, stat.allocCount);
     EXPECT_EQ(stat.openCount, stat.closeCount);
 }
 
@@ -0,0 +1,224 @@
+// Copyright (C) 2024 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "base.hpp"
+#include "pool.hpp"
+
+#include <umf/ipc.h>
+#include <umf/ipc_channel.h>
+#include <umf/pools/pool_shared.h>
+#include <umf/providers/provider_os_memory.h>
+
+#include <thread>
+#include <vector>
+
+#define SHM_NAME "umf_test_ipc_channel"
+
+using umf_test::test;
+
+struct message_t {
+    size_t producer;
+    size_t seq;
+};
+
+struct umfIpcChannelTest : test {
+    void SetUp() override {
+        test::SetUp();
+
+        char shm_name[] = SHM_NAME;
+        producerPool = createPool(shm_name, nullptr);
+        ASSERT_NE(producerPool.get(), nullptr);
+
+        size_t handleSize = 0;
+        umf_result_t ret = umfSharedPoolGetIPCHandle(
+            producerPool.get(), &heapHandle, &handleSize);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        // the consumer opens the same heap (like another process would do)
+        consumerPool = createPool(nullptr, heapHandle);
+        ASSERT_NE(consumerPool.get(), nullptr);
+    }
+
+    void TearDown() override {
+        if (heapHandle) {
+            umfPutIPCHandle(heapHandle);
+        }
+        consumerPool.reset(nullptr);
+        producerPool.reset(nullptr);
+        test::TearDown();
+    }
+
+    umf::pool_unique_handle_t createPool(char *shm_name,
+                                         umf_ipc_handle_t heapIpcHandle) {
+        auto osParams = umfOsMemoryProviderParamsDefault();
+        osParams.visibility = UMF_MEM_MAP_SHARED;
+        osParams.shm_name = shm_name;
+
+        umf_memory_provider_handle_t provider = nullptr;
+        umf_result_t ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                                   &osParams, &provider);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        auto params = umfSharedPoolParamsDefault();
+        params.heap_size = 64 * 1024 * 1024;
+        params.heap_ipc_handle = heapIpcHandle;
+
+        umf_memory_pool_handle_t hPool = nullptr;
+        ret = umfPoolCreate(umfSharedPoolOps(), provider, &params,
+                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hPool);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        return umf::pool_unique_handle_t(hPool, &umfPoolDestroy);
+    }
+
+    // create the channel on the producer side and open it on the consumer side
+    void openChannel(umf_ipc_channel_mode_t mode, size_t capacity) {
+        umf_result_t ret = umfIPCChannelCreate(producerPool.get(), mode,
+                                               capacity, &producer);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        uint64_t channelId = 0;
+        ret = umfIPCChannelGetId(producer, &channelId);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        ret = umfIPCChannelOpen(consumerPool.get(), channelId, &consumer);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    void closeChannel() {
+        EXPECT_EQ(umfIPCChannelClose(consumer), UMF_RESULT_SUCCESS);
+        EXPECT_EQ(umfIPCChannelClose(producer), UMF_RESULT_SUCCESS);
+    }
+
+    void sendMessage(size_t producerId, size_t seq) {
+        auto *msg = (message_t *)umfPoolMalloc(producerPool.get(),
+                                               sizeof(message_t));
+        ASSERT_NE(msg, nullptr);
+        msg->producer = producerId;
+        msg->seq = seq;
+
+        umf_result_t ret =
+            umfIPCChannelSend(producer, msg, sizeof(message_t), -1);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    umf::pool_unique_handle_t producerPool;
+    umf::pool_unique_handle_t consumerPool;
+    umf_ipc_handle_t heapHandle = nullptr;
+    umf_ipc_channel_handle_t producer = nullptr;
+    umf_ipc_channel_handle_t consumer = nullptr;
+};
+
+TEST_F(umfIpcChannelTest, sendReceive) {
+    openChannel(UMF_IPC_CHANNEL_SPSC, 16);
+
+    constexpr size_t NUM_MESSAGES = 10;
+    for (size_t i = 0; i < NUM_MESSAGES; i++) {
+        sendMessage(0, i);
+    }
+
+    for (size_t i = 0; i < NUM_MESSAGES; i++) {
+        message_t *msg = nullptr;
+        size_t size = 0;
+        umf_result_t ret =
+            umfIPCChannelReceive(consumer, (void **)&msg, &size, 0);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(size, sizeof(message_t));
+        EXPECT_EQ(msg->seq, i);
+
+        // the message is received without copying (in the mapping
+        // of the consumer) and it is freed by the consumer
+        EXPECT_EQ(umfPoolByPtr(msg), consumerPool.get());
+        EXPECT_EQ(umfFree(msg), UMF_RESULT_SUCCESS);
+    }
+
+    closeChannel();
+}
+
+TEST_F(umfIpcChannelTest, fullAndEmpty) {
+    openChannel(UMF_IPC_CHANNEL_SPSC, 3);
+
+    void *ptr = nullptr;
+    size_t size = 0;
+    umf_result_t ret = umfIPCChannelReceive(consumer, &ptr, &size, 0);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_TIMEOUT);
+    ret = umfIPCChannelReceive(consumer, &ptr, &size, 10);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_TIMEOUT);
+
+    // the capacity is rounded up to 4
+    void *msg = umfPoolMalloc(producerPool.get(), 64);
+    ASSERT_NE(msg, nullptr);
+    for (int i = 0; i < 4; i++) {
+        ret = umfIPCChannelSend(producer, msg, 64, 0);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ret = umfIPCChannelSend(producer, msg, 64, 0);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_TIMEOUT);
+    ret = umfIPCChannelSend(producer, msg, 64, 10);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_TIMEOUT);
+
+    // only the memory of the heap can be sent
+    int local = 0;
+    ret = umfIPCChannelSend(producer, &local, sizeof(local), 0);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    for (int i = 0; i < 4; i++) {
+        ret = umfIPCChannelReceive(consumer, &ptr, &size, 0);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+        EXPECT_EQ(size, 64);
+    }
+
+    umfPoolFree(producerPool.get(), msg);
+    closeChannel();
+}
+
+TEST_F(umfIpcChannelTest, wrongChannelId) {
+    umf_ipc_channel_handle_t channel = nullptr;
+    umf_result_t ret = umfIPCChannelOpen(consumerPool.get(), 0, &channel);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfIPCChannelOpen(consumerPool.get(), UINT64_MAX, &channel);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfIPCChannelCreate(producerPool.get(), UMF_IPC_CHANNEL_SPSC, 0,
+                              &channel);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(umfIpcChannelTest, multipleProducers) {
+    constexpr size_t NUM_PRODUCERS = 4;
+    constexpr size_t NUM_MESSAGES = 10000;
+
+    // a small ring, so both sides have to wait for each other
+    openChannel(UMF_IPC_CHANNEL_MPSC, 8);
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < NUM_PRODUCERS; p++) {
+        producers.emplace_back([&, p] {
+            for (size_t i = 0; i < NUM_MESSAGES; i++) {
+                sendMessage(p, i);
+            }
+        });
+    }
+
+    // messages of every producer are received in order
+    std::vector<size_t> nextSeq(NUM_PRODUCERS, 0);
+    for (size_t i = 0; i < NUM_PRODUCERS * NUM_MESSAGES; i++) {
+        message_t *msg = nullptr;
+        size_t size = 0;
+        umf_result_t ret =
+            umfIPCChannelReceive(consumer, (void **)&msg, &size, -1);
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        ASSERT_LT(msg->producer, NUM_PRODUCERS);
+        EXPECT_EQ(msg->seq, nextSeq[msg->producer]++);
+        umfPoolFree(consumerPool.get(), msg);
+    }
+
+    for (auto &t : producers) {
+        t.join();
+    }
+
+    closeChannel();
+}
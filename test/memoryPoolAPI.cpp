@@ -12,6 +12,7 @@
 #include "test_helpers.h"
 
 #include <umf/memory_provider.h>
+#include <umf/memspace.h>
 #include <umf/pools/pool_proxy.h>
 
 #ifdef UMF_PROXY_LIB_ENABLED
@@ -93,15 +94,23 @@ TEST_P(umfPoolWithCreateFlagsTest, memoryPoolTrace) {
     ASSERT_EQ(poolCalls["calloc"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
 
+    // the null provider does not report its memory as zeroed,
+    // so the proxy pool gives it back
+    ASSERT_EQ(providerCalls["alloc"], 2);
+    ASSERT_EQ(providerCalls["free"], 2);
+
+    // realloc with a NULL pointer behaves like malloc
     umfPoolRealloc(tracingPool.get(), nullptr, 0);
     ASSERT_EQ(poolCalls["realloc"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
 
+    ASSERT_EQ(providerCalls["alloc"], 3);
+
     umfPoolAlignedMalloc(tracingPool.get(), 0, 0);
     ASSERT_EQ(poolCalls["aligned_malloc"], 1);
     ASSERT_EQ(poolCalls.size(), ++pool_call_count);
 
-    ASSERT_EQ(providerCalls["alloc"], 2);
+    ASSERT_EQ(providerCalls["alloc"], 4);
     ASSERT_EQ(providerCalls.size(), provider_call_count);
 
     auto ret = umfPoolGetLastAllocationError(tracingPool.get());
@@ -212,6 +221,23 @@ TEST_P(umfPoolWithCreateFlagsTest, umfPoolCreateFlagsNullOps) {
     umfMemoryProviderDestroy(provider);
 }
 
+TEST_P(umfPoolWithCreateFlagsTest, umfPoolCreateFlagsWrongOpsVersion) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(&UMF_NULL_PROVIDER_OPS, nullptr, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_NE(provider, nullptr);
+
+    // ops built against headers of another version have another layout
+    umf_memory_pool_ops_t pool_ops = *umfProxyPoolOps();
+    pool_ops.version = UMF_MAKE_VERSION(0, 10);
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(&pool_ops, provider, nullptr, flags, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
+
 TEST_P(umfPoolWithCreateFlagsTest, umfPoolCreateFlagsNullPoolHandle) {
     umf_memory_provider_handle_t provider = nullptr;
     umf_result_t ret =
@@ -271,6 +297,117 @@ TEST_F(test, retrieveMemoryProvidersError) {
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+TEST_F(test, poolReset_NOT_SUPPORTED) {
+    auto nullProvider = umf_test::wrapProviderUnique(nullProviderCreate());
+    auto pool = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), nullProvider.get(), nullptr));
+
+    // the proxy pool does not implement the optional reset op
+    auto ret = umfPoolReset(pool.get());
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    ret = umfPoolReset(nullptr);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(test, poolMigrate_NOT_SUPPORTED) {
+    // the malloc provider does not implement the optional ext.migrate op
+    struct provider_no_migrate : public provider_malloc {
+        umf_result_t get_min_page_size(void *, size_t *pageSize) noexcept {
+            *pageSize = 4096;
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider_no_migrate, void>();
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+    auto pool = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+
+    umf_const_memspace_handle_t hMemspace = umfMemspaceHostAllGet();
+    if (hMemspace == nullptr) {
+        GTEST_SKIP() << "Test skipped, the host memspace is not available";
+    }
+    umf_const_memtarget_handle_t hTarget =
+        umfMemspaceMemtargetGet(hMemspace, 0);
+    ASSERT_NE(hTarget, nullptr);
+
+    // a whole page, so the range is not widened past the allocation
+    static constexpr size_t size = 4096;
+    void *ptr = umfPoolAlignedMalloc(pool.get(), size, size);
+    ASSERT_NE(ptr, nullptr);
+
+    auto ret = umfPoolMigrate(pool.get(), ptr, size, hTarget);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    ret = umfPoolMigrate(pool.get(), ptr, size, nullptr);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ret = umfPoolMigrate(nullptr, ptr, size, hTarget);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, poolMigrateNotPageMultiple) {
+    struct provider_migrate : public provider_malloc {
+        umf_result_t get_min_page_size(void *, size_t *pageSize) noexcept {
+            *pageSize = 4096;
+            return UMF_RESULT_SUCCESS;
+        }
+    };
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider_migrate, void>();
+
+    // records the range passed to the provider
+    static void *migratedPtr;
+    static size_t migratedSize;
+    provider_ops.ext.migrate = [](void *, void *ptr, size_t size,
+                                  umf_const_memtarget_handle_t) {
+        migratedPtr = ptr;
+        migratedSize = size;
+        return UMF_RESULT_SUCCESS;
+    };
+
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+    auto pool = wrapPoolUnique(
+        createPoolChecked(umfProxyPoolOps(), provider.get(), nullptr));
+
+    umf_const_memspace_handle_t hMemspace = umfMemspaceHostAllGet();
+    if (hMemspace == nullptr) {
+        GTEST_SKIP() << "Test skipped, the host memspace is not available";
+    }
+    umf_const_memtarget_handle_t hTarget =
+        umfMemspaceMemtargetGet(hMemspace, 0);
+    ASSERT_NE(hTarget, nullptr);
+
+    // the page bounds of the range are clamped to the allocation
+    static constexpr size_t size = 100;
+    auto *ptr = (char *)umfPoolAlignedMalloc(pool.get(), size, 4096);
+    ASSERT_NE(ptr, nullptr);
+
+    ASSERT_EQ(umfPoolMigrate(pool.get(), ptr, size, hTarget),
+              UMF_RESULT_SUCCESS);
+    ASSERT_EQ(migratedPtr, ptr);
+    ASSERT_EQ(migratedSize, size);
+
+    migratedPtr = nullptr;
+    migratedSize = 0;
+    ASSERT_EQ(umfPoolMigrate(pool.get(), ptr + 10, size / 2, hTarget),
+              UMF_RESULT_SUCCESS);
+    ASSERT_EQ(migratedPtr, ptr);
+    ASSERT_EQ(migratedSize, size);
+
+    // the range cannot exceed the allocation
+    ASSERT_EQ(umfPoolMigrate(pool.get(), ptr, size + 1, hTarget),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
 // TODO: extend test for different functions (not only alloc)
 TEST_F(test, getLastFailedMemoryProvider) {
     static constexpr size_t allocSize = 8;
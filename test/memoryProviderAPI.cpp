@@ -187,6 +187,15 @@ TEST_F(test, memoryProviderCreateNullOps) {
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+TEST_F(test, memoryProviderOpsWrongVersion) {
+    // ops built against headers of another version have another layout
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.version = UMF_MAKE_VERSION(0, 10);
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
 TEST_F(test, memoryProviderNullPoolHandle) {
     auto ret =
         umfMemoryProviderCreate(&UMF_NULL_PROVIDER_OPS, nullptr, nullptr);
@@ -201,6 +210,26 @@ TEST_F(test, memoryProviderOpsNullAllocField) {
     ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
+TEST_F(test, memoryProviderOpsNullAllocZeroInfoField) {
+    umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
+    provider_ops.ext.alloc_zero_info = nullptr;
+    umf_memory_provider_handle_t hProvider;
+    auto ret = umfMemoryProviderCreate(&provider_ops, nullptr, &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // falls back to alloc() and reports the memory as not zeroed
+    void *ptr = nullptr;
+    bool zeroed = true;
+    ret = umfMemoryProviderAllocZeroInfo(hProvider, 0, 0, &ptr, &zeroed);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_FALSE(zeroed);
+
+    ret = umfMemoryProviderAllocZeroInfo(hProvider, 0, 0, &ptr, nullptr);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
 TEST_F(test, memoryProviderOpsNullGetLastNativeErrorField) {
     umf_memory_provider_ops_t provider_ops = UMF_NULL_PROVIDER_OPS;
     provider_ops.get_last_native_error = nullptr;
@@ -70,7 +70,10 @@ struct umfPoolTest : umf_test::test,
 
         auto [pool_ops, pool_params, provider_ops, provider_params,
               coarse_params] = this->GetParam();
-        if (provider_ops == umfDevDaxMemoryProviderOps()) {
+        if (provider_ops == umfDevDaxMemoryProviderOps() &&
+            !static_cast<umf_devdax_memory_provider_params_t *>(
+                 provider_params)
+                 ->emulation) {
             char *path = getenv("UMF_TESTS_DEVDAX_PATH");
             if (path == nullptr || path[0] == 0) {
                 GTEST_SKIP()
@@ -0,0 +1,240 @@
+// Copyright (C) 2024 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "umf/pools/pool_arena.h"
+#include "umf/providers/provider_coarse.h"
+#include "umf/providers/provider_file_memory.h"
+#include "umf/providers/provider_os_memory.h"
+
+#include "pool.hpp"
+#include "poolFixtures.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using umf_test::test;
+using namespace umf_test;
+
+#define FILE_PATH ((char *)"tmp_arena_file_provider")
+
+static constexpr size_t chunkSize = 64 * 1024;
+
+static umf_arena_pool_params_t makeArenaParams(size_t chunk_size,
+                                               bool purge_on_reset) {
+    umf_arena_pool_params_t params = umfArenaPoolParamsDefault();
+    params.chunk_size = chunk_size;
+    params.purge_on_reset = purge_on_reset;
+    return params;
+}
+
+auto osParams = umfOsMemoryProviderParamsDefault();
+auto fileParams = umfFileMemoryProviderParamsDefault(FILE_PATH);
+auto coarseParams = umfCoarseMemoryProviderParamsDefault();
+auto arenaParams = umfArenaPoolParamsDefault();
+auto smallChunkParams = makeArenaParams(chunkSize, true);
+
+INSTANTIATE_TEST_SUITE_P(
+    arenaPoolTest, umfPoolTest,
+    ::testing::Values(
+        poolCreateExtParams{umfArenaPoolOps(), nullptr,
+                            umfOsMemoryProviderOps(), &osParams, nullptr},
+        poolCreateExtParams{umfArenaPoolOps(), &smallChunkParams,
+                            umfOsMemoryProviderOps(), &osParams, nullptr},
+        poolCreateExtParams{umfArenaPoolOps(), &arenaParams,
+                            umfFileMemoryProviderOps(), &fileParams, nullptr},
+        poolCreateExtParams{umfArenaPoolOps(), &smallChunkParams,
+                            umfOsMemoryProviderOps(), &osParams,
+                            &coarseParams}));
+
+INSTANTIATE_TEST_SUITE_P(arenaMultiPoolTest, umfMultiPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfArenaPoolOps(), &smallChunkParams,
+                             umfOsMemoryProviderOps(), &osParams, nullptr}));
+
+struct umfArenaPoolTest : umf_test::test {
+    void SetUp() override {
+        test::SetUp();
+
+        auto params = makeArenaParams(chunkSize, false);
+        pool = poolCreateExtUnique({umfArenaPoolOps(), &params,
+                                    umfOsMemoryProviderOps(), &osParams,
+                                    nullptr});
+        ASSERT_NE(pool.get(), nullptr);
+    }
+
+    void TearDown() override { test::TearDown(); }
+
+    umf::pool_unique_handle_t pool;
+};
+
+TEST_F(umfArenaPoolTest, resetReusesChunks) {
+    static constexpr size_t allocSize = 1000;
+    static constexpr size_t numAllocs = 10 * chunkSize / allocSize;
+
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < numAllocs; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), allocSize);
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, 0xAB, allocSize);
+        allocs.push_back(ptr);
+    }
+
+    // free() does not give the memory back (except the last allocation)
+    ASSERT_EQ(umfPoolFree(pool.get(), allocs[0]), UMF_RESULT_SUCCESS);
+    void *ptr = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_NE(ptr, allocs[0]);
+
+    ASSERT_EQ(umfPoolReset(pool.get()), UMF_RESULT_SUCCESS);
+
+    // the chunks are rewound and reused, the memory stays tracked
+    for (size_t i = 0; i < numAllocs; i++) {
+        ptr = umfPoolMalloc(pool.get(), allocSize);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(umfPoolByPtr(ptr), pool.get());
+        ASSERT_NE(std::find(allocs.begin(), allocs.end(), ptr), allocs.end());
+    }
+}
+
+TEST_F(umfArenaPoolTest, freeLastAllocation) {
+    void *ptr1 = umfPoolMalloc(pool.get(), 100);
+    ASSERT_NE(ptr1, nullptr);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr1), UMF_RESULT_SUCCESS);
+
+    void *ptr2 = umfPoolMalloc(pool.get(), 200);
+    ASSERT_EQ(ptr2, ptr1);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr2), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(umfArenaPoolTest, realloc) {
+    static constexpr size_t allocSize = 64;
+
+    // the last allocation grows in place
+    auto *ptr = (unsigned char *)umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, allocSize);
+    auto *new_ptr =
+        (unsigned char *)umfPoolRealloc(pool.get(), ptr, 2 * allocSize);
+    ASSERT_EQ(new_ptr, ptr);
+
+    // other allocations are moved
+    void *other = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(other, nullptr);
+    new_ptr = (unsigned char *)umfPoolRealloc(pool.get(), ptr, 4 * allocSize);
+    ASSERT_NE(new_ptr, nullptr);
+    ASSERT_NE(new_ptr, ptr);
+    for (size_t i = 0; i < allocSize; i++) {
+        ASSERT_EQ(new_ptr[i], 0xAB);
+    }
+}
+
+TEST_F(umfArenaPoolTest, largeAllocations) {
+    static constexpr size_t largeSize = 4 * chunkSize;
+
+    void *ptr = umfPoolMalloc(pool.get(), largeSize);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, largeSize);
+    ASSERT_EQ(umfPoolByPtr(ptr), pool.get());
+
+    static constexpr size_t alignment = 4 * chunkSize;
+    void *aligned = umfPoolAlignedMalloc(pool.get(), 64, alignment);
+    ASSERT_NE(aligned, nullptr);
+    ASSERT_EQ((uintptr_t)aligned % alignment, 0u);
+
+    // chunks of large allocations are returned to the provider
+    ASSERT_EQ(umfPoolReset(pool.get()), UMF_RESULT_SUCCESS);
+    ASSERT_EQ(umfPoolByPtr(ptr), nullptr);
+    ASSERT_EQ(umfPoolByPtr(aligned), nullptr);
+}
+
+TEST_F(umfArenaPoolTest, multiThreadedReset) {
+    static constexpr int numThreads = 8;
+    static constexpr size_t numAllocs = 1000;
+    static constexpr int numPhases = 3;
+
+    for (int phase = 0; phase < numPhases; phase++) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&, t] {
+                std::vector<unsigned char *> allocs;
+                for (size_t i = 0; i < numAllocs; i++) {
+                    size_t size = 8 + (i * 13) % 512;
+                    auto *ptr =
+                        (unsigned char *)umfPoolMalloc(pool.get(), size);
+                    ASSERT_NE(ptr, nullptr);
+                    memset(ptr, t, size);
+                    allocs.push_back(ptr);
+                }
+
+                // allocations of other threads do not overlap
+                for (size_t i = 0; i < numAllocs; i++) {
+                    size_t size = 8 + (i * 13) % 512;
+                    for (size_t j = 0; j < size; j++) {
+                        ASSERT_EQ(allocs[i][j], t);
+                    }
+                }
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        ASSERT_EQ(umfPoolReset(pool.get()), UMF_RESULT_SUCCESS);
+    }
+}
+
+TEST_F(umfArenaPoolTest, callocOverflow) {
+    void *ptr = umfPoolCalloc(pool.get(), 2, SIZE_MAX / 2 + 1);
+    ASSERT_EQ(ptr, nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(test, manyPoolsShareTlsSlots) {
+    // more pools than TLS slots, so the pools evict each other's slots
+    static constexpr size_t numPools = 100;
+    static constexpr size_t allocSize = 64;
+    static constexpr size_t numRounds = chunkSize / allocSize / 2;
+
+    auto params = makeArenaParams(chunkSize, false);
+    std::vector<umf::pool_unique_handle_t> pools;
+    for (size_t p = 0; p < numPools; p++) {
+        pools.push_back(poolCreateExtUnique({umfArenaPoolOps(), &params,
+                                             umfOsMemoryProviderOps(),
+                                             &osParams, nullptr}));
+        ASSERT_NE(pools.back().get(), nullptr);
+    }
+
+    std::vector<uintptr_t> lowest(numPools, UINTPTR_MAX);
+    std::vector<uintptr_t> highest(numPools, 0);
+    for (size_t r = 0; r < numRounds; r++) {
+        for (size_t p = 0; p < numPools; p++) {
+            void *ptr = umfPoolMalloc(pools[p].get(), allocSize);
+            ASSERT_NE(ptr, nullptr);
+            lowest[p] = std::min(lowest[p], (uintptr_t)ptr);
+            highest[p] = std::max(highest[p], (uintptr_t)ptr);
+        }
+    }
+
+    // an evicted pool takes its chunk back, so all allocations
+    // of a pool still fit in its first chunk
+    for (size_t p = 0; p < numPools; p++) {
+        ASSERT_LT(highest[p] - lowest[p], chunkSize);
+    }
+}
+
+TEST_F(test, arenaParams_INVALID_ARGUMENT) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &osParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    auto params = makeArenaParams(SIZE_MAX, false);
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(umfArenaPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
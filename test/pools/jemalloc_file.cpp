@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "umf/pools/pool_jemalloc.h"
+#include "umf/providers/provider_file_memory.h"
+
+#include "pool.hpp"
+#include "poolFixtures.hpp"
+
+#define FILE_PATH ((char *)"tmp_file_provider_jemalloc")
+
+auto fileParams = umfFileMemoryProviderParamsDefault(FILE_PATH);
+
+INSTANTIATE_TEST_SUITE_P(jemallocFileTest, umfPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfJemallocPoolOps(), nullptr,
+                             umfFileMemoryProviderOps(), &fileParams,
+                             nullptr}));
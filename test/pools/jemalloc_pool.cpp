@@ -3,20 +3,92 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include "umf/pools/pool_jemalloc.h"
+#include "umf/pools/pool_proxy.h"
 #include "umf/providers/provider_os_memory.h"
 
 #include "pool.hpp"
 #include "poolFixtures.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using umf_test::test;
 using namespace umf_test;
 
 auto defaultParams = umfOsMemoryProviderParamsDefault();
-INSTANTIATE_TEST_SUITE_P(jemallocPoolTest, umfPoolTest,
-                         ::testing::Values(poolCreateExtParams{
-                             umfJemallocPoolOps(), nullptr,
-                             umfOsMemoryProviderOps(), &defaultParams,
-                             nullptr}));
+
+static umf_jemalloc_pool_params_t makeJemallocParams(
+    unsigned num_arenas, umf_jemalloc_pool_arena_mode_t arena_mode) {
+    umf_jemalloc_pool_params_t params = umfJemallocPoolParamsDefault();
+    params.num_arenas = num_arenas;
+    params.arena_mode = arena_mode;
+    return params;
+}
+
+auto cpuArenasParams =
+    makeJemallocParams(4, UMF_JEMALLOC_POOL_ARENA_MODE_CPU);
+auto numaArenasParams =
+    makeJemallocParams(0, UMF_JEMALLOC_POOL_ARENA_MODE_NUMA);
+
+static umf_jemalloc_pool_params_t makeDecayParams(int64_t dirty_decay_ms,
+                                                  int64_t muzzy_decay_ms) {
+    umf_jemalloc_pool_params_t params = umfJemallocPoolParamsDefault();
+    params.dirty_decay_ms = dirty_decay_ms;
+    params.muzzy_decay_ms = muzzy_decay_ms;
+    return params;
+}
+
+// purge unused pages immediately
+auto noDecayParams = makeDecayParams(0, 0);
+
+INSTANTIATE_TEST_SUITE_P(
+    jemallocPoolTest, umfPoolTest,
+    ::testing::Values(poolCreateExtParams{umfJemallocPoolOps(), nullptr,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &cpuArenasParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr},
+                      poolCreateExtParams{umfJemallocPoolOps(),
+                                          &numaArenasParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr},
+                      poolCreateExtParams{umfJemallocPoolOps(), &noDecayParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr}));
+
+TEST_F(test, arenaParams_INVALID_ARGUMENT) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &defaultParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t pool = nullptr;
+    auto params = makeJemallocParams(
+        0, (umf_jemalloc_pool_arena_mode_t)(UMF_JEMALLOC_POOL_ARENA_MODE_NUMA +
+                                            1));
+    ret = umfPoolCreate(umfJemallocPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    params = makeJemallocParams(UINT_MAX, UMF_JEMALLOC_POOL_ARENA_MODE_THREAD);
+    ret = umfPoolCreate(umfJemallocPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    params = makeDecayParams(-3, 0);
+    ret = umfPoolCreate(umfJemallocPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
 
 // this test makes sure that jemalloc does not use
 // memory provider to allocate metadata (and hence
@@ -42,3 +114,379 @@ TEST_F(test, metadataNotAllocatedUsingProvider) {
             [pool = pool.get()](void *ptr) { umfPoolFree(pool, ptr); });
     }
 }
+
+TEST_F(test, purge) {
+    static constexpr size_t allocSize = 64 * 1024;
+    static constexpr size_t numAllocs = 256;
+
+    // never purge on its own
+    auto params = makeDecayParams(-1, -1);
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), &params,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < numAllocs; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), allocSize);
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, 0xAB, allocSize);
+        allocs.push_back(ptr);
+    }
+    for (auto ptr : allocs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+    }
+
+    ASSERT_EQ(umfJemallocPoolPurge(pool.get()), UMF_RESULT_SUCCESS);
+
+    // the pool is still usable after the purge
+    void *ptr = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xCD, allocSize);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, callocAfterPurgeSharedMemory) {
+    static constexpr size_t allocSize = 4 * 1024 * 1024;
+
+    // a forced purge does not zero shared mappings,
+    // so the purged pages cannot be reported as zeroed
+    auto sharedParams = umfOsMemoryProviderParamsDefault();
+    sharedParams.visibility = UMF_MEM_MAP_SHARED;
+    auto params = makeDecayParams(-1, -1);
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), &params,
+                                     umfOsMemoryProviderOps(), &sharedParams,
+                                     nullptr});
+
+    void *ptr = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, allocSize);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(umfJemallocPoolPurge(pool.get()), UMF_RESULT_SUCCESS);
+
+    auto *zeroed = (unsigned char *)umfPoolCalloc(pool.get(), 1, allocSize);
+    ASSERT_NE(zeroed, nullptr);
+    for (size_t i = 0; i < allocSize; i++) {
+        ASSERT_EQ(zeroed[i], 0) << "at offset " << i;
+    }
+    ASSERT_EQ(umfPoolFree(pool.get(), zeroed), UMF_RESULT_SUCCESS);
+}
+
+#ifndef _WIN32
+// provider of shared memory, whose forced purge succeeds but does not zero
+// the memory, like MADV_DONTNEED on a MAP_SHARED or a file mapping
+struct provider_shared_purge_no_zero : public provider_base_t {
+    umf_result_t alloc(size_t size, size_t align, void **ptr) noexcept {
+        size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+        if (align < page_size) {
+            align = page_size;
+        }
+
+        size_t map_size = ALIGN_UP(size, page_size) + align;
+        void *addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            return UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
+        // trim the mapping to the aligned range
+        uintptr_t begin = ALIGN_UP((uintptr_t)addr, align);
+        uintptr_t end = begin + ALIGN_UP(size, page_size);
+        if (begin > (uintptr_t)addr) {
+            munmap(addr, begin - (uintptr_t)addr);
+        }
+        if ((uintptr_t)addr + map_size > end) {
+            munmap((void *)end, (uintptr_t)addr + map_size - end);
+        }
+
+        *ptr = (void *)begin;
+        return UMF_RESULT_SUCCESS;
+    }
+    umf_result_t free(void *ptr, size_t size) noexcept {
+        munmap(ptr, ALIGN_UP(size, (size_t)sysconf(_SC_PAGESIZE)));
+        return UMF_RESULT_SUCCESS;
+    }
+    umf_result_t purge_force(void *, size_t) noexcept {
+        return UMF_RESULT_SUCCESS;
+    }
+    const char *get_name() noexcept { return "shared_purge_no_zero"; }
+};
+
+TEST_F(test, callocRetainedExtentSharedMemory) {
+    static constexpr size_t allocSize = 4 * 1024 * 1024;
+
+    // extents of a pool with disable_provider_free are never returned
+    // to the provider - after the purge they are force-purged and retained,
+    // and the next allocation reuses them
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider_shared_purge_no_zero, void>();
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    auto params = makeDecayParams(-1, -1);
+    params.disable_provider_free = true;
+    umf_memory_pool_handle_t hPool = nullptr;
+    umf_result_t ret = umfPoolCreate(umfJemallocPoolOps(), provider.get(),
+                                     &params, 0, &hPool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto pool = umf_test::wrapPoolUnique(hPool);
+
+    void *ptr = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, allocSize);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(umfJemallocPoolPurge(pool.get()), UMF_RESULT_SUCCESS);
+
+    auto *zeroed = (unsigned char *)umfPoolCalloc(pool.get(), 1, allocSize);
+    ASSERT_NE(zeroed, nullptr);
+    for (size_t i = 0; i < allocSize; i++) {
+        ASSERT_EQ(zeroed[i], 0) << "at offset " << i;
+    }
+    ASSERT_EQ(umfPoolFree(pool.get(), zeroed), UMF_RESULT_SUCCESS);
+}
+#endif
+
+TEST_F(test, purge_INVALID_ARGUMENT) {
+    ASSERT_EQ(umfJemallocPoolPurge(nullptr), UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    auto pool = poolCreateExtUnique({umfProxyPoolOps(), nullptr,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+    ASSERT_EQ(umfJemallocPoolPurge(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(test, stats) {
+    static constexpr size_t smallSize = 64;
+    static constexpr size_t largeSize = 1024 * 1024;
+    static constexpr size_t numAllocs = 128;
+
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), nullptr,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+
+    umf_jemalloc_pool_stats_t stats;
+    umf_result_t ret = umfJemallocPoolGetStats(pool.get(), &stats);
+    if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+        GTEST_SKIP() << "jemalloc was built without statistics";
+    }
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    // arenas are created lazily, on the first allocation
+    ASSERT_EQ(stats.num_arenas, 0u);
+    ASSERT_EQ(stats.allocated, 0u);
+
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < numAllocs; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), smallSize);
+        ASSERT_NE(ptr, nullptr);
+        allocs.push_back(ptr);
+    }
+    void *large = umfPoolMalloc(pool.get(), largeSize);
+    ASSERT_NE(large, nullptr);
+    memset(large, 0xAB, largeSize);
+
+    ASSERT_EQ(umfJemallocPoolGetStats(pool.get(), &stats), UMF_RESULT_SUCCESS);
+    ASSERT_GT(stats.num_arenas, 0u);
+    ASSERT_GE(stats.allocated, numAllocs * smallSize + largeSize);
+    ASSERT_GE(stats.active, stats.allocated);
+    ASSERT_GE(stats.mapped, stats.active);
+    ASSERT_GE(stats.nmalloc, 1u);
+
+    size_t count = 0;
+    ASSERT_EQ(umfJemallocPoolGetSizeClassStats(pool.get(), nullptr, &count),
+              UMF_RESULT_SUCCESS);
+    ASSERT_GT(count, 0u);
+
+    std::vector<umf_jemalloc_pool_size_class_stats_t> classStats(count);
+    ASSERT_EQ(umfJemallocPoolGetSizeClassStats(pool.get(), classStats.data(),
+                                               &count),
+              UMF_RESULT_SUCCESS);
+    ASSERT_EQ(count, classStats.size());
+
+    // objects cached in the tcache are counted as allocated as well
+    auto smallClass =
+        std::find_if(classStats.begin(), classStats.end(),
+                     [](auto &c) { return c.size == smallSize; });
+    ASSERT_NE(smallClass, classStats.end());
+    ASSERT_GE(smallClass->curobjs, numAllocs);
+
+    auto largeClass =
+        std::find_if(classStats.begin(), classStats.end(),
+                     [](auto &c) { return c.size >= largeSize; });
+    ASSERT_NE(largeClass, classStats.end());
+    ASSERT_EQ(largeClass->curobjs, 1u);
+
+    std::string dump;
+    ASSERT_EQ(umfJemallocPoolDumpStats(
+                  pool.get(),
+                  [](void *arg, const char *str) {
+                      *static_cast<std::string *>(arg) += str;
+                  },
+                  &dump),
+              UMF_RESULT_SUCCESS);
+    ASSERT_EQ(dump.front(), '{');
+    ASSERT_EQ(dump.back(), '}');
+    ASSERT_NE(dump.find("\"allocated\":"), std::string::npos);
+    ASSERT_NE(dump.find("\"size\":64,"), std::string::npos);
+
+    for (auto ptr : allocs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+    }
+    ASSERT_EQ(umfPoolFree(pool.get(), large), UMF_RESULT_SUCCESS);
+
+    size_t allocated = stats.allocated;
+    ASSERT_EQ(umfJemallocPoolGetStats(pool.get(), &stats), UMF_RESULT_SUCCESS);
+    ASSERT_LE(stats.allocated + largeSize, allocated);
+    ASSERT_GE(stats.ndalloc, 1u);
+}
+
+TEST_F(test, stats_INVALID_ARGUMENT) {
+    umf_jemalloc_pool_stats_t stats;
+    size_t count = 0;
+    auto write_cb = [](void *, const char *) {};
+
+    ASSERT_EQ(umfJemallocPoolGetStats(nullptr, &stats),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfJemallocPoolGetSizeClassStats(nullptr, nullptr, &count),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfJemallocPoolDumpStats(nullptr, write_cb, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    auto pool = poolCreateExtUnique({umfJemallocPoolOps(), nullptr,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+    ASSERT_EQ(umfJemallocPoolGetStats(pool.get(), nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfJemallocPoolGetSizeClassStats(pool.get(), nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(umfJemallocPoolDumpStats(pool.get(), nullptr, nullptr),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    auto proxyPool = poolCreateExtUnique({umfProxyPoolOps(), nullptr,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr});
+    ASSERT_EQ(umfJemallocPoolGetStats(proxyPool.get(), &stats),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(test, lazyArenas) {
+    static constexpr unsigned numArenas = 64;
+
+    auto params = makeJemallocParams(numArenas,
+                                     UMF_JEMALLOC_POOL_ARENA_MODE_THREAD);
+
+    // pools are created and destroyed repeatedly, as in a pool per request
+    for (int i = 0; i < 100; i++) {
+        auto pool = poolCreateExtUnique({umfJemallocPoolOps(), &params,
+                                         umfOsMemoryProviderOps(),
+                                         &defaultParams, nullptr});
+
+        umf_jemalloc_pool_stats_t stats;
+        umf_result_t ret = umfJemallocPoolGetStats(pool.get(), &stats);
+        if (ret == UMF_RESULT_ERROR_NOT_SUPPORTED) {
+            GTEST_SKIP() << "jemalloc was built without statistics";
+        }
+        ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+        // no arena is created until the pool is used
+        ASSERT_EQ(stats.num_arenas, 0u);
+
+        void *ptr = umfPoolMalloc(pool.get(), 64);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+
+        // a single thread uses a single arena
+        ASSERT_EQ(umfJemallocPoolGetStats(pool.get(), &stats),
+                  UMF_RESULT_SUCCESS);
+        ASSERT_EQ(stats.num_arenas, 1u);
+    }
+}
+
+TEST_F(test, manyPools) {
+    static constexpr size_t numPools = 100;
+
+    // the number of pools existing at the same time is not limited
+    std::vector<umf::pool_unique_handle_t> pools;
+    for (size_t i = 0; i < numPools; i++) {
+        pools.emplace_back(poolCreateExtUnique({umfJemallocPoolOps(), nullptr,
+                                                umfOsMemoryProviderOps(),
+                                                &defaultParams, nullptr}));
+        ASSERT_NE(pools.back().get(), nullptr);
+    }
+
+    auto allocFromAll = [&pools]() {
+        for (auto &pool : pools) {
+            void *ptr = umfPoolMalloc(pool.get(), 64);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+        }
+    };
+
+    // every thread has its own tcache of every pool
+    allocFromAll();
+    std::thread thread(allocFromAll);
+    thread.join();
+
+    // ids of destroyed pools are reused
+    pools.erase(pools.begin(), pools.begin() + numPools / 2);
+    for (size_t i = 0; i < numPools / 2; i++) {
+        pools.emplace_back(poolCreateExtUnique({umfJemallocPoolOps(), nullptr,
+                                                umfOsMemoryProviderOps(),
+                                                &defaultParams, nullptr}));
+        ASSERT_NE(pools.back().get(), nullptr);
+    }
+    allocFromAll();
+}
+
+// provider that can neither split nor merge its allocations
+static std::atomic<size_t> splitCalls;
+static std::atomic<size_t> mergeCalls;
+
+struct provider_no_split_merge : public umf_test::provider_malloc {
+    umf_result_t allocation_split(void *, size_t, size_t) {
+        splitCalls++;
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+    umf_result_t allocation_merge(void *, void *, size_t) {
+        mergeCalls++;
+        return UMF_RESULT_ERROR_NOT_SUPPORTED;
+    }
+};
+
+TEST_F(test, splitMergeNotSupported) {
+    static constexpr size_t numAllocs = 256;
+
+    splitCalls = 0;
+    mergeCalls = 0;
+
+    umf_memory_provider_ops_t provider_ops =
+        umf::providerMakeCOps<provider_no_split_merge, void>();
+    auto provider =
+        wrapProviderUnique(createProviderChecked(&provider_ops, nullptr));
+
+    umf_memory_pool_handle_t hPool = nullptr;
+    umf_result_t ret =
+        umfPoolCreate(umfJemallocPoolOps(), provider.get(), nullptr, 0, &hPool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    auto pool = umf_test::wrapPoolUnique(hPool);
+
+    // mix of small and large allocations, so that jemalloc tries
+    // to carve and coalesce extents
+    for (int round = 0; round < 2; round++) {
+        std::vector<void *> allocs;
+        for (size_t i = 0; i < numAllocs; i++) {
+            size_t size = (i % 2) ? 64 : (i + 1) * 4096;
+            void *ptr = umfPoolMalloc(pool.get(), size);
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, 0xAB, size);
+            allocs.push_back(ptr);
+        }
+        for (auto ptr : allocs) {
+            ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+        }
+    }
+
+    // the pool remembers that the provider refused and does not ask again
+    ASSERT_LE(splitCalls.load(), 1u);
+    ASSERT_LE(mergeCalls.load(), 1u);
+}
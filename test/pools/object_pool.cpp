@@ -0,0 +1,283 @@
+// Copyright (C) 2024 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "umf/pools/pool_object.h"
+#include "umf/providers/provider_coarse.h"
+#include "umf/providers/provider_file_memory.h"
+#include "umf/providers/provider_os_memory.h"
+
+#include "pool.hpp"
+#include "poolFixtures.hpp"
+
+#include <algorithm>
+#include <set>
+#include <cstdlib>
+#include <thread>
+
+using umf_test::test;
+using namespace umf_test;
+
+#define FILE_PATH ((char *)"tmp_object_file_provider")
+
+static constexpr size_t objectSize = 72;
+
+auto osParams = umfOsMemoryProviderParamsDefault();
+auto fileParams = umfFileMemoryProviderParamsDefault(FILE_PATH);
+auto coarseParams = umfCoarseMemoryProviderParamsDefault();
+auto objectParams = umfObjectPoolParamsDefault(objectSize);
+// umfMultiPoolTest allocates up to 4 KB
+auto pageObjectParams = umfObjectPoolParamsDefault(4096);
+
+struct umfObjectPoolTest : umf_test::test,
+                           ::testing::WithParamInterface<poolCreateExtParams> {
+    void SetUp() override {
+        test::SetUp();
+        pool = poolCreateExtUnique(this->GetParam());
+        ASSERT_NE(pool.get(), nullptr);
+    }
+
+    void TearDown() override { test::TearDown(); }
+
+    umf::pool_unique_handle_t pool;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    objectPoolTest, umfObjectPoolTest,
+    ::testing::Values(
+        poolCreateExtParams{umfObjectPoolOps(), &objectParams,
+                            umfOsMemoryProviderOps(), &osParams, nullptr},
+        poolCreateExtParams{umfObjectPoolOps(), &objectParams,
+                            umfFileMemoryProviderOps(), &fileParams, nullptr},
+        poolCreateExtParams{umfObjectPoolOps(), &objectParams,
+                            umfOsMemoryProviderOps(), &osParams,
+                            &coarseParams}));
+
+INSTANTIATE_TEST_SUITE_P(objectMultiPoolTest, umfMultiPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfObjectPoolOps(), &pageObjectParams,
+                             umfOsMemoryProviderOps(), &osParams, nullptr}));
+
+TEST_P(umfObjectPoolTest, allocFree) {
+    // enough objects for several slabs
+    static constexpr size_t numAllocs = 10000;
+
+    std::set<void *> allocs;
+    for (size_t i = 0; i < numAllocs; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), objectSize);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ((uintptr_t)ptr % UMF_OBJECT_POOL_ALIGNMENT_DEFAULT, 0u);
+        ASSERT_GE(umfPoolMallocUsableSize(pool.get(), ptr), objectSize);
+        memset(ptr, 0xAB, objectSize);
+        ASSERT_TRUE(allocs.insert(ptr).second);
+    }
+
+    for (auto ptr : allocs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+    }
+
+    // the freed objects are reused
+    for (size_t i = 0; i < numAllocs; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), objectSize);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_NE(allocs.find(ptr), allocs.end());
+    }
+}
+
+TEST_P(umfObjectPoolTest, sizes) {
+    void *ptr = umfPoolMalloc(pool.get(), objectSize + 1);
+    ASSERT_EQ(ptr, nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    ptr = umfPoolAlignedMalloc(pool.get(), objectSize, 4096);
+    ASSERT_EQ(ptr, nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ALIGNMENT);
+
+    ptr = umfPoolAlignedMalloc(pool.get(), 8, 8);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+
+    auto *obj = (unsigned char *)umfPoolCalloc(pool.get(), 1, objectSize);
+    ASSERT_NE(obj, nullptr);
+    for (size_t i = 0; i < objectSize; i++) {
+        ASSERT_EQ(obj[i], 0);
+    }
+
+    // realloc() works only within the object size
+    ASSERT_EQ(umfPoolRealloc(pool.get(), obj, objectSize / 2), obj);
+    ASSERT_EQ(umfPoolRealloc(pool.get(), obj, objectSize + 1), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool.get()),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // umfFree() finds the pool of the object
+    ASSERT_EQ(umfPoolByPtr(obj), pool.get());
+    ASSERT_EQ(umfFree(obj), UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfObjectPoolTest, multiThreadedMallocFree) {
+    static constexpr int numThreads = 8;
+    static constexpr size_t numAllocs = 5000;
+    static constexpr int numRounds = 3;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (int r = 0; r < numRounds; r++) {
+                std::vector<unsigned char *> allocs;
+                for (size_t i = 0; i < numAllocs; i++) {
+                    auto *ptr =
+                        (unsigned char *)umfPoolMalloc(pool.get(), objectSize);
+                    ASSERT_NE(ptr, nullptr);
+                    memset(ptr, t, objectSize);
+                    allocs.push_back(ptr);
+                }
+
+                for (auto ptr : allocs) {
+                    for (size_t j = 0; j < objectSize; j++) {
+                        ASSERT_EQ(ptr[j], t);
+                    }
+                    ASSERT_EQ(umfPoolFree(pool.get(), ptr),
+                              UMF_RESULT_SUCCESS);
+                }
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_P(umfObjectPoolTest, crossThreadFree) {
+    static constexpr size_t batchSize = 1000;
+    static constexpr int numRounds = 100;
+
+    // objects allocated by one thread and freed by another one
+    // go back to the pool, so the pool does not grow
+    std::set<void *> seen;
+    for (int r = 0; r < numRounds; r++) {
+        std::vector<void *> batch;
+        std::thread producer([&] {
+            for (size_t i = 0; i < batchSize; i++) {
+                void *ptr = umfPoolMalloc(pool.get(), objectSize);
+                ASSERT_NE(ptr, nullptr);
+                batch.push_back(ptr);
+            }
+        });
+        producer.join();
+        ASSERT_EQ(batch.size(), batchSize);
+
+        seen.insert(batch.begin(), batch.end());
+
+        std::thread consumer([&] {
+            for (auto ptr : batch) {
+                ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+            }
+        });
+        consumer.join();
+    }
+
+    ASSERT_LT(seen.size(), 10 * batchSize);
+}
+
+#ifndef _WIN32
+TEST_F(test, stealRemoteObjects) {
+    static constexpr size_t slabSize = 64 * 1024;
+    static constexpr size_t numAllocs = 10000;
+
+    // give the lists to threads instead of CPUs, so the two threads below
+    // use different lists even if they run on the same CPU
+    ASSERT_EQ(setenv("UMF_OBJECT_POOL_LISTS", "per_thread", 1), 0);
+    auto params = umfObjectPoolParamsDefault(objectSize);
+    params.slab_size = slabSize;
+    auto pool = poolCreateExtUnique({umfObjectPoolOps(), &params,
+                                     umfOsMemoryProviderOps(), &osParams,
+                                     nullptr});
+    ASSERT_EQ(unsetenv("UMF_OBJECT_POOL_LISTS"), 0);
+    ASSERT_NE(pool.get(), nullptr);
+
+    // the objects are allocated by the first thread...
+    std::vector<void *> allocs;
+    std::set<uintptr_t> slabs;
+    std::thread([&] {
+        for (size_t i = 0; i < numAllocs; i++) {
+            void *ptr = umfPoolMalloc(pool.get(), objectSize);
+            ASSERT_NE(ptr, nullptr);
+            allocs.push_back(ptr);
+            slabs.insert((uintptr_t)ptr & ~(uintptr_t)(slabSize - 1));
+        }
+    }).join();
+    ASSERT_EQ(allocs.size(), numAllocs);
+
+    // ...and freed and allocated again by the second one, so they wait
+    // on the remote list of the first thread, which the second thread
+    // drains instead of allocating new slabs
+    std::thread([&] {
+        for (auto ptr : allocs) {
+            ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+        }
+        for (size_t i = 0; i < numAllocs; i++) {
+            void *ptr = umfPoolMalloc(pool.get(), objectSize);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_NE(slabs.find((uintptr_t)ptr & ~(uintptr_t)(slabSize - 1)),
+                      slabs.end());
+        }
+    }).join();
+}
+#endif /* _WIN32 */
+
+TEST_F(test, objectPoolNoTracking) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &osParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the pool does not need the memory tracker to free objects
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, &objectParams,
+                        UMF_POOL_CREATE_FLAG_DISABLE_TRACKING, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *ptr = umfPoolMalloc(pool, objectSize);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolByPtr(ptr), nullptr);
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    umfPoolDestroy(pool);
+    umfMemoryProviderDestroy(provider);
+}
+
+TEST_F(test, objectParams_INVALID_ARGUMENT) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &osParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, nullptr, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    auto params = umfObjectPoolParamsDefault(0);
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    params = umfObjectPoolParamsDefault(objectSize);
+    params.alignment = 48;
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ALIGNMENT);
+
+    params = umfObjectPoolParamsDefault(objectSize);
+    params.slab_size = 3 * 4096;
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the object does not fit into the slab
+    params = umfObjectPoolParamsDefault(1024 * 1024);
+    params.slab_size = 1024 * 1024;
+    ret = umfPoolCreate(umfObjectPoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
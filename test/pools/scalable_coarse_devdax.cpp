@@ -13,8 +13,21 @@ auto devdaxParams = umfDevDaxMemoryProviderParamsDefault(
                                          ? atol(getenv("UMF_TESTS_DEVDAX_SIZE"))
                                          : 0);
 
-INSTANTIATE_TEST_SUITE_P(scalableCoarseDevDaxTest, umfPoolTest,
-                         ::testing::Values(poolCreateExtParams{
-                             umfScalablePoolOps(), nullptr,
-                             umfDevDaxMemoryProviderOps(), &devdaxParams,
-                             &coarseParams}));
+// the device DAX emulated with a memfd
+umf_devdax_memory_provider_params_t devdaxEmulationParamsDefault() {
+    auto params =
+        umfDevDaxMemoryProviderParamsDefault(nullptr, 1024 * 1024 * 1024);
+    params.emulation = true;
+    return params;
+}
+auto devdaxEmulationParams = devdaxEmulationParamsDefault();
+
+INSTANTIATE_TEST_SUITE_P(
+    scalableCoarseDevDaxTest, umfPoolTest,
+    ::testing::Values(poolCreateExtParams{umfScalablePoolOps(), nullptr,
+                                          umfDevDaxMemoryProviderOps(),
+                                          &devdaxParams, &coarseParams},
+                      poolCreateExtParams{umfScalablePoolOps(), nullptr,
+                                          umfDevDaxMemoryProviderOps(),
+                                          &devdaxEmulationParams,
+                                          &coarseParams}));
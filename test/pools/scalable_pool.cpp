@@ -8,9 +8,121 @@
 #include "pool.hpp"
 #include "poolFixtures.hpp"
 
+using umf_test::test;
+using namespace umf_test;
+
 auto defaultParams = umfOsMemoryProviderParamsDefault();
-INSTANTIATE_TEST_SUITE_P(scalablePoolTest, umfPoolTest,
-                         ::testing::Values(poolCreateExtParams{
-                             umfScalablePoolOps(), nullptr,
-                             umfOsMemoryProviderOps(), &defaultParams,
-                             nullptr}));
+
+static umf_scalable_pool_params_t makeScalableParams(size_t granularity,
+                                                     bool keep_all_memory,
+                                                     size_t fixed_pool_size) {
+    umf_scalable_pool_params_t params = umfScalablePoolParamsDefault();
+    params.granularity = granularity;
+    params.keep_all_memory = keep_all_memory;
+    params.fixed_pool_size = fixed_pool_size;
+    return params;
+}
+
+auto keepAllMemoryParams = makeScalableParams(64 * 1024, true, 0);
+auto fixedPoolParams = makeScalableParams(0, false, 1024 * 1024 * 1024);
+
+INSTANTIATE_TEST_SUITE_P(
+    scalablePoolTest, umfPoolTest,
+    ::testing::Values(poolCreateExtParams{umfScalablePoolOps(), nullptr,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr},
+                      poolCreateExtParams{umfScalablePoolOps(),
+                                          &keepAllMemoryParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr},
+                      poolCreateExtParams{umfScalablePoolOps(),
+                                          &fixedPoolParams,
+                                          umfOsMemoryProviderOps(),
+                                          &defaultParams, nullptr}));
+
+TEST_F(test, scalableParams_INVALID_ARGUMENT) {
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t ret = umfMemoryProviderCreate(
+        umfOsMemoryProviderOps(), &defaultParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // granularity has to be a power of 2
+    auto params = makeScalableParams(3 * 1024 * 1024, false, 0);
+    umf_memory_pool_handle_t pool = nullptr;
+    ret = umfPoolCreate(umfScalablePoolOps(), provider, &params, 0, &pool);
+    ASSERT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfMemoryProviderDestroy(provider);
+}
+
+TEST_F(test, scalableFixedPool) {
+    static constexpr size_t fixedPoolSize = 16 * 1024 * 1024;
+    static constexpr size_t allocSize = 1024 * 1024;
+
+    auto params = makeScalableParams(0, false, fixedPoolSize);
+    auto pool = poolCreateExtUnique({umfScalablePoolOps(), &params,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+    ASSERT_NE(pool.get(), nullptr);
+
+    // the pool cannot grow beyond its fixed size
+    std::vector<void *> allocs;
+    for (size_t i = 0; i < 2 * fixedPoolSize / allocSize; i++) {
+        void *ptr = umfPoolMalloc(pool.get(), allocSize);
+        if (ptr == nullptr) {
+            break;
+        }
+        allocs.push_back(ptr);
+    }
+    ASSERT_GT(allocs.size(), 0u);
+    ASSERT_LT(allocs.size(), fixedPoolSize / allocSize);
+
+    for (auto ptr : allocs) {
+        ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+    }
+
+    // the freed memory can be used again
+    void *ptr = umfPoolMalloc(pool.get(), allocSize);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(umfPoolFree(pool.get(), ptr), UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, scalablePoolReset) {
+    static constexpr size_t fixedPoolSize = 16 * 1024 * 1024;
+    static constexpr size_t allocSize = 64 * 1024;
+
+    auto params = makeScalableParams(0, false, fixedPoolSize);
+    auto pool = poolCreateExtUnique({umfScalablePoolOps(), &params,
+                                     umfOsMemoryProviderOps(), &defaultParams,
+                                     nullptr});
+    ASSERT_NE(pool.get(), nullptr);
+
+    auto fillPool = [&]() {
+        size_t n = 0;
+        while (n < 2 * fixedPoolSize / allocSize) {
+            void *ptr = umfPoolMalloc(pool.get(), allocSize);
+            if (ptr == nullptr) {
+                break;
+            }
+            // the memory obtained from the provider stays tracked
+            EXPECT_EQ(umfPoolByPtr(ptr), pool.get());
+            memset(ptr, 0xAB, allocSize);
+            n++;
+        }
+        return n;
+    };
+
+    // fill the whole fixed pool without freeing anything
+    size_t nAllocs = fillPool();
+    ASSERT_GT(nAllocs, 0u);
+    ASSERT_LT(nAllocs, 2 * fixedPoolSize / allocSize);
+
+    // reset drops all the allocations at once, so the pool
+    // can be filled up again
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(umfPoolReset(pool.get()), UMF_RESULT_SUCCESS);
+        ASSERT_EQ(fillPool(), nAllocs);
+    }
+
+    ASSERT_EQ(umfPoolReset(pool.get()), UMF_RESULT_SUCCESS);
+}
@@ -0,0 +1,193 @@
+// Copyright (C) 2024 Intel Corporation
+// Under the Apache License v2.0 with LLVM Exceptions. See LICENSE.TXT.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "umf/ipc.h"
+#include "umf/pools/pool_proxy.h"
+#include "umf/pools/pool_shared.h"
+#include "umf/providers/provider_os_memory.h"
+
+#include "pool.hpp"
+#include "poolFixtures.hpp"
+
+#define SHM_NAME "umf_test_shared_pool"
+
+static umf_os_memory_provider_params_t osSharedParamsDefault(char *shm_name) {
+    auto params = umfOsMemoryProviderParamsDefault();
+    params.visibility = UMF_MEM_MAP_SHARED;
+    params.shm_name = shm_name;
+    return params;
+}
+
+auto osSharedParams = osSharedParamsDefault(nullptr);
+auto sharedPoolParams = umfSharedPoolParamsDefault();
+
+INSTANTIATE_TEST_SUITE_P(sharedPoolTest, umfPoolTest,
+                         ::testing::Values(poolCreateExtParams{
+                             umfSharedPoolOps(), &sharedPoolParams,
+                             umfOsMemoryProviderOps(), &osSharedParams,
+                             nullptr}));
+
+struct umfSharedPoolTest : umf_test::test {
+    void SetUp() override {
+        test::SetUp();
+
+        char shm_name[] = SHM_NAME;
+        auto creatorParams = osSharedParamsDefault(shm_name);
+        creator = createPool(&creatorParams, nullptr);
+        ASSERT_NE(creator.get(), nullptr);
+    }
+
+    void TearDown() override { test::TearDown(); }
+
+    umf::pool_unique_handle_t
+    createPool(umf_os_memory_provider_params_t *providerParams,
+               umf_ipc_handle_t heapIpcHandle,
+               umf_result_t expected = UMF_RESULT_SUCCESS) {
+        umf_memory_provider_handle_t provider = nullptr;
+        umf_result_t ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                                   providerParams, &provider);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+        auto params = umfSharedPoolParamsDefault();
+        params.heap_size = HEAP_SIZE;
+        params.heap_ipc_handle = heapIpcHandle;
+
+        umf_memory_pool_handle_t hPool = nullptr;
+        ret = umfPoolCreate(umfSharedPoolOps(), provider, &params,
+                            UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hPool);
+        EXPECT_EQ(ret, expected);
+        if (ret != UMF_RESULT_SUCCESS) {
+            umfMemoryProviderDestroy(provider);
+        }
+
+        return umf::pool_unique_handle_t(hPool, &umfPoolDestroy);
+    }
+
+    static constexpr size_t HEAP_SIZE = 64 * 1024 * 1024;
+
+    umf::pool_unique_handle_t creator;
+};
+
+TEST_F(umfSharedPoolTest, allocFreeInTwoPools) {
+    constexpr size_t SIZE = 100;
+
+    umf_ipc_handle_t heapHandle = nullptr;
+    size_t handleSize = 0;
+    umf_result_t ret =
+        umfSharedPoolGetIPCHandle(creator.get(), &heapHandle, &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    // the heap is opened by the consumer using the IPC handle
+    auto consumerParams = osSharedParamsDefault(nullptr);
+    auto consumer = createPool(&consumerParams, heapHandle);
+    ASSERT_NE(consumer.get(), nullptr);
+
+    int *ptr = (int *)umfPoolMalloc(creator.get(), SIZE * sizeof(int));
+    ASSERT_NE(ptr, nullptr);
+    for (size_t i = 0; i < SIZE; ++i) {
+        ptr[i] = (int)i;
+    }
+
+    umf_ipc_region_ref_t ref;
+    ret = umfGetIPCRegionRef(ptr, SIZE * sizeof(int), &ref);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_ipc_region_handle_t region = nullptr;
+    ret = umfOpenIPCRegion(consumer.get(), heapHandle, &region);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    int *consumerPtr = nullptr;
+    ret = umfIPCRegionGetPtr(region, &ref, (void **)&consumerPtr);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    ASSERT_NE(consumerPtr, ptr);
+    for (size_t i = 0; i < SIZE; ++i) {
+        ASSERT_EQ(consumerPtr[i], (int)i);
+    }
+
+    // the memory allocated by the creator is freed by the consumer
+    // and it is reused by the next allocation of the creator
+    EXPECT_EQ(umfPoolByPtr(consumerPtr), consumer.get());
+    ret = umfFree(consumerPtr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *ptr2 = umfPoolMalloc(creator.get(), SIZE * sizeof(int));
+    EXPECT_EQ(ptr2, ptr);
+
+    // allocations of both pools are disjoint
+    void *consumerPtr2 = umfPoolMalloc(consumer.get(), SIZE * sizeof(int));
+    ASSERT_NE(consumerPtr2, nullptr);
+    EXPECT_NE(consumerPtr2, consumerPtr);
+    EXPECT_EQ(umfPoolMallocUsableSize(consumer.get(), consumerPtr2),
+              umfPoolMallocUsableSize(creator.get(), ptr2));
+
+    ret = umfPoolFree(consumer.get(), consumerPtr2);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPoolFree(creator.get(), ptr2);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfCloseIPCRegion(region);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    ret = umfPutIPCHandle(heapHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+}
+
+TEST_F(umfSharedPoolTest, outOfMemory) {
+    std::vector<void *> ptrs;
+    void *ptr = nullptr;
+    while ((ptr = umfPoolMalloc(creator.get(), 1024 * 1024)) != nullptr) {
+        ptrs.push_back(ptr);
+    }
+
+    EXPECT_EQ(umfPoolGetLastAllocationError(creator.get()),
+              UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+    EXPECT_GT(ptrs.size(), 0);
+    EXPECT_LT(ptrs.size(), HEAP_SIZE / (1024 * 1024));
+
+    // the freed slabs can be used by small allocations too
+    for (void *p : ptrs) {
+        umf_result_t ret = umfPoolFree(creator.get(), p);
+        EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    }
+
+    ptr = umfPoolMalloc(creator.get(), 64);
+    EXPECT_NE(ptr, nullptr);
+    umfPoolFree(creator.get(), ptr);
+}
+
+TEST_F(umfSharedPoolTest, wrongHeapIpcHandle) {
+    umf_memory_provider_handle_t provider = nullptr;
+    auto providerParams = osSharedParamsDefault(nullptr);
+    umf_result_t ret = umfMemoryProviderCreate(umfOsMemoryProviderOps(),
+                                               &providerParams, &provider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t hProxyPool = nullptr;
+    ret = umfPoolCreate(umfProxyPoolOps(), provider, nullptr,
+                        UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hProxyPool);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+    umf::pool_unique_handle_t proxyPool(hProxyPool, &umfPoolDestroy);
+
+    umf_ipc_handle_t heapHandle = nullptr;
+    size_t handleSize = 0;
+    ret = umfSharedPoolGetIPCHandle(proxyPool.get(), &heapHandle, &handleSize);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the IPC handle does not point to a heap of the shared memory pool
+    void *ptr = umfPoolMalloc(proxyPool.get(), HEAP_SIZE);
+    ASSERT_NE(ptr, nullptr);
+    ret = umfGetIPCHandle(ptr, &heapHandle, &handleSize);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    auto consumerParams = osSharedParamsDefault(nullptr);
+    auto consumer = createPool(&consumerParams, heapHandle,
+                               UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(consumer.get(), nullptr);
+
+    ret = umfPutIPCHandle(heapHandle);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+    ret = umfPoolFree(proxyPool.get(), ptr);
+    EXPECT_EQ(ret, UMF_RESULT_SUCCESS);
+}
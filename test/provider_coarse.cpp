@@ -10,6 +10,7 @@
 #include "provider.hpp"
 
 #include <umf/providers/provider_coarse.h>
+#include <umf/providers/provider_os_memory.h>
 
 using umf_test::KB;
 using umf_test::MB;
@@ -397,6 +398,90 @@ TEST_P(CoarseWithMemoryStrategyTest, coarseProvider_split_merge) {
     umfMemoryProviderDestroy(malloc_memory_provider);
 }
 
+TEST_P(CoarseWithMemoryStrategyTest, coarseProvider_resize) {
+    umf_result_t umf_result;
+
+    const size_t init_buffer_size = 20 * MB;
+
+    // preallocate some memory and initialize the vector with zeros
+    std::vector<char> buffer(init_buffer_size, 0);
+    void *buf = (void *)buffer.data();
+    ASSERT_NE(buf, nullptr);
+
+    coarse_memory_provider_params_t coarse_memory_provider_params;
+    // make sure there are no undefined members - prevent a UB
+    memset(&coarse_memory_provider_params, 0,
+           sizeof(coarse_memory_provider_params));
+    coarse_memory_provider_params.allocation_strategy = allocation_strategy;
+    coarse_memory_provider_params.upstream_memory_provider = nullptr;
+    coarse_memory_provider_params.immediate_init_from_upstream = false;
+    coarse_memory_provider_params.init_buffer = buf;
+    coarse_memory_provider_params.init_buffer_size = init_buffer_size;
+
+    umf_memory_provider_handle_t coarse_memory_provider = nullptr;
+    umf_result = umfMemoryProviderCreate(umfCoarseMemoryProviderOps(),
+                                         &coarse_memory_provider_params,
+                                         &coarse_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_memory_provider, nullptr);
+
+    umf_memory_provider_handle_t cp = coarse_memory_provider;
+    char *ptr = nullptr;
+    char *new_ptr = nullptr;
+
+    umf_result = umfMemoryProviderAlloc(cp, 2 * MB, 0, (void **)&ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(GetStats(cp).used_size, 2 * MB);
+    ASSERT_EQ(GetStats(cp).num_all_blocks, 2);
+    memset(ptr, 0xAB, 2 * MB);
+
+    // grow in place taking a part of the following free block
+    umf_result = umfMemoryProviderResize(cp, ptr, 2 * MB, 8 * MB,
+                                         (void **)&new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(GetStats(cp).used_size, 8 * MB);
+    ASSERT_EQ(GetStats(cp).num_all_blocks, 2);
+    ASSERT_EQ(GetStats(cp).num_free_blocks, 1);
+    ASSERT_EQ(ptr[2 * MB - 1], (char)0xAB);
+
+    // shrink in place - the tail is merged with the following free block
+    umf_result = umfMemoryProviderResize(cp, ptr, 8 * MB, 1 * MB,
+                                         (void **)&new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(GetStats(cp).used_size, 1 * MB);
+    ASSERT_EQ(GetStats(cp).num_all_blocks, 2);
+    ASSERT_EQ(GetStats(cp).num_free_blocks, 1);
+
+    // grow using the whole following free block
+    umf_result = umfMemoryProviderResize(cp, ptr, 1 * MB, init_buffer_size,
+                                         (void **)&new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(GetStats(cp).used_size, init_buffer_size);
+    ASSERT_EQ(GetStats(cp).num_all_blocks, 1);
+    ASSERT_EQ(GetStats(cp).num_free_blocks, 0);
+
+    // no space left to grow
+    umf_result = umfMemoryProviderResize(cp, ptr, init_buffer_size,
+                                         init_buffer_size + 1,
+                                         (void **)&new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    // wrong size of the allocation
+    umf_result =
+        umfMemoryProviderResize(cp, ptr, 1 * MB, 2 * MB, (void **)&new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderFree(cp, ptr, init_buffer_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(GetStats(cp).used_size, 0);
+    ASSERT_EQ(GetStats(cp).num_all_blocks, 1);
+
+    umfMemoryProviderDestroy(coarse_memory_provider);
+}
+
 TEST_P(CoarseWithMemoryStrategyTest, coarseProvider_split_merge_negative) {
     umf_memory_provider_handle_t malloc_memory_provider;
     umf_result_t umf_result;
@@ -631,3 +716,61 @@ TEST_P(CoarseWithMemoryStrategyTest, coarseProvider_purge_with_upstream) {
     umfMemoryProviderDestroy(coarse_memory_provider);
     umfMemoryProviderDestroy(malloc_memory_provider);
 }
+
+TEST_P(CoarseWithMemoryStrategyTest, coarseProvider_alloc_zero_info) {
+    umf_memory_provider_handle_t os_memory_provider;
+    umf_result_t umf_result;
+
+    umf_os_memory_provider_params_t os_params =
+        umfOsMemoryProviderParamsDefault();
+    umf_result = umfMemoryProviderCreate(umfOsMemoryProviderOps(), &os_params,
+                                         &os_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(os_memory_provider, nullptr);
+
+    coarse_memory_provider_params_t coarse_memory_provider_params;
+    // make sure there are no undefined members - prevent a UB
+    memset(&coarse_memory_provider_params, 0,
+           sizeof(coarse_memory_provider_params));
+    coarse_memory_provider_params.allocation_strategy = allocation_strategy;
+    coarse_memory_provider_params.upstream_memory_provider =
+        os_memory_provider;
+    coarse_memory_provider_params.destroy_upstream_memory_provider = true;
+
+    umf_memory_provider_handle_t coarse_memory_provider;
+    umf_result = umfMemoryProviderCreate(umfCoarseMemoryProviderOps(),
+                                         &coarse_memory_provider_params,
+                                         &coarse_memory_provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(coarse_memory_provider, nullptr);
+
+    const size_t size = 2 * MB;
+    void *ptr = nullptr;
+    bool zeroed = false;
+
+    // the first allocation comes straight from the OS provider
+    umf_result = umfMemoryProviderAllocZeroInfo(coarse_memory_provider, size,
+                                                0, &ptr, &zeroed);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_TRUE(zeroed);
+
+    memset(ptr, 0xAB, size);
+    umf_result = umfMemoryProviderFree(coarse_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the reused block is dirty
+    umf_result = umfMemoryProviderAllocZeroInfo(coarse_memory_provider, size,
+                                                0, &ptr, &zeroed);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_FALSE(zeroed);
+
+    umf_result = umfMemoryProviderFree(coarse_memory_provider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(coarse_memory_provider);
+    // os_memory_provider has already been destroyed
+    // by umfMemoryProviderDestroy(coarse_memory_provider), because:
+    // coarse_memory_provider_params.destroy_upstream_memory_provider = true;
+}
@@ -7,11 +7,13 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 
 #include "base.hpp"
 
 #include "cpp_helpers.hpp"
+#include "ipcFixtures.hpp"
 #include "test_helpers.h"
 
 #include <umf/memory_provider.h>
@@ -33,6 +35,7 @@ static const char *Native_error_str[] = {
     "allocated address is not aligned", // UMF_DEVDAX_RESULT_ERROR_ADDRESS_NOT_ALIGNED
     "memory deallocation failed",       // UMF_DEVDAX_RESULT_ERROR_FREE_FAILED
     "force purging failed", // UMF_DEVDAX_RESULT_ERROR_PURGE_FORCE_FAILED
+    "persisting memory failed", // UMF_DEVDAX_RESULT_ERROR_PERSIST_FAILED
 };
 
 // test helpers
@@ -63,14 +66,22 @@ struct umfProviderTest
     : umf_test::test,
       ::testing::WithParamInterface<providerCreateExtParams> {
     void SetUp() override {
-        char *path = getenv("UMF_TESTS_DEVDAX_PATH");
-        if (path == nullptr || path[0] == 0) {
-            GTEST_SKIP() << "Test skipped, UMF_TESTS_DEVDAX_PATH is not set";
-        }
-
-        char *size = getenv("UMF_TESTS_DEVDAX_SIZE");
-        if (size == nullptr || size[0] == 0) {
-            GTEST_SKIP() << "Test skipped, UMF_TESTS_DEVDAX_SIZE is not set";
+        auto params = static_cast<umf_devdax_memory_provider_params_t *>(
+            std::get<1>(this->GetParam()));
+
+        // the emulation mode does not need a device DAX
+        if (!params->emulation) {
+            char *path = getenv("UMF_TESTS_DEVDAX_PATH");
+            if (path == nullptr || path[0] == 0) {
+                GTEST_SKIP()
+                    << "Test skipped, UMF_TESTS_DEVDAX_PATH is not set";
+            }
+
+            char *size = getenv("UMF_TESTS_DEVDAX_SIZE");
+            if (size == nullptr || size[0] == 0) {
+                GTEST_SKIP()
+                    << "Test skipped, UMF_TESTS_DEVDAX_SIZE is not set";
+            }
         }
 
         test::SetUp();
@@ -110,7 +121,7 @@ static void test_alloc_free_success(umf_memory_provider_handle_t provider,
     }
 
     umf_result = umfMemoryProviderFree(provider, ptr, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 static void verify_last_native_error(umf_memory_provider_handle_t provider,
@@ -169,7 +180,7 @@ TEST_F(test, test_if_mapped_with_MAP_SYNC) {
     bool flag_found = is_mapped_with_MAP_SYNC(path, buf, size);
 
     umf_result = umfMemoryProviderFree(hProvider, buf, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 
     umfMemoryProviderDestroy(hProvider);
 
@@ -184,9 +195,29 @@ auto defaultParams = umfDevDaxMemoryProviderParamsDefault(
     atol(getenv("UMF_TESTS_DEVDAX_SIZE") ? getenv("UMF_TESTS_DEVDAX_SIZE")
                                          : "0"));
 
-INSTANTIATE_TEST_SUITE_P(devdaxProviderTest, umfProviderTest,
-                         ::testing::Values(providerCreateExtParams{
-                             umfDevDaxMemoryProviderOps(), &defaultParams}));
+#define EMULATION_SIZE (1024 * 1024 * 1024) // 1 GB (sparse)
+#define EMULATION_FILE "umf_test_devdax_emulation"
+
+static umf_devdax_memory_provider_params_t emulationParams(char *path) {
+    auto params = umfDevDaxMemoryProviderParamsDefault(path, EMULATION_SIZE);
+    params.emulation = true;
+    return params;
+}
+
+auto memfdParams = emulationParams(nullptr);
+auto fileParams = emulationParams((char *)EMULATION_FILE);
+
+// remove the file emulating the device DAX when the tests are done
+static struct emulation_file_cleanup_t {
+    ~emulation_file_cleanup_t() { unlink(EMULATION_FILE); }
+} emulationFileCleanup;
+
+INSTANTIATE_TEST_SUITE_P(
+    devdaxProviderTest, umfProviderTest,
+    ::testing::Values(
+        providerCreateExtParams{umfDevDaxMemoryProviderOps(), &defaultParams},
+        providerCreateExtParams{umfDevDaxMemoryProviderOps(), &memfdParams},
+        providerCreateExtParams{umfDevDaxMemoryProviderOps(), &fileParams}));
 
 TEST_P(umfProviderTest, create_destroy) {}
 
@@ -271,23 +302,153 @@ TEST_P(umfProviderTest, get_name) {
     ASSERT_STREQ(name, "DEVDAX");
 }
 
-TEST_P(umfProviderTest, free_size_0_ptr_not_null) {
+TEST_P(umfProviderTest, free_NULL) {
+    umf_result_t umf_result = umfMemoryProviderFree(provider.get(), nullptr, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, free_reuse) {
+    void *ptr1 = nullptr;
     umf_result_t umf_result =
-        umfMemoryProviderFree(provider.get(), INVALID_PTR, 0);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+        umfMemoryProviderAlloc(provider.get(), page_plus_64, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr1, nullptr);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr1, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the freed extent is the best fit for the same size
+    void *ptr2 = nullptr;
+    umf_result = umfMemoryProviderAlloc(provider.get(), page_plus_64, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr2, ptr1);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr2, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
-TEST_P(umfProviderTest, free_NULL) {
-    umf_result_t umf_result = umfMemoryProviderFree(provider.get(), nullptr, 0);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+TEST_P(umfProviderTest, alloc_all_free_all) {
+    std::vector<void *> ptrs;
+    void *ptr = nullptr;
+    while (umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr) ==
+           UMF_RESULT_SUCCESS) {
+        ptrs.push_back(ptr);
+    }
+    ASSERT_GT(ptrs.size(), 0);
+
+    // free every other page first, so that the free extents are coalesced
+    for (size_t i = 0; i < ptrs.size(); i += 2) {
+        umf_result_t umf_result =
+            umfMemoryProviderFree(provider.get(), ptrs[i], page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    for (size_t i = 1; i < ptrs.size(); i += 2) {
+        umf_result_t umf_result =
+            umfMemoryProviderFree(provider.get(), ptrs[i], page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    // the whole space has to be available again
+    size_t size = ptrs.size() * page_size;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, split_merge_free) {
+    void *ptr = nullptr;
+    size_t size = 4 * page_size;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    void *high = (char *)ptr + page_size;
+    umf_result =
+        umfMemoryProviderAllocationSplit(provider.get(), ptr, size, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result =
+        umfMemoryProviderAllocationMerge(provider.get(), ptr, high, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result =
+        umfMemoryProviderAllocationSplit(provider.get(), ptr, size, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the parts are freed separately
+    umf_result = umfMemoryProviderFree(provider.get(), high, size - page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    void *ptr2 = nullptr;
+    umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr2, ptr);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr2, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 // other negative tests
 
+TEST_P(umfProviderTest, free_size_0_ptr_not_null) {
+    umf_result_t umf_result =
+        umfMemoryProviderFree(provider.get(), INVALID_PTR, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
 TEST_P(umfProviderTest, free_INVALID_POINTER_SIZE_GT_0) {
     umf_result_t umf_result =
         umfMemoryProviderFree(provider.get(), INVALID_PTR, page_plus_64);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_P(umfProviderTest, double_free) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_P(umfProviderTest, persist) {
+    void *ptr = nullptr;
+    size_t size = 2 * page_size;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    memset(ptr, 0xAB, size);
+
+    // cache flushes on a real device DAX, msync in the emulation mode
+    umf_result = umfMemoryProviderPersist(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result =
+        umfMemoryProviderPersist(provider.get(), (char *)ptr + 100, 200);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, persist_INVALID_POINTER) {
+    umf_result_t umf_result =
+        umfMemoryProviderPersist(provider.get(), INVALID_PTR, 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
 TEST_P(umfProviderTest, purge_lazy_INVALID_POINTER) {
@@ -349,3 +510,27 @@ TEST_F(test, create_wrong_size_0) {
     EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
     EXPECT_EQ(hProvider, nullptr);
 }
+
+TEST_F(test, create_emulation_wrong_path) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    const char *path = "/tmp/umf_no_such_dir/dax0.0";
+    auto wrong_params = emulationParams((char *)path);
+    auto ret = umfMemoryProviderCreate(umfDevDaxMemoryProviderOps(),
+                                       &wrong_params, &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+}
+
+// IPC tests in the emulation mode
+
+HostMemoryAccessor hostAccessor;
+
+static std::vector<ipcTestParams> ipcTestParamsList = {
+    {umfProxyPoolOps(), nullptr, umfDevDaxMemoryProviderOps(), &memfdParams,
+     &hostAccessor},
+    {umfProxyPoolOps(), nullptr, umfDevDaxMemoryProviderOps(), &fileParams,
+     &hostAccessor},
+};
+
+INSTANTIATE_TEST_SUITE_P(devdaxProviderTest, umfIpcTest,
+                         ::testing::ValuesIn(ipcTestParamsList));
@@ -10,12 +10,18 @@
 #include "test_helpers_linux.h"
 #endif
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <umf/memory_provider.h>
+#include <umf/pools/pool_proxy.h>
 #include <umf/providers/provider_file_memory.h>
 
 using umf_test::test;
 
 #define FILE_PATH ((char *)"tmp_file")
+#define FILE_PATH_PERSISTENT ((char *)"tmp_file_persistent")
 #define INVALID_PTR ((void *)0x01)
 
 typedef enum purge_t {
@@ -29,6 +35,7 @@ static const char *Native_error_str[] = {
     "memory allocation failed",   // UMF_FILE_RESULT_ERROR_ALLOC_FAILED
     "memory deallocation failed", // UMF_FILE_RESULT_ERROR_FREE_FAILED
     "force purging failed",       // UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED
+    "persisting memory failed",   // UMF_FILE_RESULT_ERROR_PERSIST_FAILED
 };
 
 // test helpers
@@ -98,7 +105,7 @@ static void test_alloc_free_success(umf_memory_provider_handle_t provider,
     }
 
     umf_result = umfMemoryProviderFree(provider, ptr, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 static void verify_last_native_error(umf_memory_provider_handle_t provider,
@@ -153,7 +160,7 @@ TEST_F(test, test_if_mapped_with_MAP_SYNC) {
     bool flag_found = is_mapped_with_MAP_SYNC(path, buf, size);
 
     umf_result = umfMemoryProviderFree(hProvider, buf, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 
     umfMemoryProviderDestroy(hProvider);
 
@@ -209,10 +216,10 @@ TEST_P(FileProviderParamsDefault, two_allocations) {
     memset(ptr2, 0x22, size);
 
     umf_result = umfMemoryProviderFree(provider.get(), ptr1, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 
     umf_result = umfMemoryProviderFree(provider.get(), ptr2, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 TEST_P(FileProviderParamsDefault, alloc_page64_align_0) {
@@ -328,19 +335,441 @@ TEST_P(FileProviderParamsDefault, get_name) {
     ASSERT_STREQ(name, "FILE");
 }
 
+TEST_P(FileProviderParamsDefault, free_and_reuse_memory) {
+    umf_result_t umf_result;
+    void *ptr1 = nullptr;
+    void *ptr2 = nullptr;
+    void *ptr3 = nullptr;
+
+    umf_result = umfMemoryProviderAlloc(provider.get(), page_plus_64, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr1, nullptr);
+
+    // the rest of the memory mapping of ptr1 is used
+    umf_result = umfMemoryProviderAlloc(provider.get(), 64, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr2, (char *)ptr1 + page_plus_64);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr2, 64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderAlloc(provider.get(), 64, 0, &ptr3);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr3, ptr2);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr3, 64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr1, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(FileProviderParamsDefault, free_and_reuse_file_offsets) {
+    umf_result_t umf_result;
+    struct stat st;
+    void *ptr = nullptr;
+    size_t size = 16 * page_size;
+
+    umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xFF, size);
+
+    ASSERT_EQ(stat(FILE_PATH, &st), 0);
+    off_t file_size = st.st_size;
+    blkcnt_t file_blocks = st.st_blocks;
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the space of the freed memory is deallocated (hole-punched)
+    ASSERT_EQ(stat(FILE_PATH, &st), 0);
+    ASSERT_EQ(st.st_size, file_size);
+    ASSERT_LT(st.st_blocks, file_blocks);
+
+    // the freed part of the file is reused, so the file does not grow
+    umf_result = umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xFF, size);
+
+    ASSERT_EQ(stat(FILE_PATH, &st), 0);
+    ASSERT_EQ(st.st_size, file_size);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
 TEST_P(FileProviderParamsDefault, free_size_0_ptr_not_null) {
     umf_result_t umf_result =
         umfMemoryProviderFree(provider.get(), INVALID_PTR, 0);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
 }
 
 TEST_P(FileProviderParamsDefault, free_NULL) {
     umf_result_t umf_result = umfMemoryProviderFree(provider.get(), nullptr, 0);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, mmap_granularity) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+
+    auto params = umfFileMemoryProviderParamsDefault(FILE_PATH);
+    params.mmap_granularity = 16 * page_size;
+    params.fallocate_ahead = 64 * page_size;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &params, &hProvider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(hProvider, nullptr);
+
+    void *ptr1 = nullptr;
+    umf_result = umfMemoryProviderAlloc(hProvider, page_size, 0, &ptr1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr1, nullptr);
+
+    // the file is extended ahead of demand
+    struct stat st;
+    ASSERT_EQ(stat(FILE_PATH, &st), 0);
+    ASSERT_GE((size_t)st.st_size,
+              params.mmap_granularity + params.fallocate_ahead);
+
+    // both allocations come from the same memory mapping
+    void *ptr2 = nullptr;
+    umf_result = umfMemoryProviderAlloc(hProvider, page_size, 0, &ptr2);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(ptr2, (char *)ptr1 + page_size);
+
+    memset(ptr1, 0x11, page_size);
+    memset(ptr2, 0x22, page_size);
+
+    umf_result = umfMemoryProviderFree(hProvider, ptr1, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(hProvider, ptr2, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the empty memory mapping is kept and reused
+    for (int i = 0; i < 10; i++) {
+        void *ptr = nullptr;
+        umf_result = umfMemoryProviderAlloc(hProvider, page_size, 0, &ptr);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ASSERT_EQ(ptr, ptr1);
+
+        umf_result = umfMemoryProviderFree(hProvider, ptr, page_size);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
+TEST_F(test, prefetch_willneed_populate) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    size_t size = 4 * page_size;
+
+    auto params = umfFileMemoryProviderParamsDefault(FILE_PATH);
+    params.prefetch = UMF_FILE_PREFETCH_WILLNEED | UMF_FILE_PREFETCH_POPULATE;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &params, &hProvider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(hProvider, nullptr);
+
+    void *ptr = nullptr;
+    umf_result = umfMemoryProviderAlloc(hProvider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    memset(ptr, 0xFF, size);
+
+    umf_result = umfMemoryProviderFree(hProvider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(hProvider);
+}
+
+static umf_memory_provider_handle_t create_persistent_provider() {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    auto params = get_file_params_shared(FILE_PATH_PERSISTENT);
+    params.persistent = true;
+
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &params, &hProvider);
+    EXPECT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    return hProvider;
+}
+
+TEST_F(test, persistent_heap_reopen) {
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    size_t size = 3 * page_size;
+    void *root = nullptr;
+    void *ptr = nullptr;
+
+    unlink(FILE_PATH_PERSISTENT);
+
+    umf_memory_provider_handle_t hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+
+    umf_result_t umf_result = umfFileMemoryProviderGetRoot(hProvider, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(root, nullptr);
+
+    // a freed allocation must not come back
+    umf_result = umfMemoryProviderAlloc(hProvider, page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderAlloc(hProvider, size, 0, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    memset(root, 0xAB, size);
+
+    umf_result = umfMemoryProviderFree(hProvider, ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the root object has to be an allocation of the provider
+    umf_result = umfFileMemoryProviderSetRoot(hProvider, (char *)root + 8);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfFileMemoryProviderSetRoot(hProvider, root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    // reopen the heap
+    hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+
+    root = nullptr;
+    umf_result = umfFileMemoryProviderGetRoot(hProvider, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(root, nullptr);
+    for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(((unsigned char *)root)[i], 0xAB);
+    }
+
+    // new allocations do not overlap the recovered one
+    umf_result = umfMemoryProviderAlloc(hProvider, size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_TRUE((char *)ptr + size <= (char *)root ||
+                (char *)root + size <= (char *)ptr);
+    memset(ptr, 0xCD, size);
+    ASSERT_EQ(((unsigned char *)root)[size - 1], 0xAB);
+
+    umf_result = umfMemoryProviderFree(hProvider, ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // freeing the root object clears it
+    umf_result = umfMemoryProviderFree(hProvider, root, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfFileMemoryProviderGetRoot(hProvider, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(root, nullptr);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    unlink(FILE_PATH_PERSISTENT);
+}
+
+TEST_F(test, persistent_heap_log_compaction) {
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    void *root = nullptr;
+    void *ptr = nullptr;
+
+    unlink(FILE_PATH_PERSISTENT);
+
+    umf_memory_provider_handle_t hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(hProvider, page_size, 0, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    *(int *)root = 42;
+
+    umf_result = umfFileMemoryProviderSetRoot(hProvider, root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // fill the log many times
+    for (int i = 0; i < 20000; i++) {
+        umf_result = umfMemoryProviderAlloc(hProvider, 64, 0, &ptr);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        umf_result = umfMemoryProviderFree(hProvider, ptr, 64);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    }
+
+    umfMemoryProviderDestroy(hProvider);
+
+    hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+
+    root = nullptr;
+    umf_result = umfFileMemoryProviderGetRoot(hProvider, &root);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(root, nullptr);
+    ASSERT_EQ(*(int *)root, 42);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    unlink(FILE_PATH_PERSISTENT);
+}
+
+TEST_F(test, persistent_heap_max_allocs) {
+    static constexpr size_t maxAllocs = 100;
+    umf_memory_provider_handle_t hProvider = nullptr;
+    std::vector<void *> ptrs;
+    void *ptr = nullptr;
+
+    unlink(FILE_PATH_PERSISTENT);
+
+    auto params = get_file_params_shared(FILE_PATH_PERSISTENT);
+    params.persistent = true;
+    params.persistent_max_allocs = maxAllocs;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &params, &hProvider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    for (size_t i = 0; i < maxAllocs; i++) {
+        umf_result = umfMemoryProviderAlloc(hProvider, 64, 0, &ptr);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ptrs.push_back(ptr);
+    }
+
+    umf_result = umfMemoryProviderAlloc(hProvider, 64, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    // frees do not fail when the heap is full
+    for (int i = 0; i < 10; i++) {
+        umf_result = umfMemoryProviderFree(hProvider, ptrs.back(), 64);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        umf_result = umfMemoryProviderAlloc(hProvider, 64, 0, &ptr);
+        ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+        ptrs.back() = ptr;
+    }
+
+    umfMemoryProviderDestroy(hProvider);
+
+    // the existing heap keeps its limit
+    params.persistent_max_allocs = 0;
+    umf_result = umfMemoryProviderCreate(umfFileMemoryProviderOps(), &params,
+                                         &hProvider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderAlloc(hProvider, 64, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    unlink(FILE_PATH_PERSISTENT);
+}
+
+TEST_F(test, persistent_heap_single_opener) {
+    unlink(FILE_PATH_PERSISTENT);
+
+    umf_memory_provider_handle_t hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+
+    // the heap is locked by the first provider
+    umf_memory_provider_handle_t hProvider2 = nullptr;
+    auto params = get_file_params_shared(FILE_PATH_PERSISTENT);
+    params.persistent = true;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &params, &hProvider2);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    ASSERT_EQ(hProvider2, nullptr);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    // and unlocked when the provider is destroyed
+    hProvider = create_persistent_provider();
+    ASSERT_NE(hProvider, nullptr);
+    umfMemoryProviderDestroy(hProvider);
+
+    unlink(FILE_PATH_PERSISTENT);
 }
 
 // other negative tests
 
+TEST_F(test, persistent_WRONG_visibility) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+
+    auto wrong_params = umfFileMemoryProviderParamsDefault(FILE_PATH);
+    wrong_params.persistent = true;
+
+    auto ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(),
+                                       &wrong_params, &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+}
+
+TEST_F(test, persistent_WRONG_file) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+
+    // a file which is not a persistent heap
+    int fd = open(FILE_PATH_PERSISTENT, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(ftruncate(fd, 2 * 1024 * 1024), 0);
+    close(fd);
+
+    auto wrong_params = get_file_params_shared(FILE_PATH_PERSISTENT);
+    wrong_params.persistent = true;
+
+    auto ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(),
+                                       &wrong_params, &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+
+    // the root object is not supported without the persistent heap
+    wrong_params.persistent = false;
+    ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(), &wrong_params,
+                                  &hProvider);
+    ASSERT_EQ(ret, UMF_RESULT_SUCCESS);
+
+    void *root = nullptr;
+    ret = umfFileMemoryProviderGetRoot(hProvider, &root);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    umfMemoryProviderDestroy(hProvider);
+
+    unlink(FILE_PATH_PERSISTENT);
+}
+
+
+TEST_F(test, create_WRONG_mmap_granularity) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+
+    auto wrong_params = umfFileMemoryProviderParamsDefault(FILE_PATH);
+    wrong_params.mmap_granularity = page_size + 1;
+
+    auto ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(),
+                                       &wrong_params, &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+}
+
+TEST_F(test, create_WRONG_prefetch) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+
+    auto wrong_params = umfFileMemoryProviderParamsDefault(FILE_PATH);
+    wrong_params.prefetch = 1u << 5;
+
+    auto ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(),
+                                       &wrong_params, &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+
+    // populating memory requires the read protection
+    wrong_params.prefetch = UMF_FILE_PREFETCH_POPULATE;
+    wrong_params.protection = UMF_PROTECTION_WRITE;
+
+    ret = umfMemoryProviderCreate(umfFileMemoryProviderOps(), &wrong_params,
+                                  &hProvider);
+    EXPECT_EQ(ret, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(hProvider, nullptr);
+}
+
 TEST_F(test, create_empty_path) {
     umf_memory_provider_handle_t hProvider = nullptr;
     const char *path = "";
@@ -354,7 +783,30 @@ TEST_F(test, create_empty_path) {
 TEST_P(FileProviderParamsDefault, free_INVALID_POINTER_SIZE_GT_0) {
     umf_result_t umf_result =
         umfMemoryProviderFree(provider.get(), INVALID_PTR, page_plus_64);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_P(FileProviderParamsDefault, free_twice) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_plus_64, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // keep the memory mapping alive after freeing ptr
+    void *ptr_keep = nullptr;
+    umf_result = umfMemoryProviderAlloc(provider.get(), 64, 0, &ptr_keep);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr_keep, nullptr);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr_keep, 64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 TEST_P(FileProviderParamsDefault, purge_lazy_INVALID_POINTER) {
@@ -372,6 +824,21 @@ TEST_P(FileProviderParamsDefault, purge_force_INVALID_POINTER) {
                              UMF_FILE_RESULT_ERROR_PURGE_FORCE_FAILED);
 }
 
+TEST_P(FileProviderParamsDefault, persist_private_NOT_SUPPORTED) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // changes of a private mapping never reach the file
+    umf_result = umfMemoryProviderPersist(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
 // IPC tests
 
 INSTANTIATE_TEST_SUITE_P(fileProviderTest, FileProviderParamsShared,
@@ -416,7 +883,7 @@ TEST_P(FileProviderParamsShared, IPC_base_success_test) {
     ASSERT_EQ(ret, 0);
 
     umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
 }
 
 TEST_P(FileProviderParamsShared, IPC_file_not_exist) {
@@ -456,5 +923,99 @@ TEST_P(FileProviderParamsShared, IPC_file_not_exist) {
     ASSERT_EQ(new_ptr, nullptr);
 
     umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
-    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+// persist tests
+
+TEST_P(FileProviderParamsShared, persist) {
+    void *ptr = nullptr;
+    size_t size = 2 * page_size;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    memset(ptr, 0xAB, size);
+
+    // a regular file is not mapped with MAP_SYNC, so msync is used
+    umf_result = umfMemoryProviderPersist(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // an unaligned sub-range
+    umf_result =
+        umfMemoryProviderPersist(provider.get(), (char *)ptr + 100, 200);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_result = umfMemoryProviderPersist(provider.get(), ptr, 0);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the written data has to be in the file
+    int fd = open(FILE_PATH, O_RDONLY);
+    ASSERT_NE(fd, -1);
+    unsigned char byte = 0;
+    ASSERT_EQ(pread(fd, &byte, 1, size - 1), 1);
+    ASSERT_EQ(byte, 0xAB);
+    close(fd);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(FileProviderParamsShared, persist_INVALID_POINTER) {
+    umf_result_t umf_result =
+        umfMemoryProviderPersist(provider.get(), INVALID_PTR, 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderPersist(provider.get(), nullptr, 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_P(FileProviderParamsShared, persist_WRONG_SIZE) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // the range exceeds the memory mapping
+    umf_result = umfMemoryProviderPersist(provider.get(), ptr, SIZE_MAX);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_F(test, persist_pool) {
+    umf_memory_provider_handle_t hProvider = nullptr;
+    umf_result_t umf_result = umfMemoryProviderCreate(
+        umfFileMemoryProviderOps(), &file_params_shared, &hProvider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_memory_pool_handle_t hPool = nullptr;
+    umf_result = umfPoolCreate(umfProxyPoolOps(), hProvider, nullptr,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &hPool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    size_t size = 3 * 4096;
+    char *ptr = (char *)umfPoolMalloc(hPool, size);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0x5A, size);
+
+    umf_result = umfPersist(ptr + 1, size - 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the range exceeds the allocation
+    umf_result = umfPersist(ptr, size + 1);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    // the memory does not belong to any UMF pool
+    char local[64];
+    umf_result = umfPersist(local, sizeof(local));
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfPoolFree(hPool, ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umfPoolDestroy(hPool);
 }
@@ -10,6 +10,7 @@
 
 #include <umf/memory_provider.h>
 #include <umf/pools/pool_disjoint.h>
+#include <umf/pools/pool_proxy.h>
 #include <umf/providers/provider_os_memory.h>
 
 using umf_test::test;
@@ -31,6 +32,8 @@ static const char *Native_error_str[] = {
     "lazy purging failed",             // UMF_OS_RESULT_ERROR_PURGE_LAZY_FAILED
     "force purging failed",            // UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED
     "HWLOC topology discovery failed", // UMF_OS_RESULT_ERROR_TOPO_DISCOVERY_FAILED
+    "migrating memory to NUMA node failed", // UMF_OS_RESULT_ERROR_MIGRATE_FAILED
+    "resizing memory mapping failed",       // UMF_OS_RESULT_ERROR_RESIZE_FAILED
 };
 
 // test helpers
@@ -262,6 +265,21 @@ TEST_P(umfProviderTest, alloc_WRONG_SIZE) {
 
 // other positive tests
 
+TEST_P(umfProviderTest, alloc_zero_info) {
+    void *ptr = nullptr;
+    bool zeroed = false;
+    umf_result_t umf_result = umfMemoryProviderAllocZeroInfo(
+        provider.get(), page_size, 0, &ptr, &zeroed);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_TRUE(zeroed);
+    ASSERT_EQ(((unsigned char *)ptr)[page_size - 1], 0);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+
 TEST_P(umfProviderTest, get_min_page_size) {
     size_t min_page_size;
     umf_result_t umf_result = umfMemoryProviderGetMinPageSize(
@@ -328,6 +346,69 @@ TEST_P(umfProviderTest, purge_force_INVALID_POINTER) {
                              UMF_OS_RESULT_ERROR_PURGE_FORCE_FAILED);
 }
 
+TEST_P(umfProviderTest, migrate_WRONG_ARGS) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    umf_result = umfMemoryProviderMigrate(provider.get(), ptr, page_size,
+                                         nullptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, resize_grow_shrink) {
+    size_t size = 4 * page_size;
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    memset(ptr, 0xAB, size);
+
+    void *new_ptr = nullptr;
+    umf_result = umfMemoryProviderResize(provider.get(), ptr, size,
+                                         256 * page_size, &new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(new_ptr, nullptr);
+    for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(((unsigned char *)new_ptr)[i], 0xAB);
+    }
+    memset(new_ptr, 0xCD, 256 * page_size);
+
+    ptr = new_ptr;
+    umf_result = umfMemoryProviderResize(provider.get(), ptr, 256 * page_size,
+                                         page_plus_64, &new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(((unsigned char *)new_ptr)[page_plus_64 - 1], 0xCD);
+
+    umf_result = umfMemoryProviderFree(provider.get(), new_ptr, page_plus_64);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+}
+
+TEST_P(umfProviderTest, resize_INVALID_POINTER) {
+    void *ptr = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderAlloc(provider.get(), page_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfMemoryProviderFree(provider.get(), ptr, page_size);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the mapping does not exist anymore
+    void *new_ptr = nullptr;
+    umf_result = umfMemoryProviderResize(provider.get(), ptr, page_size,
+                                         2 * page_size, &new_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_ERROR_MEMORY_PROVIDER_SPECIFIC);
+
+    verify_last_native_error(provider.get(), UMF_OS_RESULT_ERROR_RESIZE_FAILED);
+}
+
 TEST_P(umfProviderTest, get_ipc_handle_size_wrong_visibility) {
     size_t size;
     umf_result_t umf_result =
@@ -393,3 +474,103 @@ static std::vector<ipcTestParams> ipcTestParamsList = {
 
 INSTANTIATE_TEST_SUITE_P(osProviderTest, umfIpcTest,
                          ::testing::ValuesIn(ipcTestParamsList));
+
+TEST_F(test, proxyPoolRealloc) {
+    auto params = umfOsMemoryProviderParamsDefault();
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfPoolCreate(umfProxyPoolOps(), provider, nullptr,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    size_t size = 16 * (size_t)sysconf(_SC_PAGE_SIZE);
+    void *ptr = umfPoolRealloc(pool, nullptr, size);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, size);
+
+    void *new_ptr = umfPoolRealloc(pool, ptr, 64 * size);
+    ASSERT_NE(new_ptr, nullptr);
+    ASSERT_EQ(((unsigned char *)new_ptr)[size - 1], 0xAB);
+    memset(new_ptr, 0xCD, 64 * size);
+    ASSERT_EQ(umfPoolByPtr((char *)new_ptr + 64 * size - 1), pool);
+
+    ASSERT_EQ(umfPoolRealloc(pool, new_ptr, 0), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool), UMF_RESULT_SUCCESS);
+
+    umfPoolDestroy(pool);
+}
+
+TEST_F(test, proxyPoolCalloc) {
+    auto params = umfOsMemoryProviderParamsDefault();
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfPoolCreate(umfProxyPoolOps(), provider, nullptr,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the OS provider returns zeroed memory, so calloc is supported
+    size_t num = 16;
+    size_t size = (size_t)sysconf(_SC_PAGE_SIZE);
+    unsigned char *ptr = (unsigned char *)umfPoolCalloc(pool, num, size);
+    ASSERT_NE(ptr, nullptr);
+    for (size_t i = 0; i < num * size; i += size / 2) {
+        ASSERT_EQ(ptr[i], 0);
+    }
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+
+    ASSERT_EQ(umfPoolCalloc(pool, SIZE_MAX, 2), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool),
+              UMF_RESULT_ERROR_INVALID_ARGUMENT);
+
+    umfPoolDestroy(pool);
+}
+
+#if (defined UMF_POOL_DISJOINT_ENABLED)
+TEST_F(test, disjointPoolReallocLargeAllocation) {
+    auto params = umfOsMemoryProviderParamsDefault();
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_memory_provider_handle_t provider = nullptr;
+    umf_result_t umf_result =
+        umfMemoryProviderCreate(umfOsMemoryProviderOps(), &params, &provider);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umf_result = umfPoolCreate(umfDisjointPoolOps(), provider, &disjointParams,
+                               UMF_POOL_CREATE_FLAG_OWN_PROVIDER, &pool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // allocations within MaxPoolableSize are not resized
+    void *small = umfPoolMalloc(pool, 64);
+    ASSERT_NE(small, nullptr);
+    ASSERT_EQ(umfPoolRealloc(pool, small, 128), nullptr);
+    ASSERT_EQ(umfPoolGetLastAllocationError(pool),
+              UMF_RESULT_ERROR_NOT_SUPPORTED);
+    ASSERT_EQ(umfPoolFree(pool, small), UMF_RESULT_SUCCESS);
+
+    // allocations above MaxPoolableSize are resized by the memory provider
+    size_t size = 4 * disjointParams.MaxPoolableSize;
+    void *ptr = umfPoolMalloc(pool, size);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, size);
+
+    size_t new_size = 64 * size;
+    void *new_ptr = umfPoolRealloc(pool, ptr, new_size);
+    ASSERT_NE(new_ptr, nullptr);
+    for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(((unsigned char *)new_ptr)[i], 0xAB);
+    }
+    memset(new_ptr, 0xCD, new_size);
+    ASSERT_EQ(umfPoolByPtr((char *)new_ptr + new_size - 1), pool);
+
+    ptr = umfPoolRealloc(pool, new_ptr, size);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(((unsigned char *)ptr)[size - 1], 0xCD);
+
+    ASSERT_EQ(umfPoolFree(pool, ptr), UMF_RESULT_SUCCESS);
+    umfPoolDestroy(pool);
+}
+#endif
@@ -12,6 +12,8 @@
 #include <random>
 #include <sched.h>
 
+#include <umf/memspace.h>
+#include <umf/pools/pool_proxy.h>
 #include <umf/providers/provider_os_memory.h>
 
 static umf_os_memory_provider_params_t UMF_OS_MEMORY_PROVIDER_PARAMS_TEST =
@@ -251,6 +253,110 @@ TEST_P(testNumaOnEachNode, checkModeInterleaveSingleNode) {
     EXPECT_NODE_EQ(ptr, numa_node_number);
 }
 
+// Test for migrating an allocation bound to one numa node to another one.
+// It will be executed on each of the available numa nodes.
+TEST_P(testNumaOnEachNode, checkMigrateToOtherNode) {
+    unsigned numa_node_number = GetParam();
+    std::vector<unsigned> numa_nodes = get_available_numa_nodes();
+    unsigned target_node = numa_nodes[0] == numa_node_number ? numa_nodes[1]
+                                                             : numa_nodes[0];
+
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    alloc_size = 4 * page_size;
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        UMF_OS_MEMORY_PROVIDER_PARAMS_TEST;
+
+    os_memory_provider_params.numa_list = &numa_node_number;
+    os_memory_provider_params.numa_list_len = 1;
+    os_memory_provider_params.numa_mode = UMF_NUMA_MODE_BIND;
+    initOsProvider(os_memory_provider_params);
+
+    umf_result_t umf_result;
+    umf_result =
+        umfMemoryProviderAlloc(os_memory_provider, alloc_size, 0, &ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    ASSERT_NE(ptr, nullptr);
+
+    // 'ptr' must point to an initialized value before retrieving its numa node
+    memset(ptr, 0xFF, alloc_size);
+    EXPECT_NODE_EQ(ptr, numa_node_number);
+
+    umf_memspace_handle_t hMemspace = nullptr;
+    umf_result = umfMemspaceCreateFromNumaArray(&target_node, 1, &hMemspace);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_const_memtarget_handle_t hTarget =
+        umfMemspaceMemtargetGet(hMemspace, 0);
+    ASSERT_NE(hTarget, nullptr);
+
+    umf_result = umfMemoryProviderMigrate(os_memory_provider, ptr, alloc_size,
+                                         hTarget);
+    umfMemspaceDestroy(hMemspace);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the content must survive the migration
+    for (size_t i = 0; i < alloc_size; i++) {
+        ASSERT_EQ(((unsigned char *)ptr)[i], 0xFF);
+    }
+    EXPECT_NODE_EQ(ptr, target_node);
+    EXPECT_NODE_EQ((char *)ptr + alloc_size - 1, target_node);
+}
+
+// Test for migrating an allocation of a pool to another numa node.
+// It will be executed on each of the available numa nodes.
+TEST_P(testNumaOnEachNode, checkPoolMigrateToOtherNode) {
+    unsigned numa_node_number = GetParam();
+    std::vector<unsigned> numa_nodes = get_available_numa_nodes();
+    unsigned target_node = numa_nodes[0] == numa_node_number ? numa_nodes[1]
+                                                             : numa_nodes[0];
+
+    size_t page_size = sysconf(_SC_PAGE_SIZE);
+    size_t size = 4 * page_size;
+    umf_os_memory_provider_params_t os_memory_provider_params =
+        UMF_OS_MEMORY_PROVIDER_PARAMS_TEST;
+
+    os_memory_provider_params.numa_list = &numa_node_number;
+    os_memory_provider_params.numa_list_len = 1;
+    os_memory_provider_params.numa_mode = UMF_NUMA_MODE_BIND;
+    initOsProvider(os_memory_provider_params);
+
+    umf_memory_pool_handle_t pool = nullptr;
+    umf_result_t umf_result =
+        umfPoolCreate(umfProxyPoolOps(), os_memory_provider, nullptr, 0, &pool);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    auto *pool_ptr = (unsigned char *)umfPoolMalloc(pool, size);
+    ASSERT_NE(pool_ptr, nullptr);
+
+    // 'pool_ptr' must point to an initialized value before retrieving
+    // its numa node
+    memset(pool_ptr, 0xFF, size);
+    EXPECT_NODE_EQ(pool_ptr, numa_node_number);
+
+    umf_memspace_handle_t hMemspace = nullptr;
+    umf_result = umfMemspaceCreateFromNumaArray(&target_node, 1, &hMemspace);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    umf_const_memtarget_handle_t hTarget =
+        umfMemspaceMemtargetGet(hMemspace, 0);
+    ASSERT_NE(hTarget, nullptr);
+
+    umf_result = umfPoolMigrate(pool, pool_ptr, size, hTarget);
+    umfMemspaceDestroy(hMemspace);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+
+    // the content must survive the migration
+    for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(pool_ptr[i], 0xFF);
+    }
+    EXPECT_NODE_EQ(pool_ptr, target_node);
+    EXPECT_NODE_EQ(pool_ptr + size - 1, target_node);
+
+    umf_result = umfPoolFree(pool, pool_ptr);
+    ASSERT_EQ(umf_result, UMF_RESULT_SUCCESS);
+    umfPoolDestroy(pool);
+}
+
 struct testNumaOnEachCpu : testNuma, testing::WithParamInterface<int> {
     void SetUp() override {
         ::testNuma::SetUp();
@@ -5,6 +5,18 @@
 #include "base.hpp"
 #include "test_helpers.h"
 #include "utils/utils_common.h"
+#include "utils/utils_concurrency.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using umf_test::test;
 
@@ -57,3 +69,124 @@ TEST_F(test, utils_parse_var) {
     EXPECT_TRUE(utils_parse_var("test1;test2;test3,abc;test4", "test3", &arg));
     EXPECT_TRUE(utils_parse_var("test1;test2;test3;test4,abc", "test4", &arg));
 }
+
+TEST_F(test, utils_flush_cache) {
+    alignas(64) char buf[3 * 64 + 1];
+    memset(buf, 0xAB, sizeof(buf));
+
+    const char *instruction = utils_flush_cache_instruction();
+    int ret = utils_flush_cache(buf + 1, sizeof(buf) - 1);
+    if (instruction == NULL) {
+        // no cache flush instruction on this platform
+        EXPECT_EQ(ret, -1);
+        return;
+    }
+
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(utils_flush_cache(buf, 0), 0);
+
+    // flushed lines stay valid
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        ASSERT_EQ(buf[i], (char)0xAB);
+    }
+}
+
+#ifndef _WIN32
+TEST_F(test, utils_msync) {
+    size_t page_size = utils_get_page_size();
+    void *ptr = utils_mmap(NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, -1, 0);
+    ASSERT_NE(ptr, nullptr);
+
+    // an unaligned range spanning two pages
+    EXPECT_EQ(utils_msync((char *)ptr + page_size - 1, 2), 0);
+
+    EXPECT_EQ(utils_munmap(ptr, 2 * page_size), 0);
+}
+#endif
+
+TEST_F(test, utils_memzero_nt) {
+    // sizes below and above the non-temporal threshold with unaligned
+    // heads and tails
+    for (size_t size : {(size_t)100, (size_t)(4 << 20) + 3}) {
+        for (size_t offset : {0, 1, 63}) {
+            std::vector<char> buf(size + offset + 1, (char)0xAB);
+            utils_memzero_nt(buf.data() + offset, size);
+
+            for (size_t i = 0; i < offset; i++) {
+                ASSERT_EQ(buf[i], (char)0xAB);
+            }
+            for (size_t i = offset; i < offset + size; i++) {
+                ASSERT_EQ(buf[i], 0) << "size " << size << " offset " << offset;
+            }
+            ASSERT_EQ(buf[offset + size], (char)0xAB);
+        }
+    }
+}
+
+TEST_F(test, utils_memcpy_nt) {
+    for (size_t size : {(size_t)100, (size_t)(4 << 20) + 3}) {
+        std::vector<char> src(size + 7);
+        for (size_t i = 0; i < src.size(); i++) {
+            src[i] = (char)(i * 7 + 1);
+        }
+
+        // the source and the destination are differently aligned
+        for (size_t offset : {0, 1, 63}) {
+            std::vector<char> dst(size + offset + 1, (char)0xAB);
+            utils_memcpy_nt(dst.data() + offset, src.data() + 5, size);
+
+            ASSERT_EQ(memcmp(dst.data() + offset, src.data() + 5, size), 0)
+                << "size " << size << " offset " << offset;
+            ASSERT_EQ(dst[offset + size], (char)0xAB);
+            if (offset) {
+                ASSERT_EQ(dst[offset - 1], (char)0xAB);
+            }
+        }
+    }
+}
+
+TEST_F(test, utils_getcpu) {
+    unsigned ncpus = utils_get_num_cpus();
+    ASSERT_GE(ncpus, 1u);
+    unsigned nnodes = utils_get_num_numa_nodes();
+    ASSERT_GE(nnodes, 1u);
+
+    unsigned cpu = UINT_MAX, node = UINT_MAX;
+    if (utils_getcpu(&cpu, &node) != 0) {
+        GTEST_SKIP() << "getcpu() is not supported";
+    }
+
+    ASSERT_NE(cpu, UINT_MAX);
+    ASSERT_LT(node, nnodes);
+}
+
+#if defined(__linux__)
+TEST_F(test, utils_shared_mutex_owner_dead) {
+    size_t page_size = utils_get_page_size();
+    auto *mutex = (utils_shared_mutex_t *)utils_mmap(
+        NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, -1, 0);
+    ASSERT_NE(mutex, nullptr);
+    ASSERT_EQ(utils_shared_mutex_init(mutex), 0);
+
+    // the child process dies holding the mutex
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        _exit(utils_shared_mutex_lock(mutex) == 0 ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    // the mutex is taken over and it is usable again after being unlocked
+    EXPECT_EQ(utils_shared_mutex_lock(mutex), EOWNERDEAD);
+    EXPECT_EQ(utils_shared_mutex_unlock(mutex), 0);
+    EXPECT_EQ(utils_shared_mutex_lock(mutex), 0);
+    EXPECT_EQ(utils_shared_mutex_unlock(mutex), 0);
+
+    EXPECT_EQ(utils_munmap(mutex, page_size), 0);
+}
+#endif